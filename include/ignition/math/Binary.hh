@@ -0,0 +1,693 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_MATH_BINARY_HH_
+#define IGNITION_MATH_BINARY_HH_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+#include <vector>
+
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Inertial.hh>
+#include <ignition/math/MassMatrix3.hh>
+#include <ignition/math/Matrix3.hh>
+#include <ignition/math/Matrix4.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Quaternion.hh>
+#include <ignition/math/Vector2.hh>
+#include <ignition/math/Vector3.hh>
+#include <ignition/math/Vector4.hh>
+#include <ignition/math/config.hh>
+
+namespace ignition
+{
+  namespace math
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_MATH_VERSION_NAMESPACE {
+    //
+    /// \enum BinaryType
+    /// \brief Types that have a binary encoding. The values are stored in
+    /// array headers and never change.
+    enum BinaryType
+    {
+      /// \brief Vector2: x y.
+      BINARY_VECTOR2 = 1,
+
+      /// \brief Vector3: x y z.
+      BINARY_VECTOR3 = 2,
+
+      /// \brief Vector4: x y z w.
+      BINARY_VECTOR4 = 3,
+
+      /// \brief Quaternion: w x y z.
+      BINARY_QUATERNION = 4,
+
+      /// \brief Pose3: x y z, then the quaternion w x y z.
+      BINARY_POSE3 = 5,
+
+      /// \brief Matrix3: 9 values in row major order.
+      BINARY_MATRIX3 = 6,
+
+      /// \brief Matrix4: 16 values in row major order.
+      BINARY_MATRIX4 = 7,
+
+      /// \brief AxisAlignedBox: the min corner, then the max corner.
+      BINARY_AXIS_ALIGNED_BOX = 8,
+
+      /// \brief Inertial: mass, the diagonal moments xx yy zz, the off
+      /// diagonal moments xy xz yz, then the pose.
+      BINARY_INERTIAL = 9
+    };
+
+    /// \enum BinaryScalar
+    /// \brief Scalar types of the binary encoding. The values are stored in
+    /// array headers and never change.
+    enum BinaryScalar
+    {
+      /// \brief 32 bit IEEE 754 float.
+      BINARY_FLOAT32 = 1,
+
+      /// \brief 64 bit IEEE 754 float.
+      BINARY_FLOAT64 = 2,
+
+      /// \brief 32 bit two's complement integer.
+      BINARY_INT32 = 3
+    };
+
+    namespace detail
+    {
+      /// \brief Map a scalar type to its BinaryScalar value.
+      template<typename S>
+      constexpr BinaryScalar BinaryScalarOf()
+      {
+        static_assert(std::is_same<S, float>::value ||
+            std::is_same<S, double>::value ||
+            (std::is_same<S, int>::value && sizeof(int) == 4),
+            "Binary encoding supports float, double and 32 bit int");
+        return std::is_same<S, float>::value ? BINARY_FLOAT32 :
+          std::is_same<S, double>::value ? BINARY_FLOAT64 : BINARY_INT32;
+      }
+
+      /// \brief Store a scalar in little endian byte order one byte at a
+      /// time, which works on any machine.
+      /// \param[in] _value The scalar.
+      /// \param[out] _bytes Destination, with room for sizeof(S) bytes.
+      template<typename S>
+      inline void StoreLittleEndianPortable(const S _value,
+          unsigned char *_bytes)
+      {
+        using Bits = typename std::conditional<sizeof(S) == 8,
+              uint64_t, uint32_t>::type;
+        Bits bits;
+        std::memcpy(&bits, &_value, sizeof(S));
+        for (size_t i = 0; i < sizeof(S); ++i)
+          _bytes[i] = static_cast<unsigned char>(bits >> (8 * i));
+      }
+
+      /// \brief Load a scalar stored in little endian byte order one byte
+      /// at a time, which works on any machine.
+      /// \param[in] _bytes Source, holding sizeof(S) bytes.
+      /// \return The scalar.
+      template<typename S>
+      inline S LoadLittleEndianPortable(const unsigned char *_bytes)
+      {
+        using Bits = typename std::conditional<sizeof(S) == 8,
+              uint64_t, uint32_t>::type;
+        Bits bits = 0;
+        for (size_t i = 0; i < sizeof(S); ++i)
+          bits |= static_cast<Bits>(_bytes[i]) << (8 * i);
+        S value;
+        std::memcpy(&value, &bits, sizeof(S));
+        return value;
+      }
+
+      /// \brief Store a scalar in little endian byte order. Little endian
+      /// machines copy the bytes directly, unless IGN_MATH_BINARY_PORTABLE
+      /// is defined.
+      /// \param[in] _value The scalar.
+      /// \param[out] _bytes Destination, with room for sizeof(S) bytes.
+      template<typename S>
+      inline void StoreLittleEndian(const S _value, unsigned char *_bytes)
+      {
+#if !defined(IGN_MATH_BINARY_PORTABLE) && defined(__BYTE_ORDER__) && \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        std::memcpy(_bytes, &_value, sizeof(S));
+#else
+        StoreLittleEndianPortable(_value, _bytes);
+#endif
+      }
+
+      /// \brief Load a scalar stored in little endian byte order. Little
+      /// endian machines copy the bytes directly, unless
+      /// IGN_MATH_BINARY_PORTABLE is defined.
+      /// \param[in] _bytes Source, holding sizeof(S) bytes.
+      /// \return The scalar.
+      template<typename S>
+      inline S LoadLittleEndian(const unsigned char *_bytes)
+      {
+#if !defined(IGN_MATH_BINARY_PORTABLE) && defined(__BYTE_ORDER__) && \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        S value;
+        std::memcpy(&value, _bytes, sizeof(S));
+        return value;
+#else
+        return LoadLittleEndianPortable<S>(_bytes);
+#endif
+      }
+
+      /// \brief Encoding of a type as a fixed number of scalars. Each
+      /// specialization defines Scalar, kType, kCount, Encode and Decode.
+      template<typename T>
+      struct BinaryCodec;
+
+      template<typename T>
+      struct BinaryCodec<Vector2<T>>
+      {
+        using Scalar = T;
+        static constexpr BinaryType kType = BINARY_VECTOR2;
+        static constexpr size_t kCount = 2;
+        static void Encode(const Vector2<T> &_v, T *_s)
+        {
+          _s[0] = _v.X();
+          _s[1] = _v.Y();
+        }
+        static void Decode(const T *_s, Vector2<T> &_v)
+        {
+          _v.Set(_s[0], _s[1]);
+        }
+      };
+
+      template<typename T>
+      struct BinaryCodec<Vector3<T>>
+      {
+        using Scalar = T;
+        static constexpr BinaryType kType = BINARY_VECTOR3;
+        static constexpr size_t kCount = 3;
+        static void Encode(const Vector3<T> &_v, T *_s)
+        {
+          _s[0] = _v.X();
+          _s[1] = _v.Y();
+          _s[2] = _v.Z();
+        }
+        static void Decode(const T *_s, Vector3<T> &_v)
+        {
+          _v.Set(_s[0], _s[1], _s[2]);
+        }
+      };
+
+      template<typename T>
+      struct BinaryCodec<Vector4<T>>
+      {
+        using Scalar = T;
+        static constexpr BinaryType kType = BINARY_VECTOR4;
+        static constexpr size_t kCount = 4;
+        static void Encode(const Vector4<T> &_v, T *_s)
+        {
+          _s[0] = _v.X();
+          _s[1] = _v.Y();
+          _s[2] = _v.Z();
+          _s[3] = _v.W();
+        }
+        static void Decode(const T *_s, Vector4<T> &_v)
+        {
+          _v.Set(_s[0], _s[1], _s[2], _s[3]);
+        }
+      };
+
+      template<typename T>
+      struct BinaryCodec<Quaternion<T>>
+      {
+        using Scalar = T;
+        static constexpr BinaryType kType = BINARY_QUATERNION;
+        static constexpr size_t kCount = 4;
+        static void Encode(const Quaternion<T> &_q, T *_s)
+        {
+          _s[0] = _q.W();
+          _s[1] = _q.X();
+          _s[2] = _q.Y();
+          _s[3] = _q.Z();
+        }
+        static void Decode(const T *_s, Quaternion<T> &_q)
+        {
+          _q.Set(_s[0], _s[1], _s[2], _s[3]);
+        }
+      };
+
+      template<typename T>
+      struct BinaryCodec<Pose3<T>>
+      {
+        using Scalar = T;
+        static constexpr BinaryType kType = BINARY_POSE3;
+        static constexpr size_t kCount = 7;
+        static void Encode(const Pose3<T> &_p, T *_s)
+        {
+          BinaryCodec<Vector3<T>>::Encode(_p.Pos(), _s);
+          BinaryCodec<Quaternion<T>>::Encode(_p.Rot(), _s + 3);
+        }
+        static void Decode(const T *_s, Pose3<T> &_p)
+        {
+          BinaryCodec<Vector3<T>>::Decode(_s, _p.Pos());
+          BinaryCodec<Quaternion<T>>::Decode(_s + 3, _p.Rot());
+        }
+      };
+
+      template<typename T>
+      struct BinaryCodec<Matrix3<T>>
+      {
+        using Scalar = T;
+        static constexpr BinaryType kType = BINARY_MATRIX3;
+        static constexpr size_t kCount = 9;
+        static void Encode(const Matrix3<T> &_m, T *_s)
+        {
+          for (size_t i = 0; i < kCount; ++i)
+            _s[i] = _m(i / 3, i % 3);
+        }
+        static void Decode(const T *_s, Matrix3<T> &_m)
+        {
+          _m.Set(_s[0], _s[1], _s[2],
+                 _s[3], _s[4], _s[5],
+                 _s[6], _s[7], _s[8]);
+        }
+      };
+
+      template<typename T>
+      struct BinaryCodec<Matrix4<T>>
+      {
+        using Scalar = T;
+        static constexpr BinaryType kType = BINARY_MATRIX4;
+        static constexpr size_t kCount = 16;
+        static void Encode(const Matrix4<T> &_m, T *_s)
+        {
+          for (size_t i = 0; i < kCount; ++i)
+            _s[i] = _m(i / 4, i % 4);
+        }
+        static void Decode(const T *_s, Matrix4<T> &_m)
+        {
+          _m.Set(_s[0], _s[1], _s[2], _s[3],
+                 _s[4], _s[5], _s[6], _s[7],
+                 _s[8], _s[9], _s[10], _s[11],
+                 _s[12], _s[13], _s[14], _s[15]);
+        }
+      };
+
+      template<>
+      struct BinaryCodec<AxisAlignedBox>
+      {
+        using Scalar = double;
+        static constexpr BinaryType kType = BINARY_AXIS_ALIGNED_BOX;
+        static constexpr size_t kCount = 6;
+        static void Encode(const AxisAlignedBox &_b, double *_s)
+        {
+          BinaryCodec<Vector3d>::Encode(_b.Min(), _s);
+          BinaryCodec<Vector3d>::Encode(_b.Max(), _s + 3);
+        }
+        static void Decode(const double *_s, AxisAlignedBox &_b)
+        {
+          // Set the corners directly so empty boxes are kept as they are.
+          BinaryCodec<Vector3d>::Decode(_s, _b.Min());
+          BinaryCodec<Vector3d>::Decode(_s + 3, _b.Max());
+        }
+      };
+
+      template<typename T>
+      struct BinaryCodec<Inertial<T>>
+      {
+        using Scalar = T;
+        static constexpr BinaryType kType = BINARY_INERTIAL;
+        static constexpr size_t kCount = 14;
+        static void Encode(const Inertial<T> &_i, T *_s)
+        {
+          const MassMatrix3<T> &m = _i.MassMatrix();
+          _s[0] = m.Mass();
+          BinaryCodec<Vector3<T>>::Encode(m.DiagonalMoments(), _s + 1);
+          BinaryCodec<Vector3<T>>::Encode(m.OffDiagonalMoments(), _s + 4);
+          BinaryCodec<Pose3<T>>::Encode(_i.Pose(), _s + 7);
+        }
+        static void Decode(const T *_s, Inertial<T> &_i)
+        {
+          Vector3<T> diagonal, offDiagonal;
+          Pose3<T> pose;
+          BinaryCodec<Vector3<T>>::Decode(_s + 1, diagonal);
+          BinaryCodec<Vector3<T>>::Decode(_s + 4, offDiagonal);
+          BinaryCodec<Pose3<T>>::Decode(_s + 7, pose);
+          _i = Inertial<T>(MassMatrix3<T>(_s[0], diagonal, offDiagonal),
+              pose);
+        }
+      };
+    }
+
+    /// \class Binary Binary.hh ignition/math/Binary.hh
+    /// \brief Compact, versioned binary encoding of math types and arrays of
+    /// them.
+    ///
+    /// A value is written as a fixed number of scalars of its own scalar
+    /// type, in little endian byte order whatever the machine, with no
+    /// padding. For example a Pose3d takes 56 bytes: x y z, then the
+    /// quaternion w x y z. The layout of each type is described by
+    /// BinaryType.
+    ///
+    /// An array starts with a 16 byte header followed by the values:
+    ///
+    /// | Offset | Size | Content                                  |
+    /// |--------|------|------------------------------------------|
+    /// | 0      | 4    | "IGNB"                                   |
+    /// | 4      | 2    | Format version, currently 1              |
+    /// | 6      | 1    | BinaryType of the values                 |
+    /// | 7      | 1    | BinaryScalar of the values               |
+    /// | 8      | 8    | Number of values, or kUnknownCount       |
+    ///
+    /// All multi-byte numbers are little endian. Since values have a fixed
+    /// size, BinaryArrayView reads any value of an array in place, for
+    /// example from a memory mapped log file, without decoding the others.
+    ///
+    /// ## Example
+    ///
+    /// \code{.cpp}
+    /// std::vector<ignition::math::Pose3d> poses = ...;
+    /// std::ofstream file("poses.bin", std::ios::binary);
+    /// ignition::math::Binary::WriteArray(file, poses.data(), poses.size());
+    ///
+    /// // Later, with the file contents at data
+    /// ignition::math::BinaryArrayView<ignition::math::Pose3d> view;
+    /// if (view.Open(data, size))
+    ///   ignition::math::Pose3d last = view[view.Size() - 1];
+    /// \endcode
+    class Binary
+    {
+      /// \brief Version of the format written.
+      public: static constexpr uint16_t kVersion = 1;
+
+      /// \brief Size of an array header in bytes.
+      public: static constexpr size_t kHeaderSize = 16;
+
+      /// \brief Count stored in the header of an array whose size is given
+      /// by the length of the data, as in a log that is still being
+      /// appended to.
+      public: static constexpr uint64_t kUnknownCount = ~uint64_t(0);
+
+      /// \brief Get the size of the encoding of a value.
+      /// \return Number of bytes.
+      public: template<typename T>
+              static constexpr size_t Size()
+      {
+        return detail::BinaryCodec<T>::kCount *
+          sizeof(typename detail::BinaryCodec<T>::Scalar);
+      }
+
+      /// \brief Get the size of an array of values with its header.
+      /// \param[in] _count Number of values.
+      /// \return Number of bytes.
+      public: template<typename T>
+              static constexpr size_t ArraySize(const size_t _count)
+      {
+        return kHeaderSize + _count * Size<T>();
+      }
+
+      /// \brief Write a value.
+      /// \param[in] _value The value.
+      /// \param[out] _buffer Buffer to write to.
+      /// \param[in] _size Size of the buffer.
+      /// \return Number of bytes written, Size<T>(), or 0 if the buffer is
+      /// too small.
+      public: template<typename T>
+              static size_t Write(const T &_value, void *_buffer,
+                  const size_t _size)
+      {
+        using Codec = detail::BinaryCodec<T>;
+        using Scalar = typename Codec::Scalar;
+        if (_size < Size<T>())
+          return 0;
+
+        Scalar s[Codec::kCount];
+        Codec::Encode(_value, s);
+        unsigned char *bytes = static_cast<unsigned char *>(_buffer);
+        for (size_t i = 0; i < Codec::kCount; ++i)
+          detail::StoreLittleEndian(s[i], bytes + i * sizeof(Scalar));
+        return Size<T>();
+      }
+
+      /// \brief Read a value written by Write().
+      /// \param[in] _buffer Buffer to read from.
+      /// \param[in] _size Size of the buffer.
+      /// \param[out] _value The value, only set on success.
+      /// \return False if the buffer is too small.
+      public: template<typename T>
+              static bool Read(const void *_buffer, const size_t _size,
+                  T &_value)
+      {
+        using Codec = detail::BinaryCodec<T>;
+        using Scalar = typename Codec::Scalar;
+        if (_size < Size<T>())
+          return false;
+
+        Scalar s[Codec::kCount];
+        const unsigned char *bytes =
+          static_cast<const unsigned char *>(_buffer);
+        for (size_t i = 0; i < Codec::kCount; ++i)
+          s[i] = detail::LoadLittleEndian<Scalar>(bytes + i * sizeof(Scalar));
+        Codec::Decode(s, _value);
+        return true;
+      }
+
+      /// \brief Write the header of an array.
+      /// \param[in] _count Number of values that follow, or kUnknownCount.
+      /// \param[out] _buffer Buffer to write to.
+      /// \param[in] _size Size of the buffer.
+      /// \return Number of bytes written, kHeaderSize, or 0 if the buffer
+      /// is too small.
+      public: template<typename T>
+              static size_t WriteHeader(const uint64_t _count, void *_buffer,
+                  const size_t _size)
+      {
+        using Codec = detail::BinaryCodec<T>;
+        if (_size < kHeaderSize)
+          return 0;
+
+        unsigned char *bytes = static_cast<unsigned char *>(_buffer);
+        std::memcpy(bytes, "IGNB", 4);
+        bytes[4] = static_cast<unsigned char>(kVersion & 0xff);
+        bytes[5] = static_cast<unsigned char>(kVersion >> 8);
+        bytes[6] = static_cast<unsigned char>(Codec::kType);
+        bytes[7] = static_cast<unsigned char>(
+            detail::BinaryScalarOf<typename Codec::Scalar>());
+        detail::StoreLittleEndian(_count, bytes + 8);
+        return kHeaderSize;
+      }
+
+      /// \brief Write an array of values with its header.
+      /// \param[in] _values The values.
+      /// \param[in] _count Number of values.
+      /// \param[out] _buffer Buffer to write to.
+      /// \param[in] _size Size of the buffer.
+      /// \return Number of bytes written, ArraySize<T>(_count), or 0 if the
+      /// buffer is too small.
+      public: template<typename T>
+              static size_t WriteArray(const T *_values, const size_t _count,
+                  void *_buffer, const size_t _size)
+      {
+        if (_size < ArraySize<T>(_count))
+          return 0;
+
+        unsigned char *bytes = static_cast<unsigned char *>(_buffer);
+        WriteHeader<T>(_count, bytes, kHeaderSize);
+        for (size_t i = 0; i < _count; ++i)
+          Write(_values[i], bytes + kHeaderSize + i * Size<T>(), Size<T>());
+        return ArraySize<T>(_count);
+      }
+
+      /// \brief Write an array of values with its header to a stream. The
+      /// values are encoded through a small stack buffer.
+      /// \param[in] _out Stream to write to, opened in binary mode.
+      /// \param[in] _values The values.
+      /// \param[in] _count Number of values.
+      /// \return False if the stream failed.
+      public: template<typename T>
+              static bool WriteArray(std::ostream &_out, const T *_values,
+                  const size_t _count)
+      {
+        unsigned char buffer[4096];
+        WriteHeader<T>(_count, buffer, sizeof(buffer));
+        _out.write(reinterpret_cast<const char *>(buffer), kHeaderSize);
+
+        const size_t chunk = sizeof(buffer) / Size<T>();
+        for (size_t first = 0; first < _count && _out; first += chunk)
+        {
+          const size_t n = std::min(chunk, _count - first);
+          for (size_t i = 0; i < n; ++i)
+          {
+            Write(_values[first + i], buffer + i * Size<T>(), Size<T>());
+          }
+          _out.write(reinterpret_cast<const char *>(buffer),
+              static_cast<std::streamsize>(n * Size<T>()));
+        }
+        return static_cast<bool>(_out);
+      }
+    };
+
+    /// \class BinaryArrayView Binary.hh ignition/math/Binary.hh
+    /// \brief Read only access to an array written by Binary::WriteArray,
+    /// in place in a memory buffer. Values are decoded one at a time when
+    /// they are accessed, so opening a view of a large array is constant
+    /// time. The buffer must outlive the view and need not be aligned.
+    ///
+    /// Decoding an AxisAlignedBox allocates, since AxisAlignedBox holds its
+    /// data behind a pointer. Other types are decoded on the stack.
+    template<typename T>
+    class BinaryArrayView
+    {
+      /// \brief Constructor of an empty view.
+      public: BinaryArrayView() = default;
+
+      /// \brief Constructor that opens a buffer.
+      /// \param[in] _data The buffer.
+      /// \param[in] _size Size of the buffer in bytes.
+      /// \sa Open
+      public: BinaryArrayView(const void *_data, const size_t _size)
+      {
+        this->Open(_data, _size);
+      }
+
+      /// \brief View an array in a buffer. The header must match T and
+      /// have a version that is not newer than Binary::kVersion. If the
+      /// header count is Binary::kUnknownCount, the array holds every
+      /// complete value in the buffer.
+      /// \param[in] _data The buffer.
+      /// \param[in] _size Size of the buffer in bytes.
+      /// \return False if the buffer does not hold an array of T, in which
+      /// case the view is empty.
+      public: bool Open(const void *_data, const size_t _size)
+      {
+        using Codec = detail::BinaryCodec<T>;
+        this->data = nullptr;
+        this->count = 0;
+
+        const unsigned char *bytes =
+          static_cast<const unsigned char *>(_data);
+        if (bytes == nullptr || _size < Binary::kHeaderSize ||
+            std::memcmp(bytes, "IGNB", 4) != 0)
+        {
+          std::cerr << "Buffer does not hold a binary math array\n";
+          return false;
+        }
+
+        const uint16_t version = static_cast<uint16_t>(
+            bytes[4] | (bytes[5] << 8));
+        if (version == 0 || version > Binary::kVersion)
+        {
+          std::cerr << "Unsupported binary math array version "
+                    << version << "\n";
+          return false;
+        }
+
+        if (bytes[6] != Codec::kType ||
+            bytes[7] != detail::BinaryScalarOf<typename Codec::Scalar>())
+        {
+          std::cerr << "Binary math array holds type " << int(bytes[6])
+                    << " of scalar " << int(bytes[7]) << ", expected "
+                    << int(Codec::kType) << " of scalar "
+                    << int(detail::BinaryScalarOf<typename Codec::Scalar>())
+                    << "\n";
+          return false;
+        }
+
+        const size_t available =
+          (_size - Binary::kHeaderSize) / Binary::Size<T>();
+        const uint64_t stored =
+          detail::LoadLittleEndian<uint64_t>(bytes + 8);
+        if (stored != Binary::kUnknownCount && stored > available)
+        {
+          std::cerr << "Binary math array holds " << stored
+                    << " values but the buffer only has room for "
+                    << available << "\n";
+          return false;
+        }
+
+        this->data = bytes + Binary::kHeaderSize;
+        this->count = stored == Binary::kUnknownCount ?
+          available : static_cast<size_t>(stored);
+        return true;
+      }
+
+      /// \brief Get the number of values.
+      /// \return Number of values, 0 if the view is empty.
+      public: size_t Size() const
+      {
+        return this->count;
+      }
+
+      /// \brief Get a value. The index is not checked.
+      /// \param[in] _index Index of the value, less than Size().
+      /// \return The value.
+      public: T operator[](const size_t _index) const
+      {
+        T value;
+        Binary::Read(this->data + _index * Binary::Size<T>(),
+            Binary::Size<T>(), value);
+        return value;
+      }
+
+      /// \brief Get a value, checking the index.
+      /// \param[in] _index Index of the value.
+      /// \param[out] _value The value, only set on success.
+      /// \return False if the index is out of range.
+      public: bool At(const size_t _index, T &_value) const
+      {
+        if (_index >= this->count)
+          return false;
+        return Binary::Read(this->data + _index * Binary::Size<T>(),
+            Binary::Size<T>(), _value);
+      }
+
+      /// \brief Decode a range of values.
+      /// \param[in] _first Index of the first value.
+      /// \param[in] _count Number of values. The range is clipped to the
+      /// array.
+      /// \param[out] _values The values. Existing content is cleared.
+      public: void Read(const size_t _first, const size_t _count,
+                  std::vector<T> &_values) const
+      {
+        _values.clear();
+        if (_first >= this->count)
+          return;
+        const size_t n = std::min(_count, this->count - _first);
+        _values.resize(n);
+        for (size_t i = 0; i < n; ++i)
+          _values[i] = (*this)[_first + i];
+      }
+
+      /// \brief Get the encoded values, which follow the header.
+      /// \return Pointer to the first value, or null if no array is open.
+      public: const unsigned char *Data() const
+      {
+        return this->data;
+      }
+
+      /// \brief Encoded values.
+      private: const unsigned char *data = nullptr;
+
+      /// \brief Number of values.
+      private: size_t count = 0;
+    };
+    }
+  }
+}
+#endif
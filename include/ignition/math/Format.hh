@@ -0,0 +1,370 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_MATH_FORMAT_HH_
+#define IGNITION_MATH_FORMAT_HH_
+
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <system_error>
+#include <type_traits>
+
+#ifndef __cpp_lib_to_chars
+#include <iomanip>
+#include <locale>
+#include <sstream>
+#include <string>
+#endif
+
+#include <ignition/math/Angle.hh>
+#include <ignition/math/Color.hh>
+#include <ignition/math/Matrix3.hh>
+#include <ignition/math/Matrix4.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Quaternion.hh>
+#include <ignition/math/Temperature.hh>
+#include <ignition/math/Vector2.hh>
+#include <ignition/math/Vector3.hh>
+#include <ignition/math/Vector4.hh>
+#include <ignition/math/config.hh>
+
+namespace ignition
+{
+  namespace math
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_MATH_VERSION_NAMESPACE {
+    //
+    /// \enum FormatMode
+    /// \brief How floating point numbers are written.
+    enum FormatMode
+    {
+      /// \brief The shortest text that reads back to the same number.
+      FORMAT_SHORTEST = 0,
+
+      /// \brief Fixed notation with a given number of digits after the
+      /// decimal point.
+      FORMAT_FIXED = 1
+    };
+
+    /// \class FormatOptions Format.hh ignition/math/Format.hh
+    /// \brief Options for writing values as text.
+    class FormatOptions
+    {
+      /// \brief Constructor.
+      /// \param[in] _mode How floating point numbers are written.
+      /// \param[in] _precision Digits after the decimal point in
+      /// FORMAT_FIXED mode.
+      /// \param[in] _separator Character written between the numbers of a
+      /// value.
+      public: constexpr FormatOptions(const FormatMode _mode = FORMAT_SHORTEST,
+                  const int _precision = 6, const char _separator = ' ')
+              : mode(_mode), precision(_precision), separator(_separator)
+      {
+      }
+
+      /// \brief How floating point numbers are written.
+      public: FormatMode mode = FORMAT_SHORTEST;
+
+      /// \brief Digits after the decimal point in FORMAT_FIXED mode.
+      public: int precision = 6;
+
+      /// \brief Character written between the numbers of a value.
+      public: char separator = ' ';
+    };
+
+    namespace detail
+    {
+      /// \brief Write a character.
+      /// \param[in] _first Start of the free space, or null after an
+      /// earlier overflow.
+      /// \param[in] _last End of the buffer.
+      /// \param[in] _c The character.
+      /// \return The end of the text, or null if the buffer is too small.
+      inline char *WriteChar(char *_first, char *_last, const char _c)
+      {
+        if (_first == nullptr || _first == _last)
+          return nullptr;
+        *_first = _c;
+        return _first + 1;
+      }
+
+      /// \brief Write a number.
+      /// \param[in] _first Start of the free space, or null after an
+      /// earlier overflow.
+      /// \param[in] _last End of the buffer.
+      /// \param[in] _value The number.
+      /// \param[in] _options The options.
+      /// \return The end of the text, or null if the buffer is too small.
+      template<typename T>
+      char *WriteNumber(char *_first, char *_last, const T _value,
+          const FormatOptions &_options)
+      {
+        static_assert(std::is_arithmetic<T>::value &&
+            !std::is_same<T, bool>::value, "T must be a number");
+
+        if (_first == nullptr)
+          return nullptr;
+
+        std::to_chars_result result;
+        if constexpr (std::is_floating_point<T>::value)
+        {
+#ifdef __cpp_lib_to_chars
+          if (_options.mode == FORMAT_FIXED)
+          {
+            result = std::to_chars(_first, _last, _value,
+                std::chars_format::fixed, _options.precision);
+          }
+          else
+          {
+            result = std::to_chars(_first, _last, _value);
+          }
+#else
+          // Slow path for standard libraries without floating point
+          // to_chars. The text round-trips but may not be the shortest.
+          std::ostringstream stream;
+          stream.imbue(std::locale::classic());
+          if (_options.mode == FORMAT_FIXED)
+            stream << std::fixed << std::setprecision(_options.precision);
+          else
+            stream << std::setprecision(std::numeric_limits<T>::max_digits10);
+          stream << _value;
+          const std::string text = stream.str();
+          if (text.size() > static_cast<size_t>(_last - _first))
+            return nullptr;
+          std::memcpy(_first, text.data(), text.size());
+          result.ptr = _first + text.size();
+          result.ec = std::errc();
+#endif
+        }
+        else
+        {
+          result = std::to_chars(_first, _last, _value);
+        }
+        return result.ec == std::errc() ? result.ptr : nullptr;
+      }
+
+      /// \brief Write numbers separated by the separator of the options.
+      template<typename T, size_t N>
+      char *WriteNumbers(char *_first, char *_last, const T (&_values)[N],
+          const FormatOptions &_options)
+      {
+        for (size_t i = 0; i < N; ++i)
+        {
+          if (i > 0)
+            _first = WriteChar(_first, _last, _options.separator);
+          _first = WriteNumber(_first, _last, _values[i], _options);
+        }
+        return _first;
+      }
+
+      /// \brief Write a number.
+      template<typename T>
+      typename std::enable_if<std::is_arithmetic<T>::value, char *>::type
+      Write(char *_first, char *_last, const T &_value,
+          const FormatOptions &_options)
+      {
+        return WriteNumber(_first, _last, _value, _options);
+      }
+
+      /// \brief Write an angle in radians.
+      inline char *Write(char *_first, char *_last, const Angle &_value,
+          const FormatOptions &_options)
+      {
+        return WriteNumber(_first, _last, _value.Radian(), _options);
+      }
+
+      /// \brief Write a temperature in Kelvin.
+      inline char *Write(char *_first, char *_last,
+          const Temperature &_value, const FormatOptions &_options)
+      {
+        return WriteNumber(_first, _last, _value.Kelvin(), _options);
+      }
+
+      /// \brief Write a color as r g b a.
+      inline char *Write(char *_first, char *_last, const Color &_value,
+          const FormatOptions &_options)
+      {
+        const float v[4] = {_value.R(), _value.G(), _value.B(), _value.A()};
+        return WriteNumbers(_first, _last, v, _options);
+      }
+
+      /// \brief Write a 2D vector as x y.
+      template<typename T>
+      char *Write(char *_first, char *_last, const Vector2<T> &_value,
+          const FormatOptions &_options)
+      {
+        const T v[2] = {_value.X(), _value.Y()};
+        return WriteNumbers(_first, _last, v, _options);
+      }
+
+      /// \brief Write a 3D vector as x y z.
+      template<typename T>
+      char *Write(char *_first, char *_last, const Vector3<T> &_value,
+          const FormatOptions &_options)
+      {
+        const T v[3] = {_value.X(), _value.Y(), _value.Z()};
+        return WriteNumbers(_first, _last, v, _options);
+      }
+
+      /// \brief Write a 4D vector as x y z w.
+      template<typename T>
+      char *Write(char *_first, char *_last, const Vector4<T> &_value,
+          const FormatOptions &_options)
+      {
+        const T v[4] = {_value.X(), _value.Y(), _value.Z(), _value.W()};
+        return WriteNumbers(_first, _last, v, _options);
+      }
+
+      /// \brief Write a quaternion as roll pitch yaw in radians.
+      template<typename T>
+      char *Write(char *_first, char *_last, const Quaternion<T> &_value,
+          const FormatOptions &_options)
+      {
+        // Adding zero turns the -0 that Euler() gives for some angles of
+        // exact rotations into 0.
+        const Vector3<T> euler = _value.Euler();
+        const T v[3] = {euler.X() + T(0), euler.Y() + T(0),
+          euler.Z() + T(0)};
+        return WriteNumbers(_first, _last, v, _options);
+      }
+
+      /// \brief Write a pose as x y z roll pitch yaw.
+      template<typename T>
+      char *Write(char *_first, char *_last, const Pose3<T> &_value,
+          const FormatOptions &_options)
+      {
+        _first = Write(_first, _last, _value.Pos(), _options);
+        _first = WriteChar(_first, _last, _options.separator);
+        return Write(_first, _last, _value.Rot(), _options);
+      }
+
+      /// \brief Write a 3x3 matrix in row major order.
+      template<typename T>
+      char *Write(char *_first, char *_last, const Matrix3<T> &_value,
+          const FormatOptions &_options)
+      {
+        T v[9];
+        for (size_t i = 0; i < 9; ++i)
+          v[i] = _value(i / 3, i % 3);
+        return WriteNumbers(_first, _last, v, _options);
+      }
+
+      /// \brief Write a 4x4 matrix in row major order.
+      template<typename T>
+      char *Write(char *_first, char *_last, const Matrix4<T> &_value,
+          const FormatOptions &_options)
+      {
+        T v[16];
+        for (size_t i = 0; i < 16; ++i)
+          v[i] = _value(i / 4, i % 4);
+        return WriteNumbers(_first, _last, v, _options);
+      }
+    }
+
+    /// \brief Write a value as text into a buffer, in the format of its
+    /// output operator, which Parse() and the input operator read.
+    ///
+    /// Unlike the output operators, formatting does not allocate and does
+    /// not depend on the global locale. Numbers are written with
+    /// std::to_chars. In FORMAT_SHORTEST mode each number is written with
+    /// the fewest digits that read back to the same value, so vectors,
+    /// matrices and pose positions round-trip exactly through Parse().
+    /// Rotations are written as Euler angles, as by the output operator,
+    /// so they round-trip up to the rounding of the Euler conversion.
+    ///
+    /// Supported types are the arithmetic types, Angle, Color, Matrix3,
+    /// Matrix4, Pose3, Quaternion, Temperature, Vector2, Vector3 and
+    /// Vector4.
+    ///
+    /// ## Example
+    ///
+    /// \code{.cpp}
+    /// char buffer[256];
+    /// size_t size = ignition::math::Format(buffer, sizeof(buffer), pose);
+    /// fwrite(buffer, 1, size, file);
+    /// \endcode
+    /// \param[out] _buffer Buffer to write to. No null character is added.
+    /// \param[in] _size Size of the buffer.
+    /// \param[in] _value The value.
+    /// \param[in] _options The options.
+    /// \return Number of characters written, or 0 if the buffer is too
+    /// small, in which case its content is unspecified.
+    template<typename T>
+    size_t Format(char *_buffer, const size_t _size, const T &_value,
+        const FormatOptions &_options = FormatOptions())
+    {
+      const char *end = detail::Write(_buffer, _buffer + _size, _value,
+          _options);
+      return end == nullptr ? 0 : static_cast<size_t>(end - _buffer);
+    }
+
+    /// \brief Write values as lines of text, one value per line, as in a
+    /// CSV or TSV file. The numbers of each value are separated by the
+    /// separator of the options, for example ',' or '\\t', and each line
+    /// ends with '\\n'. Only complete lines are written, so a large array
+    /// can be written through a small buffer in several calls.
+    ///
+    /// ## Example
+    ///
+    /// \code{.cpp}
+    /// char buffer[65536];
+    /// ignition::math::FormatOptions csv(ignition::math::FORMAT_SHORTEST,
+    ///     6, ',');
+    /// for (size_t done = 0, size = 0; done < poses.size();)
+    /// {
+    ///   const size_t lines = ignition::math::FormatLines(buffer,
+    ///       sizeof(buffer), poses.data() + done, poses.size() - done, size,
+    ///       csv);
+    ///   if (lines == 0)  // A single line does not fit in the buffer
+    ///     break;
+    ///   fwrite(buffer, 1, size, file);
+    ///   done += lines;
+    /// }
+    /// \endcode
+    /// \param[out] _buffer Buffer to write to. No null character is added.
+    /// \param[in] _size Size of the buffer.
+    /// \param[in] _values Values to write.
+    /// \param[in] _count Number of values.
+    /// \param[out] _written Number of characters written.
+    /// \param[in] _options The options.
+    /// \return Number of values written, which is less than _count when
+    /// the buffer is full, and 0 if a single line does not fit.
+    template<typename T>
+    size_t FormatLines(char *_buffer, const size_t _size, const T *_values,
+        const size_t _count, size_t &_written,
+        const FormatOptions &_options = FormatOptions())
+    {
+      char *first = _buffer;
+      char *last = _buffer + _size;
+      size_t i = 0;
+      for (; i < _count; ++i)
+      {
+        char *end = detail::Write(first, last, _values[i], _options);
+        end = detail::WriteChar(end, last, '\n');
+        if (end == nullptr)
+          break;
+        first = end;
+      }
+      _written = static_cast<size_t>(first - _buffer);
+      return i;
+    }
+    }
+  }
+}
+#endif
@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_MATH_GAUSSMARKOVPROCESSBANK_HH_
+#define IGNITION_MATH_GAUSSMARKOVPROCESSBANK_HH_
+
+#include <memory>
+#include <vector>
+#include <ignition/math/Export.hh>
+#include <ignition/math/GaussMarkovProcess.hh>
+#include <ignition/math/config.hh>
+
+namespace ignition
+{
+  namespace math
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_MATH_VERSION_NAMESPACE {
+    //
+    // Forward declarations.
+    class GaussMarkovProcessBankPrivate;
+
+    /** \class GaussMarkovProcessBank GaussMarkovProcessBank.hh\
+     * ignition/math/GaussMarkovProcessBank.hh
+     **/
+    /// \brief A set of independent Gauss-Markov processes that are all
+    /// stepped together, such as the bias of every channel of a group of
+    /// sensors.
+    ///
+    /// Process parameters and values are stored as separate arrays, and
+    /// each update draws all of the noise values in bulk with
+    /// Rand::FillNormal from the calling thread's generator, so stepping N
+    /// processes is a single vectorizable loop. The parameters can be
+    /// shared by every channel, see Set(), or set per channel, see
+    /// SetChannel().
+    ///
+    /// Two update rules are available. Update() uses the same forward
+    /// Euler step as GaussMarkovProcess::Update. UpdateExact() samples the
+    /// exact transition of the Ornstein-Uhlenbeck process, which remains
+    /// stable for any time step.
+    class IGNITION_MATH_VISIBLE GaussMarkovProcessBank
+    {
+      /// \brief Default constructor. The bank has no channels.
+      public: GaussMarkovProcessBank();
+
+      /// \brief Create a bank of processes that share the provided
+      /// parameters.
+      /// \param[in] _size Number of processes.
+      /// \param[in] _start The start value of each process.
+      /// \param[in] _theta The theta (\f$\theta\f$) parameter. A value of
+      /// zero will be used if this parameter is negative.
+      /// \param[in] _mu The mu (\f$\mu\f$) parameter.
+      /// \param[in] _sigma The sigma (\f$\sigma\f$) parameter. A value of
+      /// zero will be used if this parameter is negative.
+      /// \sa Set(size_t, double, double, double, double)
+      public: GaussMarkovProcessBank(size_t _size, double _start,
+                  double _theta, double _mu, double _sigma);
+
+      /// \brief Destructor.
+      public: ~GaussMarkovProcessBank();
+
+      /// \brief Resize the bank and give every process the same parameters.
+      /// This will also reset every process to its start value.
+      /// \param[in] _size Number of processes.
+      /// \param[in] _start The start value of each process.
+      /// \param[in] _theta The theta (\f$\theta\f$) parameter. A value of
+      /// zero will be used if this parameter is negative.
+      /// \param[in] _mu The mu (\f$\mu\f$) parameter.
+      /// \param[in] _sigma The sigma (\f$\sigma\f$) parameter. A value of
+      /// zero will be used if this parameter is negative.
+      public: void Set(size_t _size, double _start, double _theta,
+                  double _mu, double _sigma);
+
+      /// \brief Set the parameters of a single process and reset it to its
+      /// start value.
+      /// \param[in] _index Index of the process.
+      /// \param[in] _start The start value of the process.
+      /// \param[in] _theta The theta (\f$\theta\f$) parameter. A value of
+      /// zero will be used if this parameter is negative.
+      /// \param[in] _mu The mu (\f$\mu\f$) parameter.
+      /// \param[in] _sigma The sigma (\f$\sigma\f$) parameter. A value of
+      /// zero will be used if this parameter is negative.
+      /// \return False if _index is out of range.
+      public: bool SetChannel(size_t _index, double _start, double _theta,
+                  double _mu, double _sigma);
+
+      /// \brief Get the number of processes.
+      /// \return Number of processes.
+      public: size_t Size() const;
+
+      /// \brief Get the current value of every process.
+      /// \return Values of the processes, indexed by channel.
+      public: const std::vector<double> &Values() const;
+
+      /// \brief Get the start value of every process.
+      /// \return Start values, indexed by channel.
+      public: const std::vector<double> &Start() const;
+
+      /// \brief Get the theta (\f$\theta\f$) value of every process.
+      /// \return Theta values, indexed by channel.
+      public: const std::vector<double> &Theta() const;
+
+      /// \brief Get the mu (\f$\mu\f$) value of every process.
+      /// \return Mu values, indexed by channel.
+      public: const std::vector<double> &Mu() const;
+
+      /// \brief Get the sigma (\f$\sigma\f$) value of every process.
+      /// \return Sigma values, indexed by channel.
+      public: const std::vector<double> &Sigma() const;
+
+      /// \brief Reset every process to its start value.
+      public: void Reset();
+
+      /// \brief Update every process with a forward Euler step:
+      ///
+      /// \f$x_{t+1} += \theta * (\mu - x_t) * dt + \sigma * dW_t\f$
+      ///
+      /// This matches GaussMarkovProcess::Update(double). It becomes
+      /// unstable when \f$\theta * dt > 2\f$.
+      /// \param[in] _dt Length of the timestep in seconds.
+      /// \return The new values of the processes.
+      /// \sa GaussMarkovProcess::Update(double)
+      public: const std::vector<double> &Update(double _dt);
+
+      /// \brief Update every process with a forward Euler step.
+      /// \param[in] _dt Length of the timestep.
+      /// \return The new values of the processes.
+      /// \sa Update(double)
+      public: const std::vector<double> &Update(const clock::duration &_dt);
+
+      /// \brief Update every process by sampling the exact transition of
+      /// the Ornstein-Uhlenbeck process
+      /// \f$dx_t = \theta (\mu - x_t) dt + \sigma dW_t\f$:
+      ///
+      /// \f$x_{t+1} = \mu + (x_t - \mu) e^{-\theta dt} +
+      /// \sigma \sqrt{\frac{1 - e^{-2 \theta dt}}{2 \theta}} N(0, 1)\f$
+      ///
+      /// Here sigma is the diffusion coefficient of the continuous-time
+      /// process, so the noise added in a step grows with the square root
+      /// of the step length, unlike in Update(double). With \f$\theta = 0\f$
+      /// the process is a Brownian motion. The decay and noise factors are
+      /// cached while the timestep and parameters are unchanged.
+      /// \param[in] _dt Length of the timestep in seconds.
+      /// \return The new values of the processes.
+      public: const std::vector<double> &UpdateExact(double _dt);
+
+      /// \brief Update every process by sampling the exact transition.
+      /// \param[in] _dt Length of the timestep.
+      /// \return The new values of the processes.
+      /// \sa UpdateExact(double)
+      public: const std::vector<double> &UpdateExact(
+                  const clock::duration &_dt);
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::unique_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+      /// \brief Private data pointer.
+      private: std::unique_ptr<GaussMarkovProcessBankPrivate> dataPtr;
+#ifdef _WIN32
+#pragma warning(pop)
+#endif
+    };
+    }
+  }
+}
+#endif
@@ -519,6 +519,8 @@ namespace ignition
     /// \brief Parse string into an integer.
     /// \param[in] _input The input string.
     /// \return An integer, or NAN_I if unable to parse the input.
+    /// \sa Parse() in Parse.hh, which does not throw or depend on the
+    /// locale.
     inline int parseInt(const std::string &_input)
     {
       // Return NAN_I if it is empty
@@ -548,6 +550,8 @@ namespace ignition
     /// \param [in] _input The string.
     /// \return A floating point number (can be NaN) or NAN_D if the
     /// _input could not be parsed.
+    /// \sa Parse() in Parse.hh, which does not throw or depend on the
+    /// locale.
     inline double parseFloat(const std::string &_input)
     {
       // Return NAN_D if it is empty
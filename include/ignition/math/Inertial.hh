@@ -17,9 +17,13 @@
 #ifndef IGNITION_MATH_INERTIAL_HH_
 #define IGNITION_MATH_INERTIAL_HH_
 
+#include <algorithm>
+#include <vector>
+
 #include <ignition/math/config.hh>
 #include "ignition/math/MassMatrix3.hh"
 #include "ignition/math/Pose3.hh"
+#include "ignition/math/Triangle3.hh"
 
 namespace ignition
 {
@@ -260,6 +264,356 @@ namespace ignition
         return Inertial<T>(*this) += _inertial;
       }
 
+      /// \brief Compute the composite inertial of a set of bodies in one
+      /// call. All of the inertials must be expressed in the same frame F.
+      ///
+      /// This gives the same result as summing the inertials with
+      /// operator+=, but it avoids the per-step conversions and is more
+      /// accurate for large sets. The first pass computes the total mass
+      /// and the center of mass. The second pass rotates each inertia
+      /// matrix into F and shifts it to the composite center of mass with
+      /// the parallel axis theorem, which avoids the cancellation of the
+      /// single-pass formula. Both passes are blocked reductions whose
+      /// partial sums are combined in a fixed order, so the result does
+      /// not depend on how the blocks are scheduled. The mass matrix is
+      /// validated once at the end.
+      /// \param[in] _inertials Array of inertials to combine.
+      /// \param[in] _size Number of inertials.
+      /// \param[out] _result Composite inertial. Its pose is the composite
+      /// center of mass in F, with the rotation _rot. It is set to a
+      /// default Inertial if the total mass is not positive.
+      /// \param[in] _rot Rotation of the inertial frame of the result
+      /// relative to F. The default matches operator+=.
+      /// \param[in] _tolerance Tolerance passed to MassMatrix3::IsValid.
+      /// \return True if the total mass is positive and the resulting
+      /// mass matrix is valid.
+      public: static bool Aggregate(const Inertial<T> *_inertials,
+                  const size_t _size, Inertial<T> &_result,
+                  const Quaternion<T> &_rot = Quaternion<T>::Identity,
+                  const T _tolerance = IGN_MASSMATRIX3_DEFAULT_TOLERANCE<T>)
+      {
+        const size_t blockSize = 256;
+
+        // First pass: total mass and center of mass
+        T mass = 0;
+        Vector3<T> moment = Vector3<T>::Zero;
+        for (size_t start = 0; start < _size; start += blockSize)
+        {
+          const size_t end = std::min(_size, start + blockSize);
+          T blockMass = 0;
+          T mx = 0, my = 0, mz = 0;
+          for (size_t i = start; i < end; ++i)
+          {
+            const T m = _inertials[i].MassMatrix().Mass();
+            const Vector3<T> &c = _inertials[i].Pose().Pos();
+            blockMass += m;
+            mx += m * c.X();
+            my += m * c.Y();
+            mz += m * c.Z();
+          }
+          mass += blockMass;
+          moment += Vector3<T>(mx, my, mz);
+        }
+
+        if (mass <= 0)
+        {
+          _result = Inertial<T>();
+          return false;
+        }
+        const Vector3<T> com = moment / mass;
+
+        // Second pass: inertia about the center of mass, expressed in F.
+        // The symmetric matrix is accumulated as its six unique entries.
+        T sum[6] = {0, 0, 0, 0, 0, 0};
+        for (size_t start = 0; start < _size; start += blockSize)
+        {
+          const size_t end = std::min(_size, start + blockSize);
+          T xx = 0, yy = 0, zz = 0, xy = 0, xz = 0, yz = 0;
+          for (size_t i = start; i < end; ++i)
+          {
+            const MassMatrix3<T> &mm = _inertials[i].MassMatrix();
+            const Matrix3<T> r(_inertials[i].Pose().Rot());
+            const Matrix3<T> moi = mm.Moi();
+
+            // a = r * moi, then only the unique entries of a * r^T
+            T a[3][3];
+            for (int row = 0; row < 3; ++row)
+            {
+              for (int col = 0; col < 3; ++col)
+              {
+                a[row][col] = r(row, 0) * moi(0, col) +
+                  r(row, 1) * moi(1, col) + r(row, 2) * moi(2, col);
+              }
+            }
+            auto rotated = [&](int _row, int _col)
+            {
+              return a[_row][0] * r(_col, 0) + a[_row][1] * r(_col, 1) +
+                a[_row][2] * r(_col, 2);
+            };
+
+            // Parallel axis theorem
+            const T m = mm.Mass();
+            const Vector3<T> d = _inertials[i].Pose().Pos() - com;
+            xx += rotated(0, 0) + m * (d.Y() * d.Y() + d.Z() * d.Z());
+            yy += rotated(1, 1) + m * (d.Z() * d.Z() + d.X() * d.X());
+            zz += rotated(2, 2) + m * (d.X() * d.X() + d.Y() * d.Y());
+            xy += rotated(0, 1) - m * d.X() * d.Y();
+            xz += rotated(0, 2) - m * d.X() * d.Z();
+            yz += rotated(1, 2) - m * d.Y() * d.Z();
+          }
+          sum[0] += xx;
+          sum[1] += yy;
+          sum[2] += zz;
+          sum[3] += xy;
+          sum[4] += xz;
+          sum[5] += yz;
+        }
+
+        Matrix3<T> moi(
+            sum[0], sum[3], sum[4],
+            sum[3], sum[1], sum[5],
+            sum[4], sum[5], sum[2]);
+
+        // Express the inertia matrix in the requested orientation
+        if (_rot != Quaternion<T>::Identity)
+        {
+          const Matrix3<T> r(_rot);
+          moi = r.Transposed() * moi * r;
+        }
+
+        _result.massMatrix = MassMatrix3<T>(mass,
+            Vector3<T>(moi(0, 0), moi(1, 1), moi(2, 2)),
+            Vector3<T>(moi(0, 1), moi(0, 2), moi(1, 2)));
+        _result.pose = Pose3<T>(com, _rot);
+        return _result.massMatrix.IsValid(_tolerance);
+      }
+
+      /// \brief Compute the composite inertial of a set of bodies in one
+      /// call. All of the inertials must be expressed in the same frame.
+      /// \param[in] _inertials Inertials to combine.
+      /// \param[out] _result Composite inertial.
+      /// \param[in] _rot Rotation of the inertial frame of the result.
+      /// \param[in] _tolerance Tolerance passed to MassMatrix3::IsValid.
+      /// \return True if the total mass is positive and the resulting
+      /// mass matrix is valid.
+      /// \sa Aggregate(const Inertial<T>*, const size_t, Inertial<T>&,
+      /// const Quaternion<T>&, const T)
+      public: static bool Aggregate(const std::vector<Inertial<T>> &_inertials,
+                  Inertial<T> &_result,
+                  const Quaternion<T> &_rot = Quaternion<T>::Identity,
+                  const T _tolerance = IGN_MASSMATRIX3_DEFAULT_TOLERANCE<T>)
+      {
+        return Aggregate(_inertials.data(), _inertials.size(), _result, _rot,
+            _tolerance);
+      }
+
+      /// \brief Set the mass properties of a solid of uniform density
+      /// bounded by a closed triangle mesh, given as a triangle soup.
+      ///
+      /// Volume, center of mass and inertia are computed exactly from
+      /// surface integrals using the divergence theorem, following
+      /// Eberly, "Polyhedral Mass Properties (Revisited)". The triangles
+      /// must form a closed surface and be consistently wound. Either
+      /// winding is accepted: counter-clockwise when seen from outside
+      /// gives a positive signed volume, and clockwise gives a negative one,
+      /// which is flipped. The volume of the mesh is
+      /// MassMatrix().Mass() / _mat.Density().
+      ///
+      /// The triangles are summed in blocks whose partial sums are combined
+      /// in a fixed order, so the result is deterministic and the work can
+      /// be split by block. Vertices are taken relative to the first vertex
+      /// to limit cancellation for meshes far from the origin.
+      ///
+      /// The pose of this object is set to the center of mass in the mesh
+      /// frame, with no rotation.
+      /// \param[in] _mat Material of the solid.
+      /// \param[in] _triangles Array of triangles.
+      /// \param[in] _size Number of triangles.
+      /// \return True if the enclosed volume is not zero and the resulting
+      /// mass matrix is valid.
+      public: bool SetFromTriangles(const Material &_mat,
+                  const Triangle3<T> *_triangles, const size_t _size)
+      {
+        if (_size == 0)
+          return false;
+
+        const Vector3<T> origin = _triangles[0][0];
+        const size_t blockSize = 256;
+        T integrals[10] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+        for (size_t start = 0; start < _size; start += blockSize)
+        {
+          const size_t end = std::min(_size, start + blockSize);
+          T block[10] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+          for (size_t i = start; i < end; ++i)
+          {
+            const Triangle3<T> &tri = _triangles[i];
+            AddTriangleIntegrals(tri[0] - origin, tri[1] - origin,
+                tri[2] - origin, block);
+          }
+          for (int k = 0; k < 10; ++k)
+            integrals[k] += block[k];
+        }
+
+        return this->SetFromIntegrals(_mat, integrals, origin);
+      }
+
+      /// \brief Set the mass properties of a solid of uniform density
+      /// bounded by a closed indexed triangle mesh.
+      /// \param[in] _mat Material of the solid.
+      /// \param[in] _vertices Array of vertices.
+      /// \param[in] _vertexCount Number of vertices.
+      /// \param[in] _indices Array of vertex indices, three per triangle.
+      /// \param[in] _indexCount Number of indices, a multiple of three.
+      /// \return True if the mesh is well formed, the enclosed volume is not
+      /// zero and the resulting mass matrix is valid.
+      /// \sa SetFromTriangles
+      public: bool SetFromMesh(const Material &_mat,
+                  const Vector3<T> *_vertices, const size_t _vertexCount,
+                  const unsigned int *_indices, const size_t _indexCount)
+      {
+        if (_vertexCount == 0 || _indexCount == 0 || _indexCount % 3 != 0)
+          return false;
+
+        for (size_t i = 0; i < _indexCount; ++i)
+        {
+          if (_indices[i] >= _vertexCount)
+            return false;
+        }
+
+        const Vector3<T> origin = _vertices[_indices[0]];
+        const size_t triangleCount = _indexCount / 3;
+        const size_t blockSize = 256;
+        T integrals[10] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+        for (size_t start = 0; start < triangleCount; start += blockSize)
+        {
+          const size_t end = std::min(triangleCount, start + blockSize);
+          T block[10] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+          for (size_t i = start; i < end; ++i)
+          {
+            const unsigned int *idx = _indices + 3 * i;
+            AddTriangleIntegrals(_vertices[idx[0]] - origin,
+                _vertices[idx[1]] - origin, _vertices[idx[2]] - origin, block);
+          }
+          for (int k = 0; k < 10; ++k)
+            integrals[k] += block[k];
+        }
+
+        return this->SetFromIntegrals(_mat, integrals, origin);
+      }
+
+      /// \brief Set the mass properties of a solid of uniform density
+      /// bounded by a closed indexed triangle mesh.
+      /// \param[in] _mat Material of the solid.
+      /// \param[in] _vertices Vertices of the mesh.
+      /// \param[in] _indices Vertex indices, three per triangle.
+      /// \return True if the mesh is well formed, the enclosed volume is not
+      /// zero and the resulting mass matrix is valid.
+      /// \sa SetFromTriangles
+      public: bool SetFromMesh(const Material &_mat,
+                  const std::vector<Vector3<T>> &_vertices,
+                  const std::vector<unsigned int> &_indices)
+      {
+        return this->SetFromMesh(_mat, _vertices.data(), _vertices.size(),
+            _indices.data(), _indices.size());
+      }
+
+      /// \brief Add the unscaled volume integrals of the tetrahedron formed
+      /// by the origin and a triangle. The integrals are, in order, of
+      /// 1, x, y, z, x^2, y^2, z^2, xy, yz and zx.
+      /// \param[in] _p0 First vertex.
+      /// \param[in] _p1 Second vertex.
+      /// \param[in] _p2 Third vertex.
+      /// \param[in,out] _integrals Integrals to add to.
+      private: static void AddTriangleIntegrals(const Vector3<T> &_p0,
+                  const Vector3<T> &_p1, const Vector3<T> &_p2,
+                  T _integrals[10])
+      {
+        // Subexpressions of the polynomial integrals along one axis
+        auto subexpressions = [](const T _w0, const T _w1, const T _w2,
+            T &_f1, T &_f2, T &_f3, T &_g0, T &_g1, T &_g2)
+        {
+          const T temp0 = _w0 + _w1;
+          _f1 = temp0 + _w2;
+          const T temp1 = _w0 * _w0;
+          const T temp2 = temp1 + _w1 * temp0;
+          _f2 = temp2 + _w2 * _f1;
+          _f3 = _w0 * temp1 + _w1 * temp2 + _w2 * _f2;
+          _g0 = _f2 + _w0 * (_f1 + _w0);
+          _g1 = _f2 + _w1 * (_f1 + _w1);
+          _g2 = _f2 + _w2 * (_f1 + _w2);
+        };
+
+        const Vector3<T> d = (_p1 - _p0).Cross(_p2 - _p0);
+
+        T f1x, f2x, f3x, g0x, g1x, g2x;
+        T f1y, f2y, f3y, g0y, g1y, g2y;
+        T f1z, f2z, f3z, g0z, g1z, g2z;
+        subexpressions(_p0.X(), _p1.X(), _p2.X(), f1x, f2x, f3x,
+            g0x, g1x, g2x);
+        subexpressions(_p0.Y(), _p1.Y(), _p2.Y(), f1y, f2y, f3y,
+            g0y, g1y, g2y);
+        subexpressions(_p0.Z(), _p1.Z(), _p2.Z(), f1z, f2z, f3z,
+            g0z, g1z, g2z);
+
+        _integrals[0] += d.X() * f1x;
+        _integrals[1] += d.X() * f2x;
+        _integrals[2] += d.Y() * f2y;
+        _integrals[3] += d.Z() * f2z;
+        _integrals[4] += d.X() * f3x;
+        _integrals[5] += d.Y() * f3y;
+        _integrals[6] += d.Z() * f3z;
+        _integrals[7] += d.X() *
+          (_p0.Y() * g0x + _p1.Y() * g1x + _p2.Y() * g2x);
+        _integrals[8] += d.Y() *
+          (_p0.Z() * g0y + _p1.Z() * g1y + _p2.Z() * g2y);
+        _integrals[9] += d.Z() *
+          (_p0.X() * g0z + _p1.X() * g1z + _p2.X() * g2z);
+      }
+
+      /// \brief Set the mass properties from the volume integrals of a
+      /// closed mesh.
+      /// \param[in] _mat Material of the solid.
+      /// \param[in] _integrals Unscaled integrals from AddTriangleIntegrals.
+      /// \param[in] _origin Point the mesh vertices are relative to.
+      /// \return True if the volume is not zero and the resulting mass
+      /// matrix is valid.
+      private: bool SetFromIntegrals(const Material &_mat,
+                  const T _integrals[10], const Vector3<T> &_origin)
+      {
+        T intg[10];
+        const T scale[10] = {T(1) / 6, T(1) / 24, T(1) / 24, T(1) / 24,
+          T(1) / 60, T(1) / 60, T(1) / 60, T(1) / 120, T(1) / 120,
+          T(1) / 120};
+
+        // A clockwise winding gives a negative volume
+        const T sign = _integrals[0] < 0 ? T(-1) : T(1);
+        for (int k = 0; k < 10; ++k)
+          intg[k] = sign * _integrals[k] * scale[k];
+
+        const T volume = intg[0];
+        if (volume <= 0)
+          return false;
+
+        const Vector3<T> c(intg[1] / volume, intg[2] / volume,
+            intg[3] / volume);
+
+        // Second moments about the center of mass, per unit density
+        const T density = static_cast<T>(_mat.Density());
+        const Vector3<T> ixxyyzz(
+            intg[5] + intg[6] - volume * (c.Y() * c.Y() + c.Z() * c.Z()),
+            intg[4] + intg[6] - volume * (c.Z() * c.Z() + c.X() * c.X()),
+            intg[4] + intg[5] - volume * (c.X() * c.X() + c.Y() * c.Y()));
+        const Vector3<T> ixyxzyz(
+            -(intg[7] - volume * c.X() * c.Y()),
+            -(intg[9] - volume * c.Z() * c.X()),
+            -(intg[8] - volume * c.Y() * c.Z()));
+
+        this->massMatrix = MassMatrix3<T>(density * volume,
+            density * ixxyyzz, density * ixyxzyz);
+        this->pose = Pose3<T>(c + _origin, Quaternion<T>::Identity);
+        return this->massMatrix.IsValid();
+      }
+
       /// \brief Mass and inertia matrix of the object expressed in the
       /// center of mass reference frame.
       private: MassMatrix3<T> massMatrix;
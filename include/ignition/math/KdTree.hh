@@ -0,0 +1,578 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_MATH_KDTREE_HH_
+#define IGNITION_MATH_KDTREE_HH_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+#include <ignition/math/Vector3.hh>
+#include <ignition/math/config.hh>
+
+namespace ignition
+{
+  namespace math
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_MATH_VERSION_NAMESPACE {
+    //
+    /// \class KdTree KdTree.hh ignition/math/KdTree.hh
+    /// \brief A static k-d tree over 3D points for nearest neighbor and
+    /// radius queries.
+    ///
+    /// The tree is built once from a point set by splitting the widest
+    /// axis of each node at the median, so it is balanced. The nodes are
+    /// stored in a flat array with the left child of a node right after
+    /// it, and the points are copied in tree order so that a leaf reads
+    /// contiguous memory. Queries report the indices of the points in the
+    /// input.
+    ///
+    /// The template parameter is the precision the points are stored in.
+    /// KdTree<float> takes half the memory and bandwidth of
+    /// KdTree<double>, and its queries are exact for the points rounded
+    /// to float. Queries take double points and compute distances in
+    /// double in both cases.
+    ///
+    /// Queries are const and keep no state. The batch queries write only
+    /// to the outputs of their own points, so a large batch can be split
+    /// into ranges that are run on a thread pool.
+    ///
+    /// ## Example
+    ///
+    /// \code{.cpp}
+    /// ignition::math::KdTreed tree(cloud);
+    /// size_t index;
+    /// double distance;
+    /// if (tree.Nearest(point, index, distance))
+    ///   std::cout << "Closest point: " << cloud[index] << std::endl;
+    /// \endcode
+    template<typename T>
+    class KdTree
+    {
+      /// \brief Index reported for neighbors that were not found.
+      public: static constexpr size_t kNoPoint =
+                  std::numeric_limits<size_t>::max();
+
+      /// \brief Default constructor. The tree is empty.
+      public: KdTree() = default;
+
+      /// \brief Constructor that builds the tree.
+      /// \param[in] _points The points.
+      /// \param[in] _leafSize Largest number of points in a leaf.
+      /// \sa Build(const std::vector<Vector3<U>> &, const size_t)
+      public: template<typename U>
+              explicit KdTree(const std::vector<Vector3<U>> &_points,
+                  const size_t _leafSize = 8)
+      {
+        this->Build(_points, _leafSize);
+      }
+
+      /// \brief Build the tree, replacing its points. Building takes
+      /// O(n log n) time.
+      /// \param[in] _points The points. Points with a non-finite
+      /// coordinate are left out.
+      /// \param[in] _leafSize Largest number of points in a leaf. Values
+      /// below one are treated as one.
+      public: template<typename U>
+              void Build(const std::vector<Vector3<U>> &_points,
+                  const size_t _leafSize = 8)
+      {
+        this->nodes.clear();
+        this->points.clear();
+        this->indices.clear();
+
+        for (size_t i = 0; i < _points.size(); ++i)
+        {
+          const Vector3<U> &p = _points[i];
+          if (std::isfinite(p.X()) && std::isfinite(p.Y()) &&
+              std::isfinite(p.Z()))
+          {
+            this->points.push_back({{static_cast<T>(p.X()),
+                static_cast<T>(p.Y()), static_cast<T>(p.Z())}});
+            this->indices.push_back(i);
+          }
+        }
+        if (this->points.empty())
+          return;
+
+        const uint32_t leafSize = static_cast<uint32_t>(
+            std::max<size_t>(1, std::min<size_t>(_leafSize, 1u << 30)));
+
+        // A balanced tree has fewer than 2n / leafSize + 1 nodes
+        this->nodes.reserve(2 * this->points.size() / leafSize + 1);
+        this->nodes.emplace_back();
+
+        struct Task
+        {
+          uint32_t node;
+          uint32_t begin;
+          uint32_t end;
+        };
+        std::vector<Task> tasks = {{0, 0,
+          static_cast<uint32_t>(this->points.size())}};
+        std::vector<uint32_t> order(this->points.size());
+        for (uint32_t i = 0; i < order.size(); ++i)
+          order[i] = i;
+
+        while (!tasks.empty())
+        {
+          const Task task = tasks.back();
+          tasks.pop_back();
+
+          Node node;
+          for (int a = 0; a < 3; ++a)
+          {
+            node.lower[a] = std::numeric_limits<T>::max();
+            node.upper[a] = std::numeric_limits<T>::lowest();
+          }
+          for (uint32_t i = task.begin; i < task.end; ++i)
+          {
+            const Point &p = this->points[order[i]];
+            for (int a = 0; a < 3; ++a)
+            {
+              node.lower[a] = std::min(node.lower[a], p.v[a]);
+              node.upper[a] = std::max(node.upper[a], p.v[a]);
+            }
+          }
+          node.begin = task.begin;
+          node.end = task.end;
+          node.right = 0;
+
+          int axis = 0;
+          for (int a = 1; a < 3; ++a)
+          {
+            if (node.upper[a] - node.lower[a] >
+                node.upper[axis] - node.lower[axis])
+            {
+              axis = a;
+            }
+          }
+
+          // Split at the median of the widest axis, unless the points are
+          // few or all equal
+          if (task.end - task.begin > leafSize &&
+              node.upper[axis] > node.lower[axis])
+          {
+            const uint32_t mid = task.begin + (task.end - task.begin) / 2;
+            std::nth_element(order.begin() + task.begin,
+                order.begin() + mid, order.begin() + task.end,
+                [&](const uint32_t _a, const uint32_t _b)
+                {
+                  return this->points[_a].v[axis] < this->points[_b].v[axis];
+                });
+
+            const uint32_t left = static_cast<uint32_t>(this->nodes.size());
+            const uint32_t right = left + 1;
+            node.right = right;
+            this->nodes.emplace_back();
+            this->nodes.emplace_back();
+
+            // The left child must directly follow its parent, so children
+            // are moved into place after the whole tree is laid out
+            tasks.push_back({right, mid, task.end});
+            tasks.push_back({left, task.begin, mid});
+          }
+          this->nodes[task.node] = node;
+        }
+
+        this->Relayout();
+
+        // Copy the points in tree order
+        std::vector<Point> sortedPoints(order.size());
+        std::vector<size_t> sortedIndices(order.size());
+        for (size_t i = 0; i < order.size(); ++i)
+        {
+          sortedPoints[i] = this->points[order[i]];
+          sortedIndices[i] = this->indices[order[i]];
+        }
+        this->points.swap(sortedPoints);
+        this->indices.swap(sortedIndices);
+      }
+
+      /// \brief Get the number of points in the tree.
+      /// \return Number of points.
+      public: size_t Size() const
+      {
+        return this->points.size();
+      }
+
+      /// \brief Find the point nearest to a query point.
+      /// \param[in] _point Query point.
+      /// \param[out] _index Index of the nearest point. Only set if the
+      /// return value is true.
+      /// \param[out] _distance Distance to the nearest point. Only set if
+      /// the return value is true.
+      /// \param[in] _maxDistance Only consider points within this distance.
+      /// \param[in] _epsilon Allowed relative error. A positive value gives
+      /// a point at most (1 + _epsilon) times farther than the nearest
+      /// one, and skips more of the tree.
+      /// \return True if a point was found.
+      public: bool Nearest(const Vector3d &_point, size_t &_index,
+                  double &_distance,
+                  const double _maxDistance =
+                      std::numeric_limits<double>::infinity(),
+                  const double _epsilon = 0) const
+      {
+        Candidate best;
+        if (this->Search(_point, 1, _maxDistance, _epsilon, &best) == 0)
+          return false;
+        _index = best.index;
+        _distance = std::sqrt(best.distance2);
+        return true;
+      }
+
+      /// \brief Find the points nearest to a query point.
+      /// \param[in] _point Query point.
+      /// \param[in] _k Number of points to find.
+      /// \param[out] _result Indices of the _k nearest points, nearest
+      /// first, or of all points in range if there are fewer. Points at
+      /// equal distances are ordered by index. Existing content is
+      /// cleared.
+      /// \param[in] _maxDistance Only consider points within this distance.
+      /// \param[in] _epsilon Allowed relative error. A positive value gives
+      /// points that are each at most (1 + _epsilon) times farther than
+      /// the true neighbor of the same rank.
+      public: void Nearest(const Vector3d &_point, const size_t _k,
+                  std::vector<size_t> &_result,
+                  const double _maxDistance =
+                      std::numeric_limits<double>::infinity(),
+                  const double _epsilon = 0) const
+      {
+        _result.clear();
+        std::vector<Candidate> best(std::min(_k, this->Size()));
+        const size_t found = this->Search(_point, best.size(),
+            _maxDistance, _epsilon, best.data());
+        for (size_t i = 0; i < found; ++i)
+          _result.push_back(best[i].index);
+      }
+
+      /// \brief Find the nearest points of many query points. The results
+      /// are the same as those of
+      /// Nearest(const Vector3d &, const size_t, std::vector<size_t> &,
+      /// const double, const double) const on each point.
+      /// \param[in] _points Query points.
+      /// \param[in] _count Number of query points.
+      /// \param[in] _k Number of neighbors to find for each point.
+      /// \param[out] _indices Array of _count * _k indices, with the
+      /// neighbors of each query point nearest first. Neighbors that are
+      /// not found are set to kNoPoint.
+      /// \param[out] _distances Array of _count * _k distances, set to
+      /// infinity for neighbors that are not found. May be null.
+      /// \param[in] _maxDistance Only consider points within this distance.
+      /// \param[in] _epsilon Allowed relative error.
+      /// \return Total number of neighbors found.
+      public: size_t Nearest(const Vector3d *_points, const size_t _count,
+                  const size_t _k, size_t *_indices, double *_distances,
+                  const double _maxDistance =
+                      std::numeric_limits<double>::infinity(),
+                  const double _epsilon = 0) const
+      {
+        std::vector<Candidate> best(_k);
+        size_t total = 0;
+        for (size_t q = 0; q < _count; ++q)
+        {
+          const size_t found = this->Search(_points[q], _k, _maxDistance,
+              _epsilon, best.data());
+          for (size_t i = 0; i < _k; ++i)
+          {
+            _indices[q * _k + i] = i < found ? best[i].index : kNoPoint;
+            if (_distances)
+            {
+              _distances[q * _k + i] = i < found ?
+                std::sqrt(best[i].distance2) :
+                std::numeric_limits<double>::infinity();
+            }
+          }
+          total += found;
+        }
+        return total;
+      }
+
+      /// \brief Find the points within a distance of a query point.
+      /// \param[in] _point Query point.
+      /// \param[in] _radius Distance from the query point.
+      /// \param[out] _result Indices of the points at most _radius away,
+      /// in no particular order. Existing content is cleared.
+      public: void Radius(const Vector3d &_point, const double _radius,
+                  std::vector<size_t> &_result) const
+      {
+        _result.clear();
+        if (this->nodes.empty() || !(_radius >= 0))
+          return;
+
+        const double radius2 = _radius * _radius;
+        uint32_t stack[kStackSize];
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0)
+        {
+          const Node &node = this->nodes[stack[--top]];
+          if (BoxDistance2(node, _point) > radius2)
+            continue;
+
+          if (node.right == 0)
+          {
+            for (uint32_t i = node.begin; i < node.end; ++i)
+            {
+              if (this->Distance2(i, _point) <= radius2)
+                _result.push_back(this->indices[i]);
+            }
+            continue;
+          }
+
+          const uint32_t self = static_cast<uint32_t>(&node -
+              this->nodes.data());
+          stack[top++] = node.right;
+          stack[top++] = self + 1;
+        }
+      }
+
+      /// \brief Find the points within a distance of many query points.
+      /// \param[in] _points Query points.
+      /// \param[in] _count Number of query points.
+      /// \param[in] _radius Distance from the query points.
+      /// \param[out] _results Array of _count vectors, each set to the
+      /// indices of the points within _radius of its query point.
+      /// \return Total number of points found.
+      public: size_t Radius(const Vector3d *_points, const size_t _count,
+                  const double _radius,
+                  std::vector<size_t> *_results) const
+      {
+        size_t total = 0;
+        for (size_t q = 0; q < _count; ++q)
+        {
+          this->Radius(_points[q], _radius, _results[q]);
+          total += _results[q].size();
+        }
+        return total;
+      }
+
+      /// \brief A point at the stored precision.
+      private: struct Point
+      {
+        /// \brief Coordinates.
+        T v[3];
+      };
+
+      /// \brief A node of the tree.
+      private: struct Node
+      {
+        /// \brief Minimum corner of the bounding box of the points.
+        T lower[3];
+
+        /// \brief Maximum corner of the bounding box of the points.
+        T upper[3];
+
+        /// \brief First point of the node, in tree order.
+        uint32_t begin;
+
+        /// \brief One past the last point of the node.
+        uint32_t end;
+
+        /// \brief Index of the right child, or zero for a leaf. The left
+        /// child directly follows the node.
+        uint32_t right;
+      };
+
+      /// \brief A neighbor found by a search.
+      private: struct Candidate
+      {
+        /// \brief Squared distance.
+        double distance2;
+
+        /// \brief Index of the point in the input of Build.
+        size_t index;
+
+        /// \brief Order by distance, then by index.
+        /// \param[in] _c Candidate to compare with.
+        /// \return True if this candidate comes first.
+        public: bool operator<(const Candidate &_c) const
+        {
+          return this->distance2 < _c.distance2 ||
+            (!(_c.distance2 < this->distance2) && this->index < _c.index);
+        }
+      };
+
+      /// \brief Depth of the traversal stacks. A balanced tree over fewer
+      /// than 2^32 points is at most 32 levels deep, and a search keeps at
+      /// most one entry per level plus the current path.
+      private: static constexpr int kStackSize = 72;
+
+      /// \brief Reorder the nodes depth first, so that the left child of
+      /// every node directly follows it.
+      private: void Relayout()
+      {
+        std::vector<Node> sorted;
+        sorted.reserve(this->nodes.size());
+        std::vector<uint32_t> newIndex(this->nodes.size());
+        std::vector<uint32_t> stack = {0};
+        while (!stack.empty())
+        {
+          const uint32_t old = stack.back();
+          stack.pop_back();
+          newIndex[old] = static_cast<uint32_t>(sorted.size());
+          sorted.push_back(this->nodes[old]);
+          const Node &node = this->nodes[old];
+          if (node.right != 0)
+          {
+            // Children were created as (left, right = left + 1)
+            stack.push_back(node.right);
+            stack.push_back(node.right - 1);
+          }
+        }
+        for (Node &node : sorted)
+        {
+          if (node.right != 0)
+            node.right = newIndex[node.right];
+        }
+        this->nodes.swap(sorted);
+      }
+
+      /// \brief Search for the nearest points.
+      /// \param[in] _point Query point.
+      /// \param[in] _k Number of points to find.
+      /// \param[in] _maxDistance Only consider points within this distance.
+      /// \param[in] _epsilon Allowed relative error.
+      /// \param[out] _best Array of at least _k candidates, set to the
+      /// neighbors found, nearest first.
+      /// \return Number of neighbors found.
+      private: size_t Search(const Vector3d &_point, const size_t _k,
+                   const double _maxDistance, const double _epsilon,
+                   Candidate *_best) const
+      {
+        if (this->nodes.empty() || _k == 0 || !(_maxDistance >= 0))
+          return 0;
+
+        // A node is skipped if it is farther than the k-th candidate
+        // divided by (1 + epsilon)
+        const double scale = (1 + std::max(0.0, _epsilon)) *
+          (1 + std::max(0.0, _epsilon));
+        const double maxDistance2 = _maxDistance * _maxDistance;
+
+        // _best is kept as a max heap while searching
+        size_t found = 0;
+        auto limit = [&]()
+        {
+          return found < _k ? maxDistance2 : _best[0].distance2;
+        };
+
+        std::pair<uint32_t, double> stack[kStackSize];
+        int top = 0;
+        stack[top++] = {0, BoxDistance2(this->nodes[0], _point)};
+        while (top > 0)
+        {
+          const std::pair<uint32_t, double> entry = stack[--top];
+          if (entry.second * scale > limit())
+            continue;
+
+          // Descend into the nearer child down to a leaf and keep the
+          // farther ones for later
+          uint32_t index = entry.first;
+          bool pruned = false;
+          while (!pruned && this->nodes[index].right != 0)
+          {
+            const uint32_t left = index + 1;
+            const uint32_t right = this->nodes[index].right;
+            const double dl = BoxDistance2(this->nodes[left], _point);
+            const double dr = BoxDistance2(this->nodes[right], _point);
+            const bool leftFirst = dl <= dr;
+            if (std::max(dl, dr) * scale <= limit())
+              stack[top++] = {leftFirst ? right : left, std::max(dl, dr)};
+            pruned = std::min(dl, dr) * scale > limit();
+            index = leftFirst ? left : right;
+          }
+          if (pruned)
+            continue;
+
+          const Node &leaf = this->nodes[index];
+          for (uint32_t i = leaf.begin; i < leaf.end; ++i)
+          {
+            const Candidate candidate = {this->Distance2(i, _point),
+              this->indices[i]};
+            if (candidate.distance2 > maxDistance2)
+              continue;
+            if (found < _k)
+            {
+              _best[found++] = candidate;
+              std::push_heap(_best, _best + found);
+            }
+            else if (candidate < _best[0])
+            {
+              std::pop_heap(_best, _best + found);
+              _best[found - 1] = candidate;
+              std::push_heap(_best, _best + found);
+            }
+          }
+        }
+
+        std::sort_heap(_best, _best + found);
+        return found;
+      }
+
+      /// \brief Get the squared distance from a query point to the box of
+      /// a node.
+      /// \param[in] _node The node.
+      /// \param[in] _p Query point.
+      /// \return Squared distance, zero if the point is inside.
+      private: static double BoxDistance2(const Node &_node,
+                   const Vector3d &_p)
+      {
+        double d2 = 0;
+        for (int a = 0; a < 3; ++a)
+        {
+          const double below = static_cast<double>(_node.lower[a]) - _p[a];
+          const double above = _p[a] - static_cast<double>(_node.upper[a]);
+          const double d = std::max(0.0, std::max(below, above));
+          d2 += d * d;
+        }
+        return d2;
+      }
+
+      /// \brief Get the squared distance from a stored point to a query
+      /// point.
+      /// \param[in] _slot Position of the stored point, in tree order.
+      /// \param[in] _p Query point.
+      /// \return Squared distance.
+      private: double Distance2(const uint32_t _slot, const Vector3d &_p) const
+      {
+        const Point &q = this->points[_slot];
+        const double dx = static_cast<double>(q.v[0]) - _p.X();
+        const double dy = static_cast<double>(q.v[1]) - _p.Y();
+        const double dz = static_cast<double>(q.v[2]) - _p.Z();
+        return dx * dx + dy * dy + dz * dz;
+      }
+
+      /// \brief Nodes, depth first.
+      private: std::vector<Node> nodes;
+
+      /// \brief Points, in tree order.
+      private: std::vector<Point> points;
+
+      /// \brief Input index of the points, in tree order.
+      private: std::vector<size_t> indices;
+    };
+
+    typedef KdTree<double> KdTreed;
+    typedef KdTree<float> KdTreef;
+    }
+  }
+}
+#endif
@@ -831,6 +831,54 @@ namespace ignition
         return Quaternion<T>(-phi1, -phi2, -phi3).Inverse();
       }
 
+      /// \brief Compute the principal moments and principal axes offsets
+      /// of many mass matrices at once, using Matrix3::SymmetricEigen.
+      ///
+      /// When offsets are requested this is much faster than calling
+      /// PrincipalMoments and PrincipalAxesOffset on each mass matrix.
+      /// Moments alone take longer to compute than with PrincipalMoments,
+      /// but stay accurate near repeated moments. The moments are always
+      /// sorted from smallest to largest, as with a negative tolerance in
+      /// PrincipalMoments. With R the rotation matrix of an offset and L
+      /// the diagonal matrix of the moments, the moment of inertia matrix
+      /// is MOI = R * L * R^T, as for PrincipalAxesOffset. When moments
+      /// are repeated the principal axes are not unique, so the offsets may
+      /// differ from the ones returned by PrincipalAxesOffset.
+      /// \param[in] _massMatrices Array of mass matrices.
+      /// \param[in] _size Number of mass matrices.
+      /// \param[out] _moments Array of _size principal moments.
+      /// \param[out] _offsets Array of _size principal axes offsets, or
+      /// nullptr if they are not needed.
+      public: static void PrincipalMoments(
+                  const MassMatrix3<T> *_massMatrices, const size_t _size,
+                  Vector3<T> *_moments, Quaternion<T> *_offsets = nullptr)
+      {
+        const size_t blockSize = 64;
+        Matrix3<T> moi[blockSize];
+        Matrix3<T> axes[blockSize];
+        for (size_t start = 0; start < _size; start += blockSize)
+        {
+          const size_t count = std::min(blockSize, _size - start);
+          for (size_t i = 0; i < count; ++i)
+          {
+            const MassMatrix3<T> &m = _massMatrices[start + i];
+            moi[i].Set(
+                m.Ixxyyzz[0], m.Ixyxzyz[0], m.Ixyxzyz[1],
+                m.Ixyxzyz[0], m.Ixxyyzz[1], m.Ixyxzyz[2],
+                m.Ixyxzyz[1], m.Ixyxzyz[2], m.Ixxyyzz[2]);
+          }
+
+          Matrix3<T>::SymmetricEigen(moi, count, _moments + start,
+              _offsets ? axes : nullptr);
+
+          if (_offsets)
+          {
+            for (size_t i = 0; i < count; ++i)
+              _offsets[start + i].SetFromMatrix(axes[i]);
+          }
+        }
+      }
+
       /// \brief Get dimensions and rotation offset of uniform box
       /// with equivalent mass and moment of inertia.
       /// To compute this, the Matrix3 is diagonalized.
@@ -18,7 +18,9 @@
 #define IGNITION_MATH_MATRIX3_HH_
 
 #include <algorithm>
+#include <cmath>
 #include <cstring>
+#include <limits>
 #include <utility>
 #include <ignition/math/Helpers.hh>
 #include <ignition/math/Vector3.hh>
@@ -602,6 +604,180 @@ namespace ignition
           this->data[0][2], this->data[1][2], this->data[2][2]);
       }
 
+      /// \brief Compute the eigenvalues and eigenvectors of many symmetric
+      /// matrices at once, such as inertia or covariance matrices. Only the
+      /// upper triangle of each matrix is read.
+      ///
+      /// The matrices are diagonalized with the cyclic Jacobi method,
+      /// several at a time in a structure-of-arrays layout with branch-free
+      /// rotations, which compilers can vectorize when square roots do not
+      /// need to set errno (-fno-math-errno). Sweeps stop when the
+      /// off-diagonal entries of every matrix in a group are negligible
+      /// relative to its norm, which usually takes four sweeps, so the
+      /// results are accurate to a few machine epsilons even when
+      /// eigenvalues are repeated.
+      ///
+      /// The results have a consistent ordering: the eigenvalues are sorted
+      /// from smallest to largest, and the matching eigenvectors are the
+      /// columns of a rotation matrix R, so that M = R * diag(L) * R^T. The
+      /// first two columns are oriented so that their component of largest
+      /// magnitude is positive, and the third is their cross product.
+      /// \param[in] _matrices Array of symmetric matrices.
+      /// \param[in] _size Number of matrices.
+      /// \param[out] _values Array of _size eigenvalue vectors.
+      /// \param[out] _vectors Array of _size eigenvector matrices, or
+      /// nullptr if the eigenvectors are not needed.
+      public: static void SymmetricEigen(const Matrix3<T> *_matrices,
+                  const size_t _size, Vector3<T> *_values,
+                  Matrix3<T> *_vectors = nullptr)
+      {
+        const size_t lanes = 8;
+        const int maxSweeps = 16;
+        const T eps = std::numeric_limits<T>::epsilon();
+
+        for (size_t start = 0; start < _size; start += lanes)
+        {
+          const size_t count = std::min(lanes, _size - start);
+
+          // Unique entries of each matrix, and its eigenvectors. Lanes
+          // past the end of the input repeat the last matrix.
+          T a00[lanes], a11[lanes], a22[lanes], a01[lanes], a02[lanes],
+            a12[lanes];
+          T v[3][3][lanes];
+          for (size_t l = 0; l < lanes; ++l)
+          {
+            const Matrix3<T> &m = _matrices[start + std::min(l, count - 1)];
+            a00[l] = m(0, 0);
+            a11[l] = m(1, 1);
+            a22[l] = m(2, 2);
+            a01[l] = m(0, 1);
+            a02[l] = m(0, 2);
+            a12[l] = m(1, 2);
+            for (int r = 0; r < 3; ++r)
+            {
+              for (int c = 0; c < 3; ++c)
+                v[r][c][l] = r == c ? T(1) : T(0);
+            }
+          }
+
+          for (int sweep = 0; sweep < maxSweeps; ++sweep)
+          {
+            bool converged = true;
+            for (size_t l = 0; l < lanes; ++l)
+            {
+              const T off = a01[l] * a01[l] + a02[l] * a02[l] +
+                a12[l] * a12[l];
+              const T norm = a00[l] * a00[l] + a11[l] * a11[l] +
+                a22[l] * a22[l] + 2 * off;
+              converged &= off <= eps * eps * norm;
+            }
+            if (converged)
+              break;
+
+            for (size_t l = 0; l < lanes; ++l)
+            {
+              JacobiRotate(a00[l], a11[l], a01[l], a02[l], a12[l],
+                  v[0][0][l], v[0][1][l], v[1][0][l], v[1][1][l],
+                  v[2][0][l], v[2][1][l]);
+              JacobiRotate(a00[l], a22[l], a02[l], a01[l], a12[l],
+                  v[0][0][l], v[0][2][l], v[1][0][l], v[1][2][l],
+                  v[2][0][l], v[2][2][l]);
+              JacobiRotate(a11[l], a22[l], a12[l], a01[l], a02[l],
+                  v[0][1][l], v[0][2][l], v[1][1][l], v[1][2][l],
+                  v[2][1][l], v[2][2][l]);
+            }
+          }
+
+          for (size_t l = 0; l < count; ++l)
+          {
+            T values[3] = {a00[l], a11[l], a22[l]};
+            int order[3] = {0, 1, 2};
+            if (values[order[1]] < values[order[0]])
+              std::swap(order[0], order[1]);
+            if (values[order[2]] < values[order[1]])
+              std::swap(order[1], order[2]);
+            if (values[order[1]] < values[order[0]])
+              std::swap(order[0], order[1]);
+
+            _values[start + l].Set(values[order[0]], values[order[1]],
+                values[order[2]]);
+            if (!_vectors)
+              continue;
+
+            Vector3<T> cols[2];
+            for (int c = 0; c < 2; ++c)
+            {
+              cols[c].Set(v[0][order[c]][l], v[1][order[c]][l],
+                  v[2][order[c]][l]);
+              const Vector3<T> &col = cols[c];
+              T largest = col.X();
+              if (std::abs(col.Y()) > std::abs(largest))
+                largest = col.Y();
+              if (std::abs(col.Z()) > std::abs(largest))
+                largest = col.Z();
+              if (largest < 0)
+                cols[c] = -col;
+            }
+            const Vector3<T> third = cols[0].Cross(cols[1]);
+            _vectors[start + l].Set(
+                cols[0].X(), cols[1].X(), third.X(),
+                cols[0].Y(), cols[1].Y(), third.Y(),
+                cols[0].Z(), cols[1].Z(), third.Z());
+          }
+        }
+      }
+
+      /// \brief Apply a Jacobi rotation in the (p, q) plane of a symmetric
+      /// matrix that zeroes its (p, q) entry, and accumulate the rotation
+      /// in the eigenvector matrix.
+      /// \param[in,out] _app Entry (p, p).
+      /// \param[in,out] _aqq Entry (q, q).
+      /// \param[in,out] _apq Entry (p, q).
+      /// \param[in,out] _arp Entry (r, p), r being the third index.
+      /// \param[in,out] _arq Entry (r, q).
+      /// \param[in,out] _v0p Eigenvector matrix entry (0, p).
+      /// \param[in,out] _v0q Eigenvector matrix entry (0, q).
+      /// \param[in,out] _v1p Eigenvector matrix entry (1, p).
+      /// \param[in,out] _v1q Eigenvector matrix entry (1, q).
+      /// \param[in,out] _v2p Eigenvector matrix entry (2, p).
+      /// \param[in,out] _v2q Eigenvector matrix entry (2, q).
+      private: static void JacobiRotate(T &_app, T &_aqq, T &_apq,
+                   T &_arp, T &_arq, T &_v0p, T &_v0q, T &_v1p, T &_v1q,
+                   T &_v2p, T &_v2q)
+      {
+        // Tangent of the rotation angle, the smaller root of
+        // t^2 + 2 theta t - 1 = 0 with theta = (aqq - app) / (2 apq), see
+        // Numerical Recipes, section 11.1. It is written without dividing
+        // by _apq, and the denominator is only zero when _apq is zero, in
+        // which case no rotation is needed.
+        const T diff = _aqq - _app;
+        const T denom = std::abs(diff) +
+          std::sqrt(diff * diff + 4 * _apq * _apq);
+        const bool skip = !(denom > T(0));
+        const T t = std::copysign(T(2), diff) * _apq /
+          (skip ? T(1) : denom);
+        const T c = 1 / std::sqrt(t * t + 1);
+        const T s = t * c;
+
+        _app -= t * _apq;
+        _aqq += t * _apq;
+        _apq = 0;
+
+        const T arp = _arp;
+        _arp = c * arp - s * _arq;
+        _arq = s * arp + c * _arq;
+
+        const T v0p = _v0p;
+        _v0p = c * v0p - s * _v0q;
+        _v0q = s * v0p + c * _v0q;
+        const T v1p = _v1p;
+        _v1p = c * v1p - s * _v1q;
+        _v1q = s * v1p + c * _v1q;
+        const T v2p = _v2p;
+        _v2p = c * v2p - s * _v2q;
+        _v2q = s * v2p + c * _v2q;
+      }
+
       /// \brief Stream insertion operator. This operator outputs all
       /// 9 scalar values in the matrix separated by a single space.
       /// \param[in, out] _out Output stream.
@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_MATH_OCCUPANCYMAP_HH_
+#define IGNITION_MATH_OCCUPANCYMAP_HH_
+
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <vector>
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Export.hh>
+#include <ignition/math/Frustum.hh>
+#include <ignition/math/Vector3.hh>
+#include <ignition/math/config.hh>
+
+namespace ignition
+{
+  namespace math
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_MATH_VERSION_NAMESPACE {
+    //
+    // Forward declarations.
+    class OccupancyMapPrivate;
+
+    /// \class OccupancyMap OccupancyMap.hh ignition/math/OccupancyMap.hh
+    /// \brief A probabilistic 3D occupancy map stored in a sparse octree.
+    ///
+    /// The map covers a cube of 65536 voxels per side centered on the
+    /// origin, so a resolution of 0.1 m covers 6.5 km. Each voxel is
+    /// addressed by the Morton code of its integer coordinates, whose
+    /// groups of three bits give the child to descend into at each of the
+    /// 16 levels of the tree.
+    ///
+    /// Every known voxel holds the log-odds of being occupied, updated by
+    /// sensor hits and misses and clamped to [0.12, 0.97] in probability.
+    /// Voxels that were never observed are unknown. Eight sibling voxels
+    /// that reach the same value are merged into their parent, so large
+    /// free or occupied regions take a single node. Nodes are allocated in
+    /// blocks of eight siblings from a pool, and the blocks of merged
+    /// nodes are reused.
+    ///
+    /// ## Example
+    ///
+    /// \code{.cpp}
+    /// ignition::math::OccupancyMap map(0.1);
+    /// map.InsertScan(sensorPosition, scanPoints);
+    /// if (map.Occupied(ignition::math::Vector3d(1, 2, 0.5)))
+    ///   std::cout << "Blocked" << std::endl;
+    /// \endcode
+    class IGNITION_MATH_VISIBLE OccupancyMap
+    {
+      /// \brief A leaf of the tree, which is a voxel or a group of merged
+      /// voxels.
+      public: struct Leaf
+      {
+        /// \brief Center of the leaf.
+        public: Vector3d center;
+
+        /// \brief Length of the sides of the leaf.
+        public: double size = 0;
+
+        /// \brief Probability that the leaf is occupied.
+        public: double probability = 0;
+      };
+
+      /// \brief Constructor.
+      /// \param[in] _resolution Length of the sides of a voxel. Values
+      /// that are not positive and finite are replaced by 0.1.
+      public: explicit OccupancyMap(const double _resolution = 0.1);
+
+      /// \brief Copy constructor.
+      /// \param[in] _map Map to copy.
+      public: OccupancyMap(const OccupancyMap &_map);
+
+      /// \brief Destructor.
+      public: ~OccupancyMap();
+
+      /// \brief Assignment operator.
+      /// \param[in] _map Map to copy.
+      /// \return Reference to this map.
+      public: OccupancyMap &operator=(const OccupancyMap &_map);
+
+      /// \brief Get the length of the sides of a voxel.
+      /// \return The resolution.
+      public: double Resolution() const;
+
+      /// \brief Get the volume covered by the map.
+      /// \return The bounds of the map.
+      public: AxisAlignedBox Bounds() const;
+
+      /// \brief Set the probabilities used to update a voxel.
+      /// \param[in] _hit Probability that a voxel is occupied given that a
+      /// measurement ends in it, in (0.5, 1). The default is 0.7.
+      /// \param[in] _miss Probability that a voxel is occupied given that a
+      /// measurement passes through it, in (0, 0.5). The default is 0.4.
+      /// \return False if a probability is out of range, in which case
+      /// nothing is changed.
+      public: bool SetSensorModel(const double _hit, const double _miss);
+
+      /// \brief Remove all voxels, making the whole map unknown.
+      public: void Clear();
+
+      /// \brief Update a voxel with a single measurement.
+      /// \param[in] _point A point in the voxel.
+      /// \param[in] _occupied True for a hit, false for a miss.
+      /// \return False if the point is outside the map.
+      public: bool Update(const Vector3d &_point, const bool _occupied);
+
+      /// \brief Insert a scan taken from a sensor. The voxels that the rays
+      /// from the sensor to the points pass through are updated as misses,
+      /// and the voxels of the points as hits. Each voxel is updated at
+      /// most once per scan, and hits take precedence over misses.
+      /// \param[in] _origin Position of the sensor.
+      /// \param[in] _points Measured points.
+      /// \param[in] _maxRange Rays longer than this are cut at this range
+      /// and only update free space.
+      /// \return Number of points inserted as hits.
+      public: size_t InsertScan(const Vector3d &_origin,
+                  const std::vector<Vector3d> &_points,
+                  const double _maxRange =
+                      std::numeric_limits<double>::infinity());
+
+      /// \brief Get the probability that a point is occupied.
+      /// \param[in] _point The point.
+      /// \param[out] _probability Probability of the leaf that holds the
+      /// point. Only set if the return value is true.
+      /// \return False if the point is unknown or outside the map.
+      public: bool Occupancy(const Vector3d &_point,
+                  double &_probability) const;
+
+      /// \brief Check whether a point is known to be occupied.
+      /// \param[in] _point The point.
+      /// \return True if the point is known and more likely occupied than
+      /// free.
+      public: bool Occupied(const Vector3d &_point) const;
+
+      /// \brief Get the known leaves that intersect a box.
+      /// \param[in] _box The box.
+      /// \param[out] _leaves The leaves, in Morton order. Existing content
+      /// is cleared.
+      /// \param[in] _occupiedOnly True to only get occupied leaves.
+      public: void Leaves(const AxisAlignedBox &_box,
+                  std::vector<Leaf> &_leaves,
+                  const bool _occupiedOnly = false) const;
+
+      /// \brief Get the known leaves that may be in a frustum, as tested by
+      /// Frustum::Contains(const AxisAlignedBox &) const.
+      /// \param[in] _frustum The frustum.
+      /// \param[out] _leaves The leaves, in Morton order. Existing content
+      /// is cleared.
+      /// \param[in] _occupiedOnly True to only get occupied leaves.
+      public: void Leaves(const Frustum &_frustum,
+                  std::vector<Leaf> &_leaves,
+                  const bool _occupiedOnly = false) const;
+
+      /// \brief Get the number of known leaves.
+      /// \return Number of leaves.
+      public: size_t LeafCount() const;
+
+      /// \brief Get the number of bytes used by the nodes, including the
+      /// pooled blocks that are free.
+      /// \return Memory used by the tree.
+      public: size_t MemoryUsage() const;
+
+      /// \brief Write the map in a compact binary format. Each inner node
+      /// takes two bytes and each known leaf four bytes.
+      /// \param[in] _out Stream to write to.
+      /// \return False if the stream failed.
+      public: bool Save(std::ostream &_out) const;
+
+      /// \brief Read a map written by Save().
+      /// \param[in] _in Stream to read from.
+      /// \return False if the stream does not hold a valid map, in which
+      /// case this map is unchanged.
+      public: bool Load(std::istream &_in);
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::unique_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+      /// \brief Private data pointer.
+      private: std::unique_ptr<OccupancyMapPrivate> dataPtr;
+#ifdef _WIN32
+#pragma warning(pop)
+#endif
+    };
+    }
+  }
+}
+#endif
@@ -17,10 +17,15 @@
 #ifndef IGNITION_MATH_ORIENTEDBOX_HH_
 #define IGNITION_MATH_ORIENTEDBOX_HH_
 
+#include <cmath>
+#include <cstddef>
 #include <iostream>
+#include <limits>
+#include <ignition/math/AxisAlignedBox.hh>
 #include <ignition/math/Helpers.hh>
 #include <ignition/math/MassMatrix3.hh>
 #include <ignition/math/Material.hh>
+#include <ignition/math/Matrix3.hh>
 #include <ignition/math/Matrix4.hh>
 #include <ignition/math/Pose3.hh>
 #include <ignition/math/Vector3.hh>
@@ -199,6 +204,130 @@ namespace ignition
                p.Z() >= -this->size.Z()*0.5 && p.Z() <= this->size.Z()*0.5;
       }
 
+      /// \brief Check if this box overlaps another oriented box, using the
+      /// separating axis test. The face normals of both boxes are tested
+      /// first, since they separate most disjoint boxes, and then the nine
+      /// cross products of their edges. Touching boxes overlap.
+      /// \param[in] _b Box to check.
+      /// \return True if the boxes overlap.
+      public: bool Intersects(const OrientedBox<T> &_b) const
+      {
+        const Matrix3<T> rotA(this->pose.Rot());
+        const Matrix3<T> rotB(_b.pose.Rot());
+        const Vector3<T> d = _b.pose.Pos() - this->pose.Pos();
+
+        // Axes and center of _b in the frame of this box
+        T r[3][3];
+        T t[3];
+        for (int i = 0; i < 3; ++i)
+        {
+          for (int j = 0; j < 3; ++j)
+          {
+            r[i][j] = rotA(0, i) * rotB(0, j) + rotA(1, i) * rotB(1, j) +
+              rotA(2, i) * rotB(2, j);
+          }
+          t[i] = rotA(0, i) * d.X() + rotA(1, i) * d.Y() + rotA(2, i) * d.Z();
+        }
+
+        const T ea[3] = {this->size.X() * T(0.5), this->size.Y() * T(0.5),
+          this->size.Z() * T(0.5)};
+        const T eb[3] = {_b.size.X() * T(0.5), _b.size.Y() * T(0.5),
+          _b.size.Z() * T(0.5)};
+        return Overlap(ea, eb, r, t);
+      }
+
+      /// \brief Check if this box overlaps an axis aligned box, using the
+      /// separating axis test.
+      /// \param[in] _box Box to check.
+      /// \return True if the boxes overlap. An empty axis aligned box
+      /// overlaps nothing.
+      public: bool Intersects(const AxisAlignedBox &_box) const
+      {
+        const Vector3d &lower = _box.Min();
+        const Vector3d &upper = _box.Max();
+        if (lower.X() > upper.X() || lower.Y() > upper.Y() ||
+            lower.Z() > upper.Z())
+        {
+          return false;
+        }
+
+        // The axis aligned box as an oriented box with no rotation, which
+        // keeps r equal to the rotation of this box
+        const Vector3d center = (lower + upper) * 0.5;
+        const Vector3d half = (upper - lower) * 0.5;
+        const Matrix3<T> rotA(this->pose.Rot());
+        const Vector3<T> d(static_cast<T>(center.X()) - this->pose.Pos().X(),
+            static_cast<T>(center.Y()) - this->pose.Pos().Y(),
+            static_cast<T>(center.Z()) - this->pose.Pos().Z());
+
+        T r[3][3];
+        T t[3];
+        for (int i = 0; i < 3; ++i)
+        {
+          for (int j = 0; j < 3; ++j)
+            r[i][j] = rotA(j, i);
+          t[i] = rotA(0, i) * d.X() + rotA(1, i) * d.Y() + rotA(2, i) * d.Z();
+        }
+
+        const T ea[3] = {this->size.X() * T(0.5), this->size.Y() * T(0.5),
+          this->size.Z() * T(0.5)};
+        const T eb[3] = {static_cast<T>(half.X()), static_cast<T>(half.Y()),
+          static_cast<T>(half.Z())};
+        return Overlap(ea, eb, r, t);
+      }
+
+      /// \brief Check this box against many oriented boxes stored as a
+      /// structure of arrays. This gives the same results as
+      /// Intersects(const OrientedBox<T> &) const on each box, but the
+      /// rotation of this box is computed once.
+      /// \param[in] _centers Arrays of the x, y and z coordinates of the
+      /// box centers.
+      /// \param[in] _halfSizes Arrays of the half sizes of the boxes along
+      /// their own x, y and z axes.
+      /// \param[in] _rotations Nine arrays with the entries of the rotation
+      /// matrices of the boxes, in row major order, so that
+      /// _rotations[3 * row + col] holds entry (row, col). The columns are
+      /// the axes of the boxes.
+      /// \param[in] _count Number of boxes.
+      /// \param[out] _results Array of _count flags, set to true for boxes
+      /// that overlap this box.
+      /// \return Number of boxes that overlap this box.
+      public: size_t Intersects(const T *const _centers[3],
+                  const T *const _halfSizes[3], const T *const _rotations[9],
+                  const size_t _count, bool *_results) const
+      {
+        const Matrix3<T> rotA(this->pose.Rot());
+        const T ea[3] = {this->size.X() * T(0.5), this->size.Y() * T(0.5),
+          this->size.Z() * T(0.5)};
+
+        size_t hits = 0;
+        for (size_t k = 0; k < _count; ++k)
+        {
+          const T d[3] = {_centers[0][k] - this->pose.Pos().X(),
+            _centers[1][k] - this->pose.Pos().Y(),
+            _centers[2][k] - this->pose.Pos().Z()};
+
+          T r[3][3];
+          T t[3];
+          for (int i = 0; i < 3; ++i)
+          {
+            for (int j = 0; j < 3; ++j)
+            {
+              r[i][j] = rotA(0, i) * _rotations[j][k] +
+                rotA(1, i) * _rotations[3 + j][k] +
+                rotA(2, i) * _rotations[6 + j][k];
+            }
+            t[i] = rotA(0, i) * d[0] + rotA(1, i) * d[1] + rotA(2, i) * d[2];
+          }
+
+          const T eb[3] = {_halfSizes[0][k], _halfSizes[1][k],
+            _halfSizes[2][k]};
+          _results[k] = Overlap(ea, eb, r, t);
+          hits += _results[k] ? 1 : 0;
+        }
+        return hits;
+      }
+
       /// \brief Get the material associated with this box.
       /// \return The material assigned to this box.
       public: const ignition::math::Material &Material() const
@@ -267,6 +396,69 @@ namespace ignition
         return _massMat.SetFromBox(this->material, this->size);
       }
 
+      /// \brief Separating axis test of two boxes, following Ericson,
+      /// "Real-Time Collision Detection", section 4.4.1.
+      /// \param[in] _ea Half sizes of the first box.
+      /// \param[in] _eb Half sizes of the second box.
+      /// \param[in] _r Rotation of the second box in the frame of the
+      /// first, so that column j holds the j-th axis of the second box.
+      /// \param[in] _t Center of the second box in the frame of the first.
+      /// \return True if no axis separates the boxes.
+      private: static bool Overlap(const T _ea[3], const T _eb[3],
+                   const T _r[3][3], const T _t[3])
+      {
+        // A small term keeps the cross product axes from giving false
+        // separations when edges are parallel and the cross product is
+        // close to zero
+        const T eps = 16 * std::numeric_limits<T>::epsilon();
+        T absR[3][3];
+        for (int i = 0; i < 3; ++i)
+        {
+          for (int j = 0; j < 3; ++j)
+            absR[i][j] = std::abs(_r[i][j]) + eps;
+        }
+
+        // Face normals of the first box
+        for (int i = 0; i < 3; ++i)
+        {
+          const T rb = _eb[0] * absR[i][0] + _eb[1] * absR[i][1] +
+            _eb[2] * absR[i][2];
+          if (std::abs(_t[i]) > _ea[i] + rb)
+            return false;
+        }
+
+        // Face normals of the second box
+        for (int j = 0; j < 3; ++j)
+        {
+          const T ra = _ea[0] * absR[0][j] + _ea[1] * absR[1][j] +
+            _ea[2] * absR[2][j];
+          const T dist = _t[0] * _r[0][j] + _t[1] * _r[1][j] +
+            _t[2] * _r[2][j];
+          if (std::abs(dist) > ra + _eb[j])
+            return false;
+        }
+
+        // Cross products of edge i of the first box and edge j of the
+        // second
+        for (int i = 0; i < 3; ++i)
+        {
+          const int i1 = (i + 1) % 3;
+          const int i2 = (i + 2) % 3;
+          for (int j = 0; j < 3; ++j)
+          {
+            const int j1 = (j + 1) % 3;
+            const int j2 = (j + 2) % 3;
+            const T ra = _ea[i1] * absR[i2][j] + _ea[i2] * absR[i1][j];
+            const T rb = _eb[j1] * absR[i][j2] + _eb[j2] * absR[i][j1];
+            const T dist = _t[i2] * _r[i1][j] - _t[i1] * _r[i2][j];
+            if (std::abs(dist) > ra + rb)
+              return false;
+          }
+        }
+
+        return true;
+      }
+
       /// \brief The size of the box in its local frame.
       private: Vector3<T> size;
 
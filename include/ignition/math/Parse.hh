@@ -0,0 +1,453 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_MATH_PARSE_HH_
+#define IGNITION_MATH_PARSE_HH_
+
+#include <charconv>
+#include <cstddef>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#ifndef __cpp_lib_to_chars
+#include <locale>
+#include <sstream>
+#include <string>
+#endif
+
+#include <ignition/math/Angle.hh>
+#include <ignition/math/Color.hh>
+#include <ignition/math/Matrix3.hh>
+#include <ignition/math/Matrix4.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Quaternion.hh>
+#include <ignition/math/Temperature.hh>
+#include <ignition/math/Vector2.hh>
+#include <ignition/math/Vector3.hh>
+#include <ignition/math/Vector4.hh>
+#include <ignition/math/config.hh>
+
+namespace ignition
+{
+  namespace math
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_MATH_VERSION_NAMESPACE {
+    //
+    /// \enum ParseError
+    /// \brief Reasons why text could not be parsed.
+    enum ParseError
+    {
+      /// \brief The text was parsed.
+      PARSE_OK = 0,
+
+      /// \brief A token is not a number of the expected type.
+      PARSE_INVALID_NUMBER = 1,
+
+      /// \brief A number does not fit in the expected type.
+      PARSE_OUT_OF_RANGE = 2,
+
+      /// \brief The text ended before all the values were read.
+      PARSE_MISSING_VALUE = 3,
+
+      /// \brief There is more than white space after the value.
+      PARSE_TRAILING_CHARACTERS = 4
+    };
+
+    /// \class ParseResult Parse.hh ignition/math/Parse.hh
+    /// \brief The outcome of parsing text.
+    class ParseResult
+    {
+      /// \brief Constructor.
+      /// \param[in] _error The error, or PARSE_OK.
+      /// \param[in] _position Offset in the text where parsing stopped.
+      public: constexpr ParseResult(const ParseError _error = PARSE_OK,
+                  const size_t _position = 0)
+              : error(_error), position(_position)
+      {
+      }
+
+      /// \brief Check whether the text was parsed.
+      /// \return True if there was no error.
+      public: constexpr explicit operator bool() const
+      {
+        return this->error == PARSE_OK;
+      }
+
+      /// \brief Get a description of the error.
+      /// \return A static string describing the error.
+      public: const char *Message() const
+      {
+        switch (this->error)
+        {
+          case PARSE_OK:
+            return "no error";
+          case PARSE_INVALID_NUMBER:
+            return "invalid number";
+          case PARSE_OUT_OF_RANGE:
+            return "number out of range";
+          case PARSE_MISSING_VALUE:
+            return "missing value";
+          case PARSE_TRAILING_CHARACTERS:
+            return "unexpected characters after value";
+          default:
+            return "unknown error";
+        }
+      }
+
+      /// \brief The error, or PARSE_OK.
+      public: ParseError error = PARSE_OK;
+
+      /// \brief Offset in the text of the token that caused the error, or
+      /// of the end of the value on success.
+      public: size_t position = 0;
+    };
+
+    namespace detail
+    {
+      /// \brief Check for the white space characters of the "C" locale.
+      /// \param[in] _c The character.
+      /// \return True if _c is white space.
+      constexpr bool IsSpace(const char _c)
+      {
+        return _c == ' ' || (_c >= '\t' && _c <= '\r');
+      }
+
+      /// \brief Advance a position past white space.
+      /// \param[in] _text The text.
+      /// \param[in,out] _pos The position.
+      inline void SkipSpace(std::string_view _text, size_t &_pos)
+      {
+        while (_pos < _text.size() && IsSpace(_text[_pos]))
+          ++_pos;
+      }
+
+      /// \brief Read a number. A leading '+' is allowed, and the number must
+      /// be followed by white space or the end of the text.
+      /// \param[in] _text The text.
+      /// \param[in,out] _pos Position to read from. On success it is moved
+      /// past the number, otherwise to the start of the token in error.
+      /// \param[out] _value The number, only set on success.
+      /// \return The error, or PARSE_OK.
+      template<typename T>
+      ParseError ReadNumber(std::string_view _text, size_t &_pos, T &_value)
+      {
+        static_assert(std::is_arithmetic<T>::value &&
+            !std::is_same<T, bool>::value, "T must be a number");
+
+        SkipSpace(_text, _pos);
+        if (_pos >= _text.size())
+          return PARSE_MISSING_VALUE;
+
+        const char *first = _text.data() + _pos;
+        const char *last = _text.data() + _text.size();
+        if (*first == '+' && last - first > 1 && first[1] != '-')
+          ++first;
+
+        T value;
+        std::from_chars_result result;
+#ifdef __cpp_lib_to_chars
+        result = std::from_chars(first, last, value);
+#else
+        if constexpr (std::is_floating_point<T>::value)
+        {
+          // Slow path for standard libraries without floating point
+          // from_chars.
+          std::istringstream stream(std::string(first, last));
+          stream.imbue(std::locale::classic());
+          stream >> value;
+          result.ec = stream.fail() ?
+            std::errc::invalid_argument : std::errc();
+          result.ptr = stream.fail() ? first :
+            first + (stream.eof() ? last - first :
+                static_cast<std::ptrdiff_t>(stream.tellg()));
+        }
+        else
+        {
+          result = std::from_chars(first, last, value);
+        }
+#endif
+        if (result.ec == std::errc::invalid_argument ||
+            (result.ptr != last && !IsSpace(*result.ptr)))
+        {
+          return PARSE_INVALID_NUMBER;
+        }
+        if (result.ec != std::errc())
+          return PARSE_OUT_OF_RANGE;
+
+        _value = value;
+        _pos = static_cast<size_t>(result.ptr - _text.data());
+        return PARSE_OK;
+      }
+
+      /// \brief Read a number of values of type T.
+      /// \param[in] _text The text.
+      /// \param[in,out] _pos Position to read from.
+      /// \param[out] _values The values.
+      /// \return The error, or PARSE_OK.
+      template<typename T, size_t N>
+      ParseError ReadNumbers(std::string_view _text, size_t &_pos,
+          T (&_values)[N])
+      {
+        for (T &value : _values)
+        {
+          const ParseError error = ReadNumber(_text, _pos, value);
+          if (error != PARSE_OK)
+            return error;
+        }
+        return PARSE_OK;
+      }
+
+      /// \brief Read a number.
+      template<typename T>
+      typename std::enable_if<std::is_arithmetic<T>::value, ParseError>::type
+      Read(std::string_view _text, size_t &_pos, T &_value)
+      {
+        return ReadNumber(_text, _pos, _value);
+      }
+
+      /// \brief Read an angle in radians.
+      inline ParseError Read(std::string_view _text, size_t &_pos,
+          Angle &_value)
+      {
+        double v;
+        const ParseError error = ReadNumber(_text, _pos, v);
+        if (error == PARSE_OK)
+          _value.SetRadian(v);
+        return error;
+      }
+
+      /// \brief Read a temperature in Kelvin.
+      inline ParseError Read(std::string_view _text, size_t &_pos,
+          Temperature &_value)
+      {
+        double v;
+        const ParseError error = ReadNumber(_text, _pos, v);
+        if (error == PARSE_OK)
+          _value.SetKelvin(v);
+        return error;
+      }
+
+      /// \brief Read a color as r g b with an optional alpha, which is 1
+      /// when the text ends after the blue value.
+      inline ParseError Read(std::string_view _text, size_t &_pos,
+          Color &_value)
+      {
+        float v[3];
+        const ParseError error = ReadNumbers(_text, _pos, v);
+        if (error != PARSE_OK)
+          return error;
+
+        float a = 1;
+        size_t end = _pos;
+        SkipSpace(_text, end);
+        if (end < _text.size())
+        {
+          const ParseError alphaError = ReadNumber(_text, _pos, a);
+          if (alphaError != PARSE_OK)
+            return alphaError;
+        }
+        _value.R() = v[0];
+        _value.G() = v[1];
+        _value.B() = v[2];
+        _value.A() = a;
+        return PARSE_OK;
+      }
+
+      /// \brief Read a 2D vector as x y.
+      template<typename T>
+      ParseError Read(std::string_view _text, size_t &_pos,
+          Vector2<T> &_value)
+      {
+        T v[2];
+        const ParseError error = ReadNumbers(_text, _pos, v);
+        if (error == PARSE_OK)
+          _value.Set(v[0], v[1]);
+        return error;
+      }
+
+      /// \brief Read a 3D vector as x y z.
+      template<typename T>
+      ParseError Read(std::string_view _text, size_t &_pos,
+          Vector3<T> &_value)
+      {
+        T v[3];
+        const ParseError error = ReadNumbers(_text, _pos, v);
+        if (error == PARSE_OK)
+          _value.Set(v[0], v[1], v[2]);
+        return error;
+      }
+
+      /// \brief Read a 4D vector as x y z w.
+      template<typename T>
+      ParseError Read(std::string_view _text, size_t &_pos,
+          Vector4<T> &_value)
+      {
+        T v[4];
+        const ParseError error = ReadNumbers(_text, _pos, v);
+        if (error == PARSE_OK)
+          _value.Set(v[0], v[1], v[2], v[3]);
+        return error;
+      }
+
+      /// \brief Read a quaternion as roll pitch yaw in radians.
+      template<typename T>
+      ParseError Read(std::string_view _text, size_t &_pos,
+          Quaternion<T> &_value)
+      {
+        // Angles are doubles, as in operator>>.
+        double v[3];
+        const ParseError error = ReadNumbers(_text, _pos, v);
+        if (error == PARSE_OK)
+          _value.SetFromEuler(Vector3<T>(v[0], v[1], v[2]));
+        return error;
+      }
+
+      /// \brief Read a pose as x y z roll pitch yaw.
+      template<typename T>
+      ParseError Read(std::string_view _text, size_t &_pos,
+          Pose3<T> &_value)
+      {
+        Vector3<T> pos;
+        Quaternion<T> rot;
+        ParseError error = Read(_text, _pos, pos);
+        if (error == PARSE_OK)
+          error = Read(_text, _pos, rot);
+        if (error == PARSE_OK)
+          _value.Set(pos, rot);
+        return error;
+      }
+
+      /// \brief Read a 3x3 matrix in row major order.
+      template<typename T>
+      ParseError Read(std::string_view _text, size_t &_pos,
+          Matrix3<T> &_value)
+      {
+        T v[9];
+        const ParseError error = ReadNumbers(_text, _pos, v);
+        if (error == PARSE_OK)
+        {
+          _value.Set(v[0], v[1], v[2],
+                     v[3], v[4], v[5],
+                     v[6], v[7], v[8]);
+        }
+        return error;
+      }
+
+      /// \brief Read a 4x4 matrix in row major order.
+      template<typename T>
+      ParseError Read(std::string_view _text, size_t &_pos,
+          Matrix4<T> &_value)
+      {
+        T v[16];
+        const ParseError error = ReadNumbers(_text, _pos, v);
+        if (error == PARSE_OK)
+        {
+          _value.Set(v[0], v[1], v[2], v[3],
+                     v[4], v[5], v[6], v[7],
+                     v[8], v[9], v[10], v[11],
+                     v[12], v[13], v[14], v[15]);
+        }
+        return error;
+      }
+    }
+
+    /// \brief Parse a value from text in the format written by its output
+    /// operator, which is also the format read by its input operator. The
+    /// whole text must hold the value, apart from surrounding white space.
+    ///
+    /// Unlike the stream operators, parsing never throws, does not
+    /// allocate and does not depend on the global locale. Numbers are
+    /// read with std::from_chars, so they are correctly rounded and the
+    /// text written by the output operators gives the same value as the
+    /// input operators. The values may be separated by any white space,
+    /// and "inf" and "nan" are accepted for floating point types. Numbers
+    /// whose magnitude is too large, or so small that they round to zero,
+    /// are out of range.
+    ///
+    /// Supported types are the arithmetic types, Angle, Color, Matrix3,
+    /// Matrix4, Pose3, Quaternion, Temperature, Vector2, Vector3 and
+    /// Vector4.
+    ///
+    /// ## Example
+    ///
+    /// \code{.cpp}
+    /// ignition::math::Pose3d pose;
+    /// auto result = ignition::math::Parse("1 2 3 0 0 1.57", pose);
+    /// if (!result)
+    ///   std::cerr << result.Message() << std::endl;
+    /// \endcode
+    /// \param[in] _text The text.
+    /// \param[out] _value The value, which is unchanged on error.
+    /// \return The outcome. On error, its position is the offset of the
+    /// token in error.
+    template<typename T>
+    ParseResult Parse(std::string_view _text, T &_value)
+    {
+      size_t pos = 0;
+      T value = _value;
+      ParseError error = detail::Read(_text, pos, value);
+      if (error == PARSE_OK)
+      {
+        detail::SkipSpace(_text, pos);
+        if (pos < _text.size())
+          error = PARSE_TRAILING_CHARACTERS;
+        else
+          _value = value;
+      }
+      return ParseResult(error, pos);
+    }
+
+    /// \brief Parse the next value from text holding several values, as
+    /// in a file with one pose per line. See Parse(std::string_view, T&)
+    /// for the format. As with the input operator, a Color takes the next
+    /// number as its alpha value whenever the text goes on, so colors in a
+    /// sequence need all four values.
+    /// \param[in] _text The text.
+    /// \param[in,out] _pos Offset in the text to read from. On success it
+    /// is moved past the value, otherwise it is unchanged.
+    /// \param[out] _value The value, which is unchanged on error.
+    /// \return The outcome. On error, its position is the offset of the
+    /// token in error.
+    template<typename T>
+    ParseResult ParseNext(std::string_view _text, size_t &_pos, T &_value)
+    {
+      // The readers only set the value on success.
+      size_t pos = _pos;
+      const ParseError error = detail::Read(_text, pos, _value);
+      if (error == PARSE_OK)
+        _pos = pos;
+      return ParseResult(error, pos);
+    }
+
+    /// \brief Parse a temperature in Kelvin. This overload avoids copying
+    /// the temperature.
+    /// \param[in] _text The text.
+    /// \param[out] _value The temperature, which is unchanged on error.
+    /// \return The outcome.
+    inline ParseResult Parse(std::string_view _text, Temperature &_value)
+    {
+      double kelvin = 0;
+      const ParseResult result = Parse(_text, kelvin);
+      if (result)
+        _value.SetKelvin(kelvin);
+      return result;
+    }
+    }
+  }
+}
+#endif
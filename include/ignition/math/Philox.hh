@@ -0,0 +1,299 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_MATH_PHILOX_HH_
+#define IGNITION_MATH_PHILOX_HH_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ignition/math/config.hh>
+
+namespace ignition
+{
+  namespace math
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_MATH_VERSION_NAMESPACE {
+    //
+    /// \class Philox4x32 Philox.hh ignition/math/Philox.hh
+    /// \brief Counter-based random number generator implementing
+    /// Philox4x32-10 from Salmon et al., "Parallel Random Numbers: As Easy
+    /// as 1, 2, 3" (SC 2011).
+    ///
+    /// The output is a pure function of a 64-bit seed, a 64-bit stream id
+    /// and a 64-bit block counter, with four 32-bit values per block.
+    /// Streams are statistically independent, and any position in a stream
+    /// can be reached in constant time, so work can be split across any
+    /// number of threads and still produce bit-identical results as long
+    /// as each work item uses its own stream id.
+    ///
+    /// The class satisfies the C++ UniformRandomBitGenerator requirements,
+    /// so it can be used with the standard distributions.
+    ///
+    /// ## Example
+    ///
+    /// \code{.cpp}
+    /// // One independent stream per sensor, regardless of which
+    /// // thread updates it.
+    /// ignition::math::Philox4x32 gen(seed, sensorId);
+    /// std::normal_distribution<double> noise(0.0, 0.01);
+    /// double n = noise(gen);
+    /// \endcode
+    class Philox4x32
+    {
+      /// \brief Type of the generated values.
+      public: using result_type = uint32_t;
+
+      /// \brief A block of four 32-bit values.
+      public: using Block = std::array<uint32_t, 4>;
+
+      /// \brief Constructor.
+      /// \param[in] _seed Seed, used as the 64-bit key.
+      /// \param[in] _stream Stream id.
+      /// \param[in] _counter Index of the first block to generate.
+      public: explicit Philox4x32(const uint64_t _seed = 0,
+                                  const uint64_t _stream = 0,
+                                  const uint64_t _counter = 0)
+        : seed(_seed), stream(_stream), counter(_counter)
+      {
+      }
+
+      /// \brief Smallest value returned by operator().
+      /// \return 0.
+      public: static constexpr result_type min()
+      {
+        return 0;
+      }
+
+      /// \brief Largest value returned by operator().
+      /// \return 2^32 - 1.
+      public: static constexpr result_type max()
+      {
+        return std::numeric_limits<result_type>::max();
+      }
+
+      /// \brief Get the next 32-bit random value.
+      /// \return Random value in [min(), max()].
+      public: result_type operator()()
+      {
+        if (this->index == 4)
+        {
+          this->buffer = Generate(this->seed, this->stream, this->counter++);
+          this->index = 0;
+        }
+        return this->buffer[this->index++];
+      }
+
+      /// \brief Rekey the generator and rewind it to the start of a stream.
+      /// \param[in] _seed Seed, used as the 64-bit key.
+      /// \param[in] _stream Stream id.
+      public: void Seed(const uint64_t _seed, const uint64_t _stream = 0)
+      {
+        this->seed = _seed;
+        this->stream = _stream;
+        this->SetCounter(0);
+      }
+
+      /// \brief Get the seed.
+      /// \return The 64-bit key.
+      public: uint64_t Seed() const
+      {
+        return this->seed;
+      }
+
+      /// \brief Get the stream id.
+      /// \return The stream id.
+      public: uint64_t Stream() const
+      {
+        return this->stream;
+      }
+
+      /// \brief Jump to the start of a block. The next four values
+      /// returned by operator() are Generate(Seed(), Stream(), _counter).
+      /// \param[in] _counter Index of the block.
+      public: void SetCounter(const uint64_t _counter)
+      {
+        this->counter = _counter;
+        this->index = 4;
+      }
+
+      /// \brief Get the index of the next block that will be generated.
+      /// \return The block counter.
+      public: uint64_t Counter() const
+      {
+        return this->counter;
+      }
+
+      /// \brief Advance the generator as if operator() was called _n times.
+      /// \param[in] _n Number of values to skip.
+      public: void Discard(uint64_t _n)
+      {
+        const uint64_t buffered = 4u - this->index;
+        if (_n <= buffered)
+        {
+          this->index += static_cast<unsigned int>(_n);
+          return;
+        }
+        _n -= buffered;
+        this->counter += _n / 4;
+        this->index = 4;
+        const unsigned int rem = static_cast<unsigned int>(_n % 4);
+        if (rem > 0)
+        {
+          this->buffer = Generate(this->seed, this->stream, this->counter++);
+          this->index = rem;
+        }
+      }
+
+      /// \brief Fill a buffer with the next _size values of the stream,
+      /// equivalent to calling operator() _size times. Whole blocks are
+      /// generated several at a time with the rounds interleaved across
+      /// lanes, which compilers can vectorize.
+      /// \param[out] _out Buffer of at least _size values.
+      /// \param[in] _size Number of values to generate.
+      public: void Fill(uint32_t *_out, const size_t _size)
+      {
+        size_t i = 0;
+
+        // Values left in the current block
+        while (i < _size && this->index < 4)
+          _out[i++] = this->buffer[this->index++];
+
+        const size_t lanes = 8;
+        while (_size - i >= 4 * lanes)
+        {
+          uint32_t c0[lanes], c1[lanes], c2[lanes], c3[lanes];
+          for (size_t l = 0; l < lanes; ++l)
+          {
+            const uint64_t ctr = this->counter + l;
+            c0[l] = static_cast<uint32_t>(ctr);
+            c1[l] = static_cast<uint32_t>(ctr >> 32);
+            c2[l] = static_cast<uint32_t>(this->stream);
+            c3[l] = static_cast<uint32_t>(this->stream >> 32);
+          }
+
+          uint32_t key0 = static_cast<uint32_t>(this->seed);
+          uint32_t key1 = static_cast<uint32_t>(this->seed >> 32);
+          for (int round = 0; round < 10; ++round)
+          {
+            for (size_t l = 0; l < lanes; ++l)
+            {
+              const uint64_t p0 = static_cast<uint64_t>(kMul0) * c0[l];
+              const uint64_t p1 = static_cast<uint64_t>(kMul1) * c2[l];
+              c0[l] = static_cast<uint32_t>(p1 >> 32) ^ c1[l] ^ key0;
+              c1[l] = static_cast<uint32_t>(p1);
+              c2[l] = static_cast<uint32_t>(p0 >> 32) ^ c3[l] ^ key1;
+              c3[l] = static_cast<uint32_t>(p0);
+            }
+            key0 += kWeyl0;
+            key1 += kWeyl1;
+          }
+
+          for (size_t l = 0; l < lanes; ++l)
+          {
+            _out[i + 4 * l] = c0[l];
+            _out[i + 4 * l + 1] = c1[l];
+            _out[i + 4 * l + 2] = c2[l];
+            _out[i + 4 * l + 3] = c3[l];
+          }
+          this->counter += lanes;
+          i += 4 * lanes;
+        }
+
+        // Remaining values go through the block buffer
+        while (i < _size)
+          _out[i++] = (*this)();
+      }
+
+      /// \brief Stateless Philox4x32-10 bijection. This is the core of the
+      /// generator and may be called directly from parallel code.
+      /// \param[in] _seed Seed, used as the 64-bit key.
+      /// \param[in] _stream Stream id, used as the upper half of the
+      /// 128-bit counter.
+      /// \param[in] _counter Block counter, used as the lower half of the
+      /// 128-bit counter.
+      /// \return Four random 32-bit values.
+      public: static Block Generate(const uint64_t _seed,
+                                    const uint64_t _stream,
+                                    const uint64_t _counter)
+      {
+        Block ctr = {{
+          static_cast<uint32_t>(_counter),
+          static_cast<uint32_t>(_counter >> 32),
+          static_cast<uint32_t>(_stream),
+          static_cast<uint32_t>(_stream >> 32)}};
+        return Generate(ctr, static_cast<uint32_t>(_seed),
+            static_cast<uint32_t>(_seed >> 32));
+      }
+
+      /// \brief Stateless Philox4x32-10 bijection on a raw 128-bit counter
+      /// and 64-bit key, as specified by the reference implementation.
+      /// \param[in] _ctr Counter words.
+      /// \param[in] _key0 First key word.
+      /// \param[in] _key1 Second key word.
+      /// \return Four random 32-bit values.
+      public: static Block Generate(Block _ctr, uint32_t _key0,
+                                    uint32_t _key1)
+      {
+        for (int round = 0; round < 10; ++round)
+        {
+          const uint64_t p0 = static_cast<uint64_t>(kMul0) * _ctr[0];
+          const uint64_t p1 = static_cast<uint64_t>(kMul1) * _ctr[2];
+          const uint32_t hi0 = static_cast<uint32_t>(p0 >> 32);
+          const uint32_t lo0 = static_cast<uint32_t>(p0);
+          const uint32_t hi1 = static_cast<uint32_t>(p1 >> 32);
+          const uint32_t lo1 = static_cast<uint32_t>(p1);
+          _ctr = {{hi1 ^ _ctr[1] ^ _key0, lo1, hi0 ^ _ctr[3] ^ _key1, lo0}};
+          _key0 += kWeyl0;
+          _key1 += kWeyl1;
+        }
+        return _ctr;
+      }
+
+      /// \brief Philox multiplier for the first counter word.
+      private: static constexpr uint32_t kMul0 = 0xD2511F53u;
+
+      /// \brief Philox multiplier for the third counter word.
+      private: static constexpr uint32_t kMul1 = 0xCD9E8D57u;
+
+      /// \brief Weyl sequence increment for the first key word.
+      private: static constexpr uint32_t kWeyl0 = 0x9E3779B9u;
+
+      /// \brief Weyl sequence increment for the second key word.
+      private: static constexpr uint32_t kWeyl1 = 0xBB67AE85u;
+
+      /// \brief Key of the generator.
+      private: uint64_t seed;
+
+      /// \brief Stream id of the generator.
+      private: uint64_t stream;
+
+      /// \brief Index of the next block to generate.
+      private: uint64_t counter;
+
+      /// \brief Values of the current block.
+      private: Block buffer = {{0, 0, 0, 0}};
+
+      /// \brief Index of the next value in buffer. A value of 4 means the
+      /// buffer is exhausted.
+      private: unsigned int index = 4;
+    };
+    }
+  }
+}
+#endif
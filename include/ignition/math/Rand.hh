@@ -19,8 +19,11 @@
 
 #include <random>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <ignition/math/Helpers.hh>
+#include <ignition/math/Philox.hh>
+#include <ignition/math/Vector3.hh>
 #include <ignition/math/config.hh>
 
 namespace ignition
@@ -77,6 +80,114 @@ namespace ignition
       /// \param[in] _sigma Sigma value for the distribution
       public: static int32_t IntNormal(int _mean, int _sigma);
 
+      /// \brief Get a Vector3d whose components are drawn from independent
+      /// normal distributions.
+      /// \param[in] _mean Mean value for each component
+      /// \param[in] _sigma Sigma value for each component
+      /// \param[in,out] _gen Generator to draw from. Defaults to the
+      /// calling thread's generator.
+      /// \return Random vector.
+      public: static Vector3d Vector3Normal(const Vector3d &_mean,
+                  const Vector3d &_sigma,
+                  Philox4x32 &_gen = ThreadGenerator());
+
+      /// \brief Fill a buffer with doubles from a uniform distribution.
+      /// Values are built from 53 random bits, and the raw bits are
+      /// produced several blocks at a time by Philox4x32::Fill.
+      /// \param[out] _out Buffer of at least _size values.
+      /// \param[in] _size Number of values to generate.
+      /// \param[in] _min Minimum bound for the random numbers
+      /// \param[in] _max Maximum bound for the random numbers
+      /// \param[in,out] _gen Generator to draw from. Defaults to the
+      /// calling thread's generator.
+      public: static void FillUniform(double *_out, size_t _size,
+                  double _min = 0, double _max = 1,
+                  Philox4x32 &_gen = ThreadGenerator());
+
+      /// \brief Fill a buffer with floats from a uniform distribution.
+      /// Values are built from 24 random bits.
+      /// \param[out] _out Buffer of at least _size values.
+      /// \param[in] _size Number of values to generate.
+      /// \param[in] _min Minimum bound for the random numbers
+      /// \param[in] _max Maximum bound for the random numbers
+      /// \param[in,out] _gen Generator to draw from. Defaults to the
+      /// calling thread's generator.
+      public: static void FillUniform(float *_out, size_t _size,
+                  float _min = 0, float _max = 1,
+                  Philox4x32 &_gen = ThreadGenerator());
+
+      /// \brief Fill a buffer with integers from a uniform distribution
+      /// over the closed range [_min, _max]. Lemire's multiply-shift method
+      /// is used, so there is no modulo bias and rarely a rejection.
+      /// \param[out] _out Buffer of at least _size values.
+      /// \param[in] _size Number of values to generate.
+      /// \param[in] _min Minimum bound for the random numbers
+      /// \param[in] _max Maximum bound for the random numbers, which must
+      /// not be less than _min.
+      /// \param[in,out] _gen Generator to draw from. Defaults to the
+      /// calling thread's generator.
+      public: static void FillUniform(int32_t *_out, size_t _size,
+                  int32_t _min, int32_t _max,
+                  Philox4x32 &_gen = ThreadGenerator());
+
+      /// \brief Fill a buffer with doubles from a normal distribution,
+      /// using the Box-Muller transform on batches of uniform values.
+      /// \param[out] _out Buffer of at least _size values.
+      /// \param[in] _size Number of values to generate.
+      /// \param[in] _mean Mean value for the distribution
+      /// \param[in] _sigma Sigma value for the distribution
+      /// \param[in,out] _gen Generator to draw from. Defaults to the
+      /// calling thread's generator.
+      public: static void FillNormal(double *_out, size_t _size,
+                  double _mean = 0, double _sigma = 1,
+                  Philox4x32 &_gen = ThreadGenerator());
+
+      /// \brief Fill a buffer with floats from a normal distribution,
+      /// using the Box-Muller transform on 32-bit uniform values. The
+      /// tails are truncated at about 6.6 sigma.
+      /// \param[out] _out Buffer of at least _size values.
+      /// \param[in] _size Number of values to generate.
+      /// \param[in] _mean Mean value for the distribution
+      /// \param[in] _sigma Sigma value for the distribution
+      /// \param[in,out] _gen Generator to draw from. Defaults to the
+      /// calling thread's generator.
+      public: static void FillNormal(float *_out, size_t _size,
+                  float _mean = 0, float _sigma = 1,
+                  Philox4x32 &_gen = ThreadGenerator());
+
+      /// \brief Fill a buffer with vectors whose components are drawn from
+      /// independent normal distributions.
+      /// \param[out] _out Buffer of at least _size vectors.
+      /// \param[in] _size Number of vectors to generate.
+      /// \param[in] _mean Mean value for each component
+      /// \param[in] _sigma Sigma value for each component
+      /// \param[in,out] _gen Generator to draw from. Defaults to the
+      /// calling thread's generator.
+      public: static void FillNormal(Vector3d *_out, size_t _size,
+                  const Vector3d &_mean, const Vector3d &_sigma,
+                  Philox4x32 &_gen = ThreadGenerator());
+
+      /// \brief Get the calling thread's random generator. Each thread owns
+      /// an independent Philox4x32 stream keyed by (Seed(), ThreadStream()),
+      /// so it can be used concurrently without locking. The generator is
+      /// rewound to the start of its stream whenever Seed(unsigned int) is
+      /// called.
+      /// \return Reference to the thread-local generator.
+      public: static Philox4x32 &ThreadGenerator();
+
+      /// \brief Set the stream id of the calling thread's generator and
+      /// rewind it. Threads that are not assigned a stream get a unique id
+      /// in the order they first use ThreadGenerator(), which is not
+      /// reproducible between runs. To get identical results regardless of
+      /// the number of threads, assign the stream from the work item
+      /// (e.g. the sensor or particle index) rather than from the thread.
+      /// \param[in] _stream Stream id.
+      public: static void SetThreadStream(uint64_t _stream);
+
+      /// \brief Get the stream id of the calling thread's generator.
+      /// \return The stream id.
+      public: static uint64_t ThreadStream();
+
       /// \brief Get a mutable reference to the seed (create the static
       /// member if it hasn't been created yet).
       private: static uint32_t &SeedMutable();
@@ -17,6 +17,9 @@
 #ifndef IGNITION_MATH_SIGNALSTATS_HH_
 #define IGNITION_MATH_SIGNALSTATS_HH_
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <map>
 #include <memory>
 #include <string>
@@ -30,6 +33,250 @@ namespace ignition
     // Inline bracket to help doxygen filtering.
     inline namespace IGNITION_MATH_VERSION_NAMESPACE {
     //
+    /// \class SignalAccumulator SignalStats.hh ignition/math/SignalStats.hh
+    /// \brief Plain-value accumulator of all the statistics supported by
+    /// SignalStats. Unlike SignalStats it involves no virtual calls or heap
+    /// allocation, so each worker thread can keep its own instance and the
+    /// partial results can be combined afterwards with Merge. Merge is
+    /// associative, and the variance is combined using Chan's parallel
+    /// algorithm so the result matches a single serial pass up to rounding.
+    ///
+    /// ## Example
+    ///
+    /// \code{.cpp}
+    /// std::vector<ignition::math::SignalAccumulator> perThread(numThreads);
+    /// // ... each thread calls perThread[i].InsertData(sample) ...
+    /// ignition::math::SignalAccumulator total;
+    /// for (const auto &acc : perThread)
+    ///   total.Merge(acc);
+    /// \endcode
+    class SignalAccumulator
+    {
+      /// \brief Add a new sample to the accumulator.
+      /// \param[in] _data New signal data point.
+      public: void InsertData(const double _data)
+      {
+        if (this->count == 0)
+        {
+          this->min = _data;
+          this->max = _data;
+        }
+        else
+        {
+          this->min = std::min(this->min, _data);
+          this->max = std::max(this->max, _data);
+        }
+        this->maxAbs = std::max(this->maxAbs, std::abs(_data));
+        this->sum += _data;
+        this->sumSquares += _data * _data;
+
+        // Welford's online update of the mean and sum of squared deviations
+        ++this->count;
+        const double delta = _data - this->mean;
+        this->mean += delta / static_cast<double>(this->count);
+        this->m2 += delta * (_data - this->mean);
+      }
+
+      /// \brief Add a batch of samples to the accumulator. All statistics
+      /// are computed together in branch-free loops over blocks of the
+      /// input that compilers can vectorize, and each block is then merged
+      /// into this accumulator.
+      /// \param[in] _data Pointer to the first sample.
+      /// \param[in] _size Number of samples.
+      public: void InsertData(const double *_data, const size_t _size)
+      {
+        // Block size chosen so the second pass over a block reads from L1.
+        const size_t blockSize = 1024;
+        for (size_t start = 0; start < _size; start += blockSize)
+        {
+          const double *block = _data + start;
+          const size_t n = std::min(blockSize, _size - start);
+
+          SignalAccumulator partial;
+          partial.count = n;
+          partial.min = block[0];
+          partial.max = block[0];
+          for (size_t i = 0; i < n; ++i)
+          {
+            const double x = block[i];
+            const double absX = x < 0 ? -x : x;
+            partial.min = x < partial.min ? x : partial.min;
+            partial.max = x > partial.max ? x : partial.max;
+            partial.maxAbs = absX > partial.maxAbs ? absX : partial.maxAbs;
+            partial.sum += x;
+            partial.sumSquares += x * x;
+          }
+
+          // Two-pass M2 about the block mean avoids the cancellation of
+          // sumSquares - sum^2/n and needs no division per sample.
+          partial.mean = partial.sum / static_cast<double>(n);
+          for (size_t i = 0; i < n; ++i)
+          {
+            const double delta = block[i] - partial.mean;
+            partial.m2 += delta * delta;
+          }
+
+          this->Merge(partial);
+        }
+      }
+
+      /// \brief Combine the samples of another accumulator into this one.
+      /// The result is the same as if every sample inserted into _other had
+      /// been inserted into this accumulator.
+      /// \param[in] _other Accumulator to merge.
+      /// \return Reference to this accumulator.
+      public: SignalAccumulator &Merge(const SignalAccumulator &_other)
+      {
+        if (_other.count == 0)
+          return *this;
+
+        if (this->count == 0)
+        {
+          *this = _other;
+          return *this;
+        }
+
+        this->min = std::min(this->min, _other.min);
+        this->max = std::max(this->max, _other.max);
+        this->maxAbs = std::max(this->maxAbs, _other.maxAbs);
+        this->sum += _other.sum;
+        this->sumSquares += _other.sumSquares;
+
+        // Chan et al. pairwise combination of mean and M2
+        const double nA = static_cast<double>(this->count);
+        const double nB = static_cast<double>(_other.count);
+        const double n = nA + nB;
+        const double delta = _other.mean - this->mean;
+        this->mean += delta * nB / n;
+        this->m2 += _other.m2 + delta * delta * nA * nB / n;
+        this->count += _other.count;
+        return *this;
+      }
+
+      /// \brief Forget all previous data.
+      public: void Reset()
+      {
+        *this = SignalAccumulator();
+      }
+
+      /// \brief Get number of data points accumulated.
+      /// \return Number of data points.
+      public: size_t Count() const
+      {
+        return this->count;
+      }
+
+      /// \brief Get the maximum value, equivalent to SignalMaximum.
+      /// \return Maximum value, or 0 if there is no data.
+      public: double Max() const
+      {
+        return this->max;
+      }
+
+      /// \brief Get the maximum absolute value, equivalent to
+      /// SignalMaxAbsoluteValue.
+      /// \return Maximum absolute value, or 0 if there is no data.
+      public: double MaxAbs() const
+      {
+        return this->maxAbs;
+      }
+
+      /// \brief Get the mean value, equivalent to SignalMean.
+      /// \return Mean value, or 0 if there is no data.
+      public: double Mean() const
+      {
+        return this->mean;
+      }
+
+      /// \brief Get the minimum value, equivalent to SignalMinimum.
+      /// \return Minimum value, or 0 if there is no data.
+      public: double Min() const
+      {
+        return this->min;
+      }
+
+      /// \brief Get the root mean square, equivalent to
+      /// SignalRootMeanSquare.
+      /// \return Root mean square, or 0 if there is no data.
+      public: double RootMeanSquare() const
+      {
+        if (this->count == 0)
+          return 0.0;
+        return std::sqrt(this->sumSquares / static_cast<double>(this->count));
+      }
+
+      /// \brief Get the sum of all samples.
+      /// \return Sum of all samples.
+      public: double Sum() const
+      {
+        return this->sum;
+      }
+
+      /// \brief Get the sum of the squares of all samples.
+      /// \return Sum of the squared samples.
+      public: double SumSquares() const
+      {
+        return this->sumSquares;
+      }
+
+      /// \brief Get the sum of squared deviations from the mean, often
+      /// called M2.
+      /// \return Sum of squared deviations from the mean.
+      public: double SumSquaredDeviations() const
+      {
+        return this->m2;
+      }
+
+      /// \brief Get the unbiased sample variance, equivalent to
+      /// SignalVariance.
+      /// \return Variance, or 0 if there are fewer than 2 data points.
+      public: double Variance() const
+      {
+        if (this->count < 2)
+          return 0.0;
+        return this->m2 / static_cast<double>(this->count - 1);
+      }
+
+      /// \brief Get the values of every statistic, stored in a map using
+      /// the same short names as SignalStats::Map.
+      /// \return Map with short name of each statistic as key
+      /// and value of statistic as the value.
+      public: std::map<std::string, double> Map() const
+      {
+        return {
+          {"max", this->Max()},
+          {"maxAbs", this->MaxAbs()},
+          {"mean", this->Mean()},
+          {"min", this->Min()},
+          {"rms", this->RootMeanSquare()},
+          {"var", this->Variance()}};
+      }
+
+      /// \brief Number of data points.
+      private: size_t count = 0;
+
+      /// \brief Minimum value.
+      private: double min = 0.0;
+
+      /// \brief Maximum value.
+      private: double max = 0.0;
+
+      /// \brief Maximum absolute value.
+      private: double maxAbs = 0.0;
+
+      /// \brief Sum of all values.
+      private: double sum = 0.0;
+
+      /// \brief Sum of the squares of all values.
+      private: double sumSquares = 0.0;
+
+      /// \brief Running mean.
+      private: double mean = 0.0;
+
+      /// \brief Running sum of squared deviations from the mean.
+      private: double m2 = 0.0;
+    };
+
     /// \brief Forward declare private data class.
     class SignalStatisticPrivate;
 
@@ -63,6 +310,11 @@ namespace ignition
       /// \param[in] _data New signal data point.
       public: virtual void InsertData(const double _data) = 0;
 
+      /// \brief Combine the samples held by an accumulator into this
+      /// statistical measure.
+      /// \param[in] _acc Accumulator to merge.
+      public: virtual void Merge(const SignalAccumulator &_acc) = 0;
+
       /// \brief Forget all previous data.
       public: virtual void Reset();
 
@@ -93,6 +345,9 @@ namespace ignition
 
       // Documentation inherited.
       public: virtual void InsertData(const double _data) override;
+
+      // Documentation inherited.
+      public: virtual void Merge(const SignalAccumulator &_acc) override;
     };
     /// \}
 
@@ -109,6 +364,9 @@ namespace ignition
 
       // Documentation inherited.
       public: virtual void InsertData(const double _data) override;
+
+      // Documentation inherited.
+      public: virtual void Merge(const SignalAccumulator &_acc) override;
     };
     /// \}
 
@@ -125,6 +383,9 @@ namespace ignition
 
       // Documentation inherited.
       public: virtual void InsertData(const double _data) override;
+
+      // Documentation inherited.
+      public: virtual void Merge(const SignalAccumulator &_acc) override;
     };
     /// \}
 
@@ -142,6 +403,9 @@ namespace ignition
 
       // Documentation inherited.
       public: virtual void InsertData(const double _data) override;
+
+      // Documentation inherited.
+      public: virtual void Merge(const SignalAccumulator &_acc) override;
     };
     /// \}
 
@@ -161,6 +425,9 @@ namespace ignition
 
       // Documentation inherited.
       public: virtual void InsertData(const double _data) override;
+
+      // Documentation inherited.
+      public: virtual void Merge(const SignalAccumulator &_acc) override;
     };
     /// \}
 
@@ -178,6 +445,9 @@ namespace ignition
 
       // Documentation inherited.
       public: virtual void InsertData(const double _data) override;
+
+      // Documentation inherited.
+      public: virtual void Merge(const SignalAccumulator &_acc) override;
     };
     /// \}
 
@@ -215,6 +485,20 @@ namespace ignition
       /// \param[in] _data New signal data point.
       public: void InsertData(const double _data);
 
+      /// \brief Add a batch of samples to the statistical measures.
+      /// The samples are reduced in a single fused pass with a
+      /// SignalAccumulator and then merged into each statistic, so there
+      /// is one virtual call per statistic per batch instead of per sample.
+      /// \param[in] _data Pointer to the first sample.
+      /// \param[in] _size Number of samples.
+      public: void InsertData(const double *_data, const size_t _size);
+
+      /// \brief Combine the samples held by an accumulator into each
+      /// statistical measure. This is intended for reducing per-thread
+      /// SignalAccumulator objects into a single SignalStats.
+      /// \param[in] _acc Accumulator to merge.
+      public: void Merge(const SignalAccumulator &_acc);
+
       /// \brief Add a new type of statistic.
       /// \param[in] _name Short name of new statistic.
       /// Valid values include:
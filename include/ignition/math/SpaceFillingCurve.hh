@@ -0,0 +1,521 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_MATH_SPACEFILLINGCURVE_HH_
+#define IGNITION_MATH_SPACEFILLINGCURVE_HH_
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Vector2.hh>
+#include <ignition/math/Vector3.hh>
+#include <ignition/math/config.hh>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+namespace ignition
+{
+  namespace math
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_MATH_VERSION_NAMESPACE {
+    //
+    /// \class SpaceFillingCurve SpaceFillingCurve.hh
+    /// ignition/math/SpaceFillingCurve.hh
+    /// \brief Morton (Z-order) and Hilbert curve keys, and a radix sort to
+    /// order points along them.
+    ///
+    /// Points that are close along a space filling curve are close in
+    /// space, so sorting points, boxes or triangles by their key before
+    /// building a tree or a grid over them makes the later queries read
+    /// memory in order. Morton keys are cheaper to compute, and Hilbert
+    /// keys never jump between distant cells so they give slightly better
+    /// locality.
+    ///
+    /// 2D keys use 32 bits per axis and 3D keys 21 bits per axis. Bit 0 of
+    /// a Morton key is bit 0 of x, then bit 0 of y, and so on. When the
+    /// code is compiled for a CPU with BMI2, Morton keys use the pdep and
+    /// pext instructions.
+    ///
+    /// ## Example
+    ///
+    /// \code{.cpp}
+    /// std::vector<ignition::math::Vector3d> points = ...;
+    /// std::vector<size_t> order;
+    /// ignition::math::SpaceFillingCurve::Sort(points, order);
+    /// // Reorder the payloads the same way as the points
+    /// ignition::math::SpaceFillingCurve::Reorder(colors, order);
+    /// \endcode
+    class SpaceFillingCurve
+    {
+      /// \brief Types of curves.
+      public: enum Curve
+      {
+        /// \brief Morton, or Z-order, curve.
+        CURVE_MORTON = 0,
+
+        /// \brief Hilbert curve.
+        CURVE_HILBERT = 1
+      };
+
+      /// \brief Get the Morton key of a 2D cell.
+      /// \param[in] _x X coordinate of the cell.
+      /// \param[in] _y Y coordinate of the cell.
+      /// \return The key.
+      public: static uint64_t Morton(const uint32_t _x, const uint32_t _y)
+      {
+        return Spread2(_x) | (Spread2(_y) << 1);
+      }
+
+      /// \brief Get the Morton key of a 3D cell.
+      /// \param[in] _x X coordinate of the cell. Only the 21 lowest bits
+      /// are used.
+      /// \param[in] _y Y coordinate of the cell. Only the 21 lowest bits
+      /// are used.
+      /// \param[in] _z Z coordinate of the cell. Only the 21 lowest bits
+      /// are used.
+      /// \return The key.
+      public: static uint64_t Morton(const uint32_t _x, const uint32_t _y,
+                  const uint32_t _z)
+      {
+        return Spread3(_x) | (Spread3(_y) << 1) | (Spread3(_z) << 2);
+      }
+
+      /// \brief Get the 2D cell of a Morton key.
+      /// \param[in] _key The key.
+      /// \param[out] _x X coordinate of the cell.
+      /// \param[out] _y Y coordinate of the cell.
+      public: static void MortonDecode(const uint64_t _key, uint32_t &_x,
+                  uint32_t &_y)
+      {
+        _x = Compact2(_key);
+        _y = Compact2(_key >> 1);
+      }
+
+      /// \brief Get the 3D cell of a Morton key.
+      /// \param[in] _key The key.
+      /// \param[out] _x X coordinate of the cell.
+      /// \param[out] _y Y coordinate of the cell.
+      /// \param[out] _z Z coordinate of the cell.
+      public: static void MortonDecode(const uint64_t _key, uint32_t &_x,
+                  uint32_t &_y, uint32_t &_z)
+      {
+        _x = Compact3(_key);
+        _y = Compact3(_key >> 1);
+        _z = Compact3(_key >> 2);
+      }
+
+      /// \brief Get the Hilbert key of a 2D cell.
+      /// \param[in] _x X coordinate of the cell.
+      /// \param[in] _y Y coordinate of the cell.
+      /// \return The key.
+      public: static uint64_t Hilbert(const uint32_t _x, const uint32_t _y)
+      {
+        uint32_t axes[2] = {_x, _y};
+        AxesToTranspose(axes, 2, 32);
+        return Morton(axes[1], axes[0]);
+      }
+
+      /// \brief Get the Hilbert key of a 3D cell.
+      /// \param[in] _x X coordinate of the cell. Only the 21 lowest bits
+      /// are used.
+      /// \param[in] _y Y coordinate of the cell. Only the 21 lowest bits
+      /// are used.
+      /// \param[in] _z Z coordinate of the cell. Only the 21 lowest bits
+      /// are used.
+      /// \return The key.
+      public: static uint64_t Hilbert(const uint32_t _x, const uint32_t _y,
+                  const uint32_t _z)
+      {
+        uint32_t axes[3] = {_x & kMask21, _y & kMask21, _z & kMask21};
+        AxesToTranspose(axes, 3, 21);
+        return Morton(axes[2], axes[1], axes[0]);
+      }
+
+      /// \brief Get the 2D cell of a Hilbert key.
+      /// \param[in] _key The key.
+      /// \param[out] _x X coordinate of the cell.
+      /// \param[out] _y Y coordinate of the cell.
+      public: static void HilbertDecode(const uint64_t _key, uint32_t &_x,
+                  uint32_t &_y)
+      {
+        uint32_t axes[2];
+        MortonDecode(_key, axes[1], axes[0]);
+        TransposeToAxes(axes, 2, 32);
+        _x = axes[0];
+        _y = axes[1];
+      }
+
+      /// \brief Get the 3D cell of a Hilbert key.
+      /// \param[in] _key The key.
+      /// \param[out] _x X coordinate of the cell.
+      /// \param[out] _y Y coordinate of the cell.
+      /// \param[out] _z Z coordinate of the cell.
+      public: static void HilbertDecode(const uint64_t _key, uint32_t &_x,
+                  uint32_t &_y, uint32_t &_z)
+      {
+        uint32_t axes[3];
+        MortonDecode(_key, axes[2], axes[1], axes[0]);
+        TransposeToAxes(axes, 3, 21);
+        _x = axes[0];
+        _y = axes[1];
+        _z = axes[2];
+      }
+
+      /// \brief Get the key of a 2D point. The box is divided in 2^32
+      /// cells along x and y, and points outside it are moved to its
+      /// nearest cell.
+      /// \param[in] _point The point.
+      /// \param[in] _box The box. Its z extent is not used.
+      /// \param[in] _curve Type of curve.
+      /// \return The key, or zero if the point has a NaN coordinate.
+      public: template<typename T>
+              static uint64_t Key(const Vector2<T> &_point,
+                  const AxisAlignedBox &_box,
+                  const Curve _curve = CURVE_MORTON)
+      {
+        const uint32_t x = Quantize(_point.X(), _box.Min().X(),
+            _box.Max().X(), 32);
+        const uint32_t y = Quantize(_point.Y(), _box.Min().Y(),
+            _box.Max().Y(), 32);
+        return _curve == CURVE_HILBERT ? Hilbert(x, y) : Morton(x, y);
+      }
+
+      /// \brief Get the key of a 3D point. The box is divided in 2^21
+      /// cells along each axis, and points outside it are moved to its
+      /// nearest cell.
+      /// \param[in] _point The point.
+      /// \param[in] _box The box.
+      /// \param[in] _curve Type of curve.
+      /// \return The key, or zero if the point has a NaN coordinate.
+      public: template<typename T>
+              static uint64_t Key(const Vector3<T> &_point,
+                  const AxisAlignedBox &_box,
+                  const Curve _curve = CURVE_MORTON)
+      {
+        uint32_t q[3];
+        for (int a = 0; a < 3; ++a)
+          q[a] = Quantize(_point[a], _box.Min()[a], _box.Max()[a], 21);
+        return _curve == CURVE_HILBERT ? Hilbert(q[0], q[1], q[2]) :
+          Morton(q[0], q[1], q[2]);
+      }
+
+      /// \brief Sort keys with a least significant digit radix sort. The
+      /// passes over bytes that are equal in all keys are skipped, so keys
+      /// that use few bits sort faster.
+      /// \param[in,out] _keys The keys.
+      /// \param[out] _order If not null, set to the positions the sorted
+      /// keys had before sorting. Keys that are equal keep their order.
+      public: static void RadixSort(std::vector<uint64_t> &_keys,
+                  std::vector<size_t> *_order = nullptr)
+      {
+        const size_t count = _keys.size();
+        if (_order)
+        {
+          _order->resize(count);
+          std::iota(_order->begin(), _order->end(), 0);
+        }
+
+        // An insertion sort is faster for a few keys
+        if (count < kRadixMinCount)
+        {
+          for (size_t i = 1; i < count; ++i)
+          {
+            const uint64_t key = _keys[i];
+            const size_t index = _order ? (*_order)[i] : 0;
+            size_t j = i;
+            for (; j > 0 && _keys[j - 1] > key; --j)
+            {
+              _keys[j] = _keys[j - 1];
+              if (_order)
+                (*_order)[j] = (*_order)[j - 1];
+            }
+            _keys[j] = key;
+            if (_order)
+              (*_order)[j] = index;
+          }
+          return;
+        }
+
+        // Count the digits of all passes at once
+        std::vector<size_t> counts(8 * 256, 0);
+        for (const uint64_t key : _keys)
+        {
+          for (int d = 0; d < 8; ++d)
+            ++counts[d * 256 + ((key >> (8 * d)) & 0xff)];
+        }
+
+        std::vector<uint64_t> keys(count);
+        std::vector<size_t> order(_order ? count : 0);
+        for (int d = 0; d < 8; ++d)
+        {
+          size_t *digitCounts = &counts[d * 256];
+          const int shift = 8 * d;
+          if (digitCounts[(_keys[0] >> shift) & 0xff] == count)
+            continue;
+
+          size_t offset = 0;
+          for (int b = 0; b < 256; ++b)
+          {
+            const size_t c = digitCounts[b];
+            digitCounts[b] = offset;
+            offset += c;
+          }
+          for (size_t i = 0; i < count; ++i)
+          {
+            const size_t slot = digitCounts[(_keys[i] >> shift) & 0xff]++;
+            keys[slot] = _keys[i];
+            if (_order)
+              order[slot] = (*_order)[i];
+          }
+          _keys.swap(keys);
+          if (_order)
+            _order->swap(order);
+        }
+      }
+
+      /// \brief Reorder values by a permutation, such as the one given by
+      /// RadixSort.
+      /// \param[in,out] _values The values. After the call, value i is the
+      /// value that was at _order[i].
+      /// \param[in] _order The permutation, with as many entries as
+      /// _values.
+      public: template<typename T>
+              static void Reorder(std::vector<T> &_values,
+                  const std::vector<size_t> &_order)
+      {
+        std::vector<T> sorted;
+        sorted.reserve(_order.size());
+        for (const size_t i : _order)
+          sorted.push_back(_values[i]);
+        _values.swap(sorted);
+      }
+
+      /// \brief Sort points along a curve through their bounding box.
+      /// \param[in,out] _points The points. Points with a non-finite
+      /// coordinate are moved to the end.
+      /// \param[out] _order The positions the sorted points had before
+      /// sorting, to reorder other arrays with Reorder().
+      /// \param[in] _curve Type of curve.
+      public: template<typename T>
+              static void Sort(std::vector<Vector3<T>> &_points,
+                  std::vector<size_t> &_order,
+                  const Curve _curve = CURVE_MORTON)
+      {
+        Vector3d min(std::numeric_limits<double>::max(),
+            std::numeric_limits<double>::max(),
+            std::numeric_limits<double>::max());
+        Vector3d max = -min;
+        for (const Vector3<T> &p : _points)
+        {
+          if (p.IsFinite())
+          {
+            const Vector3d q(p.X(), p.Y(), p.Z());
+            min.Min(q);
+            max.Max(q);
+          }
+        }
+        const AxisAlignedBox box(min, max);
+
+        std::vector<uint64_t> keys(_points.size());
+        for (size_t i = 0; i < _points.size(); ++i)
+        {
+          keys[i] = _points[i].IsFinite() ? Key(_points[i], box, _curve) :
+            std::numeric_limits<uint64_t>::max();
+        }
+        RadixSort(keys, &_order);
+        Reorder(_points, _order);
+      }
+
+      /// \brief Mask of the 21 lowest bits.
+      private: static constexpr uint32_t kMask21 = (1u << 21) - 1;
+
+      /// \brief Number of keys below which RadixSort uses an insertion
+      /// sort.
+      private: static constexpr size_t kRadixMinCount = 64;
+
+      /// \brief Get the cell of a coordinate.
+      /// \param[in] _v The coordinate.
+      /// \param[in] _min Start of the range.
+      /// \param[in] _max End of the range.
+      /// \param[in] _bits Number of bits of the cell.
+      /// \return The cell, in [0, 2^_bits).
+      private: static uint32_t Quantize(const double _v, const double _min,
+                   const double _max, const int _bits)
+      {
+        const double cells = static_cast<double>(uint64_t(1) << _bits);
+        if (!(_max > _min))
+          return 0;
+        const double s = (_v - _min) / (_max - _min) * cells;
+        if (!(s > 0))
+          return 0;
+        if (s >= cells - 1)
+          return static_cast<uint32_t>(cells - 1);
+        return static_cast<uint32_t>(s);
+      }
+
+      /// \brief Spread the bits of a value to every other bit.
+      /// \param[in] _v The value.
+      /// \return The spread bits.
+      private: static uint64_t Spread2(const uint32_t _v)
+      {
+#if defined(__BMI2__)
+        return _pdep_u64(_v, 0x5555555555555555ULL);
+#else
+        uint64_t x = _v;
+        x = (x | (x << 16)) & 0x0000ffff0000ffffULL;
+        x = (x | (x << 8)) & 0x00ff00ff00ff00ffULL;
+        x = (x | (x << 4)) & 0x0f0f0f0f0f0f0f0fULL;
+        x = (x | (x << 2)) & 0x3333333333333333ULL;
+        x = (x | (x << 1)) & 0x5555555555555555ULL;
+        return x;
+#endif
+      }
+
+      /// \brief Gather every other bit of a value, the inverse of Spread2.
+      /// \param[in] _v The value.
+      /// \return The gathered bits.
+      private: static uint32_t Compact2(const uint64_t _v)
+      {
+#if defined(__BMI2__)
+        return static_cast<uint32_t>(_pext_u64(_v, 0x5555555555555555ULL));
+#else
+        uint64_t x = _v & 0x5555555555555555ULL;
+        x = (x | (x >> 1)) & 0x3333333333333333ULL;
+        x = (x | (x >> 2)) & 0x0f0f0f0f0f0f0f0fULL;
+        x = (x | (x >> 4)) & 0x00ff00ff00ff00ffULL;
+        x = (x | (x >> 8)) & 0x0000ffff0000ffffULL;
+        x = (x | (x >> 16)) & 0x00000000ffffffffULL;
+        return static_cast<uint32_t>(x);
+#endif
+      }
+
+      /// \brief Spread the 21 lowest bits of a value to every third bit.
+      /// \param[in] _v The value.
+      /// \return The spread bits.
+      private: static uint64_t Spread3(const uint32_t _v)
+      {
+#if defined(__BMI2__)
+        return _pdep_u64(_v, 0x1249249249249249ULL);
+#else
+        uint64_t x = _v & kMask21;
+        x = (x | (x << 32)) & 0x001f00000000ffffULL;
+        x = (x | (x << 16)) & 0x001f0000ff0000ffULL;
+        x = (x | (x << 8)) & 0x100f00f00f00f00fULL;
+        x = (x | (x << 4)) & 0x10c30c30c30c30c3ULL;
+        x = (x | (x << 2)) & 0x1249249249249249ULL;
+        return x;
+#endif
+      }
+
+      /// \brief Gather every third bit of a value, the inverse of Spread3.
+      /// \param[in] _v The value.
+      /// \return The gathered bits.
+      private: static uint32_t Compact3(const uint64_t _v)
+      {
+#if defined(__BMI2__)
+        return static_cast<uint32_t>(_pext_u64(_v, 0x1249249249249249ULL));
+#else
+        uint64_t x = _v & 0x1249249249249249ULL;
+        x = (x | (x >> 2)) & 0x10c30c30c30c30c3ULL;
+        x = (x | (x >> 4)) & 0x100f00f00f00f00fULL;
+        x = (x | (x >> 8)) & 0x001f0000ff0000ffULL;
+        x = (x | (x >> 16)) & 0x001f00000000ffffULL;
+        x = (x | (x >> 32)) & kMask21;
+        return static_cast<uint32_t>(x);
+#endif
+      }
+
+      /// \brief Convert cell coordinates to the transposed form of their
+      /// Hilbert key, following J. Skilling, "Programming the Hilbert
+      /// curve", AIP Conference Proceedings 707, 2004.
+      /// \param[in,out] _x The coordinates.
+      /// \param[in] _n Number of dimensions.
+      /// \param[in] _bits Number of bits per coordinate.
+      private: static void AxesToTranspose(uint32_t *_x, const int _n,
+                   const int _bits)
+      {
+        const uint32_t m = 1u << (_bits - 1);
+
+        // Inverse undo
+        for (uint32_t q = m; q > 1; q >>= 1)
+        {
+          const uint32_t p = q - 1;
+          for (int i = 0; i < _n; ++i)
+          {
+            // Invert the low bits of x[0] if bit q of x[i] is set, else
+            // exchange them with the low bits of x[i], without branches
+            const uint32_t set = 0u - ((_x[i] & q) != 0);
+            const uint32_t swap = (_x[0] ^ _x[i]) & p & ~set;
+            _x[0] ^= swap | (p & set);
+            _x[i] ^= swap;
+          }
+        }
+
+        // Gray encode
+        for (int i = 1; i < _n; ++i)
+          _x[i] ^= _x[i - 1];
+        uint32_t t = 0;
+        for (uint32_t q = m; q > 1; q >>= 1)
+        {
+          if (_x[_n - 1] & q)
+            t ^= q - 1;
+        }
+        for (int i = 0; i < _n; ++i)
+          _x[i] ^= t;
+      }
+
+      /// \brief Convert the transposed form of a Hilbert key to cell
+      /// coordinates, the inverse of AxesToTranspose.
+      /// \param[in,out] _x The transposed key.
+      /// \param[in] _n Number of dimensions.
+      /// \param[in] _bits Number of bits per coordinate.
+      private: static void TransposeToAxes(uint32_t *_x, const int _n,
+                   const int _bits)
+      {
+        const uint64_t end = uint64_t(1) << _bits;
+
+        // Gray decode
+        const uint32_t t = _x[_n - 1] >> 1;
+        for (int i = _n - 1; i > 0; --i)
+          _x[i] ^= _x[i - 1];
+        _x[0] ^= t;
+
+        // Undo excess work
+        for (uint64_t q = 2; q != end; q <<= 1)
+        {
+          const uint32_t p = static_cast<uint32_t>(q - 1);
+          for (int i = _n - 1; i >= 0; --i)
+          {
+            const uint32_t set = 0u - ((_x[i] & q) != 0);
+            const uint32_t swap = (_x[0] ^ _x[i]) & p & ~set;
+            _x[0] ^= swap | (p & set);
+            _x[i] ^= swap;
+          }
+        }
+      }
+    };
+    }
+  }
+}
+#endif
@@ -0,0 +1,670 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_MATH_SPATIALHASHGRID_HH_
+#define IGNITION_MATH_SPATIALHASHGRID_HH_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+#include <ignition/math/Vector3.hh>
+#include <ignition/math/config.hh>
+
+namespace ignition
+{
+  namespace math
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_MATH_VERSION_NAMESPACE {
+    //
+    /// \class SpatialHashGrid SpatialHashGrid.hh
+    /// ignition/math/SpatialHashGrid.hh
+    /// \brief A uniform grid of cubic cells over a set of points, for
+    /// fixed radius and nearest neighbor queries.
+    ///
+    /// Only the cells that hold points are stored, in a hash table keyed
+    /// on the integer cell coordinates, so the points can be spread over
+    /// any region. Build() places the points in the cells with a counting
+    /// sort, which takes linear time, so the grid can be rebuilt every
+    /// frame for moving points such as particles. The points are copied
+    /// in cell order, and queries report the indices of the points in the
+    /// input.
+    ///
+    /// Queries are fastest when the cell size is close to the query
+    /// radius. Points with a non-finite coordinate are ignored. Queries
+    /// are const, so a grid can be queried from many threads at once.
+    ///
+    /// ## Example
+    ///
+    /// \code{.cpp}
+    /// ignition::math::SpatialHashGrid<double> grid(0.1);
+    /// grid.Build(points);
+    /// std::vector<size_t> neighbors;
+    /// grid.Radius(points[0], 0.1, neighbors);
+    /// \endcode
+    template<typename T>
+    class SpatialHashGrid
+    {
+      /// \brief A pair of point indices, with the smaller one first.
+      public: using Pair = std::pair<size_t, size_t>;
+
+      /// \brief Default constructor. The cell size is 1 and the grid is
+      /// empty.
+      public: SpatialHashGrid() = default;
+
+      /// \brief Constructor.
+      /// \param[in] _cellSize Edge length of the cells.
+      /// \sa SetCellSize(const T)
+      public: explicit SpatialHashGrid(const T _cellSize)
+      {
+        this->SetCellSize(_cellSize);
+      }
+
+      /// \brief Set the edge length of the cells. This empties the grid,
+      /// which must then be built again.
+      /// \param[in] _cellSize Edge length of the cells. Values that are not
+      /// positive and finite are ignored.
+      /// \return True if the cell size was set.
+      public: bool SetCellSize(const T _cellSize)
+      {
+        if (!(_cellSize > 0) || !std::isfinite(_cellSize))
+          return false;
+        this->cellSize = _cellSize;
+        this->Clear();
+        return true;
+      }
+
+      /// \brief Get the edge length of the cells.
+      /// \return The cell size.
+      public: T CellSize() const
+      {
+        return this->cellSize;
+      }
+
+      /// \brief Remove all points.
+      public: void Clear()
+      {
+        this->xs.clear();
+        this->ys.clear();
+        this->zs.clear();
+        this->indices.clear();
+        this->cells.clear();
+        std::fill(this->table.begin(), this->table.end(), 0u);
+      }
+
+      /// \brief Build the grid from a vector of points.
+      /// \param[in] _points The points.
+      public: void Build(const std::vector<Vector3<T>> &_points)
+      {
+        this->BuildImpl(_points.size(), [&](const size_t _i)
+        {
+          return _points[_i];
+        });
+      }
+
+      /// \brief Build the grid from points stored as a structure of arrays.
+      /// \param[in] _x X coordinates of the points.
+      /// \param[in] _y Y coordinates of the points.
+      /// \param[in] _z Z coordinates of the points.
+      /// \param[in] _count Number of points.
+      public: void Build(const T *_x, const T *_y, const T *_z,
+                  const size_t _count)
+      {
+        this->BuildImpl(_count, [&](const size_t _i)
+        {
+          return Vector3<T>(_x[_i], _y[_i], _z[_i]);
+        });
+      }
+
+      /// \brief Get the number of points in the grid, which excludes
+      /// points with a non-finite coordinate.
+      /// \return Number of points.
+      public: size_t Size() const
+      {
+        return this->indices.size();
+      }
+
+      /// \brief Get the number of cells that hold points.
+      /// \return Number of occupied cells.
+      public: size_t CellCount() const
+      {
+        return this->cells.size();
+      }
+
+      /// \brief Find the points within a distance of a point.
+      /// \param[in] _point Query point.
+      /// \param[in] _radius Distance from the query point.
+      /// \param[out] _result Indices of the points at most _radius away
+      /// from _point, in no particular order. Existing content is
+      /// cleared.
+      public: void Radius(const Vector3<T> &_point, const T _radius,
+                  std::vector<size_t> &_result) const
+      {
+        _result.clear();
+        if (!(_radius >= 0) || this->cells.empty())
+          return;
+
+        const T radius2 = _radius * _radius;
+        this->ForCellsInBox(_point - Vector3<T>(_radius, _radius, _radius),
+            _point + Vector3<T>(_radius, _radius, _radius),
+            [&](const Cell &_cell)
+        {
+          for (uint32_t s = _cell.begin; s < _cell.end; ++s)
+          {
+            if (this->Distance2(s, _point) <= radius2)
+              _result.push_back(this->indices[s]);
+          }
+        });
+      }
+
+      /// \brief Find the points nearest to a point.
+      /// \param[in] _point Query point.
+      /// \param[in] _k Number of points to find.
+      /// \param[out] _result Indices of the _k nearest points, nearest
+      /// first, or of all points in range if there are fewer. Points at
+      /// equal distances are ordered by index. Existing content is
+      /// cleared.
+      /// \param[in] _maxDistance Only consider points within this distance
+      /// of the query point.
+      public: void Nearest(const Vector3<T> &_point, const size_t _k,
+                  std::vector<size_t> &_result,
+                  const T _maxDistance =
+                      std::numeric_limits<T>::infinity()) const
+      {
+        _result.clear();
+        if (_k == 0 || this->cells.empty() || !(_maxDistance >= 0))
+          return;
+
+        // Max heap of the best candidates, by squared distance and index
+        std::vector<std::pair<T, size_t>> best;
+        best.reserve(std::min(_k, this->Size()));
+        const T maxDistance2 = _maxDistance * _maxDistance;
+        auto visit = [&](const Cell &_cell)
+        {
+          for (uint32_t s = _cell.begin; s < _cell.end; ++s)
+          {
+            const std::pair<T, size_t> candidate(this->Distance2(s, _point),
+                this->indices[s]);
+            if (candidate.first > maxDistance2)
+              continue;
+            if (best.size() < _k)
+            {
+              best.push_back(candidate);
+              std::push_heap(best.begin(), best.end());
+            }
+            else if (candidate < best.front())
+            {
+              std::pop_heap(best.begin(), best.end());
+              best.back() = candidate;
+              std::push_heap(best.begin(), best.end());
+            }
+          }
+        };
+
+        // Visit shells of cells around the cell of the query point, until
+        // every cell that is not visited yet is farther than the k-th
+        // candidate or the maximum distance
+        const int64_t center[3] = {this->CellCoord(_point.X()),
+          this->CellCoord(_point.Y()), this->CellCoord(_point.Z())};
+        int64_t maxRing = 0;
+        for (int a = 0; a < 3; ++a)
+        {
+          maxRing = std::max(maxRing, std::max(center[a] - this->lower[a],
+                this->upper[a] - center[a]));
+        }
+
+        for (int64_t ring = 0; ring <= maxRing; ++ring)
+        {
+          // A shell with more cells than the grid holds is slower than
+          // visiting the remaining cells directly
+          const double side = static_cast<double>(2 * ring + 1);
+          if (6 * side * side > static_cast<double>(this->cells.size()))
+          {
+            for (const Cell &cell : this->cells)
+            {
+              if (std::abs(cell.x - center[0]) >= ring ||
+                  std::abs(cell.y - center[1]) >= ring ||
+                  std::abs(cell.z - center[2]) >= ring)
+              {
+                visit(cell);
+              }
+            }
+            break;
+          }
+
+          this->ForCellsInShell(center, ring, visit);
+
+          // Distance from the query point to the outside of the cells
+          // visited so far, less a margin for rounding
+          double reach = std::numeric_limits<double>::infinity();
+          for (int a = 0; a < 3; ++a)
+          {
+            const double p = static_cast<double>(_point[a]);
+            const double low = static_cast<double>(center[a] - ring) *
+              this->cellSize;
+            const double high = static_cast<double>(center[a] + ring + 1) *
+              this->cellSize;
+            const double margin = 8 * std::numeric_limits<T>::epsilon() *
+              (std::abs(p) + std::abs(low) + std::abs(high));
+            reach = std::min(reach, std::min(p - low, high - p) - margin);
+          }
+          if (reach > 0 && (reach * reach > maxDistance2 ||
+                (best.size() == _k && reach * reach > best.front().first)))
+          {
+            break;
+          }
+        }
+
+        std::sort_heap(best.begin(), best.end());
+        _result.reserve(best.size());
+        for (const std::pair<T, size_t> &candidate : best)
+          _result.push_back(candidate.second);
+      }
+
+      /// \brief Find all pairs of points within a distance of each other.
+      /// \param[in] _radius Distance between the points of a pair.
+      /// \param[out] _pairs The pairs, each with the smaller index first,
+      /// in no particular order. Existing content is cleared.
+      public: void Pairs(const T _radius, std::vector<Pair> &_pairs) const
+      {
+        _pairs.clear();
+        if (!(_radius >= 0) || this->cells.empty())
+          return;
+
+        const T radius2 = _radius * _radius;
+        const double reachCells =
+          std::ceil(static_cast<double>(_radius) / this->cellSize);
+        const double side = 2 * reachCells + 1;
+        const int64_t reach = static_cast<int64_t>(
+            std::min(reachCells, 4.0e18));
+
+        // Pairs of points in two cells
+        auto pairsBetween = [&](const Cell &_a, const Cell &_b)
+        {
+          for (uint32_t s = _a.begin; s < _a.end; ++s)
+          {
+            const Vector3<T> p(this->xs[s], this->ys[s], this->zs[s]);
+            for (uint32_t u = _b.begin; u < _b.end; ++u)
+            {
+              if (this->Distance2(u, p) <= radius2)
+                this->AddPair(s, u, _pairs);
+            }
+          }
+        };
+
+        // With a radius that spans more cells than the grid holds, check
+        // every pair of occupied cells instead of the neighbors
+        const bool scanCells =
+          side * side * side > static_cast<double>(this->cells.size());
+
+        for (size_t c = 0; c < this->cells.size(); ++c)
+        {
+          const Cell &cell = this->cells[c];
+          // Pairs within the cell
+          for (uint32_t s = cell.begin; s < cell.end; ++s)
+          {
+            const Vector3<T> p(this->xs[s], this->ys[s], this->zs[s]);
+            for (uint32_t u = s + 1; u < cell.end; ++u)
+            {
+              if (this->Distance2(u, p) <= radius2)
+                this->AddPair(s, u, _pairs);
+            }
+          }
+
+          if (scanCells)
+          {
+            for (size_t d = c + 1; d < this->cells.size(); ++d)
+            {
+              const Cell &other = this->cells[d];
+              if (std::abs(other.x - cell.x) <= reach &&
+                  std::abs(other.y - cell.y) <= reach &&
+                  std::abs(other.z - cell.z) <= reach)
+              {
+                pairsBetween(cell, other);
+              }
+            }
+            continue;
+          }
+
+          // Pairs with the neighbors that come after this cell, so each
+          // pair of cells is visited once
+          for (int64_t dz = -reach; dz <= reach; ++dz)
+          {
+            for (int64_t dy = -reach; dy <= reach; ++dy)
+            {
+              for (int64_t dx = -reach; dx <= reach; ++dx)
+              {
+                if (dz < 0 || (dz == 0 && (dy < 0 || (dy == 0 && dx <= 0))))
+                  continue;
+
+                const Cell *other = this->Find(cell.x + dx, cell.y + dy,
+                    cell.z + dz);
+                if (other)
+                  pairsBetween(cell, *other);
+              }
+            }
+          }
+        }
+      }
+
+      /// \brief An occupied cell.
+      private: struct Cell
+      {
+        /// \brief Cell coordinates.
+        int64_t x, y, z;
+
+        /// \brief First point of the cell, in cell order.
+        uint32_t begin;
+
+        /// \brief One past the last point of the cell.
+        uint32_t end;
+      };
+
+      /// \brief Build the grid.
+      /// \param[in] _count Number of points.
+      /// \param[in] _point Function that returns a point by index.
+      private: template<typename Points>
+               void BuildImpl(const size_t _count, const Points &_point)
+      {
+        this->Clear();
+        this->cellOf.assign(_count, kNone);
+        for (int a = 0; a < 3; ++a)
+        {
+          this->lower[a] = std::numeric_limits<int64_t>::max();
+          this->upper[a] = std::numeric_limits<int64_t>::min();
+        }
+
+        // The table keeps at most half of its slots in use. Grow it up
+        // front for the worst case of one point per cell.
+        size_t slots = 16;
+        while (slots < 2 * _count)
+          slots *= 2;
+        if (this->table.size() < slots)
+          this->table.assign(slots, 0u);
+
+        // Assign each point to a cell
+        for (size_t i = 0; i < _count; ++i)
+        {
+          const Vector3<T> p = _point(i);
+          if (!std::isfinite(p.X()) || !std::isfinite(p.Y()) ||
+              !std::isfinite(p.Z()))
+          {
+            continue;
+          }
+
+          const int64_t c[3] = {this->CellCoord(p.X()),
+            this->CellCoord(p.Y()), this->CellCoord(p.Z())};
+          uint32_t &slot = this->Slot(c[0], c[1], c[2]);
+          if (slot == 0)
+          {
+            this->cells.push_back({c[0], c[1], c[2], 0, 0});
+            slot = static_cast<uint32_t>(this->cells.size());
+            for (int a = 0; a < 3; ++a)
+            {
+              this->lower[a] = std::min(this->lower[a], c[a]);
+              this->upper[a] = std::max(this->upper[a], c[a]);
+            }
+          }
+          this->cellOf[i] = slot - 1;
+          ++this->cells[slot - 1].end;
+        }
+
+        // Counting sort of the points by cell
+        uint32_t offset = 0;
+        for (Cell &cell : this->cells)
+        {
+          cell.begin = offset;
+          offset += cell.end;
+          cell.end = cell.begin;
+        }
+        this->xs.resize(offset);
+        this->ys.resize(offset);
+        this->zs.resize(offset);
+        this->indices.resize(offset);
+        for (size_t i = 0; i < _count; ++i)
+        {
+          if (this->cellOf[i] == kNone)
+            continue;
+          const uint32_t s = this->cells[this->cellOf[i]].end++;
+          const Vector3<T> p = _point(i);
+          this->xs[s] = p.X();
+          this->ys[s] = p.Y();
+          this->zs[s] = p.Z();
+          this->indices[s] = i;
+        }
+      }
+
+      /// \brief Call a function on the occupied cells that overlap a box.
+      /// \param[in] _min Minimum corner of the box.
+      /// \param[in] _max Maximum corner of the box.
+      /// \param[in] _visit Function called with each cell.
+      private: template<typename Visit>
+               void ForCellsInBox(const Vector3<T> &_min,
+                   const Vector3<T> &_max, const Visit &_visit) const
+      {
+        int64_t low[3], high[3];
+        double volume = 1;
+        for (int a = 0; a < 3; ++a)
+        {
+          low[a] = std::max(this->lower[a], this->CellCoord(_min[a]));
+          high[a] = std::min(this->upper[a], this->CellCoord(_max[a]));
+          if (low[a] > high[a])
+            return;
+          volume *= static_cast<double>(high[a] - low[a] + 1);
+        }
+
+        // Scan the occupied cells when there are fewer of them than
+        // cells in the box
+        if (volume > static_cast<double>(this->cells.size()))
+        {
+          for (const Cell &cell : this->cells)
+          {
+            if (cell.x >= low[0] && cell.x <= high[0] &&
+                cell.y >= low[1] && cell.y <= high[1] &&
+                cell.z >= low[2] && cell.z <= high[2])
+            {
+              _visit(cell);
+            }
+          }
+          return;
+        }
+
+        for (int64_t z = low[2]; z <= high[2]; ++z)
+        {
+          for (int64_t y = low[1]; y <= high[1]; ++y)
+          {
+            for (int64_t x = low[0]; x <= high[0]; ++x)
+            {
+              const Cell *cell = this->Find(x, y, z);
+              if (cell)
+                _visit(*cell);
+            }
+          }
+        }
+      }
+
+      /// \brief Call a function on the occupied cells whose Chebyshev
+      /// distance from a cell is exactly _ring.
+      /// \param[in] _center Coordinates of the center cell.
+      /// \param[in] _ring Distance in cells.
+      /// \param[in] _visit Function called with each cell.
+      private: template<typename Visit>
+               void ForCellsInShell(const int64_t _center[3],
+                   const int64_t _ring, const Visit &_visit) const
+      {
+        for (int64_t dz = -_ring; dz <= _ring; ++dz)
+        {
+          for (int64_t dy = -_ring; dy <= _ring; ++dy)
+          {
+            // Inside the shell only the two faces along x are visited
+            const bool face = dz == -_ring || dz == _ring ||
+              dy == -_ring || dy == _ring;
+            const int64_t step = (face || _ring == 0) ? 1 : 2 * _ring;
+            for (int64_t dx = -_ring; dx <= _ring; dx += step)
+            {
+              const Cell *cell = this->Find(_center[0] + dx,
+                  _center[1] + dy, _center[2] + dz);
+              if (cell)
+                _visit(*cell);
+            }
+          }
+        }
+      }
+
+      /// \brief Get the cell coordinate of a point coordinate. Coordinates
+      /// far outside the range of int64_t are clamped.
+      /// \param[in] _value Point coordinate.
+      /// \return Cell coordinate.
+      private: int64_t CellCoord(const T _value) const
+      {
+        const double c = std::floor(static_cast<double>(_value) /
+            static_cast<double>(this->cellSize));
+        const double limit = 4.0e18;
+        return static_cast<int64_t>(std::max(-limit, std::min(limit, c)));
+      }
+
+      /// \brief Get the table slot of a cell, which holds one more than
+      /// the index of the cell, or zero if the cell is not occupied.
+      /// \param[in] _x Cell x coordinate.
+      /// \param[in] _y Cell y coordinate.
+      /// \param[in] _z Cell z coordinate.
+      /// \return Reference to the slot.
+      private: uint32_t &Slot(const int64_t _x, const int64_t _y,
+                   const int64_t _z)
+      {
+        const size_t mask = this->table.size() - 1;
+        size_t index = Hash(_x, _y, _z) & mask;
+        while (true)
+        {
+          uint32_t &slot = this->table[index];
+          if (slot == 0)
+            return slot;
+          const Cell &cell = this->cells[slot - 1];
+          if (cell.x == _x && cell.y == _y && cell.z == _z)
+            return slot;
+          index = (index + 1) & mask;
+        }
+      }
+
+      /// \brief Find an occupied cell.
+      /// \param[in] _x Cell x coordinate.
+      /// \param[in] _y Cell y coordinate.
+      /// \param[in] _z Cell z coordinate.
+      /// \return The cell, or nullptr if it holds no points.
+      private: const Cell *Find(const int64_t _x, const int64_t _y,
+                   const int64_t _z) const
+      {
+        if (this->table.empty())
+          return nullptr;
+        const size_t mask = this->table.size() - 1;
+        size_t index = Hash(_x, _y, _z) & mask;
+        while (true)
+        {
+          const uint32_t slot = this->table[index];
+          if (slot == 0)
+            return nullptr;
+          const Cell &cell = this->cells[slot - 1];
+          if (cell.x == _x && cell.y == _y && cell.z == _z)
+            return &cell;
+          index = (index + 1) & mask;
+        }
+      }
+
+      /// \brief Hash cell coordinates.
+      /// \param[in] _x Cell x coordinate.
+      /// \param[in] _y Cell y coordinate.
+      /// \param[in] _z Cell z coordinate.
+      /// \return Hash value.
+      private: static size_t Hash(const int64_t _x, const int64_t _y,
+                   const int64_t _z)
+      {
+        uint64_t h = static_cast<uint64_t>(_x) * 0x9e3779b97f4a7c15ULL ^
+          static_cast<uint64_t>(_y) * 0xc2b2ae3d27d4eb4fULL ^
+          static_cast<uint64_t>(_z) * 0x165667b19e3779f9ULL;
+        h ^= h >> 29;
+        return static_cast<size_t>(h);
+      }
+
+      /// \brief Get the squared distance from a stored point to a point.
+      /// \param[in] _slot Position of the stored point, in cell order.
+      /// \param[in] _p The other point.
+      /// \return Squared distance.
+      private: T Distance2(const uint32_t _slot, const Vector3<T> &_p) const
+      {
+        const T dx = this->xs[_slot] - _p.X();
+        const T dy = this->ys[_slot] - _p.Y();
+        const T dz = this->zs[_slot] - _p.Z();
+        return dx * dx + dy * dy + dz * dz;
+      }
+
+      /// \brief Add the pair of two stored points.
+      /// \param[in] _a Position of the first point, in cell order.
+      /// \param[in] _b Position of the second point, in cell order.
+      /// \param[in,out] _pairs Pairs to add to.
+      private: void AddPair(const uint32_t _a, const uint32_t _b,
+                   std::vector<Pair> &_pairs) const
+      {
+        const size_t a = this->indices[_a];
+        const size_t b = this->indices[_b];
+        _pairs.push_back(a < b ? Pair(a, b) : Pair(b, a));
+      }
+
+      /// \brief Cell index of points that are not in the grid.
+      private: static constexpr uint32_t kNone =
+                   std::numeric_limits<uint32_t>::max();
+
+      /// \brief Edge length of the cells.
+      private: T cellSize = 1;
+
+      /// \brief X coordinates of the points, in cell order.
+      private: std::vector<T> xs;
+
+      /// \brief Y coordinates of the points, in cell order.
+      private: std::vector<T> ys;
+
+      /// \brief Z coordinates of the points, in cell order.
+      private: std::vector<T> zs;
+
+      /// \brief Input index of the points, in cell order.
+      private: std::vector<size_t> indices;
+
+      /// \brief Occupied cells.
+      private: std::vector<Cell> cells;
+
+      /// \brief Open addressing hash table of the cells, with a power of
+      /// two size.
+      private: std::vector<uint32_t> table;
+
+      /// \brief Cell of each input point during a build.
+      private: std::vector<uint32_t> cellOf;
+
+      /// \brief Smallest coordinates of the occupied cells.
+      private: int64_t lower[3] = {0, 0, 0};
+
+      /// \brief Largest coordinates of the occupied cells.
+      private: int64_t upper[3] = {0, 0, 0};
+    };
+
+    typedef SpatialHashGrid<double> SpatialHashGridd;
+    typedef SpatialHashGrid<float> SpatialHashGridf;
+    }
+  }
+}
+#endif
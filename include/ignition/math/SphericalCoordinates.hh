@@ -64,6 +64,39 @@ namespace ignition
                 LOCAL = 4
               };
 
+      /// \enum GeodeticMethod
+      /// \brief Algorithms for converting ECEF positions to geodetic
+      /// latitude, longitude and altitude, trading accuracy for speed.
+      /// The error bounds below were measured on the WGS 84 ellipsoid over
+      /// the full latitude range.
+      public: enum GeodeticMethod
+              {
+                /// \brief Bowring's single-iteration formula, evaluated with
+                /// trigonometric functions. This is the default and matches
+                /// earlier releases. Latitude error is below 2e-13 rad
+                /// (about 1 micrometer) and altitude error below 2e-6 m for
+                /// altitudes within 12 km of the surface, growing to 1e-9
+                /// rad and 1 cm at 1000 km. The altitude loses accuracy
+                /// close to the poles.
+                BOWRING = 1,
+
+                /// \brief The same single Bowring iteration evaluated
+                /// algebraically, without forward trigonometric functions,
+                /// and with an altitude formula that is well conditioned at
+                /// the poles. About three times faster than BOWRING with the
+                /// same latitude error, and altitude error below 1e-8 m up
+                /// to 1000 km.
+                BOWRING_ALGEBRAIC = 2,
+
+                /// \brief Vermeille's closed-form solution (J. Geodesy, 2004),
+                /// exact up to floating point rounding: latitude error below
+                /// 1e-15 rad and altitude error below 1e-7 m at any altitude.
+                /// Points within about 43 km of the center of the Earth,
+                /// where the closed form is not defined, fall back to
+                /// BOWRING_ALGEBRAIC. Similar in cost to BOWRING.
+                VERMEILLE = 3
+              };
+
       /// \brief Constructor.
       public: SphericalCoordinates();
 
@@ -179,6 +212,16 @@ namespace ignition
       public: ignition::math::Vector3d LocalFromGlobalVelocity(
                   const ignition::math::Vector3d &_xyz) const;
 
+      /// \brief Set the algorithm used to convert ECEF positions to
+      /// SPHERICAL coordinates in PositionTransform.
+      /// \param[in] _method Conversion algorithm.
+      public: void SetGeodeticConversion(const GeodeticMethod &_method);
+
+      /// \brief Get the algorithm used to convert ECEF positions to
+      /// SPHERICAL coordinates in PositionTransform.
+      /// \return Conversion algorithm. The default is BOWRING.
+      public: GeodeticMethod GeodeticConversion() const;
+
       /// \brief Update coordinate transformation matrix with reference location
       public: void UpdateTransformationMatrix();
 
@@ -191,6 +234,25 @@ namespace ignition
               PositionTransform(const ignition::math::Vector3d &_pos,
                   const CoordinateType &_in, const CoordinateType &_out) const;
 
+      /// \brief Convert an array of positions between the SPHERICAL, ECEF,
+      /// LOCAL and GLOBAL frames. The result matches calling
+      /// PositionTransform(const Vector3d &, const CoordinateType &,
+      /// const CoordinateType &) on every element, but the frame dispatch
+      /// is done once for the whole array and each stage of the conversion
+      /// runs as a separate loop over contiguous blocks of points, using
+      /// the rotations cached by UpdateTransformationMatrix().
+      /// \param[in] _pos Array of positions in the frame defined by _in.
+      /// \param[out] _result Array that receives the transformed positions.
+      /// It may be the same as _pos.
+      /// \param[in] _size Number of positions.
+      /// \param[in] _in CoordinateType for input
+      /// \param[in] _out CoordinateType for output
+      /// \return False if _in or _out is not a valid CoordinateType, in
+      /// which case _result is not modified.
+      public: bool PositionTransform(const ignition::math::Vector3d *_pos,
+                  ignition::math::Vector3d *_result, const size_t _size,
+                  const CoordinateType &_in, const CoordinateType &_out) const;
+
       /// \brief Convert between velocity in SPHERICAL/ECEF/LOCAL/GLOBAL frame
       /// \param[in] _vel Velocity vector in frame defined by parameter _in
       /// \param[in] _in  CoordinateType for input
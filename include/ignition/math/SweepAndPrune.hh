@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_MATH_SWEEPANDPRUNE_HH_
+#define IGNITION_MATH_SWEEPANDPRUNE_HH_
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Export.hh>
+#include <ignition/math/config.hh>
+
+namespace ignition
+{
+  namespace math
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_MATH_VERSION_NAMESPACE {
+    //
+    // Forward declarations.
+    class SweepAndPrunePrivate;
+
+    /// \class SweepAndPrune SweepAndPrune.hh ignition/math/SweepAndPrune.hh
+    /// \brief Incremental sweep and prune broadphase, which tracks the
+    /// pairs of overlapping boxes in a set of axis aligned boxes.
+    ///
+    /// The minimum and maximum of every box are kept in a sorted endpoint
+    /// array on each of the three axes. When boxes move, Update() restores
+    /// the order with an insertion sort, and each swap of a minimum and a
+    /// maximum is exactly an event where two boxes start or stop
+    /// overlapping along that axis. Boxes that move a little between
+    /// updates only cause a few swaps, so an update costs close to O(n)
+    /// rather than the O(n^2) of checking every pair.
+    ///
+    /// Two boxes overlap when AxisAlignedBox::Intersects is true for them,
+    /// so touching boxes overlap and empty boxes never do.
+    ///
+    /// ## Example
+    ///
+    /// \code{.cpp}
+    /// ignition::math::SweepAndPrune broadphase;
+    /// size_t a = broadphase.Add(boxA);
+    /// size_t b = broadphase.Add(boxB);
+    /// broadphase.Update();
+    ///
+    /// broadphase.Set(a, movedBoxA);
+    /// broadphase.Update();
+    /// for (const auto &pair : broadphase.AddedPairs())
+    ///   std::cout << pair.first << " touches " << pair.second << std::endl;
+    /// \endcode
+    class IGNITION_MATH_VISIBLE SweepAndPrune
+    {
+      /// \brief Identifier returned for boxes that could not be added.
+      public: static constexpr size_t kInvalidId =
+                  std::numeric_limits<size_t>::max();
+
+      /// \brief A pair of box identifiers, with the smaller one first.
+      public: using Pair = std::pair<size_t, size_t>;
+
+      /// \brief Default constructor. There are no boxes.
+      public: SweepAndPrune();
+
+      /// \brief Copy constructor.
+      /// \param[in] _sap Broadphase to copy.
+      public: SweepAndPrune(const SweepAndPrune &_sap);
+
+      /// \brief Destructor.
+      public: ~SweepAndPrune();
+
+      /// \brief Assignment operator.
+      /// \param[in] _sap Broadphase to copy.
+      /// \return Reference to this broadphase.
+      public: SweepAndPrune &operator=(const SweepAndPrune &_sap);
+
+      /// \brief Add a box. Its overlaps are found by the next Update().
+      /// \param[in] _box The box.
+      /// \return Identifier of the box. Identifiers of removed boxes are
+      /// reused, but only after the Update() that reports their removal.
+      public: size_t Add(const AxisAlignedBox &_box);
+
+      /// \brief Move or resize a box. Its overlaps are updated by the next
+      /// Update().
+      /// \param[in] _id Identifier of the box.
+      /// \param[in] _box New value of the box.
+      /// \return False if _id is not a box of this broadphase.
+      public: bool Set(const size_t _id, const AxisAlignedBox &_box);
+
+      /// \brief Remove a box. Its pairs are reported as removed by the next
+      /// Update().
+      /// \param[in] _id Identifier of the box.
+      /// \return False if _id is not a box of this broadphase.
+      public: bool Remove(const size_t _id);
+
+      /// \brief Remove all boxes. The pairs that existed are reported as
+      /// removed by the next Update().
+      public: void Clear();
+
+      /// \brief Check whether an identifier belongs to a box.
+      /// \param[in] _id Identifier to check.
+      /// \return True if _id is a box of this broadphase.
+      public: bool Has(const size_t _id) const;
+
+      /// \brief Get a box.
+      /// \param[in] _id Identifier of the box.
+      /// \return The box, or an empty box if _id is not a box of this
+      /// broadphase.
+      public: AxisAlignedBox Box(const size_t _id) const;
+
+      /// \brief Get the number of boxes.
+      /// \return Number of boxes.
+      public: size_t Size() const;
+
+      /// \brief Bring the overlapping pairs up to date with the boxes that
+      /// were added, moved and removed since the last update.
+      public: void Update();
+
+      /// \brief Get the pairs of boxes that overlap, as of the last
+      /// Update().
+      /// \return The pairs, sorted.
+      public: std::vector<Pair> Pairs() const;
+
+      /// \brief Check whether two boxes overlap, as of the last Update().
+      /// \param[in] _id1 Identifier of the first box.
+      /// \param[in] _id2 Identifier of the second box.
+      /// \return True if the boxes overlap.
+      public: bool Overlapping(const size_t _id1, const size_t _id2) const;
+
+      /// \brief Get the pairs that started to overlap during the last
+      /// Update().
+      /// \return The pairs, sorted.
+      public: const std::vector<Pair> &AddedPairs() const;
+
+      /// \brief Get the pairs that stopped overlapping, including pairs of
+      /// removed boxes, during the last Update().
+      /// \return The pairs, sorted.
+      public: const std::vector<Pair> &RemovedPairs() const;
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::unique_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+      /// \brief Private data pointer.
+      private: std::unique_ptr<SweepAndPrunePrivate> dataPtr;
+#ifdef _WIN32
+#pragma warning(pop)
+#endif
+    };
+    }
+  }
+}
+#endif
@@ -0,0 +1,276 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_MATH_TRAJECTORYLOG_HH_
+#define IGNITION_MATH_TRAJECTORYLOG_HH_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <ignition/math/Export.hh>
+#include <ignition/math/Pose3.hh>
+#include <ignition/math/Vector3.hh>
+#include <ignition/math/config.hh>
+
+namespace ignition
+{
+  namespace math
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_MATH_VERSION_NAMESPACE {
+    //
+    // Forward declarations.
+    class TrajectoryLogWriterPrivate;
+    class TrajectoryLogReaderPrivate;
+
+    /// \enum TrajectoryLogType
+    /// \brief The kind of samples held by a trajectory log.
+    enum TrajectoryLogType
+    {
+      /// \brief Positions, stored as x y z columns.
+      TRAJECTORY_LOG_VECTOR3 = 3,
+
+      /// \brief Poses, stored as x y z qw qx qy qz columns.
+      TRAJECTORY_LOG_POSE3 = 7
+    };
+
+    /// \class TrajectoryLogWriter TrajectoryLog.hh
+    /// ignition/math/TrajectoryLog.hh
+    /// \brief Write a stream of timed positions or poses to a columnar
+    /// file that TrajectoryLogReader maps into memory.
+    ///
+    /// Samples are buffered in a chunk and written when the chunk is full,
+    /// so memory use is bounded by the chunk size whatever the length of
+    /// the log. Within a chunk the values are stored by column: all the
+    /// timestamps, then all the x values, and so on. Closing the log
+    /// writes an index with the time range and offset of every chunk.
+    ///
+    /// All numbers are little endian. The file starts with a 32 byte
+    /// header: "IGNTRAJ" and a zero byte, the version as a uint16, the
+    /// TrajectoryLogType as a byte, a zero byte, the chunk size as a
+    /// uint32 and 16 zero bytes. Each chunk holds its sample count as a
+    /// uint64, the timestamps in nanoseconds as int64 values, then one
+    /// column of doubles per value. The index follows the last chunk with
+    /// four 64 bit numbers per chunk: first time, last time, file offset
+    /// and sample count. The file ends with the offset of the index, the
+    /// number of chunks and "IGNTIDX" and a zero byte.
+    ///
+    /// ## Example
+    ///
+    /// \code{.cpp}
+    /// ignition::math::TrajectoryLogWriter log;
+    /// log.Open("robot.traj", ignition::math::TRAJECTORY_LOG_POSE3);
+    /// log.Append(std::chrono::steady_clock::now(), pose);
+    /// log.Close();
+    /// \endcode
+    class IGNITION_MATH_VISIBLE TrajectoryLogWriter
+    {
+      /// \brief Default number of samples per chunk.
+      public: static constexpr size_t kDefaultChunkSize = 4096;
+
+      /// \brief Constructor.
+      public: TrajectoryLogWriter();
+
+      /// \brief Destructor. Closes the log.
+      public: ~TrajectoryLogWriter();
+
+      /// \brief Create a log file, replacing any existing file. A log that
+      /// is already open is closed first.
+      /// \param[in] _filename Path of the file.
+      /// \param[in] _type The kind of samples.
+      /// \param[in] _chunkSize Number of samples per chunk, at least 1.
+      /// \return False if the file could not be created.
+      public: bool Open(const std::string &_filename,
+                  const TrajectoryLogType _type = TRAJECTORY_LOG_POSE3,
+                  const size_t _chunkSize = kDefaultChunkSize);
+
+      /// \brief Check whether a log is open.
+      /// \return True if a log is open.
+      public: bool IsOpen() const;
+
+      /// \brief Append a pose. Only valid for TRAJECTORY_LOG_POSE3 logs.
+      /// \param[in] _time Time of the sample, which must not be before the
+      /// time of the previous sample, nor before the clock epoch.
+      /// \param[in] _pose The pose.
+      /// \return False if the sample was rejected or writing failed.
+      public: bool Append(const std::chrono::steady_clock::time_point &_time,
+                  const Pose3d &_pose);
+
+      /// \brief Append a position. Only valid for TRAJECTORY_LOG_VECTOR3
+      /// logs.
+      /// \param[in] _time Time of the sample, which must not be before the
+      /// time of the previous sample, nor before the clock epoch.
+      /// \param[in] _position The position.
+      /// \return False if the sample was rejected or writing failed.
+      public: bool Append(const std::chrono::steady_clock::time_point &_time,
+                  const Vector3d &_position);
+
+      /// \brief Get the number of samples appended.
+      /// \return Number of samples.
+      public: size_t Size() const;
+
+      /// \brief Write the buffered samples and the index, and close the
+      /// file.
+      /// \return False if no log was open or writing failed.
+      public: bool Close();
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::unique_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+      /// \brief Private data pointer.
+      private: std::unique_ptr<TrajectoryLogWriterPrivate> dataPtr;
+#ifdef _WIN32
+#pragma warning(pop)
+#endif
+    };
+
+    /// \class TrajectoryLogReader TrajectoryLog.hh
+    /// ignition/math/TrajectoryLog.hh
+    /// \brief Random access to a log written by TrajectoryLogWriter.
+    ///
+    /// The file is mapped into memory, and samples are decoded from the
+    /// mapped columns when they are accessed, so opening a log only reads
+    /// its header and index. Finding a time is a binary search over the
+    /// chunk index and then over the timestamps of one chunk. A log that
+    /// was not closed, for example because the writer crashed, has no
+    /// index; its complete chunks are found by walking the file.
+    ///
+    /// All const functions may be called from several threads at once.
+    class IGNITION_MATH_VISIBLE TrajectoryLogReader
+    {
+      /// \brief The columns of a chunk, in place in the mapped file.
+      public: struct Chunk
+      {
+        /// \brief Number of samples.
+        public: size_t count = 0;
+
+        /// \brief Timestamps in nanoseconds since the clock epoch.
+        public: const int64_t *time = nullptr;
+
+        /// \brief Value columns: x y z, then qw qx qy qz for pose logs.
+        public: const double *columns[7] = {nullptr, nullptr, nullptr,
+                  nullptr, nullptr, nullptr, nullptr};
+      };
+
+      /// \brief Constructor.
+      public: TrajectoryLogReader();
+
+      /// \brief Destructor. Closes the log.
+      public: ~TrajectoryLogReader();
+
+      /// \brief Open a log file. A log that is already open is closed
+      /// first.
+      /// \param[in] _filename Path of the file.
+      /// \return False if the file could not be read or is not a log.
+      public: bool Open(const std::string &_filename);
+
+      /// \brief Close the log and unmap the file.
+      public: void Close();
+
+      /// \brief Check whether a log is open.
+      /// \return True if a log is open.
+      public: bool IsOpen() const;
+
+      /// \brief Get the kind of samples.
+      /// \return The type of the log.
+      public: TrajectoryLogType Type() const;
+
+      /// \brief Get the number of samples.
+      /// \return Number of samples, 0 if no log is open.
+      public: size_t Size() const;
+
+      /// \brief Get the time of the first sample.
+      /// \return The time, or the clock epoch if the log is empty.
+      public: std::chrono::steady_clock::time_point StartTime() const;
+
+      /// \brief Get the time of the last sample.
+      /// \return The time, or the clock epoch if the log is empty.
+      public: std::chrono::steady_clock::time_point EndTime() const;
+
+      /// \brief Get the time of a sample.
+      /// \param[in] _index Index of the sample.
+      /// \param[out] _time The time.
+      /// \return False if the index is out of range.
+      public: bool Time(const size_t _index,
+                  std::chrono::steady_clock::time_point &_time) const;
+
+      /// \brief Get a sample as a pose. Position logs give poses with no
+      /// rotation.
+      /// \param[in] _index Index of the sample.
+      /// \param[out] _pose The pose.
+      /// \return False if the index is out of range.
+      public: bool Pose(const size_t _index, Pose3d &_pose) const;
+
+      /// \brief Get the position of a sample.
+      /// \param[in] _index Index of the sample.
+      /// \param[out] _position The position.
+      /// \return False if the index is out of range.
+      public: bool Position(const size_t _index, Vector3d &_position) const;
+
+      /// \brief Find the last sample at or before a time.
+      /// \param[in] _time The time.
+      /// \param[out] _index Index of the sample.
+      /// \return False if the log is empty or the time is before the first
+      /// sample.
+      public: bool Find(const std::chrono::steady_clock::time_point &_time,
+                  size_t &_index) const;
+
+      /// \brief Get the pose at a time, interpolating linearly between the
+      /// positions and spherically between the rotations of the samples
+      /// around the time.
+      /// \param[in] _time The time.
+      /// \param[out] _pose The pose.
+      /// \return False if the time is outside the log.
+      public: bool Interpolate(
+                  const std::chrono::steady_clock::time_point &_time,
+                  Pose3d &_pose) const;
+
+      /// \brief Get the number of chunks.
+      /// \return Number of chunks.
+      public: size_t ChunkCount() const;
+
+      /// \brief Get the columns of a chunk, for processing samples without
+      /// decoding them. The pointers stay valid until the log is closed.
+      /// \param[in] _chunk Index of the chunk.
+      /// \param[out] _columns The columns.
+      /// \param[out] _first Index of the first sample of the chunk.
+      /// \return False if the index is out of range, or if the machine is
+      /// not little endian, in which case the stored numbers cannot be
+      /// used in place.
+      public: bool ChunkColumns(const size_t _chunk, Chunk &_columns,
+                  size_t &_first) const;
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::unique_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+      /// \brief Private data pointer.
+      private: std::unique_ptr<TrajectoryLogReaderPrivate> dataPtr;
+#ifdef _WIN32
+#pragma warning(pop)
+#endif
+    };
+    }
+  }
+}
+#endif
@@ -17,6 +17,11 @@
 #ifndef IGNITION_MATH_TRIANGLE3_HH_
 #define IGNITION_MATH_TRIANGLE3_HH_
 
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
 #include <ignition/math/Helpers.hh>
 #include <ignition/math/Line3.hh>
 #include <ignition/math/Plane.hh>
@@ -234,6 +239,98 @@ namespace ignition
         return false;
       }
 
+      /// \brief Intersect a ray with this triangle using the watertight
+      /// algorithm from Woop, Benthin and Wald, "Watertight Ray/Triangle
+      /// Intersection" (JCGT 2013).
+      ///
+      /// The ray is sheared so its direction becomes the z-axis, and the
+      /// side of each edge is decided by a 2D edge function. Neighboring
+      /// triangles evaluate their shared edge with the same products, so a
+      /// ray through a shared edge or vertex hits at least one of them and
+      /// never slips between them. Both faces of the triangle are hit, and
+      /// degenerate triangles or rays that lie in the plane of the triangle
+      /// miss. For float triangles the edge functions are evaluated in
+      /// double precision.
+      ///
+      /// \param[in] _origin Origin of the ray.
+      /// \param[in] _dir Direction of the ray, which does not need to be
+      /// normalized.
+      /// \param[out] _t Ray parameter of the hit, so that the hit point is
+      /// _origin + _t * _dir, or infinity on a miss.
+      /// \param[out] _u Barycentric weight of the second point of the
+      /// triangle at the hit, or zero on a miss.
+      /// \param[out] _v Barycentric weight of the third point of the
+      /// triangle at the hit, or zero on a miss.
+      /// \param[in] _tMin Smallest ray parameter to consider.
+      /// \param[in] _tMax Largest ray parameter to consider.
+      /// \return True if the ray hits the triangle with _t in
+      /// [_tMin, _tMax].
+      /// \sa Intersects(const Line3<T> &, Vector3<T> &) const
+      public: bool IntersectWatertight(const Vector3<T> &_origin,
+                  const Vector3<T> &_dir, T &_t, T &_u, T &_v,
+                  const T _tMin = 0,
+                  const T _tMax = std::numeric_limits<T>::infinity()) const
+      {
+        const Shear s = RayShear(_dir);
+        const Vector3<T> a = this->pts[0] - _origin;
+        const Vector3<T> b = this->pts[1] - _origin;
+        const Vector3<T> c = this->pts[2] - _origin;
+        return Watertight(s, a[s.kx], a[s.ky], a[s.kz], b[s.kx], b[s.ky],
+            b[s.kz], c[s.kx], c[s.ky], c[s.kz], _tMin, _tMax, _t, _u, _v);
+      }
+
+      /// \brief Intersect one ray with many triangles stored as a
+      /// structure of arrays. This gives the same results as
+      /// IntersectWatertight(const Vector3<T> &, const Vector3<T> &, T &,
+      /// T &, T &, const T, const T) const on each triangle, but the shear
+      /// of the ray
+      /// is computed once and the loop over the triangles has no branches,
+      /// so compilers can vectorize it.
+      /// \param[in] _origin Origin of the ray.
+      /// \param[in] _dir Direction of the ray.
+      /// \param[in] _p0 Arrays of the x, y and z coordinates of the first
+      /// point of each triangle.
+      /// \param[in] _p1 Arrays of the x, y and z coordinates of the second
+      /// point of each triangle.
+      /// \param[in] _p2 Arrays of the x, y and z coordinates of the third
+      /// point of each triangle.
+      /// \param[in] _count Number of triangles.
+      /// \param[out] _t Array of _count ray parameters. Triangles that are
+      /// missed get infinity.
+      /// \param[out] _u Array of _count barycentric weights of the second
+      /// point. Triangles that are missed get zero.
+      /// \param[out] _v Array of _count barycentric weights of the third
+      /// point. Triangles that are missed get zero.
+      /// \param[in] _tMin Smallest ray parameter to consider.
+      /// \param[in] _tMax Largest ray parameter to consider.
+      /// \return Number of triangles hit.
+      public: static size_t IntersectWatertight(const Vector3<T> &_origin,
+                  const Vector3<T> &_dir, const T *const _p0[3],
+                  const T *const _p1[3], const T *const _p2[3],
+                  const size_t _count, T *_t, T *_u, T *_v,
+                  const T _tMin = 0,
+                  const T _tMax = std::numeric_limits<T>::infinity())
+      {
+        const Shear s = RayShear(_dir);
+        const T ox = _origin[s.kx];
+        const T oy = _origin[s.ky];
+        const T oz = _origin[s.kz];
+        const T *p0x = _p0[s.kx], *p0y = _p0[s.ky], *p0z = _p0[s.kz];
+        const T *p1x = _p1[s.kx], *p1y = _p1[s.ky], *p1z = _p1[s.kz];
+        const T *p2x = _p2[s.kx], *p2y = _p2[s.ky], *p2z = _p2[s.kz];
+
+        size_t hits = 0;
+        for (size_t i = 0; i < _count; ++i)
+        {
+          const bool hit = Watertight(s, p0x[i] - ox, p0y[i] - oy,
+              p0z[i] - oz, p1x[i] - ox, p1y[i] - oy, p1z[i] - oz,
+              p2x[i] - ox, p2y[i] - oy, p2z[i] - oz, _tMin, _tMax, _t[i],
+              _u[i], _v[i]);
+          hits += hit ? 1 : 0;
+        }
+        return hits;
+      }
+
       /// \brief Get the length of the triangle's perimeter.
       /// \return Sum of the triangle's line segments.
       public: T Perimeter() const
@@ -265,6 +362,112 @@ namespace ignition
         return this->pts[clamp(_index, IGN_ZERO_SIZE_T, IGN_TWO_SIZE_T)];
       }
 
+      /// \brief Permutation and shear that map a ray direction to the
+      /// z-axis.
+      private: struct Shear
+      {
+        /// \brief Axis that becomes x.
+        int kx;
+
+        /// \brief Axis that becomes y.
+        int ky;
+
+        /// \brief Axis with the largest direction component, which
+        /// becomes z.
+        int kz;
+
+        /// \brief Shear along x.
+        T sx;
+
+        /// \brief Shear along y.
+        T sy;
+
+        /// \brief Scale along z.
+        T sz;
+      };
+
+      /// \brief Compute the shear of a ray direction.
+      /// \param[in] _dir Ray direction.
+      /// \return The shear. A zero direction gives non-finite factors,
+      /// which make every test miss.
+      private: static Shear RayShear(const Vector3<T> &_dir)
+      {
+        int kz = 0;
+        if (std::abs(_dir[1]) > std::abs(_dir[kz]))
+          kz = 1;
+        if (std::abs(_dir[2]) > std::abs(_dir[kz]))
+          kz = 2;
+        int kx = (kz + 1) % 3;
+        int ky = (kx + 1) % 3;
+
+        // Keep the winding of the edge functions
+        if (_dir[kz] < 0)
+          std::swap(kx, ky);
+
+        const T sz = T(1) / _dir[kz];
+        return {kx, ky, kz, _dir[kx] * sz, _dir[ky] * sz, sz};
+      }
+
+      /// \brief Watertight test on the points of a triangle relative to
+      /// the ray origin, given along the permuted axes of the shear. The
+      /// body has no branches so it can be inlined into vectorized loops.
+      /// \param[in] _s Shear of the ray.
+      /// \param[in] _ax First point, along kx.
+      /// \param[in] _ay First point, along ky.
+      /// \param[in] _az First point, along kz.
+      /// \param[in] _bx Second point, along kx.
+      /// \param[in] _by Second point, along ky.
+      /// \param[in] _bz Second point, along kz.
+      /// \param[in] _cx Third point, along kx.
+      /// \param[in] _cy Third point, along ky.
+      /// \param[in] _cz Third point, along kz.
+      /// \param[in] _tMin Smallest ray parameter to consider.
+      /// \param[in] _tMax Largest ray parameter to consider.
+      /// \param[out] _t Ray parameter, or infinity on a miss.
+      /// \param[out] _u Barycentric weight of the second point, or zero on
+      /// a miss.
+      /// \param[out] _v Barycentric weight of the third point, or zero on
+      /// a miss.
+      /// \return True on a hit.
+      private: static bool Watertight(const Shear &_s, const T _ax,
+                   const T _ay, const T _az, const T _bx, const T _by,
+                   const T _bz, const T _cx, const T _cy, const T _cz,
+                   const T _tMin, const T _tMax, T &_t, T &_u, T &_v)
+      {
+        // Products of floats are exact in double, which removes the
+        // rounding that would otherwise make edge functions vanish
+        using Wide = typename std::conditional<
+          std::is_same<T, float>::value, double, T>::type;
+
+        const Wide ax = _ax - _s.sx * _az;
+        const Wide ay = _ay - _s.sy * _az;
+        const Wide bx = _bx - _s.sx * _bz;
+        const Wide by = _by - _s.sy * _bz;
+        const Wide cx = _cx - _s.sx * _cz;
+        const Wide cy = _cy - _s.sy * _cz;
+
+        // Scaled barycentric coordinates
+        const Wide e0 = cx * by - cy * bx;
+        const Wide e1 = ax * cy - ay * cx;
+        const Wide e2 = bx * ay - by * ax;
+        const bool negative = (e0 < 0) | (e1 < 0) | (e2 < 0);
+        const bool positive = (e0 > 0) | (e1 > 0) | (e2 > 0);
+
+        const Wide det = e0 + e1 + e2;
+        const Wide scaledT = (e0 * _az + e1 * _bz + e2 * _cz) * _s.sz;
+        const Wide invDet = Wide(1) / det;
+        const T t = static_cast<T>(scaledT * invDet);
+
+        // Comparisons are written so that NaN misses
+        const bool inside = !(negative & positive);
+        const bool nonZero = (det < 0) | (det > 0);
+        const bool hit = inside & nonZero & (t >= _tMin) & (t <= _tMax);
+        _t = hit ? t : std::numeric_limits<T>::infinity();
+        _u = hit ? static_cast<T>(e1 * invDet) : T(0);
+        _v = hit ? static_cast<T>(e2 * invDet) : T(0);
+        return hit;
+      }
+
       /// The points of the triangle
       private: Vector3<T> pts[3];
     };
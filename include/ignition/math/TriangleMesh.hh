@@ -0,0 +1,269 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#ifndef IGNITION_MATH_TRIANGLEMESH_HH_
+#define IGNITION_MATH_TRIANGLEMESH_HH_
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <vector>
+#include <ignition/math/AxisAlignedBox.hh>
+#include <ignition/math/Export.hh>
+#include <ignition/math/Line3.hh>
+#include <ignition/math/Triangle3.hh>
+#include <ignition/math/Vector3.hh>
+#include <ignition/math/config.hh>
+
+namespace ignition
+{
+  namespace math
+  {
+    // Inline bracket to help doxygen filtering.
+    inline namespace IGNITION_MATH_VERSION_NAMESPACE {
+    //
+    // Forward declarations.
+    class TriangleMeshPrivate;
+
+    /// \class TriangleMesh TriangleMesh.hh ignition/math/TriangleMesh.hh
+    /// \brief An indexed triangle mesh with a bounding volume hierarchy
+    /// (BVH) over its triangles, for ray casting and nearest point queries.
+    ///
+    /// The hierarchy is built with binned surface area heuristic splits
+    /// when the mesh is set, and the triangles are stored in hierarchy
+    /// order so that a query touches contiguous memory. Queries are const
+    /// and keep no state, so a single mesh can be queried from any number
+    /// of threads at once. A single thread casts a few million rays per
+    /// second on meshes of around 10^5 triangles, more with the packet
+    /// forms, so higher ray rates need several threads.
+    ///
+    /// Rays are given as an origin and a direction, and a ray hit is
+    /// reported with the parameter t such that the hit point is
+    /// origin + t * direction. Segments are rays with a direction of
+    /// B - A and t in [0, 1].
+    ///
+    /// ## Example
+    ///
+    /// \code{.cpp}
+    /// ignition::math::TriangleMesh mesh(vertices, indices);
+    /// ignition::math::TriangleMesh::RayHit hit;
+    /// if (mesh.RayCast(origin, direction, hit))
+    ///   std::cout << "Range: " << hit.t * direction.Length() << std::endl;
+    /// \endcode
+    class IGNITION_MATH_VISIBLE TriangleMesh
+    {
+      /// \brief Triangle index used for queries that found no triangle.
+      public: static constexpr size_t kNoTriangle =
+                  std::numeric_limits<size_t>::max();
+
+      /// \brief Result of a ray query.
+      public: struct RayHit
+      {
+        /// \brief Ray parameter of the hit, or infinity if there is no hit.
+        public: double t = std::numeric_limits<double>::infinity();
+
+        /// \brief Hit point.
+        public: Vector3d point;
+
+        /// \brief Unit normal of the triangle that was hit, following the
+        /// right hand rule on the triangle's vertex order.
+        public: Vector3d normal;
+
+        /// \brief Index of the triangle that was hit, or kNoTriangle.
+        public: size_t triangle = kNoTriangle;
+
+        /// \brief Barycentric weight of the triangle's second vertex.
+        public: double u = 0;
+
+        /// \brief Barycentric weight of the triangle's third vertex.
+        public: double v = 0;
+      };
+
+      /// \brief Result of a nearest point query.
+      public: struct PointHit
+      {
+        /// \brief Distance from the query point to the mesh, or infinity
+        /// if no triangle is in range.
+        public: double distance = std::numeric_limits<double>::infinity();
+
+        /// \brief Nearest point on the mesh.
+        public: Vector3d point;
+
+        /// \brief Index of the triangle that holds the nearest point, or
+        /// kNoTriangle.
+        public: size_t triangle = kNoTriangle;
+
+        /// \brief Barycentric weight of the triangle's second vertex.
+        public: double u = 0;
+
+        /// \brief Barycentric weight of the triangle's third vertex.
+        public: double v = 0;
+      };
+
+      /// \brief Default constructor. The mesh is empty.
+      public: TriangleMesh();
+
+      /// \brief Create a mesh and build its hierarchy.
+      /// \param[in] _vertices Vertex positions.
+      /// \param[in] _indices Three vertex indices per triangle.
+      /// \sa Set(const std::vector<Vector3d> &,
+      /// const std::vector<unsigned int> &)
+      public: TriangleMesh(const std::vector<Vector3d> &_vertices,
+                  const std::vector<unsigned int> &_indices);
+
+      /// \brief Copy constructor.
+      /// \param[in] _mesh Mesh to copy.
+      public: TriangleMesh(const TriangleMesh &_mesh);
+
+      /// \brief Destructor.
+      public: ~TriangleMesh();
+
+      /// \brief Assignment operator.
+      /// \param[in] _mesh Mesh to copy.
+      /// \return Reference to this mesh.
+      public: TriangleMesh &operator=(const TriangleMesh &_mesh);
+
+      /// \brief Set the vertices and triangles of the mesh and rebuild its
+      /// hierarchy. Building takes O(n log n) time in the number of
+      /// triangles.
+      /// \param[in] _vertices Vertex positions.
+      /// \param[in] _indices Three vertex indices per triangle.
+      /// \return False, leaving the mesh empty, if the number of indices
+      /// is not a multiple of three or an index is out of range.
+      public: bool Set(const std::vector<Vector3d> &_vertices,
+                  const std::vector<unsigned int> &_indices);
+
+      /// \brief Get the vertex positions.
+      /// \return The vertices of the mesh.
+      public: const std::vector<Vector3d> &Vertices() const;
+
+      /// \brief Get the vertex indices, three per triangle.
+      /// \return The indices of the mesh.
+      public: const std::vector<unsigned int> &Indices() const;
+
+      /// \brief Get the number of triangles.
+      /// \return Number of triangles.
+      public: size_t TriangleCount() const;
+
+      /// \brief Get a triangle of the mesh.
+      /// \param[in] _index Index of the triangle.
+      /// \return The triangle, or a default triangle if _index is out of
+      /// range.
+      public: Triangle3d Triangle(const size_t _index) const;
+
+      /// \brief Get the bounding box of the mesh.
+      /// \return Bounding box of all triangles, which is empty for an
+      /// empty mesh.
+      public: AxisAlignedBox BoundingBox() const;
+
+      /// \brief Find the first triangle hit by a ray.
+      /// \param[in] _origin Origin of the ray.
+      /// \param[in] _dir Direction of the ray, which does not need to be
+      /// normalized.
+      /// \param[out] _hit The nearest hit, only set if the return value is
+      /// true.
+      /// \param[in] _minT Smallest ray parameter to consider.
+      /// \param[in] _maxT Largest ray parameter to consider.
+      /// \return True if a triangle is hit with t in [_minT, _maxT].
+      public: bool RayCast(const Vector3d &_origin, const Vector3d &_dir,
+                  RayHit &_hit, const double _minT = 0,
+                  const double _maxT =
+                      std::numeric_limits<double>::infinity()) const;
+
+      /// \brief Find the first triangle hit by a segment, from its first
+      /// point towards its second.
+      /// \param[in] _segment Segment to check.
+      /// \param[out] _hit The nearest hit, with t in [0, 1], only set if
+      /// the return value is true.
+      /// \return True if the segment hits a triangle.
+      public: bool RayCast(const Line3d &_segment, RayHit &_hit) const;
+
+      /// \brief Cast a packet of rays. Rays are traversed through the
+      /// hierarchy in groups of eight, so coherent rays such as those of a
+      /// depth camera share most of the node visits. The results are the
+      /// same as casting each ray on its own.
+      /// \param[in] _origins Origins of the rays.
+      /// \param[in] _dirs Directions of the rays.
+      /// \param[in] _count Number of rays.
+      /// \param[out] _hits Array of _count hits. Rays that miss get a
+      /// default RayHit, with infinite t and kNoTriangle.
+      /// \param[in] _minT Smallest ray parameter to consider.
+      /// \param[in] _maxT Largest ray parameter to consider.
+      /// \return Number of rays that hit a triangle.
+      public: size_t RayCast(const Vector3d *_origins, const Vector3d *_dirs,
+                  const size_t _count, RayHit *_hits, const double _minT = 0,
+                  const double _maxT =
+                      std::numeric_limits<double>::infinity()) const;
+
+      /// \brief Check whether any triangle blocks a ray. This stops at the
+      /// first hit that is found, and is faster than RayCast.
+      /// \param[in] _origin Origin of the ray.
+      /// \param[in] _dir Direction of the ray.
+      /// \param[in] _minT Smallest ray parameter to consider.
+      /// \param[in] _maxT Largest ray parameter to consider.
+      /// \return True if a triangle is hit with t in [_minT, _maxT].
+      public: bool Occluded(const Vector3d &_origin, const Vector3d &_dir,
+                  const double _minT = 0,
+                  const double _maxT =
+                      std::numeric_limits<double>::infinity()) const;
+
+      /// \brief Check whether any triangle blocks a segment.
+      /// \param[in] _segment Segment to check.
+      /// \return True if a triangle intersects the segment.
+      public: bool Occluded(const Line3d &_segment) const;
+
+      /// \brief Check a packet of rays for occlusion, eight at a time.
+      /// \param[in] _origins Origins of the rays.
+      /// \param[in] _dirs Directions of the rays.
+      /// \param[in] _count Number of rays.
+      /// \param[out] _occluded Array of _count flags, set to true for rays
+      /// that are blocked.
+      /// \param[in] _minT Smallest ray parameter to consider.
+      /// \param[in] _maxT Largest ray parameter to consider.
+      /// \return Number of rays that are blocked.
+      public: size_t Occluded(const Vector3d *_origins,
+                  const Vector3d *_dirs, const size_t _count,
+                  bool *_occluded, const double _minT = 0,
+                  const double _maxT =
+                      std::numeric_limits<double>::infinity()) const;
+
+      /// \brief Find the point on the mesh nearest to a query point.
+      /// \param[in] _point Query point.
+      /// \param[out] _hit The nearest point, only set if the return value
+      /// is true.
+      /// \param[in] _maxDistance Only consider triangles within this
+      /// distance of the query point.
+      /// \return True if a triangle is within _maxDistance.
+      public: bool ClosestPoint(const Vector3d &_point, PointHit &_hit,
+                  const double _maxDistance =
+                      std::numeric_limits<double>::infinity()) const;
+
+#ifdef _WIN32
+// Disable warning C4251 which is triggered by
+// std::unique_ptr
+#pragma warning(push)
+#pragma warning(disable: 4251)
+#endif
+      /// \brief Private data pointer.
+      private: std::unique_ptr<TriangleMeshPrivate> dataPtr;
+#ifdef _WIN32
+#pragma warning(pop)
+#endif
+    };
+    }
+  }
+}
+#endif
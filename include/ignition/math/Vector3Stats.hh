@@ -47,6 +47,12 @@ namespace ignition
       /// \param[in] _data New signal data point.
       public: void InsertData(const Vector3d &_data);
 
+      /// \brief Add a batch of samples to the statistical measures.
+      /// \param[in] _data Pointer to the first data point.
+      /// \param[in] _size Number of data points.
+      /// \sa SignalStats::InsertData(const double *, const size_t)
+      public: void InsertData(const Vector3d *_data, const size_t _size);
+
       /// \brief Add a new type of statistic.
       /// \param[in] _name Short name of new statistic.
       /// Valid values include:
@@ -17,11 +17,15 @@
 #ifndef IGNITION_MATH_GRAPH_GRAPH_HH_
 #define IGNITION_MATH_GRAPH_GRAPH_HH_
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <map>
 #include <set>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -128,6 +132,53 @@ namespace graph
       }
     }
 
+    /// \brief Create a graph from vertices sorted by Id, building the
+    /// internal structures in one pass. This is much faster than adding
+    /// the vertices and edges one by one when loading large graphs.
+    ///
+    /// A vertex with Id kNullId gets the Id following the previous vertex,
+    /// so vertices that all use the default Id are numbered from 0. Vertices
+    /// whose Id is not greater than the previous Id are ignored. Edges get
+    /// Ids from 0 in the order given; edges whose vertices do not exist are
+    /// ignored. For valid input the result is the same as with the
+    /// constructor taking vertices and edges.
+    /// \param[in] _vertices Vertices, sorted by Id.
+    /// \param[in] _edges Edges between the vertices.
+    /// \return The new graph.
+    public: static Graph FromSorted(const std::vector<Vertex<V>> &_vertices,
+                const std::vector<EdgeInitializer<E>> &_edges)
+    {
+      Graph graph;
+      SortedIndex index;
+      index.ids.reserve(_vertices.size());
+      index.adjacency.reserve(_vertices.size());
+      for (auto const &v : _vertices)
+      {
+        if (!graph.AddSortedVertex(v.Name(), v.Data(), v.Id(), index))
+        {
+          std::cerr << "[Graph::FromSorted()] Vertex with Id [" << v.Id()
+                    << "] is out of order. Ignoring." << std::endl;
+        }
+      }
+
+      EdgeId id = 0;
+      for (auto const &e : _edges)
+      {
+        if (graph.AddSortedEdge(EdgeType(e.vertices, e.data, e.weight, id),
+              index))
+        {
+          ++id;
+        }
+        else
+        {
+          std::cerr << "[Graph::FromSorted()] Ignoring edge" << std::endl;
+        }
+      }
+
+      graph.FinishSorted();
+      return graph;
+    }
+
     /// \brief Add a new vertex to the graph.
     /// \param[in] _name Name of the vertex. It doesn't have to be unique.
     /// \param[in] _data Data to be stored in the vertex.
@@ -681,6 +732,210 @@ namespace graph
       return iter->second;
     }
 
+    /// \brief Write the graph in a compact binary format that Load()
+    /// reads back. Vertex and edge data are copied byte for byte, so V and
+    /// E must be trivially copyable, and the file can only be loaded on a
+    /// machine with the same byte order.
+    ///
+    /// The file starts with a 48 byte header: "IGNGRAPH", the format
+    /// version as a uint16, 1 for directed or 0 for undirected edges as a
+    /// byte, 1 for little or 2 for big endian as a byte, the sizes of V and
+    /// E as uint32 values, 4 zero bytes, then the number of vertices, the
+    /// number of edges and the size of the name table as uint64 values.
+    /// The name table follows, padded to a multiple of 8 bytes, then one
+    /// record per vertex in Id order: Id, name offset and name length as
+    /// uint64 values and the data. Last comes one record per edge in Id
+    /// order: Id and the two vertex Ids as uint64 values, the weight as a
+    /// double and the data. Data are padded to a multiple of 8 bytes, so
+    /// every record has a fixed size and is aligned in the file.
+    /// \param[out] _out Stream to write to, opened in binary mode.
+    /// \return False if writing failed.
+    public: bool Save(std::ostream &_out) const
+    {
+      static_assert(std::is_trivially_copyable<V>::value,
+          "Graph::Save() needs trivially copyable vertex data");
+      static_assert(std::is_trivially_copyable<E>::value,
+          "Graph::Save() needs trivially copyable edge data");
+
+      uint64_t nameBytes = 0;
+      for (auto const &v : this->vertices)
+        nameBytes += v.second.Name().size();
+
+      std::vector<char> buffer;
+      buffer.reserve(kIoBufferSize);
+      buffer.insert(buffer.end(), kFileMagic, kFileMagic + 8);
+      Put(buffer, kFileVersion);
+      Put(buffer, static_cast<uint8_t>(IsDirected() ? 1 : 0));
+      Put(buffer, HostByteOrder());
+      Put(buffer, static_cast<uint32_t>(sizeof(V)));
+      Put(buffer, static_cast<uint32_t>(sizeof(E)));
+      Put(buffer, static_cast<uint32_t>(0));
+      Put(buffer, static_cast<uint64_t>(this->vertices.size()));
+      Put(buffer, static_cast<uint64_t>(this->edges.size()));
+      Put(buffer, nameBytes);
+
+      auto flush = [&](const size_t _needed)
+      {
+        if (buffer.size() + _needed > kIoBufferSize)
+        {
+          _out.write(buffer.data(), static_cast<std::streamsize>(
+                buffer.size()));
+          buffer.clear();
+        }
+      };
+
+      for (auto const &v : this->vertices)
+      {
+        const std::string &name = v.second.Name();
+        flush(name.size());
+        if (name.size() > kIoBufferSize)
+          _out.write(name.data(), static_cast<std::streamsize>(name.size()));
+        else
+          buffer.insert(buffer.end(), name.begin(), name.end());
+      }
+      flush(kIoBufferSize);
+      buffer.resize(Padding(nameBytes), 0);
+
+      uint64_t nameOffset = 0;
+      for (auto const &v : this->vertices)
+      {
+        flush(kVertexRecordSize);
+        Put(buffer, static_cast<uint64_t>(v.first));
+        Put(buffer, nameOffset);
+        Put(buffer, static_cast<uint64_t>(v.second.Name().size()));
+        Put(buffer, v.second.Data());
+        buffer.resize(buffer.size() + Padding(sizeof(V)), 0);
+        nameOffset += v.second.Name().size();
+      }
+
+      for (auto const &e : this->edges)
+      {
+        flush(kEdgeRecordSize);
+        const VertexId_P ends = e.second.Vertices();
+        Put(buffer, static_cast<uint64_t>(e.first));
+        Put(buffer, static_cast<uint64_t>(ends.first));
+        Put(buffer, static_cast<uint64_t>(ends.second));
+        Put(buffer, e.second.Weight());
+        Put(buffer, e.second.Data());
+        buffer.resize(buffer.size() + Padding(sizeof(E)), 0);
+      }
+      flush(kIoBufferSize);
+
+      return static_cast<bool>(_out);
+    }
+
+    /// \brief Replace the graph with one written by Save(). The vertices
+    /// and edges keep their Ids and are added in one pass, as with
+    /// FromSorted().
+    /// \param[in] _in Stream to read from, opened in binary mode.
+    /// \return False if the stream does not hold a graph of this type, in
+    /// which case the graph is not changed.
+    public: bool Load(std::istream &_in)
+    {
+      static_assert(std::is_trivially_copyable<V>::value,
+          "Graph::Load() needs trivially copyable vertex data");
+      static_assert(std::is_trivially_copyable<E>::value,
+          "Graph::Load() needs trivially copyable edge data");
+
+      char header[kFileHeaderSize];
+      if (!_in.read(header, sizeof(header)) ||
+          std::memcmp(header, kFileMagic, 8) != 0)
+      {
+        std::cerr << "[Graph::Load()] Not a graph file" << std::endl;
+        return false;
+      }
+
+      const char *field = header + 8;
+      const uint16_t version = Get<uint16_t>(field);
+      const uint8_t directed = Get<uint8_t>(field);
+      const uint8_t byteOrder = Get<uint8_t>(field);
+      const uint32_t vertexDataSize = Get<uint32_t>(field);
+      const uint32_t edgeDataSize = Get<uint32_t>(field);
+      Get<uint32_t>(field);
+      const uint64_t vertexCount = Get<uint64_t>(field);
+      const uint64_t edgeCount = Get<uint64_t>(field);
+      const uint64_t nameBytes = Get<uint64_t>(field);
+      if (version != kFileVersion)
+      {
+        std::cerr << "[Graph::Load()] Unsupported graph file version ["
+                  << version << "]" << std::endl;
+        return false;
+      }
+      if ((directed == 1) != IsDirected() || byteOrder != HostByteOrder() ||
+          vertexDataSize != sizeof(V) || edgeDataSize != sizeof(E))
+      {
+        std::cerr << "[Graph::Load()] The file holds a different type of "
+                  << "graph, or was written on a machine with a different "
+                  << "byte order" << std::endl;
+        return false;
+      }
+
+      // Grow the name table while reading, so that a corrupt size fails
+      // at the end of the stream instead of allocating it all
+      std::string nameTable;
+      for (uint64_t done = 0; done < nameBytes;)
+      {
+        const size_t size = static_cast<size_t>(std::min<uint64_t>(
+              nameBytes - done, kIoBufferSize));
+        nameTable.resize(static_cast<size_t>(done) + size);
+        if (!_in.read(&nameTable[static_cast<size_t>(done)],
+              static_cast<std::streamsize>(size)))
+        {
+          break;
+        }
+        done += size;
+      }
+      char padding[8];
+      if (!_in || !_in.read(padding, Padding(nameBytes)))
+      {
+        std::cerr << "[Graph::Load()] Truncated graph file" << std::endl;
+        return false;
+      }
+
+      Graph graph;
+      SortedIndex index;
+      std::vector<char> buffer;
+      const bool verticesOk = ReadRecords(_in, vertexCount,
+          kVertexRecordSize, buffer, [&](const char *_record)
+          {
+            const VertexId id = Get<uint64_t>(_record);
+            const uint64_t offset = Get<uint64_t>(_record);
+            const uint64_t length = Get<uint64_t>(_record);
+            if (id == kNullId || offset > nameTable.size() ||
+                length > nameTable.size() - offset)
+            {
+              return false;
+            }
+            return graph.AddSortedVertex(
+                nameTable.substr(static_cast<size_t>(offset),
+                  static_cast<size_t>(length)),
+                Get<V>(_record), id, index);
+          });
+
+      const bool edgesOk = verticesOk && ReadRecords(_in, edgeCount,
+          kEdgeRecordSize, buffer, [&](const char *_record)
+          {
+            const EdgeId id = Get<uint64_t>(_record);
+            VertexId_P ends;
+            ends.first = Get<uint64_t>(_record);
+            ends.second = Get<uint64_t>(_record);
+            const double weight = Get<double>(_record);
+            return id != kNullId && graph.AddSortedEdge(
+                EdgeType(ends, Get<E>(_record), weight, id), index);
+          });
+
+      if (!edgesOk)
+      {
+        std::cerr << "[Graph::Load()] Corrupt or truncated graph file"
+                  << std::endl;
+        return false;
+      }
+
+      graph.FinishSorted();
+      *this = std::move(graph);
+      return true;
+    }
+
     /// \brief Stream insertion operator. The output uses DOT graph
     /// description language.
     /// \param[out] _out The output stream.
@@ -690,6 +945,180 @@ namespace graph
     friend std::ostream &operator<<(std::ostream &_out,
                                     const Graph<VV, EE, EEdgeType> &_g);
 
+    /// \brief Vertex Ids and adjacency sets of a graph being built by
+    /// FromSorted() or Load(), in Id order.
+    private: struct SortedIndex
+    {
+      /// \brief Vertex Ids.
+      public: std::vector<VertexId> ids;
+
+      /// \brief Adjacency set of each vertex.
+      public: std::vector<EdgeId_S *> adjacency;
+
+      /// \brief Find the adjacency set of a vertex.
+      /// \param[in] _id Vertex Id.
+      /// \return The set, or nullptr if the vertex does not exist.
+      public: EdgeId_S *Find(const VertexId _id) const
+      {
+        // Vertices are usually numbered from 0 without gaps
+        if (_id < this->ids.size() && this->ids[_id] == _id)
+          return this->adjacency[_id];
+
+        auto it = std::lower_bound(this->ids.begin(), this->ids.end(), _id);
+        if (it == this->ids.end() || *it != _id)
+          return nullptr;
+        return this->adjacency[it - this->ids.begin()];
+      }
+    };
+
+    /// \brief Add a vertex with a greater Id than every other vertex,
+    /// inserting it at the end of the maps.
+    /// \param[in] _name Name of the vertex.
+    /// \param[in] _data Data to be stored in the vertex.
+    /// \param[in] _id Id of the vertex, or kNullId to use the Id following
+    /// the last vertex.
+    /// \param[in,out] _index Index of the vertices added so far.
+    /// \return False if the Id is not greater than the last Id.
+    private: bool AddSortedVertex(const std::string &_name, const V &_data,
+                 VertexId _id, SortedIndex &_index)
+    {
+      if (_id == kNullId)
+        _id = _index.ids.empty() ? 0 : _index.ids.back() + 1;
+      if (_id == kNullId || (!_index.ids.empty() && _id <= _index.ids.back()))
+        return false;
+
+      this->vertices.emplace_hint(this->vertices.end(), _id,
+          Vertex<V>(_name, _data, _id));
+      auto adjIt = this->adjList.emplace_hint(this->adjList.end(), _id,
+          EdgeId_S());
+      this->names.emplace(_name, _id);
+      _index.ids.push_back(_id);
+      _index.adjacency.push_back(&adjIt->second);
+      return true;
+    }
+
+    /// \brief Link an edge with a greater Id than every other edge,
+    /// inserting it at the end of the maps and adjacency sets.
+    /// \param[in] _edge The edge.
+    /// \param[in] _index Index of the vertices.
+    /// \return False if the Id is not greater than the last Id or a vertex
+    /// of the edge does not exist.
+    private: bool AddSortedEdge(EdgeType &&_edge, const SortedIndex &_index)
+    {
+      const EdgeId id = _edge.Id();
+      if (!this->edges.empty() && id <= this->edges.rbegin()->first)
+        return false;
+
+      const VertexId_P ends = _edge.Vertices();
+      EdgeId_S *first = _index.Find(ends.first);
+      EdgeId_S *second = _index.Find(ends.second);
+      if (!first || !second)
+        return false;
+
+      first->insert(first->end(), id);
+      second->insert(second->end(), id);
+      this->edges.emplace_hint(this->edges.end(), id, std::move(_edge));
+      return true;
+    }
+
+    /// \brief Set the next Ids after FromSorted() or Load() added the
+    /// vertices and edges.
+    private: void FinishSorted()
+    {
+      // Fall back to searching from 0 when the last Id is the largest one
+      this->nextVertexId = 0;
+      if (!this->vertices.empty() &&
+          this->vertices.rbegin()->first + 1 < MAX_UI64)
+      {
+        this->nextVertexId = this->vertices.rbegin()->first + 1;
+      }
+
+      this->nextEdgeId = 0;
+      if (!this->edges.empty() && this->edges.rbegin()->first + 1 < MAX_UI64)
+        this->nextEdgeId = this->edges.rbegin()->first + 1;
+    }
+
+    /// \brief Read fixed size records, a block at a time.
+    /// \param[in] _in Stream to read from.
+    /// \param[in] _count Number of records.
+    /// \param[in] _size Size of a record in bytes.
+    /// \param[in] _buffer Buffer for a block of records.
+    /// \param[in] _record Function called with each record, which returns
+    /// false if the record is invalid.
+    /// \return False if reading failed or a record was invalid.
+    private: template<typename RecordFn>
+    static bool ReadRecords(std::istream &_in, const uint64_t _count,
+        const size_t _size, std::vector<char> &_buffer, RecordFn _record)
+    {
+      const uint64_t perBlock = kIoBufferSize / _size;
+      for (uint64_t done = 0; done < _count;)
+      {
+        const size_t block = static_cast<size_t>(
+            std::min<uint64_t>(_count - done, perBlock));
+        _buffer.resize(block * _size);
+        if (!_in.read(_buffer.data(),
+              static_cast<std::streamsize>(_buffer.size())))
+        {
+          return false;
+        }
+        for (size_t i = 0; i < block; ++i)
+        {
+          if (!_record(_buffer.data() + i * _size))
+            return false;
+        }
+        done += block;
+      }
+      return true;
+    }
+
+    /// \brief Append the bytes of a value to a buffer.
+    /// \param[in,out] _buffer The buffer.
+    /// \param[in] _value The value.
+    private: template<typename T>
+    static void Put(std::vector<char> &_buffer, const T &_value)
+    {
+      const size_t size = _buffer.size();
+      _buffer.resize(size + sizeof(T));
+      std::memcpy(_buffer.data() + size, &_value, sizeof(T));
+    }
+
+    /// \brief Read a value and advance past it.
+    /// \param[in,out] _bytes Location of the value.
+    /// \return The value.
+    private: template<typename T>
+    static T Get(const char *&_bytes)
+    {
+      T value;
+      std::memcpy(&value, _bytes, sizeof(T));
+      _bytes += sizeof(T);
+      return value;
+    }
+
+    /// \brief Get the number of bytes padding a size to a multiple of 8.
+    /// \param[in] _size The size.
+    /// \return Number of padding bytes.
+    private: static size_t Padding(const uint64_t _size)
+    {
+      return static_cast<size_t>((8 - _size % 8) % 8);
+    }
+
+    /// \brief Get whether the edges are directed.
+    /// \return True for directed graphs.
+    private: static bool IsDirected()
+    {
+      return std::is_same<EdgeType, DirectedEdge<E>>::value;
+    }
+
+    /// \brief Get the byte order of this machine.
+    /// \return 1 for little endian, 2 for big endian.
+    private: static uint8_t HostByteOrder()
+    {
+      const uint16_t probe = 1;
+      uint8_t first;
+      std::memcpy(&first, &probe, 1);
+      return first == 1 ? 1 : 2;
+    }
+
     /// \brief Get an available Id to be assigned to a new vertex.
     /// \return The next available Id or kNullId if there aren't ids available.
     private: VertexId &NextVertexId()
@@ -716,6 +1145,26 @@ namespace graph
       return this->nextEdgeId;
     }
 
+    /// \brief Magic bytes at the start of a graph file.
+    private: static constexpr char kFileMagic[9] = "IGNGRAPH";
+
+    /// \brief Graph file format version.
+    private: static constexpr uint16_t kFileVersion = 1;
+
+    /// \brief Size of the graph file header in bytes.
+    private: static constexpr size_t kFileHeaderSize = 48;
+
+    /// \brief Size of a vertex record in a graph file.
+    private: static constexpr size_t kVertexRecordSize =
+               24 + sizeof(V) + (8 - sizeof(V) % 8) % 8;
+
+    /// \brief Size of an edge record in a graph file.
+    private: static constexpr size_t kEdgeRecordSize =
+               32 + sizeof(E) + (8 - sizeof(E) % 8) % 8;
+
+    /// \brief Size of the buffer used to read and write graph files.
+    private: static constexpr size_t kIoBufferSize = 65536;
+
     /// \brief The next vertex Id to be assigned to a new vertex.
     protected: VertexId nextVertexId = 0u;
 
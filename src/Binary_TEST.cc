@@ -0,0 +1,268 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ignition/math/Binary.hh"
+#include "ignition/math/Rand.hh"
+
+using namespace ignition;
+
+/////////////////////////////////////////////////
+/// \brief Check that two doubles have the same bits.
+/// \param[in] _a First value.
+/// \param[in] _b Second value.
+/// \return True if the values are bit for bit identical.
+bool SameBits(const double _a, const double _b)
+{
+  return std::memcmp(&_a, &_b, sizeof(double)) == 0;
+}
+
+/////////////////////////////////////////////////
+/// \brief Write a value and read it back.
+/// \param[in] _value The value.
+/// \return The value read.
+template<typename T>
+T RoundTrip(const T &_value)
+{
+  // Use an odd offset to check that alignment is not needed
+  unsigned char buffer[256];
+  EXPECT_EQ(math::Binary::Size<T>(),
+      math::Binary::Write(_value, buffer + 1, sizeof(buffer) - 1));
+  T value;
+  EXPECT_TRUE(math::Binary::Read(buffer + 1, math::Binary::Size<T>(),
+        value));
+  return value;
+}
+
+/////////////////////////////////////////////////
+TEST(BinaryTest, Layout)
+{
+  EXPECT_EQ(16u, math::Binary::Size<math::Vector2d>());
+  EXPECT_EQ(12u, math::Binary::Size<math::Vector3f>());
+  EXPECT_EQ(12u, math::Binary::Size<math::Vector3i>());
+  EXPECT_EQ(32u, math::Binary::Size<math::Quaterniond>());
+  EXPECT_EQ(56u, math::Binary::Size<math::Pose3d>());
+  EXPECT_EQ(28u, math::Binary::Size<math::Pose3f>());
+  EXPECT_EQ(72u, math::Binary::Size<math::Matrix3d>());
+  EXPECT_EQ(128u, math::Binary::Size<math::Matrix4d>());
+  EXPECT_EQ(48u, math::Binary::Size<math::AxisAlignedBox>());
+  EXPECT_EQ(112u, math::Binary::Size<math::Inertiald>());
+  EXPECT_EQ(16u + 3 * 56u, math::Binary::ArraySize<math::Pose3d>(3));
+
+  // Little endian whatever the machine
+  unsigned char bytes[12];
+  math::Binary::Write(math::Vector3i(1, -2, 0x01020304), bytes,
+      sizeof(bytes));
+  const unsigned char expected[12] = {
+    1, 0, 0, 0, 0xfe, 0xff, 0xff, 0xff, 4, 3, 2, 1};
+  EXPECT_EQ(0, std::memcmp(expected, bytes, sizeof(bytes)));
+
+  // The quaternion is stored as w x y z
+  unsigned char q[16];
+  math::Binary::Write(math::Quaternionf(1, 0, 0, 0), q, sizeof(q));
+  EXPECT_EQ(0x3f, q[3]);
+  EXPECT_EQ(0x80, q[2]);
+
+  // Too small buffers
+  EXPECT_EQ(0u, math::Binary::Write(math::Vector3d::One, bytes,
+        sizeof(bytes)));
+  math::Vector3d v(1, 2, 3);
+  EXPECT_FALSE(math::Binary::Read(bytes, sizeof(bytes), v));
+  EXPECT_EQ(math::Vector3d(1, 2, 3), v);
+}
+
+/////////////////////////////////////////////////
+TEST(BinaryTest, Portable)
+{
+  // The byte at a time path used on big endian machines, or when
+  // IGN_MATH_BINARY_PORTABLE is defined, gives the same bytes
+  unsigned char fast[8];
+  unsigned char portable[8];
+  auto check = [&](auto _value)
+  {
+    using S = decltype(_value);
+    std::memset(fast, 0, sizeof(fast));
+    std::memset(portable, 0xff, sizeof(portable));
+    math::detail::StoreLittleEndian(_value, fast);
+    math::detail::StoreLittleEndianPortable(_value, portable);
+    EXPECT_EQ(0, std::memcmp(fast, portable, sizeof(S)));
+    const S fastValue = math::detail::LoadLittleEndian<S>(portable);
+    const S portableValue = math::detail::LoadLittleEndianPortable<S>(fast);
+    EXPECT_EQ(0, std::memcmp(&_value, &fastValue, sizeof(S)));
+    EXPECT_EQ(0, std::memcmp(&_value, &portableValue, sizeof(S)));
+  };
+  check(1.5f);
+  check(-0.1);
+  check(0x01020304);
+  check(-2);
+  check(static_cast<int64_t>(-1234567890123456789));
+  check(static_cast<uint64_t>(0x0102030405060708));
+  check(std::numeric_limits<double>::quiet_NaN());
+
+  math::detail::StoreLittleEndianPortable(
+      static_cast<uint64_t>(0x0102030405060708), portable);
+  const unsigned char expected[8] = {8, 7, 6, 5, 4, 3, 2, 1};
+  EXPECT_EQ(0, std::memcmp(expected, portable, sizeof(expected)));
+  math::detail::StoreLittleEndianPortable(1.0f, portable);
+  EXPECT_EQ(0x3f, portable[3]);
+  EXPECT_EQ(0x80, portable[2]);
+}
+
+/////////////////////////////////////////////////
+TEST(BinaryTest, Values)
+{
+  EXPECT_EQ(math::Vector2d(1.5, -2), RoundTrip(math::Vector2d(1.5, -2)));
+  EXPECT_EQ(math::Vector3i(7, -8, 9), RoundTrip(math::Vector3i(7, -8, 9)));
+  EXPECT_EQ(math::Vector4f(1, 2, 3, 4), RoundTrip(math::Vector4f(1, 2, 3, 4)));
+
+  // Values are kept exactly, without normalizing
+  const math::Quaterniond q(0.1, 0.2, 0.3, 0.4);
+  const math::Quaterniond q2 = RoundTrip(q);
+  EXPECT_TRUE(SameBits(q.W(), q2.W()));
+  EXPECT_TRUE(SameBits(q.X(), q2.X()));
+  EXPECT_TRUE(SameBits(q.Y(), q2.Y()));
+  EXPECT_TRUE(SameBits(q.Z(), q2.Z()));
+
+  math::Rand::Seed(15);
+  const math::Pose3d p(math::Rand::DblUniform(-1, 1), 2, 3,
+      math::Rand::DblUniform(-1, 1), 0.2, 0.3);
+  const math::Pose3d p2 = RoundTrip(p);
+  EXPECT_EQ(p.Pos(), p2.Pos());
+  EXPECT_TRUE(SameBits(p.Rot().W(), p2.Rot().W()));
+  EXPECT_TRUE(SameBits(p.Rot().Z(), p2.Rot().Z()));
+
+  const math::Matrix3d m3(1, 2, 3, 4, 5, 6, 7, 8, 9);
+  EXPECT_EQ(m3, RoundTrip(m3));
+  const math::Matrix4d m4(p);
+  EXPECT_EQ(m4, RoundTrip(m4));
+
+  const math::AxisAlignedBox box(-1, -2, -3, 1, 2, 3);
+  EXPECT_EQ(box, RoundTrip(box));
+  const math::AxisAlignedBox empty = RoundTrip(math::AxisAlignedBox());
+  EXPECT_EQ(math::AxisAlignedBox().Min(), empty.Min());
+  EXPECT_EQ(math::AxisAlignedBox().Max(), empty.Max());
+
+  const math::Inertiald inertial(math::MassMatrix3d(2,
+        math::Vector3d(1, 2, 3), math::Vector3d(0.1, 0.2, 0.3)),
+      math::Pose3d(1, 2, 3, 0, 0, 1));
+  EXPECT_EQ(inertial, RoundTrip(inertial));
+}
+
+/////////////////////////////////////////////////
+TEST(BinaryTest, Array)
+{
+  math::Rand::Seed(16);
+  std::vector<math::Pose3d> poses;
+  for (int i = 0; i < 1000; ++i)
+  {
+    poses.push_back(math::Pose3d(math::Rand::DblUniform(-9, 9),
+          math::Rand::DblUniform(-9, 9), math::Rand::DblUniform(-9, 9),
+          math::Rand::DblUniform(-3, 3), math::Rand::DblUniform(-3, 3),
+          math::Rand::DblUniform(-3, 3)));
+  }
+
+  std::vector<unsigned char> buffer(
+      math::Binary::ArraySize<math::Pose3d>(poses.size()));
+  EXPECT_EQ(0u, math::Binary::WriteArray(poses.data(), poses.size(),
+        buffer.data(), buffer.size() - 1));
+  EXPECT_EQ(buffer.size(), math::Binary::WriteArray(poses.data(),
+        poses.size(), buffer.data(), buffer.size()));
+  EXPECT_EQ(0, std::memcmp("IGNB\x01\x00\x05\x02", buffer.data(), 8));
+
+  // The stream writer gives the same bytes
+  std::ostringstream out;
+  EXPECT_TRUE(math::Binary::WriteArray(out, poses.data(), poses.size()));
+  const std::string streamed = out.str();
+  ASSERT_EQ(buffer.size(), streamed.size());
+  EXPECT_EQ(0, std::memcmp(buffer.data(), streamed.data(), buffer.size()));
+
+  // Values are read in place
+  math::BinaryArrayView<math::Pose3d> view(streamed.data(), streamed.size());
+  ASSERT_EQ(poses.size(), view.Size());
+  EXPECT_EQ(reinterpret_cast<const unsigned char *>(streamed.data()) + 16,
+      view.Data());
+  for (size_t i = 0; i < poses.size(); ++i)
+    EXPECT_EQ(poses[i], view[i]);
+  math::Pose3d pose;
+  EXPECT_TRUE(view.At(999, pose));
+  EXPECT_EQ(poses[999], pose);
+  EXPECT_FALSE(view.At(1000, pose));
+
+  std::vector<math::Pose3d> range = {pose};
+  view.Read(995, 10, range);
+  ASSERT_EQ(5u, range.size());
+  EXPECT_EQ(poses[995], range[0]);
+  view.Read(1000, 10, range);
+  EXPECT_TRUE(range.empty());
+
+  // A log being appended to holds every complete value
+  math::Binary::WriteHeader<math::Pose3d>(math::Binary::kUnknownCount,
+      buffer.data(), buffer.size());
+  EXPECT_TRUE(view.Open(buffer.data(), buffer.size() - 30));
+  EXPECT_EQ(poses.size() - 1, view.Size());
+  EXPECT_EQ(poses[998], view[998]);
+}
+
+/////////////////////////////////////////////////
+TEST(BinaryTest, Errors)
+{
+  const math::Vector3f values[2] = {math::Vector3f(1, 2, 3),
+    math::Vector3f(4, 5, 6)};
+  unsigned char buffer[64];
+  const size_t size = math::Binary::WriteArray(values, 2, buffer,
+      sizeof(buffer));
+  ASSERT_EQ(40u, size);
+
+  math::BinaryArrayView<math::Vector3f> view;
+  EXPECT_EQ(0u, view.Size());
+  EXPECT_EQ(nullptr, view.Data());
+  EXPECT_TRUE(view.Open(buffer, size));
+  EXPECT_EQ(values[1], view[1]);
+
+  // Wrong type or scalar
+  EXPECT_FALSE(math::BinaryArrayView<math::Vector3d>().Open(buffer, size));
+  EXPECT_FALSE(math::BinaryArrayView<math::Vector4f>().Open(buffer, size));
+
+  // Truncated data, or not an array
+  EXPECT_FALSE(view.Open(buffer, size - 1));
+  EXPECT_EQ(0u, view.Size());
+  EXPECT_FALSE(view.Open(buffer, 10));
+  EXPECT_FALSE(view.Open(nullptr, 0));
+  buffer[0] = 'X';
+  EXPECT_FALSE(view.Open(buffer, size));
+  buffer[0] = 'I';
+
+  // Newer versions are rejected
+  buffer[4] = 2;
+  EXPECT_FALSE(view.Open(buffer, size));
+  buffer[4] = 1;
+  EXPECT_TRUE(view.Open(buffer, size));
+
+  // An empty array
+  EXPECT_EQ(16u, math::Binary::WriteArray<math::Vector3f>(nullptr, 0,
+        buffer, sizeof(buffer)));
+  EXPECT_TRUE(view.Open(buffer, 16));
+  EXPECT_EQ(0u, view.Size());
+}
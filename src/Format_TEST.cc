@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "ignition/math/Format.hh"
+#include "ignition/math/Parse.hh"
+#include "ignition/math/Rand.hh"
+
+using namespace ignition;
+
+/////////////////////////////////////////////////
+/// \brief Check that two values have the same bits.
+/// \param[in] _a First value.
+/// \param[in] _b Second value.
+/// \return True if the values are bit for bit identical.
+template<typename T>
+bool SameBits(const T _a, const T _b)
+{
+  return std::memcmp(&_a, &_b, sizeof(T)) == 0;
+}
+
+/////////////////////////////////////////////////
+/// \brief Format a value into a string.
+/// \param[in] _value The value.
+/// \param[in] _options The options.
+/// \return The text, or "overflow" if it does not fit in 512 characters.
+template<typename T>
+std::string ToString(const T &_value,
+    const math::FormatOptions &_options = math::FormatOptions())
+{
+  char buffer[512];
+  const size_t size = math::Format(buffer, sizeof(buffer), _value, _options);
+  return size == 0 ? "overflow" : std::string(buffer, size);
+}
+
+/////////////////////////////////////////////////
+TEST(FormatTest, Numbers)
+{
+  EXPECT_EQ("0.1", ToString(0.1));
+  EXPECT_EQ("0.1", ToString(0.1f));
+  EXPECT_EQ("-2.5", ToString(-2.5));
+  EXPECT_EQ("1e+300", ToString(1e300));
+  EXPECT_EQ("5e-324", ToString(std::numeric_limits<double>::denorm_min()));
+  EXPECT_EQ("-42", ToString(-42));
+  EXPECT_EQ("inf", ToString(std::numeric_limits<double>::infinity()));
+  EXPECT_EQ("nan", ToString(std::numeric_limits<double>::quiet_NaN()));
+
+  const math::FormatOptions fixed(math::FORMAT_FIXED, 3);
+  EXPECT_EQ("0.100", ToString(0.1, fixed));
+  EXPECT_EQ("-2.000", ToString(-2.0, fixed));
+  EXPECT_EQ("0.001", ToString(0.0005, fixed));
+  EXPECT_EQ("3", ToString(2.6, math::FormatOptions(math::FORMAT_FIXED, 0)));
+  EXPECT_EQ("7", ToString(7, fixed));
+
+  // The buffer must hold the whole text
+  char buffer[4];
+  EXPECT_EQ(3u, math::Format(buffer, sizeof(buffer), 1.5));
+  EXPECT_EQ(4u, math::Format(buffer, sizeof(buffer), 1.25));
+  EXPECT_EQ(0u, math::Format(buffer, sizeof(buffer), 1.125));
+  EXPECT_EQ(0u, math::Format(buffer, 0, 1));
+}
+
+/////////////////////////////////////////////////
+TEST(FormatTest, Types)
+{
+  EXPECT_EQ("1 2.5 -3", ToString(math::Vector3d(1, 2.5, -3)));
+  EXPECT_EQ("1,2", ToString(math::Vector2i(1, 2),
+        math::FormatOptions(math::FORMAT_SHORTEST, 6, ',')));
+  EXPECT_EQ("1 2 3 4", ToString(math::Vector4f(1, 2, 3, 4)));
+  EXPECT_EQ("0.5", ToString(math::Angle(0.5)));
+  EXPECT_EQ("300", ToString(math::Temperature(300)));
+  EXPECT_EQ("0.5 0.25 1 1", ToString(math::Color(0.5f, 0.25f, 1.0f)));
+  EXPECT_EQ("0 0 0", ToString(math::Quaterniond::Identity));
+  EXPECT_EQ("1.000\t2.000\t3.000\t0.000\t0.000\t1.000",
+      ToString(math::Pose3d(1, 2, 3, 0, 0, 1),
+        math::FormatOptions(math::FORMAT_FIXED, 3, '\t')));
+  EXPECT_EQ("1 2 3 4 5 6 7 8 9",
+      ToString(math::Matrix3d(1, 2, 3, 4, 5, 6, 7, 8, 9)));
+  EXPECT_EQ("1 0 0 0 0 1 0 0 0 0 1 0 0 0 0 1",
+      ToString(math::Matrix4d::Identity));
+
+  // A value that does not fit is not written
+  char buffer[8];
+  EXPECT_EQ(0u, math::Format(buffer, sizeof(buffer),
+        math::Vector3d(1.5, 2.5, 3.5)));
+  EXPECT_EQ(7u, math::Format(buffer, sizeof(buffer),
+        math::Vector3d(1, 2, 3.5)));
+}
+
+/////////////////////////////////////////////////
+TEST(FormatTest, RoundTrip)
+{
+  math::Rand::Seed(14);
+  for (int i = 0; i < 1000; ++i)
+  {
+    const double scale = std::pow(10.0, math::Rand::IntUniform(-30, 30));
+    auto random = [&]()
+    {
+      return math::Rand::DblUniform(-1, 1) * scale;
+    };
+
+    // Shortest text reads back exactly
+    const math::Vector3d v(random(), random(), random());
+    math::Vector3d parsedV;
+    EXPECT_TRUE(math::Parse(ToString(v), parsedV));
+    EXPECT_TRUE(SameBits(v.X(), parsedV.X())) << v.X();
+    EXPECT_TRUE(SameBits(v.Y(), parsedV.Y())) << v.Y();
+    EXPECT_TRUE(SameBits(v.Z(), parsedV.Z())) << v.Z();
+
+    const math::Vector3f vf(random(), random(), random());
+    math::Vector3f parsedVf;
+    EXPECT_TRUE(math::Parse(ToString(vf), parsedVf));
+    EXPECT_TRUE(SameBits(vf.X(), parsedVf.X())) << vf.X();
+    EXPECT_TRUE(SameBits(vf.Y(), parsedVf.Y())) << vf.Y();
+    EXPECT_TRUE(SameBits(vf.Z(), parsedVf.Z())) << vf.Z();
+
+    const math::Matrix4d m(math::Pose3d(random(), random(), random(),
+          math::Rand::DblUniform(-3, 3), math::Rand::DblUniform(-3, 3),
+          math::Rand::DblUniform(-3, 3)));
+    math::Matrix4d parsedM;
+    EXPECT_TRUE(math::Parse(ToString(m), parsedM));
+    for (int j = 0; j < 16; ++j)
+    {
+      EXPECT_TRUE(SameBits(m(j / 4, j % 4), parsedM(j / 4, j % 4))) << j;
+    }
+
+    // Rotations go through Euler angles
+    const math::Pose3d p(m.Pose());
+    math::Pose3d parsedP;
+    EXPECT_TRUE(math::Parse(ToString(p), parsedP));
+    EXPECT_TRUE(SameBits(p.Pos().X(), parsedP.Pos().X())) << p.Pos().X();
+    EXPECT_TRUE(SameBits(p.Pos().Y(), parsedP.Pos().Y())) << p.Pos().Y();
+    EXPECT_TRUE(SameBits(p.Pos().Z(), parsedP.Pos().Z())) << p.Pos().Z();
+    EXPECT_TRUE(p.Rot().Equal(parsedP.Rot(), 1e-12) ||
+        p.Rot().Equal(-parsedP.Rot(), 1e-12));
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(FormatTest, FormatLines)
+{
+  std::vector<math::Pose3d> poses;
+  for (int i = 0; i < 100; ++i)
+    poses.push_back(math::Pose3d(i, 0.5 * i, -i, 0, 0, 0));
+
+  // Write through a small buffer and read back
+  const math::FormatOptions csv(math::FORMAT_SHORTEST, 6, ',');
+  std::string text;
+  char buffer[64];
+  size_t done = 0;
+  size_t calls = 0;
+  while (done < poses.size())
+  {
+    size_t size = 0;
+    const size_t count = math::FormatLines(buffer, sizeof(buffer),
+        poses.data() + done, poses.size() - done, size, csv);
+    ASSERT_GT(count, 0u);
+    ASSERT_EQ('\n', buffer[size - 1]);
+    text.append(buffer, size);
+    done += count;
+    ++calls;
+  }
+  EXPECT_GT(calls, 1u);
+  EXPECT_EQ("0,0,0,0,0,0\n1,0.5,-1,0,0,0\n", text.substr(0, 27));
+
+  size_t lines = 0;
+  size_t start = 0;
+  for (size_t end = text.find('\n'); end != std::string::npos;
+       start = end + 1, end = text.find('\n', start))
+  {
+    std::string line = text.substr(start, end - start);
+    for (char &c : line)
+    {
+      if (c == ',')
+        c = ' ';
+    }
+    math::Pose3d pose;
+    EXPECT_TRUE(math::Parse(line, pose)) << line;
+    EXPECT_EQ(poses[lines], pose);
+    ++lines;
+  }
+  EXPECT_EQ(poses.size(), lines);
+
+  // A line that does not fit is not written
+  size_t size = 5;
+  EXPECT_EQ(0u, math::FormatLines(buffer, 4, poses.data() + 10, 1, size));
+  EXPECT_EQ(0u, size);
+  EXPECT_EQ(0u, math::FormatLines(buffer, sizeof(buffer),
+        poses.data(), 0, size));
+}
@@ -0,0 +1,237 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <cmath>
+
+#include <ignition/math/GaussMarkovProcessBank.hh>
+#include <ignition/math/Helpers.hh>
+#include <ignition/math/Rand.hh>
+
+using namespace ignition::math;
+
+//////////////////////////////////////////////////
+class ignition::math::GaussMarkovProcessBankPrivate
+{
+  /// \brief Recompute the exact transition factors for a timestep.
+  /// \param[in] _dt Length of the timestep in seconds.
+  public: void UpdateExactFactors(double _dt);
+
+  /// \brief Current process values.
+  public: std::vector<double> value;
+
+  /// \brief Process start values.
+  public: std::vector<double> start;
+
+  /// \brief Process theta values.
+  public: std::vector<double> theta;
+
+  /// \brief Process mu values.
+  public: std::vector<double> mu;
+
+  /// \brief Process sigma values.
+  public: std::vector<double> sigma;
+
+  /// \brief Scratch buffer for the normal noise of one update.
+  public: std::vector<double> noise;
+
+  /// \brief Cached exact decay factors, exp(-theta * dt).
+  public: std::vector<double> decay;
+
+  /// \brief Cached exact noise factors.
+  public: std::vector<double> diffusion;
+
+  /// \brief Timestep the exact factors were computed for.
+  public: double exactDt = 0.0;
+
+  /// \brief True if the exact factors match the current parameters.
+  public: bool exactValid = false;
+};
+
+//////////////////////////////////////////////////
+void GaussMarkovProcessBankPrivate::UpdateExactFactors(double _dt)
+{
+  // The cached factors are only reused for the exact same timestep
+  if (this->exactValid && equal(this->exactDt, _dt, 0.0))
+    return;
+
+  const size_t size = this->value.size();
+  this->decay.resize(size);
+  this->diffusion.resize(size);
+  for (size_t i = 0; i < size; ++i)
+  {
+    const double rate = this->theta[i];
+    this->decay[i] = std::exp(-rate * _dt);
+
+    // Variance of the transition is sigma^2 (1 - exp(-2 theta dt)) /
+    // (2 theta), which tends to sigma^2 dt as theta goes to zero. expm1
+    // keeps it accurate for small theta * dt.
+    const double variance = rate > 0 ?
+      -std::expm1(-2.0 * rate * _dt) / (2.0 * rate) : _dt;
+    this->diffusion[i] = this->sigma[i] * std::sqrt(std::max(0.0, variance));
+  }
+  this->exactDt = _dt;
+  this->exactValid = true;
+}
+
+//////////////////////////////////////////////////
+GaussMarkovProcessBank::GaussMarkovProcessBank()
+  : dataPtr(new GaussMarkovProcessBankPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+GaussMarkovProcessBank::GaussMarkovProcessBank(size_t _size, double _start,
+    double _theta, double _mu, double _sigma)
+  : dataPtr(new GaussMarkovProcessBankPrivate)
+{
+  this->Set(_size, _start, _theta, _mu, _sigma);
+}
+
+//////////////////////////////////////////////////
+GaussMarkovProcessBank::~GaussMarkovProcessBank()
+{
+}
+
+//////////////////////////////////////////////////
+void GaussMarkovProcessBank::Set(size_t _size, double _start, double _theta,
+    double _mu, double _sigma)
+{
+  this->dataPtr->start.assign(_size, _start);
+  this->dataPtr->theta.assign(_size, std::max(0.0, _theta));
+  this->dataPtr->mu.assign(_size, _mu);
+  this->dataPtr->sigma.assign(_size, std::max(0.0, _sigma));
+  this->dataPtr->noise.resize(_size);
+  this->dataPtr->exactValid = false;
+  this->Reset();
+}
+
+//////////////////////////////////////////////////
+bool GaussMarkovProcessBank::SetChannel(size_t _index, double _start,
+    double _theta, double _mu, double _sigma)
+{
+  if (_index >= this->Size())
+    return false;
+
+  this->dataPtr->start[_index] = _start;
+  this->dataPtr->theta[_index] = std::max(0.0, _theta);
+  this->dataPtr->mu[_index] = _mu;
+  this->dataPtr->sigma[_index] = std::max(0.0, _sigma);
+  this->dataPtr->value[_index] = _start;
+  this->dataPtr->exactValid = false;
+  return true;
+}
+
+//////////////////////////////////////////////////
+size_t GaussMarkovProcessBank::Size() const
+{
+  return this->dataPtr->value.size();
+}
+
+//////////////////////////////////////////////////
+const std::vector<double> &GaussMarkovProcessBank::Values() const
+{
+  return this->dataPtr->value;
+}
+
+//////////////////////////////////////////////////
+const std::vector<double> &GaussMarkovProcessBank::Start() const
+{
+  return this->dataPtr->start;
+}
+
+//////////////////////////////////////////////////
+const std::vector<double> &GaussMarkovProcessBank::Theta() const
+{
+  return this->dataPtr->theta;
+}
+
+//////////////////////////////////////////////////
+const std::vector<double> &GaussMarkovProcessBank::Mu() const
+{
+  return this->dataPtr->mu;
+}
+
+//////////////////////////////////////////////////
+const std::vector<double> &GaussMarkovProcessBank::Sigma() const
+{
+  return this->dataPtr->sigma;
+}
+
+//////////////////////////////////////////////////
+void GaussMarkovProcessBank::Reset()
+{
+  this->dataPtr->value = this->dataPtr->start;
+}
+
+//////////////////////////////////////////////////
+const std::vector<double> &GaussMarkovProcessBank::Update(
+    const clock::duration &_dt)
+{
+  // Time difference in seconds
+  return this->Update(std::chrono::duration<double>(_dt).count());
+}
+
+//////////////////////////////////////////////////
+const std::vector<double> &GaussMarkovProcessBank::Update(double _dt)
+{
+  const size_t size = this->Size();
+  double *value = this->dataPtr->value.data();
+  const double *theta = this->dataPtr->theta.data();
+  const double *mu = this->dataPtr->mu.data();
+  const double *sigma = this->dataPtr->sigma.data();
+  double *noise = this->dataPtr->noise.data();
+
+  Rand::FillNormal(noise, size);
+  for (size_t i = 0; i < size; ++i)
+  {
+    value[i] += theta[i] * (mu[i] - value[i]) * _dt + sigma[i] * noise[i];
+  }
+
+  // Output the new values.
+  return this->dataPtr->value;
+}
+
+//////////////////////////////////////////////////
+const std::vector<double> &GaussMarkovProcessBank::UpdateExact(
+    const clock::duration &_dt)
+{
+  // Time difference in seconds
+  return this->UpdateExact(std::chrono::duration<double>(_dt).count());
+}
+
+//////////////////////////////////////////////////
+const std::vector<double> &GaussMarkovProcessBank::UpdateExact(double _dt)
+{
+  this->dataPtr->UpdateExactFactors(_dt);
+
+  const size_t size = this->Size();
+  double *value = this->dataPtr->value.data();
+  const double *mu = this->dataPtr->mu.data();
+  const double *decay = this->dataPtr->decay.data();
+  const double *diffusion = this->dataPtr->diffusion.data();
+  double *noise = this->dataPtr->noise.data();
+
+  Rand::FillNormal(noise, size);
+  for (size_t i = 0; i < size; ++i)
+  {
+    value[i] = mu[i] + (value[i] - mu[i]) * decay[i] +
+      diffusion[i] * noise[i];
+  }
+
+  // Output the new values.
+  return this->dataPtr->value;
+}
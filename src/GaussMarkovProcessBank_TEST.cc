@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include "ignition/math/GaussMarkovProcess.hh"
+#include "ignition/math/GaussMarkovProcessBank.hh"
+#include "ignition/math/Helpers.hh"
+#include "ignition/math/Rand.hh"
+#include "ignition/math/SignalStats.hh"
+
+using namespace ignition;
+using namespace math;
+
+/////////////////////////////////////////////////
+TEST(GaussMarkovProcessBankTest, DefaultConstructor)
+{
+  GaussMarkovProcessBank bank;
+  EXPECT_EQ(0u, bank.Size());
+  EXPECT_TRUE(bank.Values().empty());
+  EXPECT_TRUE(bank.Update(0.1).empty());
+  EXPECT_TRUE(bank.UpdateExact(0.1).empty());
+  EXPECT_FALSE(bank.SetChannel(0, 1, 1, 1, 1));
+}
+
+/////////////////////////////////////////////////
+TEST(GaussMarkovProcessBankTest, Set)
+{
+  GaussMarkovProcessBank bank(3, -1.2, -1.0, 2.5, -0.5);
+  EXPECT_EQ(3u, bank.Size());
+  for (size_t i = 0; i < bank.Size(); ++i)
+  {
+    EXPECT_DOUBLE_EQ(-1.2, bank.Start()[i]);
+    EXPECT_DOUBLE_EQ(-1.2, bank.Values()[i]);
+    EXPECT_DOUBLE_EQ(0.0, bank.Theta()[i]);
+    EXPECT_DOUBLE_EQ(2.5, bank.Mu()[i]);
+    EXPECT_DOUBLE_EQ(0.0, bank.Sigma()[i]);
+  }
+
+  EXPECT_TRUE(bank.SetChannel(1, 3, 4, 5, 6));
+  EXPECT_FALSE(bank.SetChannel(3, 3, 4, 5, 6));
+  EXPECT_DOUBLE_EQ(3.0, bank.Start()[1]);
+  EXPECT_DOUBLE_EQ(3.0, bank.Values()[1]);
+  EXPECT_DOUBLE_EQ(4.0, bank.Theta()[1]);
+  EXPECT_DOUBLE_EQ(5.0, bank.Mu()[1]);
+  EXPECT_DOUBLE_EQ(6.0, bank.Sigma()[1]);
+  EXPECT_DOUBLE_EQ(-1.2, bank.Values()[2]);
+}
+
+/////////////////////////////////////////////////
+TEST(GaussMarkovProcessBankTest, UpdateMatchesProcess)
+{
+  // Without noise, the Euler update matches GaussMarkovProcess
+  GaussMarkovProcessBank bank(2, -1.2, 1.0, 2.5, 0);
+  EXPECT_TRUE(bank.SetChannel(1, 4.0, 0.5, -1.0, 0));
+  GaussMarkovProcess gmp0(-1.2, 1.0, 2.5, 0);
+  GaussMarkovProcess gmp1(4.0, 0.5, -1.0, 0);
+
+  clock::duration dt = std::chrono::milliseconds(100);
+  for (int i = 0; i < 200; ++i)
+  {
+    const std::vector<double> &values = bank.Update(dt);
+    EXPECT_DOUBLE_EQ(gmp0.Update(dt), values[0]);
+    EXPECT_DOUBLE_EQ(gmp1.Update(dt), values[1]);
+  }
+  EXPECT_NEAR(2.5, bank.Values()[0], 1e-4);
+  EXPECT_NEAR(-1.0, bank.Values()[1], 1e-3);
+
+  bank.Reset();
+  EXPECT_DOUBLE_EQ(-1.2, bank.Values()[0]);
+  EXPECT_DOUBLE_EQ(4.0, bank.Values()[1]);
+}
+
+/////////////////////////////////////////////////
+TEST(GaussMarkovProcessBankTest, UpdateExact)
+{
+  // Without noise, the exact update follows the analytic solution even
+  // for a timestep where the Euler update would diverge.
+  GaussMarkovProcessBank bank(1, -1.2, 30.0, 2.5, 0);
+  GaussMarkovProcessBank euler(1, -1.2, 30.0, 2.5, 0);
+  for (int i = 1; i <= 5; ++i)
+  {
+    bank.UpdateExact(0.1);
+    euler.Update(0.1);
+    EXPECT_NEAR(2.5 + (-1.2 - 2.5) * std::exp(-30.0 * 0.1 * i),
+        bank.Values()[0], 1e-12);
+  }
+  EXPECT_GT(std::abs(euler.Values()[0] - 2.5), 10.0);
+
+  // A zero step does not change the values
+  bank.UpdateExact(std::chrono::seconds(0));
+  EXPECT_NEAR(2.5 + (-1.2 - 2.5) * std::exp(-30.0 * 0.5),
+      bank.Values()[0], 1e-12);
+}
+
+/////////////////////////////////////////////////
+TEST(GaussMarkovProcessBankTest, Noise)
+{
+  // The stationary distribution of the process is normal with mean mu and
+  // variance sigma^2 / (2 theta), for any timestep.
+  const size_t size = 20000;
+  const double theta = 2.0;
+  const double mu = 1.5;
+  const double sigma = 0.8;
+  GaussMarkovProcessBank bank(size, mu, theta, mu, sigma);
+
+  // Half the channels are Brownian motions
+  for (size_t i = size / 2; i < size; ++i)
+    EXPECT_TRUE(bank.SetChannel(i, 0, 0, 0, sigma));
+
+  Rand::SetThreadStream(12);
+  for (double dt : {0.01, 5.0, 5.0})
+    bank.UpdateExact(dt);
+
+  SignalAccumulator ou;
+  ou.InsertData(bank.Values().data(), size / 2);
+  EXPECT_NEAR(mu, ou.Mean(), 0.02);
+  EXPECT_NEAR(sigma * sigma / (2 * theta), ou.Variance(), 0.01);
+
+  SignalAccumulator brownian;
+  brownian.InsertData(bank.Values().data() + size / 2, size / 2);
+  EXPECT_NEAR(0.0, brownian.Mean(), 0.06);
+  EXPECT_NEAR(sigma * sigma * 10.01, brownian.Variance(), 0.4);
+}
@@ -17,8 +17,10 @@
 
 #include <gtest/gtest.h>
 #include <cmath>
+#include <vector>
 
 #include "ignition/math/Inertial.hh"
+#include "ignition/math/Rand.hh"
 
 using namespace ignition;
 
@@ -231,7 +233,7 @@ void SetRotation(const double _mass,
     math::Quaterniond(-0.1, 0.2, -0.3),
     math::Quaterniond(0.4, 0.2, 0.5),
     math::Quaterniond(-0.1, 0.7, -0.7)};
-  for (const auto rot : rotations)
+  for (const auto &rot : rotations)
   {
     {
       auto inertial = inertialRef;
@@ -603,3 +605,243 @@ TEST(Inertiald_Test, AdditionInvalid)
     EXPECT_TRUE((i0 + i).MassMatrix().IsValid());
   }
 }
+
+/////////////////////////////////////////////////
+TEST(Inertiald_Test, Aggregate)
+{
+  // Two half-cubes
+  {
+    const double mass = 12.0;
+    math::MassMatrix3d cubeMM3;
+    EXPECT_TRUE(cubeMM3.SetFromBox(mass, math::Vector3d(1, 1, 1)));
+    const math::Inertiald cube(cubeMM3, math::Pose3d::Zero);
+    math::MassMatrix3d half;
+    EXPECT_TRUE(half.SetFromBox(0.5*mass, math::Vector3d(0.5, 1, 1)));
+    std::vector<math::Inertiald> halves = {
+      math::Inertiald(half, math::Pose3d(-0.25, 0, 0, 0, 0, 0)),
+      math::Inertiald(half, math::Pose3d(0.25, 0, 0, 0, 0, 0))};
+
+    math::Inertiald result;
+    EXPECT_TRUE(math::Inertiald::Aggregate(halves, result));
+    EXPECT_EQ(cube, result);
+
+    // Expressed in a rotated frame, the moments about the center of mass
+    // in the base frame are unchanged
+    const math::Quaterniond rot(0.1, 0.2, 0.3);
+    EXPECT_TRUE(math::Inertiald::Aggregate(halves, result, rot));
+    EXPECT_EQ(rot, result.Pose().Rot());
+    EXPECT_EQ(cube.Moi(), result.Moi());
+  }
+
+  // Many random bodies, compared with operator+=
+  {
+    math::Rand::Seed(42);
+    std::vector<math::Inertiald> bodies;
+    for (int i = 0; i < 1000; ++i)
+    {
+      math::MassMatrix3d mm;
+      EXPECT_TRUE(mm.SetFromBox(math::Rand::DblUniform(0.1, 10),
+          math::Vector3d(math::Rand::DblUniform(0.1, 2),
+            math::Rand::DblUniform(0.1, 2), math::Rand::DblUniform(0.1, 2))));
+      math::Pose3d pose(math::Rand::DblUniform(-5, 5),
+          math::Rand::DblUniform(-5, 5), math::Rand::DblUniform(-5, 5),
+          math::Rand::DblUniform(-3, 3), math::Rand::DblUniform(-3, 3),
+          math::Rand::DblUniform(-3, 3));
+      bodies.push_back(math::Inertiald(mm, pose));
+    }
+
+    math::Inertiald sum = bodies[0];
+    for (size_t i = 1; i < bodies.size(); ++i)
+      sum += bodies[i];
+
+    math::Inertiald result;
+    EXPECT_TRUE(math::Inertiald::Aggregate(bodies.data(), bodies.size(),
+        result));
+    EXPECT_NEAR(sum.MassMatrix().Mass(), result.MassMatrix().Mass(), 1e-9);
+    EXPECT_EQ(sum.Pose(), result.Pose());
+    const math::Matrix3d expected = sum.Moi();
+    const math::Matrix3d actual = result.Moi();
+    for (int row = 0; row < 3; ++row)
+    {
+      for (int col = 0; col < 3; ++col)
+      {
+        EXPECT_NEAR(expected(row, col), actual(row, col),
+            1e-9 * std::abs(expected(0, 0)));
+      }
+    }
+  }
+
+  // A single body is unchanged, apart from the inertial frame rotation
+  {
+    math::MassMatrix3d mm(2.0, math::Vector3d(2, 3, 4),
+        math::Vector3d(0.1, 0.2, 0.3));
+    math::Inertiald body(mm, math::Pose3d(1, 2, 3, 0.4, 0.5, 0.6));
+    math::Inertiald result;
+    EXPECT_TRUE(math::Inertiald::Aggregate(&body, 1, result,
+        body.Pose().Rot()));
+    EXPECT_EQ(body, result);
+  }
+
+  // No mass
+  {
+    math::Inertiald result(math::MassMatrix3d(1.0, math::Vector3d::One,
+          math::Vector3d::Zero), math::Pose3d(1, 0, 0, 0, 0, 0));
+    EXPECT_FALSE(math::Inertiald::Aggregate(nullptr, 0, result));
+    EXPECT_EQ(math::Inertiald(), result);
+
+    std::vector<math::Inertiald> massless(3);
+    EXPECT_FALSE(math::Inertiald::Aggregate(massless, result));
+  }
+
+  // Invalid result
+  {
+    std::vector<math::Inertiald> invalid = {math::Inertiald(
+        math::MassMatrix3d(1.0, math::Vector3d(1, 1, 5),
+          math::Vector3d::Zero), math::Pose3d::Zero)};
+    math::Inertiald result;
+    EXPECT_FALSE(math::Inertiald::Aggregate(invalid, result));
+    EXPECT_DOUBLE_EQ(1.0, result.MassMatrix().Mass());
+  }
+}
+
+/////////////////////////////////////////////////
+/// \brief Vertices and indices of a box mesh, wound counter-clockwise when
+/// seen from outside.
+/// \param[in] _size Size of the box.
+/// \param[in] _pose Pose of the box.
+/// \param[out] _vertices Vertices.
+/// \param[out] _indices Indices, three per triangle.
+void BoxMesh(const math::Vector3d &_size, const math::Pose3d &_pose,
+    std::vector<math::Vector3d> &_vertices, std::vector<unsigned int> &_indices)
+{
+  _vertices.clear();
+  for (int i = 0; i < 8; ++i)
+  {
+    math::Vector3d corner(
+        (i & 1 ? 0.5 : -0.5) * _size.X(),
+        (i & 2 ? 0.5 : -0.5) * _size.Y(),
+        (i & 4 ? 0.5 : -0.5) * _size.Z());
+    _vertices.push_back(_pose.CoordPositionAdd(corner));
+  }
+  _indices = {
+    0, 2, 1, 1, 2, 3,  // -z
+    4, 5, 6, 5, 7, 6,  // +z
+    0, 1, 4, 1, 5, 4,  // -y
+    2, 6, 3, 3, 6, 7,  // +y
+    0, 4, 2, 2, 4, 6,  // -x
+    1, 3, 5, 3, 7, 5};  // +x
+}
+
+/////////////////////////////////////////////////
+TEST(Inertiald_Test, SetFromMesh)
+{
+  const math::Material material(1000.0);
+  const math::Vector3d size(1, 2, 3);
+
+  // Box centered on the origin
+  {
+    std::vector<math::Vector3d> vertices;
+    std::vector<unsigned int> indices;
+    BoxMesh(size, math::Pose3d::Zero, vertices, indices);
+
+    math::MassMatrix3d expected;
+    EXPECT_TRUE(expected.SetFromBox(material, size));
+
+    math::Inertiald inertial;
+    EXPECT_TRUE(inertial.SetFromMesh(material, vertices, indices));
+    EXPECT_EQ(math::Inertiald(expected, math::Pose3d::Zero), inertial);
+    EXPECT_DOUBLE_EQ(6.0, inertial.MassMatrix().Mass() / material.Density());
+
+    // Same result from a triangle soup
+    std::vector<math::Triangle3d> triangles;
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+      triangles.push_back(math::Triangle3d(vertices[indices[i]],
+            vertices[indices[i + 1]], vertices[indices[i + 2]]));
+    }
+    math::Inertiald soup;
+    EXPECT_TRUE(soup.SetFromTriangles(material, triangles.data(),
+          triangles.size()));
+    EXPECT_EQ(inertial, soup);
+
+    // Reversed winding gives the same result
+    for (size_t i = 0; i < indices.size(); i += 3)
+      std::swap(indices[i + 1], indices[i + 2]);
+    math::Inertiald reversed;
+    EXPECT_TRUE(reversed.SetFromMesh(material, vertices, indices));
+    EXPECT_EQ(inertial, reversed);
+  }
+
+  // Rotated box far from the origin
+  {
+    const math::Pose3d pose(1e5, -2e5, 3e4, 0.3, -0.2, 1.1);
+    std::vector<math::Vector3d> vertices;
+    std::vector<unsigned int> indices;
+    BoxMesh(size, pose, vertices, indices);
+
+    math::MassMatrix3d boxMM;
+    EXPECT_TRUE(boxMM.SetFromBox(material, size));
+    const math::Inertiald expected(boxMM, pose);
+
+    math::Inertiald inertial;
+    EXPECT_TRUE(inertial.SetFromMesh(material, vertices, indices));
+    EXPECT_NEAR(expected.MassMatrix().Mass(), inertial.MassMatrix().Mass(),
+        1e-6);
+    EXPECT_TRUE(expected.Pose().Pos().Equal(inertial.Pose().Pos(), 1e-6));
+    const math::Matrix3d expectedMoi = expected.Moi();
+    const math::Matrix3d moi = inertial.Moi();
+    for (int row = 0; row < 3; ++row)
+    {
+      for (int col = 0; col < 3; ++col)
+        EXPECT_NEAR(expectedMoi(row, col), moi(row, col), 1e-4);
+    }
+  }
+
+  // Unit right tetrahedron, with known mass properties
+  {
+    std::vector<math::Vector3d> vertices = {
+      math::Vector3d::Zero, math::Vector3d::UnitX, math::Vector3d::UnitY,
+      math::Vector3d::UnitZ};
+    std::vector<unsigned int> indices = {
+      0, 2, 1, 0, 1, 3, 0, 3, 2, 1, 2, 3};
+
+    math::Inertiald inertial;
+    EXPECT_TRUE(inertial.SetFromMesh(math::Material(1.0), vertices, indices));
+    EXPECT_DOUBLE_EQ(1.0 / 6.0, inertial.MassMatrix().Mass());
+    EXPECT_EQ(math::Vector3d(0.25, 0.25, 0.25), inertial.Pose().Pos());
+
+    // Ixx about the center of mass: m * 3/40, Ixy: m / 80
+    const double m = 1.0 / 6.0;
+    EXPECT_NEAR(m * 3.0 / 40.0, inertial.MassMatrix().Ixx(), 1e-12);
+    EXPECT_NEAR(m * 3.0 / 40.0, inertial.MassMatrix().Iyy(), 1e-12);
+    EXPECT_NEAR(m * 3.0 / 40.0, inertial.MassMatrix().Izz(), 1e-12);
+    EXPECT_NEAR(m / 80.0, inertial.MassMatrix().Ixy(), 1e-12);
+    EXPECT_NEAR(m / 80.0, inertial.MassMatrix().Ixz(), 1e-12);
+    EXPECT_NEAR(m / 80.0, inertial.MassMatrix().Iyz(), 1e-12);
+  }
+
+  // Invalid meshes
+  {
+    std::vector<math::Vector3d> vertices;
+    std::vector<unsigned int> indices;
+    BoxMesh(size, math::Pose3d::Zero, vertices, indices);
+
+    math::Inertiald inertial;
+    EXPECT_FALSE(inertial.SetFromMesh(material, vertices, {}));
+    EXPECT_FALSE(inertial.SetFromMesh(material, {}, indices));
+    EXPECT_FALSE(inertial.SetFromTriangles(material, nullptr, 0));
+
+    // Not a multiple of three
+    std::vector<unsigned int> partial(indices.begin(), indices.end() - 1);
+    EXPECT_FALSE(inertial.SetFromMesh(material, vertices, partial));
+
+    // Index out of range
+    std::vector<unsigned int> outOfRange = indices;
+    outOfRange[5] = 8;
+    EXPECT_FALSE(inertial.SetFromMesh(material, vertices, outOfRange));
+
+    // A single triangle encloses no volume
+    std::vector<unsigned int> flat(indices.begin(), indices.begin() + 3);
+    EXPECT_FALSE(inertial.SetFromMesh(material, vertices, flat));
+  }
+}
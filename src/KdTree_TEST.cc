@@ -0,0 +1,333 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "ignition/math/KdTree.hh"
+#include "ignition/math/Rand.hh"
+
+using namespace ignition;
+
+/////////////////////////////////////////////////
+/// \brief Random points in clusters, so that the tree is unevenly dense.
+std::vector<math::Vector3d> ClusteredPoints(const size_t _count)
+{
+  std::vector<math::Vector3d> points;
+  math::Vector3d center;
+  for (size_t i = 0; i < _count; ++i)
+  {
+    if (i % 50 == 0)
+    {
+      center.Set(math::Rand::DblUniform(-10, 10),
+          math::Rand::DblUniform(-10, 10), math::Rand::DblUniform(-10, 10));
+    }
+    points.push_back(center + math::Vector3d(math::Rand::DblNormal(0, 1),
+          math::Rand::DblNormal(0, 1), math::Rand::DblNormal(0, 1)));
+  }
+  return points;
+}
+
+/////////////////////////////////////////////////
+/// \brief Find the k nearest points by checking every point.
+std::vector<size_t> BruteNearest(const std::vector<math::Vector3d> &_points,
+    const math::Vector3d &_p, const size_t _k, const double _maxDistance)
+{
+  std::vector<std::pair<double, size_t>> all;
+  for (size_t i = 0; i < _points.size(); ++i)
+  {
+    const double d2 = (_points[i] - _p).SquaredLength();
+    if (d2 <= _maxDistance * _maxDistance)
+      all.push_back({d2, i});
+  }
+  std::sort(all.begin(), all.end());
+  std::vector<size_t> result;
+  for (size_t i = 0; i < std::min(_k, all.size()); ++i)
+    result.push_back(all[i].second);
+  return result;
+}
+
+/////////////////////////////////////////////////
+TEST(KdTreeTest, Empty)
+{
+  math::KdTreed tree;
+  EXPECT_EQ(0u, tree.Size());
+
+  size_t index = 7;
+  double distance = 3;
+  EXPECT_FALSE(tree.Nearest(math::Vector3d::Zero, index, distance));
+  EXPECT_EQ(7u, index);
+  EXPECT_DOUBLE_EQ(3.0, distance);
+
+  std::vector<size_t> result = {1, 2};
+  tree.Nearest(math::Vector3d::Zero, 3, result);
+  EXPECT_TRUE(result.empty());
+  result = {1, 2};
+  tree.Radius(math::Vector3d::Zero, 10, result);
+  EXPECT_TRUE(result.empty());
+
+  const math::Vector3d query;
+  size_t indices[2];
+  double distances[2];
+  EXPECT_EQ(0u, tree.Nearest(&query, 1, 2, indices, distances));
+  EXPECT_EQ(math::KdTreed::kNoPoint, indices[0]);
+  EXPECT_EQ(math::KdTreed::kNoPoint, indices[1]);
+  EXPECT_TRUE(std::isinf(distances[1]));
+
+  tree.Build(std::vector<math::Vector3d>());
+  EXPECT_EQ(0u, tree.Size());
+}
+
+/////////////////////////////////////////////////
+TEST(KdTreeTest, Small)
+{
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  const std::vector<math::Vector3d> points = {
+    {0, 0, 0}, {0.5, 0, 0}, {-0.5, 0, 0}, {0, 2, 0}, {nan, 0, 0},
+    {100, 100, 100}, {0.5, 0, 0}};
+
+  // Leaves of one point give the deepest tree
+  math::KdTreed tree(points, 1);
+
+  // The point with a NaN coordinate is left out
+  EXPECT_EQ(6u, tree.Size());
+
+  size_t index;
+  double distance;
+  ASSERT_TRUE(tree.Nearest(math::Vector3d(90, 90, 90), index, distance));
+  EXPECT_EQ(5u, index);
+  EXPECT_DOUBLE_EQ(std::sqrt(300.0), distance);
+  EXPECT_FALSE(tree.Nearest(math::Vector3d(90, 90, 90), index, distance,
+        10.0));
+
+  // Ties are ordered by index
+  ASSERT_TRUE(tree.Nearest(math::Vector3d(0.4, 0, 0), index, distance));
+  EXPECT_EQ(1u, index);
+  EXPECT_NEAR(0.1, distance, 1e-12);
+
+  std::vector<size_t> result;
+  tree.Nearest(math::Vector3d(0.4, 0, 0), 3, result);
+  EXPECT_EQ(std::vector<size_t>({1, 6, 0}), result);
+  tree.Nearest(math::Vector3d(0.4, 0, 0), 10, result);
+  EXPECT_EQ(std::vector<size_t>({1, 6, 0, 2, 3, 5}), result);
+  tree.Nearest(math::Vector3d(0.4, 0, 0), 10, result, 1.0);
+  EXPECT_EQ(std::vector<size_t>({1, 6, 0, 2}), result);
+
+  tree.Radius(math::Vector3d::Zero, 0.5, result);
+  std::sort(result.begin(), result.end());
+  EXPECT_EQ(std::vector<size_t>({0, 1, 2, 6}), result);
+  tree.Radius(math::Vector3d(0, 1, 0), 1.0, result);
+  std::sort(result.begin(), result.end());
+  EXPECT_EQ(std::vector<size_t>({0, 3}), result);
+  tree.Radius(math::Vector3d::Zero, -1.0, result);
+  EXPECT_TRUE(result.empty());
+
+  // Many equal points
+  tree.Build(std::vector<math::Vector3d>(100, math::Vector3d(1, 2, 3)), 4);
+  EXPECT_EQ(100u, tree.Size());
+  tree.Nearest(math::Vector3d::Zero, 3, result);
+  EXPECT_EQ(std::vector<size_t>({0, 1, 2}), result);
+  tree.Radius(math::Vector3d(1, 2, 3), 0, result);
+  EXPECT_EQ(100u, result.size());
+
+  // Rebuilding replaces the points
+  tree.Build(std::vector<math::Vector3d>({{5, 5, 5}}));
+  EXPECT_EQ(1u, tree.Size());
+  tree.Radius(math::Vector3d::Zero, 0.5, result);
+  EXPECT_TRUE(result.empty());
+}
+
+/////////////////////////////////////////////////
+TEST(KdTreeTest, RandomQueries)
+{
+  math::Rand::Seed(17);
+  const std::vector<math::Vector3d> points = ClusteredPoints(3000);
+
+  for (const size_t leafSize : {1u, 8u, 64u})
+  {
+    math::KdTreed tree(points, leafSize);
+    ASSERT_EQ(points.size(), tree.Size());
+
+    std::vector<size_t> result;
+    for (int i = 0; i < 200; ++i)
+    {
+      const math::Vector3d p(math::Rand::DblUniform(-12, 12),
+          math::Rand::DblUniform(-12, 12), math::Rand::DblUniform(-12, 12));
+      const double radius = math::Rand::DblUniform(0, 3);
+
+      tree.Radius(p, radius, result);
+      std::sort(result.begin(), result.end());
+      std::vector<size_t> expected;
+      for (size_t j = 0; j < points.size(); ++j)
+      {
+        if ((points[j] - p).SquaredLength() <= radius * radius)
+          expected.push_back(j);
+      }
+      EXPECT_EQ(expected, result);
+
+      const size_t k = static_cast<size_t>(math::Rand::IntUniform(1, 20));
+      tree.Nearest(p, k, result);
+      EXPECT_EQ(BruteNearest(points, p, k,
+            std::numeric_limits<double>::infinity()), result);
+      tree.Nearest(p, k, result, radius);
+      EXPECT_EQ(BruteNearest(points, p, k, radius), result);
+
+      size_t index;
+      double distance;
+      ASSERT_TRUE(tree.Nearest(p, index, distance));
+      EXPECT_EQ(BruteNearest(points, p, 1,
+            std::numeric_limits<double>::infinity())[0], index);
+      EXPECT_DOUBLE_EQ(points[index].Distance(p), distance);
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(KdTreeTest, Approximate)
+{
+  math::Rand::Seed(8);
+  const std::vector<math::Vector3d> points = ClusteredPoints(3000);
+  math::KdTreed tree(points);
+
+  const double epsilon = 0.5;
+  std::vector<size_t> result;
+  for (int i = 0; i < 200; ++i)
+  {
+    const math::Vector3d p(math::Rand::DblUniform(-12, 12),
+        math::Rand::DblUniform(-12, 12), math::Rand::DblUniform(-12, 12));
+
+    // Each neighbor is within (1 + epsilon) of the exact one of the same
+    // rank
+    const std::vector<size_t> exact = BruteNearest(points, p, 5,
+        std::numeric_limits<double>::infinity());
+    tree.Nearest(p, 5, result, std::numeric_limits<double>::infinity(),
+        epsilon);
+    ASSERT_EQ(exact.size(), result.size());
+    for (size_t j = 0; j < exact.size(); ++j)
+    {
+      EXPECT_LE(points[result[j]].Distance(p),
+          (1 + epsilon) * points[exact[j]].Distance(p) + 1e-12);
+    }
+
+    size_t index;
+    double distance;
+    ASSERT_TRUE(tree.Nearest(p, index, distance,
+          std::numeric_limits<double>::infinity(), epsilon));
+    EXPECT_LE(distance, (1 + epsilon) * points[exact[0]].Distance(p) + 1e-12);
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(KdTreeTest, Batch)
+{
+  math::Rand::Seed(3);
+  const std::vector<math::Vector3d> points = ClusteredPoints(1000);
+  math::KdTreed tree(points);
+
+  std::vector<math::Vector3d> queries;
+  for (int i = 0; i < 50; ++i)
+  {
+    queries.push_back(math::Vector3d(math::Rand::DblUniform(-12, 12),
+          math::Rand::DblUniform(-12, 12), math::Rand::DblUniform(-12, 12)));
+  }
+
+  // The batch gives the same results as one query at a time, and pads the
+  // neighbors that are out of range
+  const size_t k = 4;
+  const double maxDistance = 1.5;
+  std::vector<size_t> indices(queries.size() * k);
+  std::vector<double> distances(queries.size() * k);
+  const size_t found = tree.Nearest(queries.data(), queries.size(), k,
+      indices.data(), distances.data(), maxDistance);
+
+  size_t expectedFound = 0;
+  std::vector<size_t> result;
+  for (size_t q = 0; q < queries.size(); ++q)
+  {
+    tree.Nearest(queries[q], k, result, maxDistance);
+    expectedFound += result.size();
+    for (size_t i = 0; i < k; ++i)
+    {
+      if (i < result.size())
+      {
+        EXPECT_EQ(result[i], indices[q * k + i]);
+        EXPECT_DOUBLE_EQ(points[result[i]].Distance(queries[q]),
+            distances[q * k + i]);
+      }
+      else
+      {
+        EXPECT_EQ(math::KdTreed::kNoPoint, indices[q * k + i]);
+        EXPECT_TRUE(std::isinf(distances[q * k + i]));
+      }
+    }
+  }
+  EXPECT_EQ(expectedFound, found);
+  EXPECT_GT(found, 0u);
+  EXPECT_LT(found, queries.size() * k);
+
+  // Distances are optional
+  EXPECT_EQ(found, tree.Nearest(queries.data(), queries.size(), k,
+        indices.data(), nullptr, maxDistance));
+
+  std::vector<std::vector<size_t>> results(queries.size());
+  size_t total = tree.Radius(queries.data(), queries.size(), 1.0,
+      results.data());
+  size_t expectedTotal = 0;
+  for (size_t q = 0; q < queries.size(); ++q)
+  {
+    tree.Radius(queries[q], 1.0, result);
+    EXPECT_EQ(result, results[q]);
+    expectedTotal += result.size();
+  }
+  EXPECT_EQ(expectedTotal, total);
+}
+
+/////////////////////////////////////////////////
+TEST(KdTreeTest, Float)
+{
+  math::Rand::Seed(4);
+  std::vector<math::Vector3f> points;
+  for (int i = 0; i < 500; ++i)
+  {
+    points.push_back(math::Vector3f(
+          static_cast<float>(math::Rand::DblUniform(-1, 1)),
+          static_cast<float>(math::Rand::DblUniform(-1, 1)),
+          static_cast<float>(math::Rand::DblUniform(-1, 1))));
+  }
+
+  // Float points are stored exactly
+  math::KdTreef tree(points);
+  size_t index;
+  double distance;
+  ASSERT_TRUE(tree.Nearest(math::Vector3d::Zero, index, distance));
+  for (const math::Vector3f &p : points)
+    EXPECT_LE(points[index].SquaredLength(), p.SquaredLength());
+  EXPECT_DOUBLE_EQ(math::Vector3d(points[index].X(), points[index].Y(),
+        points[index].Z()).Length(), distance);
+
+  // Double points are rounded to float
+  std::vector<math::Vector3d> doubles = {{0.1, 0, 0}, {1, 1, 1}};
+  tree.Build(doubles);
+  ASSERT_TRUE(tree.Nearest(math::Vector3d::Zero, index, distance));
+  EXPECT_EQ(0u, index);
+  EXPECT_DOUBLE_EQ(static_cast<double>(0.1f), distance);
+}
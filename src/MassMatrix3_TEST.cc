@@ -17,6 +17,8 @@
 
 #include <gtest/gtest.h>
 #include <cmath>
+#include <vector>
+
 
 #include "ignition/math/Helpers.hh"
 #include "ignition/math/MassMatrix3.hh"
@@ -934,3 +936,75 @@ TEST(MassMatrix3dTest, ValidMomentsTolerance)
   EXPECT_FALSE(massMatrix.IsNearPositive(-1));
   EXPECT_FALSE(massMatrix.IsPositive(-1));
 }
+
+/////////////////////////////////////////////////
+TEST(MassMatrix3dTest, PrincipalMomentsBatch)
+{
+  std::vector<math::MassMatrix3d> massMatrices;
+
+  // Diagonal, with repeated moments and general
+  massMatrices.push_back(math::MassMatrix3d(1.0, math::Vector3d(3, 2, 4),
+      math::Vector3d::Zero));
+  massMatrices.push_back(math::MassMatrix3d(1.0, math::Vector3d(2, 2, 2),
+      math::Vector3d::Zero));
+  massMatrices.push_back(math::MassMatrix3d(1.0, math::Vector3d(2, 2, 3),
+      math::Vector3d(-0.5, 0.1, 0.2)));
+  massMatrices.push_back(math::MassMatrix3d(12.0, math::Vector3d(4, 5, 6),
+      math::Vector3d(0, 0, 1)));
+  massMatrices.push_back(math::MassMatrix3d(1.0, math::Vector3d(3.5, 3.5, 3),
+      math::Vector3d(0.5, 0, 0)));
+  const size_t firstBox = massMatrices.size();
+  std::vector<math::Vector3d> boxMoments;
+  for (int i = 0; i < 100; ++i)
+  {
+    const double mass = 1.0 + i;
+    const math::Vector3d size(1 + i % 3, 2, 3 + i % 5);
+    math::MassMatrix3d m;
+    EXPECT_TRUE(m.SetFromBox(mass, size,
+        math::Quaterniond(0.1 * i, 0.2 * i, -0.3 * i)));
+    massMatrices.push_back(m);
+
+    const math::Vector3d size2 = size * size;
+    math::Vector3d expected(size2.Y() + size2.Z(), size2.Z() + size2.X(),
+        size2.X() + size2.Y());
+    expected *= mass / 12.0;
+    math::sort3(expected.X(), expected.Y(), expected.Z());
+    boxMoments.push_back(expected);
+  }
+
+  std::vector<math::Vector3d> moments(massMatrices.size());
+  std::vector<math::Quaterniond> offsets(massMatrices.size());
+  math::MassMatrix3d::PrincipalMoments(massMatrices.data(),
+      massMatrices.size(), moments.data(), offsets.data());
+
+  for (size_t i = 0; i < massMatrices.size(); ++i)
+  {
+    const math::MassMatrix3d &m = massMatrices[i];
+
+    // Same moments as the single matrix version, sorted. The trigonometric
+    // method of PrincipalMoments loses accuracy near repeated moments.
+    EXPECT_TRUE(moments[i].Equal(m.PrincipalMoments(-1e-6),
+          1e-5 * moments[i].Max()))
+      << i << ": " << moments[i] << " != " << m.PrincipalMoments(-1e-6);
+
+    // MOI = R * L * R^T
+    const math::Matrix3d r(offsets[i]);
+    const math::Matrix3d l(moments[i].X(), 0, 0, 0, moments[i].Y(), 0,
+        0, 0, moments[i].Z());
+    EXPECT_TRUE((r * l * r.Transposed()).Equal(m.Moi(), 1e-9)) << i;
+  }
+
+  // Exact moments of the boxes
+  for (size_t i = 0; i < boxMoments.size(); ++i)
+  {
+    EXPECT_TRUE(moments[firstBox + i].Equal(boxMoments[i],
+          1e-12 * boxMoments[i].Max()))
+      << i << ": " << moments[firstBox + i] << " != " << boxMoments[i];
+  }
+
+  // Offsets are optional
+  std::vector<math::Vector3d> momentsOnly(massMatrices.size());
+  math::MassMatrix3d::PrincipalMoments(massMatrices.data(),
+      massMatrices.size(), momentsOnly.data());
+  EXPECT_EQ(moments, momentsOnly);
+}
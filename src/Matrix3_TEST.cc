@@ -17,8 +17,12 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
+
 #include "ignition/math/Helpers.hh"
 #include "ignition/math/Matrix3.hh"
+#include "ignition/math/Rand.hh"
 
 using namespace ignition;
 
@@ -404,3 +408,86 @@ TEST(Matrix3dTest, From2Axes)
   m1.SetFrom2Axes(v1, v2);
   EXPECT_EQ(math::Matrix3d::Zero - math::Matrix3d::Identity, m1);
 }
+
+/////////////////////////////////////////////////
+TEST(Matrix3dTest, SymmetricEigen)
+{
+  // Random rotations and eigenvalues, including repeated eigenvalues
+  math::Rand::Seed(7);
+  std::vector<math::Matrix3d> matrices;
+  std::vector<math::Vector3d> expectedValues;
+  for (int i = 0; i < 1001; ++i)
+  {
+    const math::Matrix3d r(math::Quaterniond(math::Rand::DblUniform(-3, 3),
+          math::Rand::DblUniform(-3, 3), math::Rand::DblUniform(-3, 3)));
+    math::Vector3d values(math::Rand::DblUniform(-10, 10),
+        math::Rand::DblUniform(-10, 10), math::Rand::DblUniform(-10, 10));
+    if (i % 5 == 0)
+      values.Y() = values.X();
+    if (i % 7 == 0)
+      values.Z() = values.X();
+    const math::Matrix3d l(values.X(), 0, 0, 0, values.Y(), 0,
+        0, 0, values.Z());
+    matrices.push_back(r * l * r.Transposed());
+    math::sort3(values.X(), values.Y(), values.Z());
+    expectedValues.push_back(values);
+  }
+
+  // Diagonal and zero matrices
+  matrices.push_back(math::Matrix3d(3, 0, 0, 0, 1, 0, 0, 0, 2));
+  expectedValues.push_back(math::Vector3d(1, 2, 3));
+  matrices.push_back(math::Matrix3d::Zero);
+  expectedValues.push_back(math::Vector3d::Zero);
+
+  std::vector<math::Vector3d> values(matrices.size());
+  std::vector<math::Matrix3d> vectors(matrices.size());
+  math::Matrix3d::SymmetricEigen(matrices.data(), matrices.size(),
+      values.data(), vectors.data());
+
+  for (size_t i = 0; i < matrices.size(); ++i)
+  {
+    EXPECT_TRUE(values[i].Equal(expectedValues[i], 1e-12))
+      << i << ": " << values[i] << " != " << expectedValues[i];
+
+    // Sorted from smallest to largest
+    EXPECT_LE(values[i].X(), values[i].Y());
+    EXPECT_LE(values[i].Y(), values[i].Z());
+
+    // The eigenvectors form a rotation that diagonalizes the matrix
+    const math::Matrix3d &r = vectors[i];
+    EXPECT_NEAR(1.0, r.Determinant(), 1e-12);
+    EXPECT_TRUE((r * r.Transposed()).Equal(math::Matrix3d::Identity, 1e-12));
+    const math::Matrix3d l(values[i].X(), 0, 0, 0, values[i].Y(), 0,
+        0, 0, values[i].Z());
+    EXPECT_TRUE((r * l * r.Transposed()).Equal(matrices[i], 1e-12)) << i;
+
+    // The largest component of the first two eigenvectors is positive
+    for (int c = 0; c < 2; ++c)
+    {
+      math::Vector3d col(r(0, c), r(1, c), r(2, c));
+      math::Vector3d absCol = col.Abs();
+      const double largest = absCol.X() >= absCol.Y() && absCol.X() >=
+        absCol.Z() ? col.X() : (absCol.Y() >= absCol.Z() ? col.Y() : col.Z());
+      EXPECT_GT(largest, 0.0);
+    }
+  }
+
+  // Eigenvalues only, with a size that is not a multiple of the group size
+  std::vector<math::Vector3d> valuesOnly(3);
+  math::Matrix3d::SymmetricEigen(matrices.data(), 3, valuesOnly.data());
+  for (size_t i = 0; i < valuesOnly.size(); ++i)
+    EXPECT_EQ(values[i], valuesOnly[i]);
+
+  // Only the upper triangle is read
+  math::Matrix3d upper(2, 1, 0, 100, 2, 0, 100, 100, 5);
+  math::Vector3d upperValues;
+  math::Matrix3d::SymmetricEigen(&upper, 1, &upperValues);
+  EXPECT_TRUE(upperValues.Equal(math::Vector3d(1, 3, 5), 1e-12));
+
+  // Single precision
+  math::Matrix3f mf(4, 1, 0, 1, 4, 0, 0, 0, 1);
+  math::Vector3f valuesf;
+  math::Matrix3f vectorsf;
+  math::Matrix3f::SymmetricEigen(&mf, 1, &valuesf, &vectorsf);
+  EXPECT_TRUE(valuesf.Equal(math::Vector3f(1, 3, 5), 1e-5f));
+}
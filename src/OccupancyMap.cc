@@ -0,0 +1,816 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include <ignition/math/OccupancyMap.hh>
+#include <ignition/math/SpaceFillingCurve.hh>
+
+using namespace ignition::math;
+
+namespace
+{
+  /// \brief Number of levels below the root. Voxels are at this level.
+  const int kDepth = 16;
+
+  /// \brief Number of voxels along each side of the map.
+  const int64_t kSide = int64_t(1) << kDepth;
+
+  /// \brief Magic bytes at the start of a saved map, with the format
+  /// version in the last byte.
+  const char kMagic[8] = {'I', 'G', 'N', 'O', 'C', 'C', 'M', 1};
+
+  /// \brief Types of the nodes in a saved map.
+  enum NodeType
+  {
+    /// \brief A leaf that was never observed.
+    NODE_UNKNOWN = 0,
+
+    /// \brief A leaf with a value.
+    NODE_LEAF = 1,
+
+    /// \brief A node with children.
+    NODE_INNER = 2
+  };
+
+  /// \brief A node of the tree.
+  struct Node
+  {
+    /// \brief Index of the first of the eight children, or zero for a
+    /// leaf. The root is the only node at index zero.
+    uint32_t children;
+
+    /// \brief Log-odds of occupancy of a leaf, or the largest one of the
+    /// known leaves below an inner node. NaN if unknown.
+    float logOdds;
+  };
+
+  /// \brief Log-odds value of unknown nodes.
+  const float kUnknown = std::numeric_limits<float>::quiet_NaN();
+
+  /// \brief Convert a probability to log-odds.
+  /// \param[in] _p Probability.
+  /// \return Log-odds.
+  inline float LogOdds(const double _p)
+  {
+    return static_cast<float>(std::log(_p / (1 - _p)));
+  }
+
+  /// \brief Lowest log-odds of a known leaf.
+  const float kClampMin = LogOdds(0.12);
+
+  /// \brief Highest log-odds of a known leaf.
+  const float kClampMax = LogOdds(0.97);
+
+  /// \brief Convert log-odds to a probability.
+  /// \param[in] _l Log-odds.
+  /// \return Probability.
+  inline double Probability(const float _l)
+  {
+    return 1.0 / (1.0 + std::exp(-static_cast<double>(_l)));
+  }
+
+  /// \brief Check whether two values are equal, with unknown values equal
+  /// to each other.
+  inline bool Same(const float _a, const float _b)
+  {
+    if (std::isnan(_a) || std::isnan(_b))
+      return std::isnan(_a) && std::isnan(_b);
+    return !(_a < _b) && !(_b < _a);
+  }
+
+  /// \brief Get the Morton code of a voxel.
+  /// \param[in] _x X coordinate.
+  /// \param[in] _y Y coordinate.
+  /// \param[in] _z Z coordinate.
+  /// \return Morton code.
+  inline uint64_t Morton(const int64_t _x, const int64_t _y, const int64_t _z)
+  {
+    return SpaceFillingCurve::Morton(static_cast<uint32_t>(_x),
+        static_cast<uint32_t>(_y), static_cast<uint32_t>(_z));
+  }
+
+  /// \brief Append bytes to a buffer in little endian order.
+  /// \param[in] _value Value to write.
+  /// \param[in] _bytes Number of bytes.
+  /// \param[in,out] _buffer Buffer.
+  void Write(uint64_t _value, const int _bytes, std::string &_buffer)
+  {
+    for (int i = 0; i < _bytes; ++i, _value >>= 8)
+      _buffer.push_back(static_cast<char>(_value & 0xff));
+  }
+
+  /// \brief Read bytes in little endian order.
+  /// \param[in] _in Stream.
+  /// \param[in] _bytes Number of bytes.
+  /// \return The value, or zero if the stream failed.
+  uint64_t Read(std::istream &_in, const int _bytes)
+  {
+    unsigned char data[8] = {0};
+    if (!_in.read(reinterpret_cast<char *>(data), _bytes))
+      return 0;
+    uint64_t value = 0;
+    for (int i = _bytes - 1; i >= 0; --i)
+      value = (value << 8) | data[i];
+    return value;
+  }
+}
+
+/// \brief Private data for the OccupancyMap class.
+class ignition::math::OccupancyMapPrivate
+{
+  /// \brief Get the voxel that holds a point.
+  /// \param[in] _p The point.
+  /// \param[out] _code Morton code of the voxel.
+  /// \return False if the point is outside the map.
+  public: bool Key(const Vector3d &_p, uint64_t &_code) const;
+
+  /// \brief Get the leaf that holds a voxel.
+  /// \param[in] _code Morton code of the voxel.
+  /// \return The leaf.
+  public: const Node &Find(const uint64_t _code) const;
+
+  /// \brief Update a voxel.
+  /// \param[in] _code Morton code of the voxel.
+  /// \param[in] _delta Log-odds to add.
+  public: void Update(const uint64_t _code, const float _delta);
+
+  /// \brief Add the voxels crossed by a segment to the scan buffers.
+  /// \param[in] _start Start of the segment.
+  /// \param[in] _end End of the segment.
+  /// \param[in] _hit True if the voxel of _end is a hit.
+  /// \return True if the end was added as a hit.
+  public: bool Trace(const Vector3d &_start, const Vector3d &_end,
+              bool _hit);
+
+  /// \brief Take a block of eight leaves from the pool.
+  /// \param[in] _logOdds Value of the leaves.
+  /// \return Index of the first leaf.
+  public: uint32_t Allocate(const float _logOdds);
+
+  /// \brief Collect the known leaves below a node.
+  /// \param[in] _index Index of the node.
+  /// \param[in] _level Level of the node.
+  /// \param[in] _x X coordinate of the first voxel of the node.
+  /// \param[in] _y Y coordinate of the first voxel of the node.
+  /// \param[in] _z Z coordinate of the first voxel of the node.
+  /// \param[in] _visible Function that tells whether a node box is
+  /// wanted.
+  /// \param[in] _occupiedOnly True to only collect occupied leaves.
+  /// \param[out] _leaves The leaves.
+  public: template<typename Visible>
+          void Collect(const uint32_t _index, const int _level,
+              const int64_t _x, const int64_t _y, const int64_t _z,
+              const Visible &_visible, const bool _occupiedOnly,
+              std::vector<OccupancyMap::Leaf> &_leaves) const;
+
+  /// \brief Append a node and its descendants to a buffer.
+  /// \param[in] _index Index of the node, which is an inner node.
+  /// \param[in,out] _buffer Buffer.
+  public: void Save(const uint32_t _index, std::string &_buffer) const;
+
+  /// \brief Read the children of an inner node.
+  /// \param[in] _in Stream.
+  /// \param[in] _index Index of the node.
+  /// \param[in] _level Level of the node.
+  /// \return False if the data is not valid.
+  public: bool Load(std::istream &_in, const uint32_t _index,
+              const int _level);
+
+  /// \brief Set the value of an inner node from its children.
+  /// \param[in] _index Index of the node.
+  public: void Summarize(const uint32_t _index);
+
+  /// \brief Length of the sides of a voxel.
+  public: double resolution = 0.1;
+
+  /// \brief Log-odds added by a hit.
+  public: float hit = LogOdds(0.7);
+
+  /// \brief Log-odds added by a miss.
+  public: float miss = LogOdds(0.4);
+
+  /// \brief Nodes. The root is at index zero and the others are in
+  /// blocks of eight siblings.
+  public: std::vector<Node> nodes = {{0, kUnknown}};
+
+  /// \brief Blocks of nodes that are free for reuse.
+  public: std::vector<uint32_t> freeBlocks;
+
+  /// \brief Voxels crossed by the rays of a scan.
+  public: std::vector<uint64_t> misses;
+
+  /// \brief Voxels hit by a scan.
+  public: std::vector<uint64_t> hits;
+};
+
+//////////////////////////////////////////////////
+bool OccupancyMapPrivate::Key(const Vector3d &_p, uint64_t &_code) const
+{
+  int64_t key[3];
+  for (int a = 0; a < 3; ++a)
+  {
+    const double g = std::floor(_p[a] / this->resolution + kSide / 2);
+    if (!(g >= 0 && g < kSide))
+      return false;
+    key[a] = static_cast<int64_t>(g);
+  }
+  _code = Morton(key[0], key[1], key[2]);
+  return true;
+}
+
+//////////////////////////////////////////////////
+const Node &OccupancyMapPrivate::Find(const uint64_t _code) const
+{
+  const Node *node = &this->nodes[0];
+  for (int level = 0; level < kDepth && node->children != 0; ++level)
+  {
+    const int shift = 3 * (kDepth - 1 - level);
+    node = &this->nodes[node->children + ((_code >> shift) & 7)];
+  }
+  return *node;
+}
+
+//////////////////////////////////////////////////
+uint32_t OccupancyMapPrivate::Allocate(const float _logOdds)
+{
+  uint32_t block;
+  if (!this->freeBlocks.empty())
+  {
+    block = this->freeBlocks.back();
+    this->freeBlocks.pop_back();
+  }
+  else
+  {
+    block = static_cast<uint32_t>(this->nodes.size());
+    this->nodes.resize(this->nodes.size() + 8);
+  }
+  for (uint32_t i = block; i < block + 8; ++i)
+    this->nodes[i] = {0, _logOdds};
+  return block;
+}
+
+//////////////////////////////////////////////////
+void OccupancyMapPrivate::Summarize(const uint32_t _index)
+{
+  const Node *children = &this->nodes[this->nodes[_index].children];
+  float value = kUnknown;
+  for (int i = 0; i < 8; ++i)
+  {
+    if (!std::isnan(children[i].logOdds) &&
+        !(children[i].logOdds <= value))
+    {
+      value = children[i].logOdds;
+    }
+  }
+  this->nodes[_index].logOdds = value;
+}
+
+//////////////////////////////////////////////////
+void OccupancyMapPrivate::Update(const uint64_t _code, const float _delta)
+{
+  uint32_t path[kDepth];
+  int depth = 0;
+  uint32_t index = 0;
+  for (int level = 0; ; ++level)
+  {
+    if (this->nodes[index].children == 0)
+    {
+      const float value = this->nodes[index].logOdds;
+      const float updated = std::min(kClampMax, std::max(kClampMin,
+            (std::isnan(value) ? 0.0f : value) + _delta));
+
+      // A leaf that is clamped, possibly a merged one, does not change
+      if (Same(updated, value))
+        return;
+
+      if (level == kDepth)
+      {
+        this->nodes[index].logOdds = updated;
+        break;
+      }
+
+      const uint32_t block = this->Allocate(value);
+      this->nodes[index].children = block;
+    }
+    path[depth++] = index;
+    const int shift = 3 * (kDepth - 1 - level);
+    index = this->nodes[index].children +
+      static_cast<uint32_t>((_code >> shift) & 7);
+  }
+
+  // Merge equal siblings and update the values of the ancestors, until a
+  // node does not change
+  for (int i = depth - 1; i >= 0; --i)
+  {
+    Node &parent = this->nodes[path[i]];
+    const Node *children = &this->nodes[parent.children];
+    bool same = true;
+    for (int c = 0; c < 8 && same; ++c)
+    {
+      same = children[c].children == 0 &&
+        Same(children[c].logOdds, children[0].logOdds);
+    }
+
+    if (same)
+    {
+      this->freeBlocks.push_back(parent.children);
+      parent.children = 0;
+      parent.logOdds = children[0].logOdds;
+      continue;
+    }
+
+    const float previous = parent.logOdds;
+    this->Summarize(path[i]);
+    if (Same(previous, parent.logOdds))
+      break;
+  }
+}
+
+//////////////////////////////////////////////////
+bool OccupancyMapPrivate::Trace(const Vector3d &_start, const Vector3d &_end,
+    bool _hit)
+{
+  // Work in voxel units, and clip the segment to the map
+  double g0[3], g1[3], d[3];
+  double t0 = 0;
+  double t1 = 1;
+  for (int a = 0; a < 3; ++a)
+  {
+    g0[a] = _start[a] / this->resolution + kSide / 2;
+    g1[a] = _end[a] / this->resolution + kSide / 2;
+    d[a] = g1[a] - g0[a];
+    if (!(std::abs(d[a]) > 0))
+    {
+      if (!(g0[a] >= 0 && g0[a] < kSide))
+        return false;
+      continue;
+    }
+    double ta = (0 - g0[a]) / d[a];
+    double tb = (kSide - g0[a]) / d[a];
+    if (ta > tb)
+      std::swap(ta, tb);
+    t0 = std::max(t0, ta);
+    t1 = std::min(t1, tb);
+  }
+  if (!(t0 <= t1))
+    return false;
+  // The clipped range is within [0, 1]
+  const bool startClipped = t0 > 0;
+  const bool endClipped = t1 < 1;
+  _hit = _hit && !endClipped;
+
+  int64_t cell[3], last[3], step[3];
+  double tMax[3], tDelta[3];
+  int64_t steps = 0;
+  for (int a = 0; a < 3; ++a)
+  {
+    // Unclipped ends use the same voxel as Key()
+    const double start = startClipped ? g0[a] + d[a] * t0 : g0[a];
+    const double end = endClipped ? g0[a] + d[a] * t1 : g1[a];
+    cell[a] = std::min(kSide - 1, std::max<int64_t>(0,
+          static_cast<int64_t>(std::floor(start))));
+    last[a] = std::min(kSide - 1, std::max<int64_t>(0,
+          static_cast<int64_t>(std::floor(end))));
+    step[a] = last[a] > cell[a] ? 1 : -1;
+    steps += std::abs(last[a] - cell[a]);
+    if (!(std::abs(d[a]) > 0))
+    {
+      tMax[a] = std::numeric_limits<double>::infinity();
+      tDelta[a] = 0;
+      continue;
+    }
+    const double boundary = static_cast<double>(cell[a] +
+        (d[a] > 0 ? 1 : 0));
+    tMax[a] = (boundary - g0[a]) / d[a];
+    tDelta[a] = 1.0 / std::abs(d[a]);
+  }
+
+  // Step to the neighbor whose boundary the ray crosses first. Axes that
+  // already reached the last voxel are not stepped, so rounding never
+  // leads the walk astray.
+  for (int64_t i = 0; i < steps; ++i)
+  {
+    this->misses.push_back(Morton(cell[0], cell[1], cell[2]));
+    int axis = -1;
+    for (int a = 0; a < 3; ++a)
+    {
+      if (cell[a] != last[a] && (axis < 0 || tMax[a] < tMax[axis]))
+        axis = a;
+    }
+    cell[axis] += step[axis];
+    tMax[axis] += tDelta[axis];
+  }
+
+  const uint64_t code = Morton(cell[0], cell[1], cell[2]);
+  if (_hit)
+    this->hits.push_back(code);
+  else
+    this->misses.push_back(code);
+  return _hit;
+}
+
+//////////////////////////////////////////////////
+template<typename Visible>
+void OccupancyMapPrivate::Collect(const uint32_t _index, const int _level,
+    const int64_t _x, const int64_t _y, const int64_t _z,
+    const Visible &_visible, const bool _occupiedOnly,
+    std::vector<OccupancyMap::Leaf> &_leaves) const
+{
+  const Node &node = this->nodes[_index];
+  if (std::isnan(node.logOdds) || (_occupiedOnly && !(node.logOdds > 0)))
+    return;
+
+  const int64_t size = int64_t(1) << (kDepth - _level);
+  const double res = this->resolution;
+  const Vector3d min((_x - kSide / 2) * res, (_y - kSide / 2) * res,
+      (_z - kSide / 2) * res);
+  const double length = size * res;
+  if (!_visible(min, min + Vector3d(length, length, length)))
+    return;
+
+  if (node.children == 0)
+  {
+    OccupancyMap::Leaf leaf;
+    leaf.center = min + Vector3d(length, length, length) * 0.5;
+    leaf.size = length;
+    leaf.probability = Probability(node.logOdds);
+    _leaves.push_back(leaf);
+    return;
+  }
+
+  const int64_t half = size / 2;
+  for (uint32_t c = 0; c < 8; ++c)
+  {
+    this->Collect(node.children + c, _level + 1,
+        _x + (c & 1) * half, _y + ((c >> 1) & 1) * half,
+        _z + ((c >> 2) & 1) * half, _visible, _occupiedOnly, _leaves);
+  }
+}
+
+//////////////////////////////////////////////////
+void OccupancyMapPrivate::Save(const uint32_t _index,
+    std::string &_buffer) const
+{
+  const Node *children = &this->nodes[this->nodes[_index].children];
+  uint64_t types = 0;
+  for (int c = 0; c < 8; ++c)
+  {
+    const uint64_t type = children[c].children != 0 ? NODE_INNER :
+      (std::isnan(children[c].logOdds) ? NODE_UNKNOWN : NODE_LEAF);
+    types |= type << (2 * c);
+  }
+  Write(types, 2, _buffer);
+
+  for (int c = 0; c < 8; ++c)
+  {
+    if (children[c].children == 0 && !std::isnan(children[c].logOdds))
+    {
+      uint32_t bits;
+      std::memcpy(&bits, &children[c].logOdds, sizeof(bits));
+      Write(bits, 4, _buffer);
+    }
+  }
+  for (uint32_t c = 0; c < 8; ++c)
+  {
+    if (children[c].children != 0)
+      this->Save(this->nodes[_index].children + c, _buffer);
+  }
+}
+
+//////////////////////////////////////////////////
+bool OccupancyMapPrivate::Load(std::istream &_in, const uint32_t _index,
+    const int _level)
+{
+  if (_level >= kDepth)
+    return false;
+
+  const uint64_t types = Read(_in, 2);
+  const uint32_t block = this->Allocate(kUnknown);
+  this->nodes[_index].children = block;
+  for (uint32_t c = 0; c < 8; ++c)
+  {
+    const uint64_t type = (types >> (2 * c)) & 3;
+    if (type == NODE_LEAF)
+    {
+      const uint32_t bits = static_cast<uint32_t>(Read(_in, 4));
+      float value;
+      std::memcpy(&value, &bits, sizeof(value));
+      if (!(value >= kClampMin && value <= kClampMax))
+        return false;
+      this->nodes[block + c].logOdds = value;
+    }
+    else if (type != NODE_UNKNOWN && type != NODE_INNER)
+    {
+      return false;
+    }
+  }
+  for (uint32_t c = 0; c < 8; ++c)
+  {
+    if (((types >> (2 * c)) & 3) == NODE_INNER &&
+        !this->Load(_in, block + c, _level + 1))
+    {
+      return false;
+    }
+  }
+  this->Summarize(_index);
+  return static_cast<bool>(_in);
+}
+
+//////////////////////////////////////////////////
+OccupancyMap::OccupancyMap(const double _resolution)
+  : dataPtr(new OccupancyMapPrivate)
+{
+  if (_resolution > 0 && std::isfinite(_resolution))
+    this->dataPtr->resolution = _resolution;
+  else
+    std::cerr << "Invalid resolution [" << _resolution << "], using 0.1\n";
+}
+
+//////////////////////////////////////////////////
+OccupancyMap::OccupancyMap(const OccupancyMap &_map)
+  : dataPtr(new OccupancyMapPrivate(*_map.dataPtr))
+{
+}
+
+//////////////////////////////////////////////////
+OccupancyMap::~OccupancyMap()
+{
+}
+
+//////////////////////////////////////////////////
+OccupancyMap &OccupancyMap::operator=(const OccupancyMap &_map)
+{
+  *this->dataPtr = *_map.dataPtr;
+  return *this;
+}
+
+//////////////////////////////////////////////////
+double OccupancyMap::Resolution() const
+{
+  return this->dataPtr->resolution;
+}
+
+//////////////////////////////////////////////////
+AxisAlignedBox OccupancyMap::Bounds() const
+{
+  const double half = this->dataPtr->resolution * (kSide / 2);
+  return AxisAlignedBox(-half, -half, -half, half, half, half);
+}
+
+//////////////////////////////////////////////////
+bool OccupancyMap::SetSensorModel(const double _hit, const double _miss)
+{
+  if (!(_hit > 0.5 && _hit < 1 && _miss > 0 && _miss < 0.5))
+  {
+    std::cerr << "Invalid sensor model, hit [" << _hit << "] must be in "
+      << "(0.5, 1) and miss [" << _miss << "] in (0, 0.5)\n";
+    return false;
+  }
+  this->dataPtr->hit = LogOdds(_hit);
+  this->dataPtr->miss = LogOdds(_miss);
+  return true;
+}
+
+//////////////////////////////////////////////////
+void OccupancyMap::Clear()
+{
+  this->dataPtr->nodes = {{0, kUnknown}};
+  this->dataPtr->freeBlocks.clear();
+}
+
+//////////////////////////////////////////////////
+bool OccupancyMap::Update(const Vector3d &_point, const bool _occupied)
+{
+  uint64_t code;
+  if (!this->dataPtr->Key(_point, code))
+    return false;
+  this->dataPtr->Update(code,
+      _occupied ? this->dataPtr->hit : this->dataPtr->miss);
+  return true;
+}
+
+//////////////////////////////////////////////////
+size_t OccupancyMap::InsertScan(const Vector3d &_origin,
+    const std::vector<Vector3d> &_points, const double _maxRange)
+{
+  if (!_origin.IsFinite())
+    return 0;
+
+  auto &misses = this->dataPtr->misses;
+  auto &hits = this->dataPtr->hits;
+  misses.clear();
+  hits.clear();
+
+  size_t count = 0;
+  for (const Vector3d &p : _points)
+  {
+    if (!p.IsFinite())
+      continue;
+    const double range = p.Distance(_origin);
+    if (range > _maxRange)
+    {
+      this->dataPtr->Trace(_origin,
+          _origin + (p - _origin) * (_maxRange / range), false);
+    }
+    else if (this->dataPtr->Trace(_origin, p, true))
+    {
+      ++count;
+    }
+  }
+
+  // Morton order visits the tree depth first, which keeps the updates
+  // within the same branches
+  SpaceFillingCurve::RadixSort(misses);
+  misses.erase(std::unique(misses.begin(), misses.end()), misses.end());
+  SpaceFillingCurve::RadixSort(hits);
+  hits.erase(std::unique(hits.begin(), hits.end()), hits.end());
+
+  auto hit = hits.begin();
+  for (const uint64_t code : misses)
+  {
+    while (hit != hits.end() && *hit < code)
+      ++hit;
+    if (hit == hits.end() || *hit != code)
+      this->dataPtr->Update(code, this->dataPtr->miss);
+  }
+  for (const uint64_t code : hits)
+    this->dataPtr->Update(code, this->dataPtr->hit);
+
+  return count;
+}
+
+//////////////////////////////////////////////////
+bool OccupancyMap::Occupancy(const Vector3d &_point,
+    double &_probability) const
+{
+  uint64_t code;
+  if (!this->dataPtr->Key(_point, code))
+    return false;
+  const Node &leaf = this->dataPtr->Find(code);
+  if (std::isnan(leaf.logOdds))
+    return false;
+  _probability = Probability(leaf.logOdds);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool OccupancyMap::Occupied(const Vector3d &_point) const
+{
+  uint64_t code;
+  return this->dataPtr->Key(_point, code) &&
+    this->dataPtr->Find(code).logOdds > 0;
+}
+
+//////////////////////////////////////////////////
+void OccupancyMap::Leaves(const AxisAlignedBox &_box,
+    std::vector<Leaf> &_leaves, const bool _occupiedOnly) const
+{
+  _leaves.clear();
+
+  // Voxels are half open, so a box that ends on a voxel boundary does not
+  // reach into the next voxel
+  const Vector3d &boxMin = _box.Min();
+  const Vector3d &boxMax = _box.Max();
+  auto visible = [&](const Vector3d &_min, const Vector3d &_max)
+  {
+    return _min.X() <= boxMax.X() && _max.X() > boxMin.X() &&
+      _min.Y() <= boxMax.Y() && _max.Y() > boxMin.Y() &&
+      _min.Z() <= boxMax.Z() && _max.Z() > boxMin.Z();
+  };
+  this->dataPtr->Collect(0, 0, 0, 0, 0, visible, _occupiedOnly, _leaves);
+}
+
+//////////////////////////////////////////////////
+void OccupancyMap::Leaves(const Frustum &_frustum,
+    std::vector<Leaf> &_leaves, const bool _occupiedOnly) const
+{
+  _leaves.clear();
+  auto visible = [&](const Vector3d &_min, const Vector3d &_max)
+  {
+    return _frustum.Contains(AxisAlignedBox(_min, _max));
+  };
+  this->dataPtr->Collect(0, 0, 0, 0, 0, visible, _occupiedOnly, _leaves);
+}
+
+//////////////////////////////////////////////////
+size_t OccupancyMap::LeafCount() const
+{
+  size_t count = 0;
+  for (const Node &node : this->dataPtr->nodes)
+  {
+    if (node.children == 0 && !std::isnan(node.logOdds))
+      ++count;
+  }
+
+  // Blocks in the pool hold stale leaves
+  for (const uint32_t block : this->dataPtr->freeBlocks)
+  {
+    for (uint32_t i = block; i < block + 8; ++i)
+    {
+      const Node &node = this->dataPtr->nodes[i];
+      if (node.children == 0 && !std::isnan(node.logOdds))
+        --count;
+    }
+  }
+  return count;
+}
+
+//////////////////////////////////////////////////
+size_t OccupancyMap::MemoryUsage() const
+{
+  return this->dataPtr->nodes.capacity() * sizeof(Node) +
+    this->dataPtr->freeBlocks.capacity() * sizeof(uint32_t);
+}
+
+//////////////////////////////////////////////////
+bool OccupancyMap::Save(std::ostream &_out) const
+{
+  std::string buffer(kMagic, sizeof(kMagic));
+  uint64_t resolution;
+  std::memcpy(&resolution, &this->dataPtr->resolution, sizeof(resolution));
+  Write(resolution, 8, buffer);
+
+  const Node &root = this->dataPtr->nodes[0];
+  if (root.children != 0)
+  {
+    Write(NODE_INNER, 1, buffer);
+    this->dataPtr->Save(0, buffer);
+  }
+  else if (std::isnan(root.logOdds))
+  {
+    Write(NODE_UNKNOWN, 1, buffer);
+  }
+  else
+  {
+    Write(NODE_LEAF, 1, buffer);
+    uint32_t bits;
+    std::memcpy(&bits, &root.logOdds, sizeof(bits));
+    Write(bits, 4, buffer);
+  }
+
+  _out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+  return static_cast<bool>(_out);
+}
+
+//////////////////////////////////////////////////
+bool OccupancyMap::Load(std::istream &_in)
+{
+  char magic[sizeof(kMagic)];
+  if (!_in.read(magic, sizeof(magic)) ||
+      !std::equal(magic, magic + sizeof(magic), kMagic))
+  {
+    std::cerr << "Not an occupancy map, or an unsupported version\n";
+    return false;
+  }
+
+  OccupancyMapPrivate data;
+  data.hit = this->dataPtr->hit;
+  data.miss = this->dataPtr->miss;
+  const uint64_t resolution = Read(_in, 8);
+  std::memcpy(&data.resolution, &resolution, sizeof(resolution));
+
+  bool valid = data.resolution > 0 && std::isfinite(data.resolution);
+  const uint64_t type = Read(_in, 1);
+  if (valid && type == NODE_INNER)
+  {
+    valid = data.Load(_in, 0, 0);
+  }
+  else if (valid && type == NODE_LEAF)
+  {
+    const uint32_t bits = static_cast<uint32_t>(Read(_in, 4));
+    std::memcpy(&data.nodes[0].logOdds, &bits, sizeof(bits));
+    valid = data.nodes[0].logOdds >= kClampMin &&
+      data.nodes[0].logOdds <= kClampMax;
+  }
+  else
+  {
+    valid = valid && type == NODE_UNKNOWN;
+  }
+
+  if (!valid || !_in)
+  {
+    std::cerr << "Invalid or truncated occupancy map\n";
+    return false;
+  }
+  *this->dataPtr = std::move(data);
+  return true;
+}
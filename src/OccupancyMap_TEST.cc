@@ -0,0 +1,325 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ignition/math/Helpers.hh"
+#include "ignition/math/OccupancyMap.hh"
+#include "ignition/math/Rand.hh"
+
+using namespace ignition;
+
+/////////////////////////////////////////////////
+/// \brief Check that two maps have the same leaves.
+void ExpectSameLeaves(const math::OccupancyMap &_a,
+    const math::OccupancyMap &_b)
+{
+  std::vector<math::OccupancyMap::Leaf> leavesA, leavesB;
+  _a.Leaves(_a.Bounds(), leavesA);
+  _b.Leaves(_b.Bounds(), leavesB);
+  ASSERT_EQ(leavesA.size(), leavesB.size());
+  for (size_t i = 0; i < leavesA.size(); ++i)
+  {
+    EXPECT_EQ(leavesA[i].center, leavesB[i].center);
+    EXPECT_DOUBLE_EQ(leavesA[i].size, leavesB[i].size);
+    EXPECT_DOUBLE_EQ(leavesA[i].probability, leavesB[i].probability);
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(OccupancyMapTest, Empty)
+{
+  math::OccupancyMap map;
+  EXPECT_DOUBLE_EQ(0.1, map.Resolution());
+  EXPECT_EQ(math::AxisAlignedBox(-3276.8, -3276.8, -3276.8,
+        3276.8, 3276.8, 3276.8), map.Bounds());
+  EXPECT_EQ(0u, map.LeafCount());
+  EXPECT_GT(map.MemoryUsage(), 0u);
+
+  double probability = 3;
+  EXPECT_FALSE(map.Occupancy(math::Vector3d::Zero, probability));
+  EXPECT_DOUBLE_EQ(3.0, probability);
+  EXPECT_FALSE(map.Occupied(math::Vector3d::Zero));
+
+  std::vector<math::OccupancyMap::Leaf> leaves(2);
+  map.Leaves(map.Bounds(), leaves);
+  EXPECT_TRUE(leaves.empty());
+
+  EXPECT_DOUBLE_EQ(0.25, math::OccupancyMap(0.25).Resolution());
+  EXPECT_DOUBLE_EQ(0.1, math::OccupancyMap(0).Resolution());
+  EXPECT_DOUBLE_EQ(0.1, math::OccupancyMap(-1).Resolution());
+
+  EXPECT_FALSE(map.SetSensorModel(0.5, 0.4));
+  EXPECT_FALSE(map.SetSensorModel(0.7, 0.5));
+  EXPECT_FALSE(map.SetSensorModel(1.0, 0.4));
+  EXPECT_FALSE(map.SetSensorModel(0.7, 0.0));
+  EXPECT_TRUE(map.SetSensorModel(0.9, 0.2));
+}
+
+/////////////////////////////////////////////////
+TEST(OccupancyMapTest, Update)
+{
+  math::OccupancyMap map(0.5);
+  const math::Vector3d p(1.2, -0.3, 0.7);
+  double probability;
+
+  EXPECT_TRUE(map.Update(p, true));
+  ASSERT_TRUE(map.Occupancy(p, probability));
+  EXPECT_NEAR(0.7, probability, 1e-6);
+  EXPECT_TRUE(map.Occupied(p));
+  EXPECT_EQ(1u, map.LeafCount());
+
+  // The whole voxel has the value, and its neighbors are unknown
+  EXPECT_TRUE(map.Occupied(math::Vector3d(1.0, -0.5, 0.5)));
+  EXPECT_TRUE(map.Occupied(math::Vector3d(1.49, -0.01, 0.99)));
+  EXPECT_FALSE(map.Occupancy(math::Vector3d(1.5, -0.3, 0.7), probability));
+  EXPECT_FALSE(map.Occupancy(math::Vector3d(1.2, 0, 0.7), probability));
+
+  // A hit and a miss cancel
+  EXPECT_TRUE(map.Update(p, false));
+  ASSERT_TRUE(map.Occupancy(p, probability));
+  EXPECT_NEAR(0.7 * 0.4 / (0.7 * 0.4 + 0.3 * 0.6), probability, 1e-6);
+
+  // Values are clamped
+  for (int i = 0; i < 50; ++i)
+    map.Update(p, true);
+  ASSERT_TRUE(map.Occupancy(p, probability));
+  EXPECT_NEAR(0.97, probability, 1e-6);
+  for (int i = 0; i < 50; ++i)
+    map.Update(p, false);
+  ASSERT_TRUE(map.Occupancy(p, probability));
+  EXPECT_NEAR(0.12, probability, 1e-6);
+  EXPECT_FALSE(map.Occupied(p));
+
+  // Outside the map
+  EXPECT_FALSE(map.Update(math::Vector3d(1e5, 0, 0), true));
+  EXPECT_FALSE(map.Update(math::Vector3d(NAN, 0, 0), true));
+  EXPECT_FALSE(map.Occupied(math::Vector3d(0, -1e5, 0)));
+  EXPECT_EQ(1u, map.LeafCount());
+
+  map.Clear();
+  EXPECT_EQ(0u, map.LeafCount());
+  EXPECT_FALSE(map.Occupancy(p, probability));
+}
+
+/////////////////////////////////////////////////
+TEST(OccupancyMapTest, Merge)
+{
+  math::OccupancyMap map(1.0);
+
+  // Eight clamped voxels of one parent merge into one leaf
+  for (int i = 0; i < 8; ++i)
+  {
+    const math::Vector3d p(0.5 + (i & 1), 0.5 + ((i >> 1) & 1),
+        0.5 + ((i >> 2) & 1));
+    for (int j = 0; j < 10; ++j)
+      map.Update(p, true);
+    if (i < 7)
+    {
+      EXPECT_EQ(static_cast<size_t>(i + 1), map.LeafCount());
+    }
+  }
+  EXPECT_EQ(1u, map.LeafCount());
+
+  std::vector<math::OccupancyMap::Leaf> leaves;
+  map.Leaves(map.Bounds(), leaves);
+  ASSERT_EQ(1u, leaves.size());
+  EXPECT_EQ(math::Vector3d(1, 1, 1), leaves[0].center);
+  EXPECT_DOUBLE_EQ(2.0, leaves[0].size);
+  EXPECT_NEAR(0.97, leaves[0].probability, 1e-6);
+
+  // More hits do not split the merged leaf, a miss does
+  const size_t memory = map.MemoryUsage();
+  map.Update(math::Vector3d(0.5, 0.5, 0.5), true);
+  EXPECT_EQ(1u, map.LeafCount());
+  map.Update(math::Vector3d(0.5, 0.5, 0.5), false);
+  EXPECT_EQ(8u, map.LeafCount());
+  double probability;
+  ASSERT_TRUE(map.Occupancy(math::Vector3d(1.5, 1.5, 1.5), probability));
+  EXPECT_NEAR(0.97, probability, 1e-6);
+
+  // Merging again reuses the pooled nodes
+  map.Update(math::Vector3d(0.5, 0.5, 0.5), true);
+  EXPECT_EQ(1u, map.LeafCount());
+  map.Update(math::Vector3d(0.5, 0.5, 0.5), false);
+  map.Update(math::Vector3d(0.5, 0.5, 0.5), true);
+  EXPECT_EQ(memory, map.MemoryUsage());
+}
+
+/////////////////////////////////////////////////
+TEST(OccupancyMapTest, InsertScan)
+{
+  math::OccupancyMap map(0.1);
+  const math::Vector3d origin(0.05, 0.05, 0.05);
+
+  // A ray along x frees the voxels up to the hit
+  EXPECT_EQ(1u, map.InsertScan(origin, {math::Vector3d(1.05, 0.05, 0.05)}));
+  double probability;
+  for (int i = 0; i < 10; ++i)
+  {
+    ASSERT_TRUE(map.Occupancy(math::Vector3d(0.05 + i * 0.1, 0.05, 0.05),
+          probability)) << i;
+    EXPECT_NEAR(0.4, probability, 1e-6);
+  }
+  EXPECT_TRUE(map.Occupied(math::Vector3d(1.05, 0.05, 0.05)));
+  EXPECT_FALSE(map.Occupancy(math::Vector3d(1.15, 0.05, 0.05), probability));
+  EXPECT_EQ(11u, map.LeafCount());
+
+  // Voxels crossed by several rays of a scan are updated once, and hits
+  // win over misses
+  map.Clear();
+  EXPECT_EQ(2u, map.InsertScan(origin, {math::Vector3d(0.55, 0.05, 0.05),
+        math::Vector3d(1.05, 0.05, 0.05)}));
+  ASSERT_TRUE(map.Occupancy(math::Vector3d(0.25, 0.05, 0.05), probability));
+  EXPECT_NEAR(0.4, probability, 1e-6);
+  ASSERT_TRUE(map.Occupancy(math::Vector3d(0.55, 0.05, 0.05), probability));
+  EXPECT_NEAR(0.7, probability, 1e-6);
+
+  // Rays beyond the maximum range only free space
+  map.Clear();
+  EXPECT_EQ(0u, map.InsertScan(origin, {math::Vector3d(5.05, 0.05, 0.05)},
+        1.0));
+  EXPECT_FALSE(map.Occupied(math::Vector3d(5.05, 0.05, 0.05)));
+  ASSERT_TRUE(map.Occupancy(math::Vector3d(0.95, 0.05, 0.05), probability));
+  EXPECT_NEAR(0.4, probability, 1e-6);
+  EXPECT_FALSE(map.Occupancy(math::Vector3d(1.15, 0.05, 0.05), probability));
+
+  // Rays are cut at the bounds of the map
+  map.Clear();
+  EXPECT_EQ(0u, map.InsertScan(math::Vector3d(3276, 0, 0),
+        {math::Vector3d(3300, 0, 0), math::Vector3d(NAN, 0, 0)}));
+  EXPECT_TRUE(map.Occupancy(math::Vector3d(3276.75, 0, 0), probability));
+  EXPECT_EQ(8u, map.LeafCount());
+  EXPECT_EQ(0u, map.InsertScan(math::Vector3d(NAN, 0, 0),
+        {math::Vector3d(1, 0, 0)}));
+}
+
+/////////////////////////////////////////////////
+TEST(OccupancyMapTest, RandomScan)
+{
+  math::Rand::Seed(12);
+  math::OccupancyMap map(0.2);
+  const math::Vector3d origin(0.3, -0.1, 1.1);
+  std::vector<math::Vector3d> points;
+  for (int i = 0; i < 500; ++i)
+  {
+    math::Vector3d dir(math::Rand::DblNormal(0, 1),
+        math::Rand::DblNormal(0, 1), math::Rand::DblNormal(0, 1));
+    dir.Normalize();
+    points.push_back(origin + dir * math::Rand::DblUniform(1, 8));
+  }
+  EXPECT_EQ(points.size(), map.InsertScan(origin, points));
+
+  // Every hit is occupied, and every point along a ray is known
+  for (const math::Vector3d &p : points)
+  {
+    EXPECT_TRUE(map.Occupied(p));
+    const double length = p.Distance(origin);
+    for (double s = 0; s < length - 0.35; s += 0.01)
+    {
+      double probability;
+      const math::Vector3d q = origin + (p - origin) * (s / length);
+      ASSERT_TRUE(map.Occupancy(q, probability)) << p << " " << s;
+    }
+  }
+
+  // Box queries return the known leaves that overlap the box
+  const math::AxisAlignedBox box(-2, -2, 0, 2, 1, 3);
+  std::vector<math::OccupancyMap::Leaf> leaves, occupied;
+  map.Leaves(box, leaves);
+  map.Leaves(box, occupied, true);
+  EXPECT_FALSE(leaves.empty());
+  EXPECT_FALSE(occupied.empty());
+  EXPECT_LT(occupied.size(), leaves.size());
+  size_t occupiedCount = 0;
+  for (const math::OccupancyMap::Leaf &leaf : leaves)
+  {
+    const math::Vector3d half(leaf.size / 2, leaf.size / 2, leaf.size / 2);
+    EXPECT_TRUE(math::AxisAlignedBox(leaf.center - half,
+          leaf.center + half).Intersects(box));
+    double probability;
+    ASSERT_TRUE(map.Occupancy(leaf.center, probability));
+    EXPECT_DOUBLE_EQ(probability, leaf.probability);
+    if (probability > 0.5)
+      ++occupiedCount;
+  }
+  EXPECT_EQ(occupiedCount, occupied.size());
+
+  // Frustum queries only return leaves in front of the frustum
+  const math::Frustum frustum(0.1, 5, math::Angle(IGN_DTOR(60)), 1.0,
+      math::Pose3d(origin, math::Quaterniond::Identity));
+  map.Leaves(frustum, leaves);
+  EXPECT_FALSE(leaves.empty());
+  for (const math::OccupancyMap::Leaf &leaf : leaves)
+    EXPECT_GT(leaf.center.X() + leaf.size, origin.X());
+}
+
+/////////////////////////////////////////////////
+TEST(OccupancyMapTest, SaveLoad)
+{
+  math::Rand::Seed(2);
+  math::OccupancyMap map(0.25);
+  std::vector<math::Vector3d> points;
+  for (int i = 0; i < 200; ++i)
+  {
+    points.push_back(math::Vector3d(math::Rand::DblUniform(-5, 5),
+          math::Rand::DblUniform(-5, 5), math::Rand::DblUniform(-1, 1)));
+  }
+  map.InsertScan(math::Vector3d(0, 0, 1.5), points);
+  ASSERT_GT(map.LeafCount(), 100u);
+
+  std::stringstream stream;
+  ASSERT_TRUE(map.Save(stream));
+  const std::string data = stream.str();
+
+  // Two bytes per inner node and four per leaf, in the worst case
+  EXPECT_LT(data.size(), map.LeafCount() * 7);
+
+  math::OccupancyMap loaded(1.0);
+  std::stringstream in(data);
+  ASSERT_TRUE(loaded.Load(in));
+  EXPECT_DOUBLE_EQ(0.25, loaded.Resolution());
+  EXPECT_EQ(map.LeafCount(), loaded.LeafCount());
+  ExpectSameLeaves(map, loaded);
+
+  // Copies are independent
+  math::OccupancyMap copy(loaded);
+  loaded.Clear();
+  ExpectSameLeaves(map, copy);
+  loaded = copy;
+  ExpectSameLeaves(map, loaded);
+
+  // Truncated and foreign data is rejected and leaves the map unchanged
+  std::stringstream truncated(data.substr(0, data.size() / 2));
+  EXPECT_FALSE(loaded.Load(truncated));
+  ExpectSameLeaves(map, loaded);
+  std::stringstream foreign("not an occupancy map");
+  EXPECT_FALSE(loaded.Load(foreign));
+  ExpectSameLeaves(map, loaded);
+
+  // Empty map and a single merged root
+  math::OccupancyMap empty;
+  std::stringstream emptyStream;
+  ASSERT_TRUE(empty.Save(emptyStream));
+  ASSERT_TRUE(loaded.Load(emptyStream));
+  EXPECT_EQ(0u, loaded.LeafCount());
+}
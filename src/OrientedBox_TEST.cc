@@ -16,9 +16,12 @@
 */
 #include <gtest/gtest.h>
 #include <cmath>
+#include <memory>
+#include <vector>
 
 #include "ignition/math/Angle.hh"
 #include "ignition/math/OrientedBox.hh"
+#include "ignition/math/Rand.hh"
 
 using namespace ignition;
 using namespace math;
@@ -374,3 +377,185 @@ TEST(OrientedBoxTest, Mass)
   EXPECT_EQ(expectedMassMat, massMat);
   EXPECT_DOUBLE_EQ(expectedMassMat.Mass(), massMat.Mass());
 }
+
+//////////////////////////////////////////////////
+TEST(OrientedBoxTest, IntersectsFaces)
+{
+  const OrientedBoxd a(Vector3d(2, 2, 2));
+
+  EXPECT_TRUE(a.Intersects(a));
+  EXPECT_TRUE(a.Intersects(OrientedBoxd(Vector3d(0.1, 0.1, 0.1))));
+  EXPECT_TRUE(a.Intersects(OrientedBoxd(Vector3d(1, 1, 1),
+          Pose3d(1.4, 0, 0, 0, 0, 0))));
+  EXPECT_FALSE(a.Intersects(OrientedBoxd(Vector3d(1, 1, 1),
+          Pose3d(1.6, 0, 0, 0, 0, 0))));
+
+  // Touching boxes overlap
+  EXPECT_TRUE(a.Intersects(OrientedBoxd(Vector3d(1, 1, 1),
+          Pose3d(0, 1.5, 0, 0, 0, 0))));
+
+  // Separated by a face of the rotated box only
+  const OrientedBoxd b(Vector3d(2, 2, 2), Pose3d(2.6, 0, 0, 0, 0, IGN_PI_4));
+  EXPECT_FALSE(a.Intersects(b));
+  EXPECT_FALSE(b.Intersects(a));
+  const OrientedBoxd c(Vector3d(2, 2, 2), Pose3d(2.3, 0, 0, 0, 0, IGN_PI_4));
+  EXPECT_TRUE(a.Intersects(c));
+  EXPECT_TRUE(c.Intersects(a));
+
+  // Float boxes
+  const OrientedBoxf af(Vector3f(2, 2, 2), Pose3f(0, 0, 0, 0.3f, 0, 0));
+  EXPECT_TRUE(af.Intersects(OrientedBoxf(Vector3f(1, 1, 1),
+          Pose3f(1.4f, 0, 0, 0, 0, 0))));
+  EXPECT_FALSE(af.Intersects(OrientedBoxf(Vector3f(1, 1, 1),
+          Pose3f(1.6f, 0, 0, 0, 0, 0))));
+}
+
+//////////////////////////////////////////////////
+TEST(OrientedBoxTest, IntersectsEdges)
+{
+  // A vertical edge of the first box faces a horizontal edge of the
+  // second, so the only separating axis is their cross product
+  const double offset = std::sqrt(2.0);
+  const OrientedBoxd a(Vector3d(1, 1, 1), Pose3d(0, 0, 0, 0, 0, IGN_PI_4));
+  const OrientedBoxd b(Vector3d(1, 1, 1),
+      Pose3d(offset + 0.01, 0, 0, 0, IGN_PI_4, 0));
+  const OrientedBoxd c(Vector3d(1, 1, 1),
+      Pose3d(offset - 0.01, 0, 0, 0, IGN_PI_4, 0));
+  EXPECT_FALSE(a.Intersects(b));
+  EXPECT_FALSE(b.Intersects(a));
+  EXPECT_TRUE(a.Intersects(c));
+  EXPECT_TRUE(c.Intersects(a));
+
+  // Parallel edges
+  const OrientedBoxd d(Vector3d(1, 1, 1), Pose3d(0, 0, 0, 0, 0, 0.1));
+  EXPECT_TRUE(d.Intersects(OrientedBoxd(Vector3d(1, 1, 1),
+          Pose3d(0.9, 0.1, 0, 0, 0, 0.1))));
+  EXPECT_FALSE(d.Intersects(OrientedBoxd(Vector3d(1, 1, 1),
+          Pose3d(0, 0, 1.1, 0, 0, 0.1))));
+}
+
+//////////////////////////////////////////////////
+TEST(OrientedBoxTest, IntersectsAxisAlignedBox)
+{
+  const OrientedBoxd a(Vector3d(1, 1, 1), Pose3d(0, 0, 0, 0, 0, IGN_PI_4));
+  EXPECT_TRUE(a.Intersects(AxisAlignedBox(0.6, -0.1, -0.1, 1, 0.1, 0.1)));
+  EXPECT_FALSE(a.Intersects(AxisAlignedBox(0.8, -0.1, -0.1, 1, 0.1, 0.1)));
+  EXPECT_FALSE(a.Intersects(AxisAlignedBox(0.5, 0.5, -1, 1, 1, 1)));
+  EXPECT_FALSE(a.Intersects(AxisAlignedBox()));
+
+  // Same result as an oriented box without rotation
+  Rand::Seed(3);
+  for (int i = 0; i < 1000; ++i)
+  {
+    const Vector3d lower(Rand::DblUniform(-2, 2), Rand::DblUniform(-2, 2),
+        Rand::DblUniform(-2, 2));
+    const Vector3d size(Rand::DblUniform(0, 1), Rand::DblUniform(0, 1),
+        Rand::DblUniform(0, 1));
+    const OrientedBoxd b(Vector3d(Rand::DblUniform(0, 2),
+          Rand::DblUniform(0, 2), Rand::DblUniform(0, 2)),
+        Pose3d(Rand::DblUniform(-1, 1), Rand::DblUniform(-1, 1),
+          Rand::DblUniform(-1, 1), Rand::DblUniform(-IGN_PI, IGN_PI),
+          Rand::DblUniform(-IGN_PI, IGN_PI),
+          Rand::DblUniform(-IGN_PI, IGN_PI)));
+    EXPECT_EQ(b.Intersects(OrientedBoxd(size,
+            Pose3d(lower + size * 0.5, Quaterniond::Identity))),
+        b.Intersects(AxisAlignedBox(lower, lower + size)));
+  }
+}
+
+//////////////////////////////////////////////////
+TEST(OrientedBoxTest, IntersectsRandom)
+{
+  // Boxes that share a point overlap, and the test is symmetric
+  Rand::Seed(9);
+  std::vector<OrientedBoxd> boxes;
+  for (int i = 0; i < 200; ++i)
+  {
+    boxes.push_back(OrientedBoxd(Vector3d(Rand::DblUniform(0.1, 2),
+          Rand::DblUniform(0.1, 2), Rand::DblUniform(0.1, 2)),
+        Pose3d(Rand::DblUniform(-3, 3), Rand::DblUniform(-3, 3),
+          Rand::DblUniform(-3, 3), Rand::DblUniform(-IGN_PI, IGN_PI),
+          Rand::DblUniform(-IGN_PI, IGN_PI),
+          Rand::DblUniform(-IGN_PI, IGN_PI))));
+  }
+
+  int overlaps = 0;
+  for (size_t i = 0; i < boxes.size(); ++i)
+  {
+    const Matrix3d rot(boxes[i].Pose().Rot());
+    const Vector3d half = boxes[i].Size() * 0.5;
+    for (size_t j = 0; j < boxes.size(); ++j)
+    {
+      const bool overlap = boxes[i].Intersects(boxes[j]);
+      EXPECT_EQ(overlap, boxes[j].Intersects(boxes[i]));
+      overlaps += overlap ? 1 : 0;
+
+      // Corners, edge midpoints and the center of box i
+      for (int k = 0; k < 27; ++k)
+      {
+        const Vector3d local((k % 3 - 1) * half.X(),
+            (k / 3 % 3 - 1) * half.Y(), (k / 9 - 1) * half.Z());
+        const Vector3d p = boxes[i].Pose().Pos() + rot * local;
+        if (boxes[j].Contains(p))
+        {
+          EXPECT_TRUE(overlap) << i << " " << j;
+          break;
+        }
+      }
+    }
+  }
+  EXPECT_GT(overlaps, 400);
+  EXPECT_LT(overlaps, 40000);
+}
+
+//////////////////////////////////////////////////
+TEST(OrientedBoxTest, IntersectsBatch)
+{
+  Rand::Seed(17);
+  const OrientedBoxd box(Vector3d(1, 2, 0.5),
+      Pose3d(0.1, -0.2, 0.3, 0.4, -0.5, 0.6));
+
+  const size_t count = 500;
+  std::vector<OrientedBoxd> boxes;
+  std::vector<double> centers[3], halfSizes[3], rotations[9];
+  for (size_t k = 0; k < count; ++k)
+  {
+    const OrientedBoxd b(Vector3d(Rand::DblUniform(0.1, 1),
+          Rand::DblUniform(0.1, 1), Rand::DblUniform(0.1, 1)),
+        Pose3d(Rand::DblUniform(-2, 2), Rand::DblUniform(-2, 2),
+          Rand::DblUniform(-2, 2), Rand::DblUniform(-IGN_PI, IGN_PI),
+          Rand::DblUniform(-IGN_PI, IGN_PI),
+          Rand::DblUniform(-IGN_PI, IGN_PI)));
+    boxes.push_back(b);
+
+    const Matrix3d rot(b.Pose().Rot());
+    for (int i = 0; i < 3; ++i)
+    {
+      centers[i].push_back(b.Pose().Pos()[i]);
+      halfSizes[i].push_back(b.Size()[i] * 0.5);
+      for (int j = 0; j < 3; ++j)
+        rotations[3 * i + j].push_back(rot(i, j));
+    }
+  }
+
+  const double *c[3] = {centers[0].data(), centers[1].data(),
+    centers[2].data()};
+  const double *h[3] = {halfSizes[0].data(), halfSizes[1].data(),
+    halfSizes[2].data()};
+  const double *r[9];
+  for (int i = 0; i < 9; ++i)
+    r[i] = rotations[i].data();
+
+  std::unique_ptr<bool[]> results(new bool[count]);
+  const size_t hits = box.Intersects(c, h, r, count, results.get());
+
+  size_t expected = 0;
+  for (size_t k = 0; k < count; ++k)
+  {
+    EXPECT_EQ(box.Intersects(boxes[k]), results[k]) << k;
+    expected += results[k] ? 1 : 0;
+  }
+  EXPECT_EQ(expected, hits);
+  EXPECT_GT(hits, 0u);
+  EXPECT_LT(hits, count);
+}
@@ -0,0 +1,259 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "ignition/math/Parse.hh"
+#include "ignition/math/Rand.hh"
+
+using namespace ignition;
+
+/////////////////////////////////////////////////
+/// \brief Check that two numbers have the same bits.
+/// \param[in] _a First value.
+/// \param[in] _b Second value.
+/// \return True if the values are bit for bit identical.
+template<typename T>
+bool SameBits(const T _a, const T _b)
+{
+  return std::memcmp(&_a, &_b, sizeof(T)) == 0;
+}
+
+/////////////////////////////////////////////////
+/// \brief Check that the text written by the output operator is read to
+/// the same value by Parse and by the input operator.
+/// \param[in] _value Value to write.
+/// \return The value read by Parse.
+template<typename T>
+T RoundTrip(const T &_value)
+{
+  std::ostringstream out;
+  out << _value;
+
+  T streamed;
+  std::istringstream in(out.str());
+  in >> streamed;
+
+  T parsed;
+  const math::ParseResult result = math::Parse(out.str(), parsed);
+  EXPECT_TRUE(result) << out.str() << ": " << result.Message();
+  EXPECT_EQ(out.str().size(), result.position);
+
+  std::ostringstream streamedOut, parsedOut;
+  streamedOut << std::setprecision(17) << streamed;
+  parsedOut << std::setprecision(17) << parsed;
+  EXPECT_EQ(streamedOut.str(), parsedOut.str());
+  return parsed;
+}
+
+/////////////////////////////////////////////////
+TEST(ParseTest, Numbers)
+{
+  double d = 0;
+  EXPECT_TRUE(math::Parse("1.5", d));
+  EXPECT_DOUBLE_EQ(1.5, d);
+  EXPECT_TRUE(math::Parse("  -2e3\n", d));
+  EXPECT_DOUBLE_EQ(-2000, d);
+  EXPECT_TRUE(math::Parse("+.25", d));
+  EXPECT_DOUBLE_EQ(0.25, d);
+  EXPECT_TRUE(math::Parse("1e-310", d));
+  EXPECT_DOUBLE_EQ(1e-310, d);
+  EXPECT_TRUE(math::Parse("-inf", d));
+  EXPECT_TRUE(std::isinf(d));
+  EXPECT_TRUE(math::Parse("nan", d));
+  EXPECT_TRUE(std::isnan(d));
+
+  // Errors leave the value unchanged
+  d = 3;
+  math::ParseResult result = math::Parse("", d);
+  EXPECT_FALSE(result);
+  EXPECT_EQ(math::PARSE_MISSING_VALUE, result.error);
+  EXPECT_EQ(0u, result.position);
+  EXPECT_EQ(math::PARSE_MISSING_VALUE, math::Parse("  \t", d).error);
+  EXPECT_EQ(math::PARSE_INVALID_NUMBER, math::Parse("abc", d).error);
+  EXPECT_EQ(math::PARSE_INVALID_NUMBER, math::Parse("1.5x", d).error);
+  EXPECT_EQ(math::PARSE_INVALID_NUMBER, math::Parse("1,5", d).error);
+  EXPECT_EQ(math::PARSE_INVALID_NUMBER, math::Parse("+-1", d).error);
+  EXPECT_EQ(math::PARSE_INVALID_NUMBER, math::Parse("0x10", d).error);
+  EXPECT_EQ(math::PARSE_OUT_OF_RANGE, math::Parse("1e400", d).error);
+  EXPECT_EQ(math::PARSE_OUT_OF_RANGE, math::Parse("1e-400", d).error);
+  result = math::Parse(" 1 2", d);
+  EXPECT_EQ(math::PARSE_TRAILING_CHARACTERS, result.error);
+  EXPECT_EQ(3u, result.position);
+  EXPECT_DOUBLE_EQ(3, d);
+  EXPECT_STREQ("unexpected characters after value", result.Message());
+
+  int i = 0;
+  EXPECT_TRUE(math::Parse("-42", i));
+  EXPECT_EQ(-42, i);
+  EXPECT_EQ(math::PARSE_INVALID_NUMBER, math::Parse("4.2", i).error);
+  EXPECT_EQ(math::PARSE_OUT_OF_RANGE, math::Parse("3000000000", i).error);
+  uint8_t u = 0;
+  EXPECT_TRUE(math::Parse("255", u));
+  EXPECT_EQ(255u, u);
+  EXPECT_EQ(math::PARSE_OUT_OF_RANGE, math::Parse("256", u).error);
+  EXPECT_EQ(math::PARSE_INVALID_NUMBER, math::Parse("-1", u).error);
+
+  float f = 0;
+  EXPECT_TRUE(math::Parse("0.1", f));
+  EXPECT_TRUE(SameBits(0.1f, f)) << f;
+  EXPECT_EQ(math::PARSE_OUT_OF_RANGE, math::Parse("1e39", f).error);
+}
+
+/////////////////////////////////////////////////
+TEST(ParseTest, Types)
+{
+  math::Vector3d v;
+  EXPECT_TRUE(math::Parse("1 2\t3", v));
+  EXPECT_EQ(math::Vector3d(1, 2, 3), v);
+
+  // The position points to the token in error
+  math::ParseResult result = math::Parse("1 2 x", v);
+  EXPECT_EQ(math::PARSE_INVALID_NUMBER, result.error);
+  EXPECT_EQ(4u, result.position);
+  result = math::Parse("4 5", v);
+  EXPECT_EQ(math::PARSE_MISSING_VALUE, result.error);
+  EXPECT_EQ(3u, result.position);
+  EXPECT_EQ(math::Vector3d(1, 2, 3), v);
+
+  math::Vector2i v2;
+  EXPECT_TRUE(math::Parse("-1 7", v2));
+  EXPECT_EQ(math::Vector2i(-1, 7), v2);
+  math::Vector4f v4;
+  EXPECT_TRUE(math::Parse("1 2 3 4", v4));
+  EXPECT_EQ(math::Vector4f(1, 2, 3, 4), v4);
+
+  math::Angle angle;
+  EXPECT_TRUE(math::Parse("1.5", angle));
+  EXPECT_DOUBLE_EQ(1.5, angle.Radian());
+
+  math::Temperature temp;
+  EXPECT_TRUE(math::Parse("300", temp));
+  EXPECT_DOUBLE_EQ(300, temp.Kelvin());
+  EXPECT_FALSE(math::Parse("300K", temp));
+  EXPECT_DOUBLE_EQ(300, temp.Kelvin());
+
+  math::Quaterniond q;
+  EXPECT_TRUE(math::Parse("0 0 1.5707963267948966", q));
+  EXPECT_EQ(math::Quaterniond(0, 0, IGN_PI_2), q);
+
+  math::Pose3d pose;
+  EXPECT_TRUE(math::Parse("1 2 3 0.1 0.2 0.3", pose));
+  EXPECT_EQ(math::Pose3d(1, 2, 3, 0.1, 0.2, 0.3), pose);
+  result = math::Parse("1 2 3 0.1 0.2", pose);
+  EXPECT_EQ(math::PARSE_MISSING_VALUE, result.error);
+  EXPECT_EQ(math::Pose3d(1, 2, 3, 0.1, 0.2, 0.3), pose);
+
+  math::Matrix3d m3;
+  EXPECT_TRUE(math::Parse("1 2 3 4 5 6 7 8 9", m3));
+  EXPECT_EQ(math::Matrix3d(1, 2, 3, 4, 5, 6, 7, 8, 9), m3);
+  math::Matrix4d m4;
+  EXPECT_TRUE(math::Parse("1 0 0 1\n0 1 0 2\n0 0 1 3\n0 0 0 1", m4));
+  EXPECT_EQ(math::Matrix4d(1, 0, 0, 1, 0, 1, 0, 2, 0, 0, 1, 3, 0, 0, 0, 1),
+      m4);
+  EXPECT_EQ(math::PARSE_TRAILING_CHARACTERS,
+      math::Parse("1 0 0 1 0 1 0 2 0 0 1 3 0 0 0 1 0", m4).error);
+
+  // Alpha is optional
+  math::Color color;
+  EXPECT_TRUE(math::Parse("0.1 0.2 0.3", color));
+  EXPECT_EQ(math::Color(0.1f, 0.2f, 0.3f, 1.0f), color);
+  EXPECT_TRUE(math::Parse("0.1 0.2 0.3 0.4 ", color));
+  EXPECT_EQ(math::Color(0.1f, 0.2f, 0.3f, 0.4f), color);
+  EXPECT_EQ(math::PARSE_INVALID_NUMBER,
+      math::Parse("0.1 0.2 0.3 a", color).error);
+}
+
+/////////////////////////////////////////////////
+TEST(ParseTest, ParseNext)
+{
+  const std::string_view text = "1 2 3 0 0 0\n4 5 6 0 0 0.5\n7 8 9 0 0";
+  size_t pos = 0;
+  math::Pose3d pose;
+  EXPECT_TRUE(math::ParseNext(text, pos, pose));
+  EXPECT_EQ(math::Pose3d(1, 2, 3, 0, 0, 0), pose);
+  EXPECT_EQ(11u, pos);
+  EXPECT_TRUE(math::ParseNext(text, pos, pose));
+  EXPECT_EQ(math::Pose3d(4, 5, 6, 0, 0, 0.5), pose);
+
+  const size_t last = pos;
+  const math::ParseResult result = math::ParseNext(text, pos, pose);
+  EXPECT_EQ(math::PARSE_MISSING_VALUE, result.error);
+  EXPECT_EQ(text.size(), result.position);
+  EXPECT_EQ(last, pos);
+  EXPECT_EQ(math::Pose3d(4, 5, 6, 0, 0, 0.5), pose);
+
+  // Parsing stops at the end of the view
+  double d = 0;
+  EXPECT_TRUE(math::Parse(std::string_view("12345", 2), d));
+  EXPECT_DOUBLE_EQ(12, d);
+}
+
+/////////////////////////////////////////////////
+TEST(ParseTest, RoundTrip)
+{
+  math::Rand::Seed(13);
+  for (int i = 0; i < 200; ++i)
+  {
+    const double scale = std::pow(10.0, math::Rand::IntUniform(-8, 8));
+    auto random = [&]()
+    {
+      return math::Rand::DblUniform(-1, 1) * scale;
+    };
+
+    RoundTrip(random());
+    RoundTrip(static_cast<float>(random()));
+    RoundTrip(math::Rand::IntUniform(-100000, 100000));
+    RoundTrip(math::Angle(random()));
+    RoundTrip(math::Vector2d(random(), random()));
+    RoundTrip(math::Vector3d(random(), random(), random()));
+    RoundTrip(math::Vector3f(random(), random(), random()));
+    RoundTrip(math::Vector4d(random(), random(), random(), random()));
+    RoundTrip(math::Quaterniond(random(), random(), random()));
+    RoundTrip(math::Pose3d(random(), random(), random(),
+          random(), random(), random()));
+    RoundTrip(math::Pose3f(random(), random(), random(),
+          random(), random(), random()));
+    RoundTrip(math::Matrix3d(random(), random(), random(),
+          random(), random(), random(), random(), random(), random()));
+    RoundTrip(math::Matrix4d(math::Pose3d(random(), random(), random(),
+          random(), random(), random())));
+    RoundTrip(math::Color(math::Rand::DblUniform(0, 1),
+          math::Rand::DblUniform(0, 1), math::Rand::DblUniform(0, 1),
+          math::Rand::DblUniform(0, 1)));
+
+    // Values written with enough digits are read back exactly
+    const math::Vector3d v(random(), random(), random());
+    std::ostringstream out;
+    out << std::setprecision(std::numeric_limits<double>::max_digits10)
+        << v.X() << " " << v.Y() << " " << v.Z();
+    math::Vector3d parsed;
+    EXPECT_TRUE(math::Parse(out.str(), parsed));
+    EXPECT_TRUE(SameBits(v.X(), parsed.X())) << v.X();
+    EXPECT_TRUE(SameBits(v.Y(), parsed.Y())) << v.Y();
+    EXPECT_TRUE(SameBits(v.Z(), parsed.Z())) << v.Z();
+  }
+}
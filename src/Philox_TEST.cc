@@ -0,0 +1,145 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include "ignition/math/Philox.hh"
+
+using namespace ignition;
+
+//////////////////////////////////////////////////
+TEST(PhiloxTest, KnownAnswer)
+{
+  // Known-answer vectors from the Random123 reference implementation
+  {
+    math::Philox4x32::Block out =
+      math::Philox4x32::Generate({{0, 0, 0, 0}}, 0, 0);
+    EXPECT_EQ(out[0], 0x6627e8d5u);
+    EXPECT_EQ(out[1], 0xe169c58du);
+    EXPECT_EQ(out[2], 0xbc57ac4cu);
+    EXPECT_EQ(out[3], 0x9b00dbd8u);
+  }
+  {
+    math::Philox4x32::Block out = math::Philox4x32::Generate(
+        {{0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu}},
+        0xffffffffu, 0xffffffffu);
+    EXPECT_EQ(out[0], 0x408f276du);
+    EXPECT_EQ(out[1], 0x41c83b0eu);
+    EXPECT_EQ(out[2], 0xa20bc7c6u);
+    EXPECT_EQ(out[3], 0x6d5451fdu);
+  }
+  {
+    math::Philox4x32::Block out = math::Philox4x32::Generate(
+        {{0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u}},
+        0xa4093822u, 0x299f31d0u);
+    EXPECT_EQ(out[0], 0xd16cfe09u);
+    EXPECT_EQ(out[1], 0x94fdccebu);
+    EXPECT_EQ(out[2], 0x5001e420u);
+    EXPECT_EQ(out[3], 0x24126ea1u);
+  }
+}
+
+//////////////////////////////////////////////////
+TEST(PhiloxTest, Stream)
+{
+  math::Philox4x32 gen(1234, 5);
+  EXPECT_EQ(gen.Seed(), 1234u);
+  EXPECT_EQ(gen.Stream(), 5u);
+  EXPECT_EQ(gen.Counter(), 0u);
+
+  std::vector<uint32_t> values;
+  for (int i = 0; i < 12; ++i)
+    values.push_back(gen());
+  EXPECT_EQ(gen.Counter(), 3u);
+
+  // Values come from consecutive blocks
+  for (uint64_t b = 0; b < 3; ++b)
+  {
+    math::Philox4x32::Block block = math::Philox4x32::Generate(1234, 5, b);
+    for (int i = 0; i < 4; ++i)
+      EXPECT_EQ(values[b * 4 + i], block[i]);
+  }
+
+  // Random access
+  gen.SetCounter(1);
+  EXPECT_EQ(gen(), values[4]);
+
+  // Discard within and across blocks
+  for (uint64_t skip = 0; skip < 9; ++skip)
+  {
+    math::Philox4x32 other(1234, 5);
+    other();
+    other.Discard(skip);
+    EXPECT_EQ(other(), values[1 + skip]) << skip;
+  }
+
+  // Reseeding rewinds the stream
+  gen.Seed(1234, 5);
+  EXPECT_EQ(gen(), values[0]);
+
+  // A different stream or seed gives different values
+  math::Philox4x32 otherStream(1234, 6);
+  math::Philox4x32 otherSeed(1235, 5);
+  EXPECT_NE(otherStream(), values[0]);
+  EXPECT_NE(otherSeed(), values[0]);
+}
+
+//////////////////////////////////////////////////
+TEST(PhiloxTest, StandardDistributions)
+{
+  math::Philox4x32 gen(42);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+  double sum = 0;
+  const int count = 10000;
+  for (int i = 0; i < count; ++i)
+  {
+    const double d = dist(gen);
+    EXPECT_GE(d, -1.0);
+    EXPECT_LT(d, 1.0);
+    sum += d;
+  }
+  // Standard deviation of the mean is sqrt(1/3 / count) ~= 0.0058
+  EXPECT_NEAR(sum / count, 0.0, 0.03);
+}
+
+//////////////////////////////////////////////////
+TEST(PhiloxTest, Fill)
+{
+  // Bulk fill matches repeated calls, from any starting offset
+  for (size_t offset : {0u, 1u, 3u, 4u})
+  {
+    for (size_t size : {0u, 5u, 32u, 100u})
+    {
+      math::Philox4x32 serial(99, 3);
+      math::Philox4x32 bulk(99, 3);
+      serial.Discard(offset);
+      bulk.Discard(offset);
+
+      std::vector<uint32_t> expected(size);
+      for (auto &value : expected)
+        value = serial();
+
+      std::vector<uint32_t> values(size);
+      bulk.Fill(values.data(), size);
+      EXPECT_EQ(values, expected);
+      EXPECT_EQ(bulk(), serial());
+    }
+  }
+}
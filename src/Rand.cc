@@ -16,6 +16,8 @@
 */
 
 #include <sys/types.h>
+#include <algorithm>
+#include <atomic>
 #include <ctime>
 
 #ifdef _WIN32
@@ -30,12 +32,76 @@
 using namespace ignition;
 using namespace math;
 
+namespace
+{
+  /// \brief Incremented every time the seed is set, so that thread-local
+  /// generators know to rekey themselves.
+  std::atomic<uint64_t> gSeedEpoch{0};
+
+  /// \brief Next stream id handed out to threads without an explicit one.
+  /// Counts down from the top of the range to stay clear of small,
+  /// user-assigned stream ids.
+  std::atomic<uint64_t> gNextThreadStream{~uint64_t(0)};
+
+  /// \brief Per-thread generator state.
+  struct ThreadRandState
+  {
+    /// \brief Generator of this thread.
+    Philox4x32 generator;
+
+    /// \brief Seed epoch the generator was keyed with.
+    uint64_t epoch = ~uint64_t(0);
+
+    /// \brief Whether the stream id has been assigned.
+    bool hasStream = false;
+  };
+
+  //////////////////////////////////////////////////
+  ThreadRandState &ThreadState()
+  {
+    static thread_local ThreadRandState state;
+    return state;
+  }
+
+  /// \brief Number of raw 32-bit values generated at a time by the bulk
+  /// fill functions.
+  const size_t kChunkSize = 512;
+
+  //////////////////////////////////////////////////
+  /// \brief Build a double in [0, 1) from 53 random bits.
+  inline double ToUnitDouble(const uint32_t _hi, const uint32_t _lo)
+  {
+    return ((_hi >> 5) * 67108864.0 + (_lo >> 6)) *
+      (1.0 / 9007199254740992.0);
+  }
+
+  //////////////////////////////////////////////////
+  /// \brief Build a float in [0, 1) from 24 random bits.
+  inline float ToUnitFloat(const uint32_t _u)
+  {
+    return (_u >> 8) * (1.0f / 16777216.0f);
+  }
+
+  //////////////////////////////////////////////////
+  /// \brief Standard normal pairs from uniform pairs with Box-Muller.
+  /// _u1 must be in (0, 1] and _u2 in [0, 1).
+  inline void BoxMuller(const double _u1, const double _u2,
+      double &_z0, double &_z1)
+  {
+    const double r = std::sqrt(-2.0 * std::log(_u1));
+    const double theta = 2.0 * IGN_PI * _u2;
+    _z0 = r * std::cos(theta);
+    _z1 = r * std::sin(theta);
+  }
+}
+
 //////////////////////////////////////////////////
 void Rand::Seed(unsigned int _seed)
 {
   std::seed_seq seq{_seed};
   SeedMutable() = _seed;
   RandGenerator().seed(seq);
+  ++gSeedEpoch;
 }
 
 //////////////////////////////////////////////////
@@ -74,6 +140,146 @@ int32_t Rand::IntNormal(int _mean, int _sigma)
   return static_cast<int32_t>(d(RandGenerator()));
 }
 
+//////////////////////////////////////////////////
+Vector3d Rand::Vector3Normal(const Vector3d &_mean, const Vector3d &_sigma,
+    Philox4x32 &_gen)
+{
+  Vector3d result;
+  FillNormal(&result, 1, _mean, _sigma, _gen);
+  return result;
+}
+
+//////////////////////////////////////////////////
+void Rand::FillUniform(double *_out, size_t _size, double _min, double _max,
+    Philox4x32 &_gen)
+{
+  uint32_t bits[kChunkSize];
+  const double range = _max - _min;
+  for (size_t start = 0; start < _size; start += kChunkSize / 2)
+  {
+    const size_t n = std::min(kChunkSize / 2, _size - start);
+    _gen.Fill(bits, 2 * n);
+    for (size_t i = 0; i < n; ++i)
+    {
+      _out[start + i] =
+        _min + range * ToUnitDouble(bits[2 * i], bits[2 * i + 1]);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void Rand::FillUniform(float *_out, size_t _size, float _min, float _max,
+    Philox4x32 &_gen)
+{
+  uint32_t bits[kChunkSize];
+  const float range = _max - _min;
+  for (size_t start = 0; start < _size; start += kChunkSize)
+  {
+    const size_t n = std::min(kChunkSize, _size - start);
+    _gen.Fill(bits, n);
+    for (size_t i = 0; i < n; ++i)
+      _out[start + i] = _min + range * ToUnitFloat(bits[i]);
+  }
+}
+
+//////////////////////////////////////////////////
+// Lemire, "Fast Random Integer Generation in an Interval" (2019)
+void Rand::FillUniform(int32_t *_out, size_t _size, int32_t _min,
+    int32_t _max, Philox4x32 &_gen)
+{
+  const uint64_t range =
+    static_cast<uint64_t>(static_cast<int64_t>(_max) - _min) + 1;
+
+  uint32_t bits[kChunkSize];
+  for (size_t start = 0; start < _size; start += kChunkSize)
+  {
+    const size_t n = std::min(kChunkSize, _size - start);
+    _gen.Fill(bits, n);
+    for (size_t i = 0; i < n; ++i)
+    {
+      uint64_t m = static_cast<uint64_t>(bits[i]) * range;
+      if (static_cast<uint32_t>(m) < range)
+      {
+        // Reject the few values that would bias the result
+        const uint32_t threshold =
+          static_cast<uint32_t>((uint64_t(1) << 32) % range);
+        while (static_cast<uint32_t>(m) < threshold)
+          m = static_cast<uint64_t>(_gen()) * range;
+      }
+      _out[start + i] = static_cast<int32_t>(
+          static_cast<int64_t>(_min) + static_cast<int64_t>(m >> 32));
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void Rand::FillNormal(double *_out, size_t _size, double _mean,
+    double _sigma, Philox4x32 &_gen)
+{
+  // Each pair of normal values uses four 32-bit values
+  uint32_t bits[kChunkSize];
+  for (size_t start = 0; start < _size; start += kChunkSize / 2)
+  {
+    const size_t n = std::min(kChunkSize / 2, _size - start);
+    const size_t pairs = (n + 1) / 2;
+    _gen.Fill(bits, 4 * pairs);
+    for (size_t p = 0; p < pairs; ++p)
+    {
+      const double u1 = 1.0 - ToUnitDouble(bits[4 * p], bits[4 * p + 1]);
+      const double u2 = ToUnitDouble(bits[4 * p + 2], bits[4 * p + 3]);
+      double z0, z1;
+      BoxMuller(u1, u2, z0, z1);
+      _out[start + 2 * p] = _mean + _sigma * z0;
+      if (2 * p + 1 < n)
+        _out[start + 2 * p + 1] = _mean + _sigma * z1;
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void Rand::FillNormal(float *_out, size_t _size, float _mean, float _sigma,
+    Philox4x32 &_gen)
+{
+  // Each pair of normal values uses two 32-bit values
+  uint32_t bits[kChunkSize];
+  for (size_t start = 0; start < _size; start += kChunkSize)
+  {
+    const size_t n = std::min(kChunkSize, _size - start);
+    const size_t pairs = (n + 1) / 2;
+    _gen.Fill(bits, 2 * pairs);
+    for (size_t p = 0; p < pairs; ++p)
+    {
+      const double u1 = (bits[2 * p] + 0.5) * (1.0 / 4294967296.0);
+      const double u2 = bits[2 * p + 1] * (1.0 / 4294967296.0);
+      double z0, z1;
+      BoxMuller(u1, u2, z0, z1);
+      _out[start + 2 * p] = _mean + _sigma * static_cast<float>(z0);
+      if (2 * p + 1 < n)
+        _out[start + 2 * p + 1] = _mean + _sigma * static_cast<float>(z1);
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void Rand::FillNormal(Vector3d *_out, size_t _size, const Vector3d &_mean,
+    const Vector3d &_sigma, Philox4x32 &_gen)
+{
+  const size_t chunk = kChunkSize / 2;
+  double values[3 * chunk];
+  for (size_t start = 0; start < _size; start += chunk)
+  {
+    const size_t n = std::min(chunk, _size - start);
+    FillNormal(values, 3 * n, 0.0, 1.0, _gen);
+    for (size_t i = 0; i < n; ++i)
+    {
+      _out[start + i].Set(
+          _mean.X() + _sigma.X() * values[3 * i],
+          _mean.Y() + _sigma.Y() * values[3 * i + 1],
+          _mean.Z() + _sigma.Z() * values[3 * i + 2]);
+    }
+  }
+}
+
 //////////////////////////////////////////////////
 uint32_t &Rand::SeedMutable()
 {
@@ -90,3 +296,37 @@ GeneratorType &Rand::RandGenerator()
   static GeneratorType randGenerator(Seed());
   return randGenerator;
 }
+
+//////////////////////////////////////////////////
+Philox4x32 &Rand::ThreadGenerator()
+{
+  ThreadRandState &state = ThreadState();
+  if (!state.hasStream)
+  {
+    state.generator.Seed(state.generator.Seed(), gNextThreadStream--);
+    state.hasStream = true;
+  }
+
+  const uint64_t epoch = gSeedEpoch.load(std::memory_order_acquire);
+  if (state.epoch != epoch)
+  {
+    state.generator.Seed(Seed(), state.generator.Stream());
+    state.epoch = epoch;
+  }
+  return state.generator;
+}
+
+//////////////////////////////////////////////////
+void Rand::SetThreadStream(uint64_t _stream)
+{
+  ThreadRandState &state = ThreadState();
+  state.epoch = gSeedEpoch.load(std::memory_order_acquire);
+  state.generator.Seed(Seed(), _stream);
+  state.hasStream = true;
+}
+
+//////////////////////////////////////////////////
+uint64_t Rand::ThreadStream()
+{
+  return ThreadGenerator().Stream();
+}
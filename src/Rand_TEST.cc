@@ -17,8 +17,14 @@
 
 #include <gtest/gtest.h>
 
+#include <limits>
+#include <thread>
+#include <vector>
+
 #include "ignition/math/Helpers.hh"
 #include "ignition/math/Rand.hh"
+#include "ignition/math/SignalStats.hh"
+#include "ignition/math/Vector3Stats.hh"
 
 using namespace ignition;
 
@@ -77,3 +83,179 @@ TEST(RandTest, SetSeed)
     EXPECT_EQ(second[i], math::Rand::IntUniform(-10, 10));
   }
 }
+
+//////////////////////////////////////////////////
+TEST(RandTest, ThreadGenerator)
+{
+  math::Rand::Seed(17);
+
+  // Work split across threads by item gives the same values as a
+  // serial pass, regardless of the number of threads.
+  const unsigned int items = 8;
+  std::vector<uint32_t> serial(items);
+  for (unsigned int i = 0; i < items; ++i)
+  {
+    math::Rand::SetThreadStream(i);
+    EXPECT_EQ(math::Rand::ThreadStream(), i);
+    math::Rand::ThreadGenerator().Discard(100);
+    serial[i] = math::Rand::ThreadGenerator()();
+    EXPECT_EQ(serial[i], math::Philox4x32::Generate(17, i, 25)[0]);
+  }
+
+  for (unsigned int numThreads : {1u, 3u, 8u})
+  {
+    std::vector<uint32_t> parallel(items);
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < numThreads; ++t)
+    {
+      threads.emplace_back([&, t]()
+      {
+        for (unsigned int i = t; i < items; i += numThreads)
+        {
+          math::Rand::SetThreadStream(i);
+          math::Rand::ThreadGenerator().Discard(100);
+          parallel[i] = math::Rand::ThreadGenerator()();
+        }
+      });
+    }
+    for (auto &thread : threads)
+      thread.join();
+    EXPECT_EQ(serial, parallel);
+  }
+
+  // Threads without an explicit stream get distinct streams
+  uint64_t streams[2];
+  std::thread first([&]() {streams[0] = math::Rand::ThreadStream();});
+  first.join();
+  std::thread second([&]() {streams[1] = math::Rand::ThreadStream();});
+  second.join();
+  EXPECT_NE(streams[0], streams[1]);
+
+  // Setting the seed rewinds and rekeys the thread generator
+  math::Rand::SetThreadStream(3);
+  math::Rand::ThreadGenerator()();
+  math::Rand::Seed(18);
+  EXPECT_EQ(math::Rand::ThreadStream(), 3u);
+  EXPECT_EQ(math::Rand::ThreadGenerator()(),
+      math::Philox4x32::Generate(18, 3, 0)[0]);
+}
+
+//////////////////////////////////////////////////
+TEST(RandTest, FillUniform)
+{
+  const size_t count = 10001;
+  math::Philox4x32 gen(7);
+
+  std::vector<double> dbl(count);
+  math::Rand::FillUniform(dbl.data(), count, -2.0, 3.0, gen);
+  math::SignalAccumulator dblStats;
+  dblStats.InsertData(dbl.data(), count);
+  EXPECT_GE(dblStats.Min(), -2.0);
+  EXPECT_LT(dblStats.Max(), 3.0);
+  EXPECT_NEAR(dblStats.Mean(), 0.5, 0.05);
+  EXPECT_NEAR(dblStats.Variance(), 25.0 / 12.0, 0.1);
+
+  std::vector<float> flt(count);
+  math::Rand::FillUniform(flt.data(), count, 1.0f, 2.0f, gen);
+  for (float f : flt)
+  {
+    EXPECT_GE(f, 1.0f);
+    EXPECT_LT(f, 2.0f);
+  }
+
+  std::vector<int32_t> ints(count);
+  math::Rand::FillUniform(ints.data(), count, -3, 3, gen);
+  std::vector<int> histogram(7, 0);
+  for (int32_t i : ints)
+  {
+    ASSERT_GE(i, -3);
+    ASSERT_LE(i, 3);
+    histogram[i + 3]++;
+  }
+  for (int h : histogram)
+    EXPECT_NEAR(h, count / 7.0, 150);
+
+  // Full 32-bit range. Each raw value maps to one integer, with no
+  // rejection, so the result is the raw stream offset by the minimum.
+  const int32_t intMin = std::numeric_limits<int32_t>::min();
+  const int32_t intMax = std::numeric_limits<int32_t>::max();
+  math::Philox4x32 raw = gen;
+  math::Rand::FillUniform(ints.data(), count, intMin, intMax, gen);
+  size_t negative = 0;
+  for (size_t i = 0; i < count; ++i)
+  {
+    const int64_t expected = static_cast<int64_t>(intMin) + raw();
+    ASSERT_EQ(expected, ints[i]) << i;
+    negative += ints[i] < 0 ? 1 : 0;
+  }
+  EXPECT_NEAR(negative, count / 2.0, 300);
+
+  // Ranges one short of the full range stay inside their bounds
+  math::Rand::FillUniform(ints.data(), count, intMin + 1, intMax, gen);
+  for (int32_t i : ints)
+    ASSERT_GE(i, intMin + 1);
+  math::Rand::FillUniform(ints.data(), count, intMin, intMax - 1, gen);
+  for (int32_t i : ints)
+    ASSERT_LE(i, intMax - 1);
+
+  // Ranges at the extremes
+  math::Rand::FillUniform(ints.data(), count, intMax - 1, intMax, gen);
+  for (int32_t i : ints)
+    ASSERT_GE(i, intMax - 1);
+  math::Rand::FillUniform(ints.data(), count, intMin, intMin + 1, gen);
+  for (int32_t i : ints)
+    ASSERT_LE(i, intMin + 1);
+
+  // Same stream gives the same values
+  math::Philox4x32 gen2(7);
+  std::vector<double> dbl2(count);
+  math::Rand::FillUniform(dbl2.data(), count, -2.0, 3.0, gen2);
+  EXPECT_EQ(dbl, dbl2);
+}
+
+//////////////////////////////////////////////////
+TEST(RandTest, FillNormal)
+{
+  // Odd count to exercise the unpaired Box-Muller value
+  const size_t count = 20001;
+  math::Philox4x32 gen(11, 2);
+
+  std::vector<double> dbl(count);
+  math::Rand::FillNormal(dbl.data(), count, 1.0, 2.0, gen);
+  math::SignalAccumulator dblStats;
+  dblStats.InsertData(dbl.data(), count);
+  EXPECT_NEAR(dblStats.Mean(), 1.0, 0.1);
+  EXPECT_NEAR(dblStats.Variance(), 4.0, 0.2);
+
+  std::vector<float> flt(count);
+  math::Rand::FillNormal(flt.data(), count, -1.0f, 0.5f, gen);
+  math::SignalAccumulator fltStats;
+  for (float f : flt)
+    fltStats.InsertData(f);
+  EXPECT_NEAR(fltStats.Mean(), -1.0, 0.025);
+  EXPECT_NEAR(fltStats.Variance(), 0.25, 0.0125);
+
+  std::vector<math::Vector3d> vec(count);
+  math::Rand::FillNormal(vec.data(), count, math::Vector3d(1, 2, 3),
+      math::Vector3d(0.1, 1, 10), gen);
+  math::Vector3Stats vecStats;
+  vecStats.InsertStatistics("mean,var");
+  vecStats.InsertData(vec.data(), vec.size());
+  EXPECT_NEAR(vecStats.X().Map()["mean"], 1.0, 0.005);
+  EXPECT_NEAR(vecStats.Y().Map()["mean"], 2.0, 0.05);
+  EXPECT_NEAR(vecStats.Z().Map()["mean"], 3.0, 0.5);
+  EXPECT_NEAR(vecStats.X().Map()["var"], 0.01, 0.0005);
+  EXPECT_NEAR(vecStats.Y().Map()["var"], 1.0, 0.05);
+  EXPECT_NEAR(vecStats.Z().Map()["var"], 100.0, 5.0);
+
+  // Single draws use the thread generator
+  math::Rand::SetThreadStream(4);
+  math::Vector3d v = math::Rand::Vector3Normal(
+      math::Vector3d::Zero, math::Vector3d::One);
+  math::Rand::SetThreadStream(4);
+  math::Vector3d filled;
+  math::Rand::FillNormal(&filled, 1, math::Vector3d::Zero,
+      math::Vector3d::One);
+  EXPECT_EQ(v, filled);
+  EXPECT_NE(v, math::Vector3d::Zero);
+}
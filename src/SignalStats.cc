@@ -77,6 +77,19 @@ void SignalMaximum::InsertData(const double _data)
   this->dataPtr->count++;
 }
 
+//////////////////////////////////////////////////
+void SignalMaximum::Merge(const SignalAccumulator &_acc)
+{
+  if (_acc.Count() == 0)
+    return;
+
+  if (this->dataPtr->count == 0 || _acc.Max() > this->dataPtr->data)
+  {
+    this->dataPtr->data = _acc.Max();
+  }
+  this->dataPtr->count += static_cast<unsigned int>(_acc.Count());
+}
+
 //////////////////////////////////////////////////
 double SignalMean::Value() const
 {
@@ -100,6 +113,13 @@ void SignalMean::InsertData(const double _data)
   this->dataPtr->count++;
 }
 
+//////////////////////////////////////////////////
+void SignalMean::Merge(const SignalAccumulator &_acc)
+{
+  this->dataPtr->data += _acc.Sum();
+  this->dataPtr->count += static_cast<unsigned int>(_acc.Count());
+}
+
 //////////////////////////////////////////////////
 double SignalMinimum::Value() const
 {
@@ -122,6 +142,19 @@ void SignalMinimum::InsertData(const double _data)
   this->dataPtr->count++;
 }
 
+//////////////////////////////////////////////////
+void SignalMinimum::Merge(const SignalAccumulator &_acc)
+{
+  if (_acc.Count() == 0)
+    return;
+
+  if (this->dataPtr->count == 0 || _acc.Min() < this->dataPtr->data)
+  {
+    this->dataPtr->data = _acc.Min();
+  }
+  this->dataPtr->count += static_cast<unsigned int>(_acc.Count());
+}
+
 //////////////////////////////////////////////////
 double SignalRootMeanSquare::Value() const
 {
@@ -145,6 +178,13 @@ void SignalRootMeanSquare::InsertData(const double _data)
   this->dataPtr->count++;
 }
 
+//////////////////////////////////////////////////
+void SignalRootMeanSquare::Merge(const SignalAccumulator &_acc)
+{
+  this->dataPtr->data += _acc.SumSquares();
+  this->dataPtr->count += static_cast<unsigned int>(_acc.Count());
+}
+
 //////////////////////////////////////////////////
 double SignalMaxAbsoluteValue::Value() const
 {
@@ -168,6 +208,16 @@ void SignalMaxAbsoluteValue::InsertData(const double _data)
   this->dataPtr->count++;
 }
 
+//////////////////////////////////////////////////
+void SignalMaxAbsoluteValue::Merge(const SignalAccumulator &_acc)
+{
+  if (_acc.MaxAbs() > this->dataPtr->data)
+  {
+    this->dataPtr->data = _acc.MaxAbs();
+  }
+  this->dataPtr->count += static_cast<unsigned int>(_acc.Count());
+}
+
 //////////////////////////////////////////////////
 // wikipedia.org/wiki/Algorithms_for_calculating_variance#Online_algorithm
 // based on Knuth's algorithm
@@ -204,6 +254,39 @@ void SignalVariance::InsertData(const double _data)
   this->dataPtr->data += delta * (_data - this->dataPtr->extraData);
 }
 
+//////////////////////////////////////////////////
+// wikipedia.org/wiki/Algorithms_for_calculating_variance#Parallel_algorithm
+// based on Chan et al.
+void SignalVariance::Merge(const SignalAccumulator &_acc)
+{
+  if (_acc.Count() == 0)
+    return;
+
+  if (this->dataPtr->count == 0)
+  {
+    this->dataPtr->count = static_cast<unsigned int>(_acc.Count());
+    this->dataPtr->extraData = _acc.Mean();
+    this->dataPtr->data = _acc.SumSquaredDeviations();
+    return;
+  }
+
+  const double nA = this->dataPtr->count;
+  const double nB = static_cast<double>(_acc.Count());
+  const double n = nA + nB;
+
+  // delta = mean_b - mean_a
+  const double delta = _acc.Mean() - this->dataPtr->extraData;
+
+  // mean = mean_a + delta * n_b / n
+  this->dataPtr->extraData += delta * nB / n;
+
+  // M2 = M2_a + M2_b + delta^2 * n_a * n_b / n
+  this->dataPtr->data +=
+    _acc.SumSquaredDeviations() + delta * delta * nA * nB / n;
+
+  this->dataPtr->count += static_cast<unsigned int>(_acc.Count());
+}
+
 //////////////////////////////////////////////////
 SignalStats::SignalStats()
   : dataPtr(new SignalStatsPrivate)
@@ -250,6 +333,26 @@ void SignalStats::InsertData(const double _data)
   }
 }
 
+//////////////////////////////////////////////////
+void SignalStats::InsertData(const double *_data, const size_t _size)
+{
+  if (_size == 0 || this->dataPtr->stats.empty())
+    return;
+
+  SignalAccumulator acc;
+  acc.InsertData(_data, _size);
+  this->Merge(acc);
+}
+
+//////////////////////////////////////////////////
+void SignalStats::Merge(const SignalAccumulator &_acc)
+{
+  for (auto &statistic : this->dataPtr->stats)
+  {
+    statistic->Merge(_acc);
+  }
+}
+
 //////////////////////////////////////////////////
 bool SignalStats::InsertStatistic(const std::string &_name)
 {
@@ -17,6 +17,8 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
 #include <ignition/math/Rand.hh>
 #include <ignition/math/SignalStats.hh>
 
@@ -639,3 +641,146 @@ TEST(SignalStatsTest, SignalStats)
   }
 }
 
+
+//////////////////////////////////////////////////
+TEST(SignalStatsTest, SignalAccumulator)
+{
+  math::SignalAccumulator acc;
+  EXPECT_EQ(acc.Count(), 0u);
+  EXPECT_DOUBLE_EQ(acc.Max(), 0.0);
+  EXPECT_DOUBLE_EQ(acc.MaxAbs(), 0.0);
+  EXPECT_DOUBLE_EQ(acc.Mean(), 0.0);
+  EXPECT_DOUBLE_EQ(acc.Min(), 0.0);
+  EXPECT_DOUBLE_EQ(acc.RootMeanSquare(), 0.0);
+  EXPECT_DOUBLE_EQ(acc.Variance(), 0.0);
+
+  // Compare against the virtual statistics on the same data
+  math::SignalStats stats;
+  EXPECT_TRUE(stats.InsertStatistics("max,maxAbs,mean,min,rms,var"));
+  for (int i = 0; i < 100; ++i)
+  {
+    const double value = math::Rand::DblNormal(1.0, 2.0);
+    acc.InsertData(value);
+    stats.InsertData(value);
+  }
+  EXPECT_EQ(acc.Count(), 100u);
+
+  auto expected = stats.Map();
+  auto map = acc.Map();
+  EXPECT_EQ(map.size(), expected.size());
+  for (auto const &stat : expected)
+  {
+    EXPECT_NEAR(map[stat.first], stat.second, 1e-10) << stat.first;
+  }
+
+  // Reset
+  acc.Reset();
+  EXPECT_EQ(acc.Count(), 0u);
+  EXPECT_DOUBLE_EQ(acc.Mean(), 0.0);
+  EXPECT_DOUBLE_EQ(acc.Variance(), 0.0);
+}
+
+//////////////////////////////////////////////////
+TEST(SignalStatsTest, SignalAccumulatorMerge)
+{
+  // Split data into unevenly sized chunks, as if gathered by several
+  // threads, and check that merging matches a single serial pass.
+  math::SignalAccumulator serial;
+  math::SignalAccumulator chunks[4];
+  const int sizes[4] = {0, 1, 37, 500};
+  for (int c = 0; c < 4; ++c)
+  {
+    for (int i = 0; i < sizes[c]; ++i)
+    {
+      const double value = 1e6 + math::Rand::DblNormal(0.0, 0.5);
+      serial.InsertData(value);
+      chunks[c].InsertData(value);
+    }
+  }
+
+  // Merge in two different orders
+  math::SignalAccumulator left;
+  for (auto const &chunk : chunks)
+    left.Merge(chunk);
+
+  math::SignalAccumulator right;
+  math::SignalAccumulator tail(chunks[2]);
+  tail.Merge(chunks[3]);
+  right.Merge(chunks[1]).Merge(tail).Merge(chunks[0]);
+
+  for (auto const &merged : {left, right})
+  {
+    EXPECT_EQ(merged.Count(), serial.Count());
+    EXPECT_DOUBLE_EQ(merged.Max(), serial.Max());
+    EXPECT_DOUBLE_EQ(merged.MaxAbs(), serial.MaxAbs());
+    EXPECT_DOUBLE_EQ(merged.Min(), serial.Min());
+    EXPECT_NEAR(merged.Mean(), serial.Mean(), 1e-6);
+    EXPECT_NEAR(merged.RootMeanSquare(), serial.RootMeanSquare(), 1e-6);
+    EXPECT_NEAR(merged.Variance(), serial.Variance(), 1e-9);
+  }
+
+  // Reduce the accumulators into a SignalStats
+  math::SignalStats stats;
+  EXPECT_TRUE(stats.InsertStatistics("max,maxAbs,mean,min,rms,var"));
+  stats.InsertData(1e6);
+  stats.Merge(math::SignalAccumulator());
+  EXPECT_EQ(stats.Count(), 1u);
+  for (auto const &chunk : chunks)
+    stats.Merge(chunk);
+
+  math::SignalAccumulator expected;
+  expected.InsertData(1e6);
+  expected.Merge(serial);
+  EXPECT_EQ(stats.Count(), expected.Count());
+  auto map = stats.Map();
+  EXPECT_DOUBLE_EQ(map["max"], expected.Max());
+  EXPECT_DOUBLE_EQ(map["maxAbs"], expected.MaxAbs());
+  EXPECT_DOUBLE_EQ(map["min"], expected.Min());
+  EXPECT_NEAR(map["mean"], expected.Mean(), 1e-6);
+  EXPECT_NEAR(map["rms"], expected.RootMeanSquare(), 1e-6);
+  EXPECT_NEAR(map["var"], expected.Variance(), 1e-9);
+}
+
+//////////////////////////////////////////////////
+TEST(SignalStatsTest, InsertDataBatch)
+{
+  // Use more samples than a single internal block
+  std::vector<double> data(2500);
+  for (auto &value : data)
+    value = math::Rand::DblNormal(-3.0, 4.0);
+
+  math::SignalStats serial;
+  math::SignalStats batch;
+  EXPECT_TRUE(serial.InsertStatistics("max,maxAbs,mean,min,rms,var"));
+  EXPECT_TRUE(batch.InsertStatistics("max,maxAbs,mean,min,rms,var"));
+
+  for (auto const &value : data)
+    serial.InsertData(value);
+
+  // Insert in two batches to check that batches accumulate
+  batch.InsertData(data.data(), 1);
+  batch.InsertData(data.data() + 1, data.size() - 1);
+  batch.InsertData(data.data(), 0);
+
+  EXPECT_EQ(batch.Count(), serial.Count());
+  auto expected = serial.Map();
+  auto map = batch.Map();
+  for (auto const &stat : expected)
+  {
+    EXPECT_NEAR(map[stat.first], stat.second, 1e-9) << stat.first;
+  }
+
+  // Accumulator batch insertion matches per-sample insertion
+  math::SignalAccumulator accSerial;
+  math::SignalAccumulator accBatch;
+  for (auto const &value : data)
+    accSerial.InsertData(value);
+  accBatch.InsertData(data.data(), data.size());
+  EXPECT_EQ(accBatch.Count(), accSerial.Count());
+  EXPECT_DOUBLE_EQ(accBatch.Max(), accSerial.Max());
+  EXPECT_DOUBLE_EQ(accBatch.MaxAbs(), accSerial.MaxAbs());
+  EXPECT_DOUBLE_EQ(accBatch.Min(), accSerial.Min());
+  EXPECT_NEAR(accBatch.Mean(), accSerial.Mean(), 1e-12);
+  EXPECT_NEAR(accBatch.RootMeanSquare(), accSerial.RootMeanSquare(), 1e-12);
+  EXPECT_NEAR(accBatch.Variance(), accSerial.Variance(), 1e-10);
+}
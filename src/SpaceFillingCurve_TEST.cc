@@ -0,0 +1,252 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+#include "ignition/math/Rand.hh"
+#include "ignition/math/SpaceFillingCurve.hh"
+
+using namespace ignition;
+using Curve = math::SpaceFillingCurve;
+
+/////////////////////////////////////////////////
+/// \brief Get a random 32 bit value.
+uint32_t RandomBits()
+{
+  return (static_cast<uint32_t>(math::Rand::IntUniform(0, 0xffff)) << 16) |
+    static_cast<uint32_t>(math::Rand::IntUniform(0, 0xffff));
+}
+
+/////////////////////////////////////////////////
+TEST(SpaceFillingCurveTest, Morton)
+{
+  EXPECT_EQ(0u, Curve::Morton(0, 0));
+  EXPECT_EQ(1u, Curve::Morton(1, 0));
+  EXPECT_EQ(2u, Curve::Morton(0, 1));
+  EXPECT_EQ(0xfu, Curve::Morton(3, 3));
+  EXPECT_EQ(0xffffffffffffffffULL, Curve::Morton(0xffffffff, 0xffffffff));
+  EXPECT_EQ(0xaaaaaaaaaaaaaaaaULL, Curve::Morton(0, 0xffffffff));
+
+  EXPECT_EQ(1u, Curve::Morton(1, 0, 0));
+  EXPECT_EQ(2u, Curve::Morton(0, 1, 0));
+  EXPECT_EQ(4u, Curve::Morton(0, 0, 1));
+  EXPECT_EQ(0x38u, Curve::Morton(2, 2, 2));
+  EXPECT_EQ(0x7fffffffffffffffULL,
+      Curve::Morton(0x1fffff, 0x1fffff, 0x1fffff));
+
+  // Bits above 21 are ignored in 3D
+  EXPECT_EQ(Curve::Morton(5, 6, 7),
+      Curve::Morton(5 | (1u << 21), 6 | (1u << 30), 7));
+
+  // Decoding is the inverse of encoding
+  math::Rand::Seed(9);
+  for (int i = 0; i < 1000; ++i)
+  {
+    const uint32_t x = RandomBits();
+    const uint32_t y = RandomBits();
+    const uint32_t z = RandomBits();
+    uint32_t dx, dy, dz;
+    Curve::MortonDecode(Curve::Morton(x, y), dx, dy);
+    EXPECT_EQ(x, dx);
+    EXPECT_EQ(y, dy);
+    Curve::MortonDecode(Curve::Morton(x, y, z), dx, dy, dz);
+    EXPECT_EQ(x & 0x1fffff, dx);
+    EXPECT_EQ(y & 0x1fffff, dy);
+    EXPECT_EQ(z & 0x1fffff, dz);
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(SpaceFillingCurveTest, Hilbert)
+{
+  // The first four cells of the 2D curve fill a 2x2 block
+  uint32_t x, y, z;
+  for (uint64_t key = 0; key < 4; ++key)
+  {
+    Curve::HilbertDecode(key, x, y);
+    EXPECT_EQ(key, Curve::Hilbert(x, y));
+    EXPECT_LT(x, 2u);
+    EXPECT_LT(y, 2u);
+    if (key > 0)
+    {
+      uint32_t px, py;
+      Curve::HilbertDecode(key - 1, px, py);
+      EXPECT_EQ(1, std::abs(static_cast<int>(x) - static_cast<int>(px)) +
+          std::abs(static_cast<int>(y) - static_cast<int>(py)));
+    }
+  }
+  // Consecutive keys are neighbor cells, and decoding is the inverse of
+  // encoding
+  math::Rand::Seed(10);
+  for (int i = 0; i < 1000; ++i)
+  {
+    const uint64_t key2 = (static_cast<uint64_t>(RandomBits()) << 32) |
+      RandomBits();
+    const uint64_t key = key2 == std::numeric_limits<uint64_t>::max() ?
+      key2 - 1 : key2;
+    uint32_t x2, y2;
+    Curve::HilbertDecode(key, x, y);
+    Curve::HilbertDecode(key + 1, x2, y2);
+    EXPECT_EQ(key, Curve::Hilbert(x, y));
+    EXPECT_EQ(1, std::abs(static_cast<int64_t>(x) - x2) +
+        std::abs(static_cast<int64_t>(y) - y2));
+
+    const uint64_t key3 = key >> 2;
+    uint32_t z2;
+    Curve::HilbertDecode(key3, x, y, z);
+    Curve::HilbertDecode(key3 + 1, x2, y2, z2);
+    EXPECT_EQ(key3, Curve::Hilbert(x, y, z));
+    EXPECT_EQ(1, std::abs(static_cast<int64_t>(x) - x2) +
+        std::abs(static_cast<int64_t>(y) - y2) +
+        std::abs(static_cast<int64_t>(z) - z2));
+    EXPECT_LE(x, 0x1fffffu);
+    EXPECT_LE(y, 0x1fffffu);
+    EXPECT_LE(z, 0x1fffffu);
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(SpaceFillingCurveTest, Key)
+{
+  const math::AxisAlignedBox box(0, 0, 0, 2, 4, 8);
+
+  // Cells split the box evenly
+  uint32_t x, y, z;
+  Curve::MortonDecode(Curve::Key(math::Vector3d(1, 1, 1), box), x, y, z);
+  EXPECT_EQ(1u << 20, x);
+  EXPECT_EQ(1u << 19, y);
+  EXPECT_EQ(1u << 18, z);
+  Curve::HilbertDecode(Curve::Key(math::Vector3d(1, 1, 1), box,
+        Curve::CURVE_HILBERT), x, y, z);
+  EXPECT_EQ(1u << 20, x);
+  EXPECT_EQ(1u << 19, y);
+  EXPECT_EQ(1u << 18, z);
+
+  // Points outside go to the nearest cell
+  Curve::MortonDecode(Curve::Key(math::Vector3d(-1, 5, 8), box), x, y, z);
+  EXPECT_EQ(0u, x);
+  EXPECT_EQ(0x1fffffu, y);
+  EXPECT_EQ(0x1fffffu, z);
+  EXPECT_EQ(0u, Curve::Key(math::Vector3d(NAN, NAN, NAN), box));
+
+  // Flat boxes put every point in the first cell along the flat axis
+  Curve::MortonDecode(Curve::Key(math::Vector3d(1, 1, 5),
+        math::AxisAlignedBox(0, 0, 5, 2, 2, 5)), x, y, z);
+  EXPECT_EQ(1u << 20, x);
+  EXPECT_EQ(0u, z);
+
+  // 2D keys use the x and y extents of the box
+  Curve::MortonDecode(Curve::Key(math::Vector2d(1, 3), box), x, y);
+  EXPECT_EQ(1u << 31, x);
+  EXPECT_EQ(3u << 30, y);
+  Curve::HilbertDecode(Curve::Key(math::Vector2f(1, 3), box,
+        Curve::CURVE_HILBERT), x, y);
+  EXPECT_EQ(1u << 31, x);
+  EXPECT_EQ(3u << 30, y);
+}
+
+/////////////////////////////////////////////////
+TEST(SpaceFillingCurveTest, RadixSort)
+{
+  math::Rand::Seed(11);
+  for (const size_t count : {0u, 1u, 10u, 63u, 64u, 1000u, 20000u})
+  {
+    for (const int bits : {8, 40, 64})
+    {
+      std::vector<uint64_t> keys;
+      for (size_t i = 0; i < count; ++i)
+      {
+        uint64_t key = (static_cast<uint64_t>(RandomBits()) << 32) |
+          RandomBits();
+        if (bits < 64)
+          key &= (uint64_t(1) << bits) - 1;
+        keys.push_back(key);
+      }
+
+      std::vector<size_t> expectedOrder(count);
+      for (size_t i = 0; i < count; ++i)
+        expectedOrder[i] = i;
+      std::stable_sort(expectedOrder.begin(), expectedOrder.end(),
+          [&](size_t _a, size_t _b) { return keys[_a] < keys[_b]; });
+      std::vector<uint64_t> expected = keys;
+      std::sort(expected.begin(), expected.end());
+
+      // Sorting is stable
+      std::vector<uint64_t> sorted = keys;
+      std::vector<size_t> order = {5};
+      Curve::RadixSort(sorted, &order);
+      EXPECT_EQ(expected, sorted) << count << " " << bits;
+      EXPECT_EQ(expectedOrder, order) << count << " " << bits;
+
+      sorted = keys;
+      Curve::RadixSort(sorted);
+      EXPECT_EQ(expected, sorted);
+
+      Curve::Reorder(keys, order);
+      EXPECT_EQ(expected, keys);
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(SpaceFillingCurveTest, Sort)
+{
+  math::Rand::Seed(12);
+  std::vector<math::Vector3d> points;
+  for (int i = 0; i < 2000; ++i)
+  {
+    points.push_back(math::Vector3d(math::Rand::DblUniform(-3, 3),
+          math::Rand::DblUniform(-3, 3), math::Rand::DblUniform(0, 1)));
+  }
+  points[7].Set(NAN, 0, 0);
+
+  for (const Curve::Curve curve : {Curve::CURVE_MORTON,
+      Curve::CURVE_HILBERT})
+  {
+    std::vector<math::Vector3d> sorted = points;
+    std::vector<size_t> order;
+    Curve::Sort(sorted, order, curve);
+    ASSERT_EQ(points.size(), sorted.size());
+    ASSERT_EQ(points.size(), order.size());
+
+    // The order maps back to the input, and the invalid point is last
+    for (size_t i = 0; i + 1 < sorted.size(); ++i)
+      EXPECT_EQ(points[order[i]], sorted[i]);
+    EXPECT_EQ(7u, order.back());
+
+    // Neighbors along the curve are much closer than random pairs
+    double sortedDistance = 0;
+    double inputDistance = 0;
+    for (size_t i = 9; i + 1 < sorted.size(); ++i)
+    {
+      sortedDistance += sorted[i].Distance(sorted[i - 1]);
+      inputDistance += points[i].Distance(points[i - 1]);
+    }
+    EXPECT_LT(sortedDistance * 5, inputDistance);
+  }
+
+  std::vector<math::Vector3f> empty;
+  std::vector<size_t> order = {1};
+  Curve::Sort(empty, order);
+  EXPECT_TRUE(order.empty());
+}
@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "ignition/math/Rand.hh"
+#include "ignition/math/SpatialHashGrid.hh"
+
+using namespace ignition;
+
+/////////////////////////////////////////////////
+/// \brief Random points in clusters, so that cells hold varying numbers
+/// of points.
+std::vector<math::Vector3d> ClusteredPoints(const size_t _count)
+{
+  std::vector<math::Vector3d> points;
+  math::Vector3d center;
+  for (size_t i = 0; i < _count; ++i)
+  {
+    if (i % 50 == 0)
+    {
+      center.Set(math::Rand::DblUniform(-10, 10),
+          math::Rand::DblUniform(-10, 10), math::Rand::DblUniform(-10, 10));
+    }
+    points.push_back(center + math::Vector3d(math::Rand::DblNormal(0, 1),
+          math::Rand::DblNormal(0, 1), math::Rand::DblNormal(0, 1)));
+  }
+  return points;
+}
+
+/////////////////////////////////////////////////
+/// \brief Find the k nearest points by checking every point.
+std::vector<size_t> BruteNearest(const std::vector<math::Vector3d> &_points,
+    const math::Vector3d &_p, const size_t _k, const double _maxDistance)
+{
+  std::vector<std::pair<double, size_t>> all;
+  for (size_t i = 0; i < _points.size(); ++i)
+  {
+    const double d2 = (_points[i] - _p).SquaredLength();
+    if (d2 <= _maxDistance * _maxDistance)
+      all.push_back({d2, i});
+  }
+  std::sort(all.begin(), all.end());
+  std::vector<size_t> result;
+  for (size_t i = 0; i < std::min(_k, all.size()); ++i)
+    result.push_back(all[i].second);
+  return result;
+}
+
+/////////////////////////////////////////////////
+TEST(SpatialHashGridTest, Empty)
+{
+  math::SpatialHashGridd grid;
+  EXPECT_DOUBLE_EQ(1.0, grid.CellSize());
+  EXPECT_EQ(0u, grid.Size());
+  EXPECT_EQ(0u, grid.CellCount());
+
+  EXPECT_FALSE(grid.SetCellSize(0));
+  EXPECT_FALSE(grid.SetCellSize(-1));
+  EXPECT_FALSE(grid.SetCellSize(std::numeric_limits<double>::infinity()));
+  EXPECT_DOUBLE_EQ(1.0, grid.CellSize());
+  EXPECT_TRUE(grid.SetCellSize(0.5));
+  EXPECT_DOUBLE_EQ(0.5, grid.CellSize());
+
+  std::vector<size_t> result = {1, 2};
+  grid.Radius(math::Vector3d::Zero, 10, result);
+  EXPECT_TRUE(result.empty());
+  result = {1, 2};
+  grid.Nearest(math::Vector3d::Zero, 3, result);
+  EXPECT_TRUE(result.empty());
+  std::vector<math::SpatialHashGridd::Pair> pairs = {{1, 2}};
+  grid.Pairs(10, pairs);
+  EXPECT_TRUE(pairs.empty());
+
+  grid.Build(std::vector<math::Vector3d>());
+  EXPECT_EQ(0u, grid.Size());
+}
+
+/////////////////////////////////////////////////
+TEST(SpatialHashGridTest, Small)
+{
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  const std::vector<math::Vector3d> points = {
+    {0, 0, 0}, {0.5, 0, 0}, {-0.5, 0, 0}, {0, 2, 0}, {nan, 0, 0},
+    {100, 100, 100}, {0.5, 0, 0}};
+
+  math::SpatialHashGridd grid(1.0);
+  grid.Build(points);
+
+  // The point with a NaN coordinate is left out
+  EXPECT_EQ(6u, grid.Size());
+  EXPECT_EQ(4u, grid.CellCount());
+
+  std::vector<size_t> result;
+  grid.Radius(math::Vector3d::Zero, 0.5, result);
+  std::sort(result.begin(), result.end());
+  EXPECT_EQ(std::vector<size_t>({0, 1, 2, 6}), result);
+
+  grid.Radius(math::Vector3d(0, 1, 0), 1.0, result);
+  std::sort(result.begin(), result.end());
+  EXPECT_EQ(std::vector<size_t>({0, 3}), result);
+
+  // Ties are ordered by index
+  grid.Nearest(math::Vector3d(0.4, 0, 0), 3, result);
+  EXPECT_EQ(std::vector<size_t>({1, 6, 0}), result);
+  grid.Nearest(math::Vector3d(0.4, 0, 0), 10, result);
+  EXPECT_EQ(std::vector<size_t>({1, 6, 0, 2, 3, 5}), result);
+  grid.Nearest(math::Vector3d(0.4, 0, 0), 10, result, 1.0);
+  EXPECT_EQ(std::vector<size_t>({1, 6, 0, 2}), result);
+  grid.Nearest(math::Vector3d(90, 90, 90), 1, result);
+  EXPECT_EQ(std::vector<size_t>({5}), result);
+
+  std::vector<math::SpatialHashGridd::Pair> pairs;
+  grid.Pairs(0.5, pairs);
+  std::sort(pairs.begin(), pairs.end());
+  EXPECT_EQ(std::vector<math::SpatialHashGridd::Pair>(
+        {{0, 1}, {0, 2}, {0, 6}, {1, 6}}), pairs);
+
+  // Rebuilding replaces the points
+  grid.Build(std::vector<math::Vector3d>({{5, 5, 5}}));
+  EXPECT_EQ(1u, grid.Size());
+  grid.Radius(math::Vector3d::Zero, 0.5, result);
+  EXPECT_TRUE(result.empty());
+}
+
+/////////////////////////////////////////////////
+TEST(SpatialHashGridTest, RandomQueries)
+{
+  math::Rand::Seed(21);
+  const std::vector<math::Vector3d> points = ClusteredPoints(2000);
+
+  // Structure of arrays input gives the same grid
+  std::vector<double> x, y, z;
+  for (const math::Vector3d &p : points)
+  {
+    x.push_back(p.X());
+    y.push_back(p.Y());
+    z.push_back(p.Z());
+  }
+
+  for (const double cellSize : {0.05, 0.5, 3.0})
+  {
+    math::SpatialHashGridd grid(cellSize);
+    grid.Build(x.data(), y.data(), z.data(), x.size());
+    ASSERT_EQ(points.size(), grid.Size());
+
+    std::vector<size_t> result;
+    for (int i = 0; i < 100; ++i)
+    {
+      const math::Vector3d p(math::Rand::DblUniform(-12, 12),
+          math::Rand::DblUniform(-12, 12), math::Rand::DblUniform(-12, 12));
+      const double radius = math::Rand::DblUniform(0, 3);
+
+      grid.Radius(p, radius, result);
+      std::sort(result.begin(), result.end());
+      std::vector<size_t> expected;
+      for (size_t j = 0; j < points.size(); ++j)
+      {
+        if ((points[j] - p).SquaredLength() <= radius * radius)
+          expected.push_back(j);
+      }
+      EXPECT_EQ(expected, result);
+
+      const size_t k = static_cast<size_t>(math::Rand::IntUniform(1, 20));
+      grid.Nearest(p, k, result);
+      EXPECT_EQ(BruteNearest(points, p, k,
+            std::numeric_limits<double>::infinity()), result);
+      grid.Nearest(p, k, result, radius);
+      EXPECT_EQ(BruteNearest(points, p, k, radius), result);
+    }
+
+    for (const double radius : {0.1, 0.4, 1.0})
+    {
+      std::vector<math::SpatialHashGridd::Pair> pairs;
+      grid.Pairs(radius, pairs);
+      std::sort(pairs.begin(), pairs.end());
+      std::vector<math::SpatialHashGridd::Pair> expected;
+      for (size_t a = 0; a < points.size(); ++a)
+      {
+        for (size_t b = a + 1; b < points.size(); ++b)
+        {
+          if ((points[a] - points[b]).SquaredLength() <= radius * radius)
+            expected.push_back({a, b});
+        }
+      }
+      EXPECT_EQ(expected, pairs) << cellSize << " " << radius;
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(SpatialHashGridTest, Float)
+{
+  math::Rand::Seed(4);
+  std::vector<math::Vector3f> points;
+  for (int i = 0; i < 500; ++i)
+  {
+    points.push_back(math::Vector3f(
+          static_cast<float>(math::Rand::DblUniform(-1, 1)),
+          static_cast<float>(math::Rand::DblUniform(-1, 1)),
+          static_cast<float>(math::Rand::DblUniform(-1, 1))));
+  }
+
+  math::SpatialHashGridf grid(0.2f);
+  grid.Build(points);
+
+  std::vector<size_t> result;
+  grid.Nearest(math::Vector3f::Zero, 1, result);
+  ASSERT_EQ(1u, result.size());
+  for (const math::Vector3f &p : points)
+    EXPECT_LE(points[result[0]].SquaredLength(), p.SquaredLength());
+
+  std::vector<math::SpatialHashGridf::Pair> pairs;
+  grid.Pairs(0.1f, pairs);
+  for (const math::SpatialHashGridf::Pair &pair : pairs)
+  {
+    EXPECT_LT(pair.first, pair.second);
+    EXPECT_LE(points[pair.first].Distance(points[pair.second]), 0.1f + 1e-6f);
+  }
+}
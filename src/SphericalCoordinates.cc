@@ -14,6 +14,7 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
 #include <string>
 
 #include "ignition/math/Matrix3.hh"
@@ -85,8 +86,366 @@ class ignition::math::SphericalCoordinatesPrivate
 
   /// \brief Cache sine head transform
   public: double sinHea;
+
+  /// \brief Algorithm used to convert from ECEF to SPHERICAL.
+  public: SphericalCoordinates::GeodeticMethod geodeticMethod =
+            SphericalCoordinates::BOWRING;
+
+  /// \brief Convert ECEF to SPHERICAL with the selected algorithm.
+  /// \param[in] _ecef ECEF position.
+  /// \return Latitude (rad), longitude (rad) and altitude (m).
+  public: ignition::math::Vector3d Geodetic(
+              const ignition::math::Vector3d &_ecef) const;
+
+  /// \brief Convert ECEF to SPHERICAL with Bowring's formula.
+  /// \param[in] _ecef ECEF position.
+  /// \return Latitude (rad), longitude (rad) and altitude (m).
+  public: ignition::math::Vector3d GeodeticBowring(
+              const ignition::math::Vector3d &_ecef) const;
+
+  /// \brief Convert ECEF to SPHERICAL with Bowring's formula, evaluated
+  /// without forward trigonometric functions.
+  /// \param[in] _ecef ECEF position.
+  /// \return Latitude (rad), longitude (rad) and altitude (m).
+  public: ignition::math::Vector3d GeodeticBowringAlgebraic(
+              const ignition::math::Vector3d &_ecef) const;
+
+  /// \brief Convert ECEF to SPHERICAL with Vermeille's closed form.
+  /// \param[in] _ecef ECEF position.
+  /// \return Latitude (rad), longitude (rad) and altitude (m).
+  public: ignition::math::Vector3d GeodeticVermeille(
+              const ignition::math::Vector3d &_ecef) const;
+
+  /// \brief Convert an array of positions to ECEF.
+  /// \param[in] _pos Positions in the _in frame.
+  /// \param[out] _ecef ECEF positions, may be the same as _pos.
+  /// \param[in] _size Number of positions.
+  /// \param[in] _in Frame of the input positions.
+  public: void ToECEF(const ignition::math::Vector3d *_pos,
+              ignition::math::Vector3d *_ecef, const size_t _size,
+              const SphericalCoordinates::CoordinateType _in) const;
+
+  /// \brief Convert an array of ECEF positions to another frame.
+  /// \param[in] _ecef ECEF positions.
+  /// \param[out] _pos Positions in the _out frame, may be the same as
+  /// _ecef.
+  /// \param[in] _size Number of positions.
+  /// \param[in] _out Frame of the output positions.
+  public: void FromECEF(const ignition::math::Vector3d *_ecef,
+              ignition::math::Vector3d *_pos, const size_t _size,
+              const SphericalCoordinates::CoordinateType _out) const;
 };
 
+//////////////////////////////////////////////////
+ignition::math::Vector3d SphericalCoordinatesPrivate::Geodetic(
+    const ignition::math::Vector3d &_ecef) const
+{
+  switch (this->geodeticMethod)
+  {
+    case SphericalCoordinates::BOWRING_ALGEBRAIC:
+      return this->GeodeticBowringAlgebraic(_ecef);
+    case SphericalCoordinates::VERMEILLE:
+      return this->GeodeticVermeille(_ecef);
+    case SphericalCoordinates::BOWRING:
+    default:
+      return this->GeodeticBowring(_ecef);
+  }
+}
+
+//////////////////////////////////////////////////
+ignition::math::Vector3d SphericalCoordinatesPrivate::GeodeticBowring(
+    const ignition::math::Vector3d &_ecef) const
+{
+  double p = sqrt(_ecef.X() * _ecef.X() + _ecef.Y() * _ecef.Y());
+  double theta = atan((_ecef.Z() * this->ellA) / (p * this->ellB));
+
+  // Calculate latitude and longitude
+  double lat = atan(
+      (_ecef.Z() + std::pow(this->ellP, 2) * this->ellB *
+       std::pow(sin(theta), 3)) /
+      (p - std::pow(this->ellE, 2) * this->ellA * std::pow(cos(theta), 3)));
+
+  double lon = atan2(_ecef.Y(), _ecef.X());
+
+  // Recalculate radius of planet curvature at the current latitude.
+  double nCurvature = 1.0 - std::pow(this->ellE, 2) * std::pow(sin(lat), 2);
+  nCurvature = this->ellA / sqrt(nCurvature);
+
+  // Now calculate Z
+  return ignition::math::Vector3d(lat, lon, p/cos(lat) - nCurvature);
+}
+
+//////////////////////////////////////////////////
+ignition::math::Vector3d SphericalCoordinatesPrivate::GeodeticBowringAlgebraic(
+    const ignition::math::Vector3d &_ecef) const
+{
+  const double x = _ecef.X();
+  const double y = _ecef.Y();
+  const double z = _ecef.Z();
+  const double e2 = this->ellE * this->ellE;
+  const double p = sqrt(x * x + y * y);
+
+  // sin and cos of the parametric latitude, tan(theta) = z a / (p b)
+  const double za = z * this->ellA;
+  const double pb = p * this->ellB;
+  const double r = sqrt(za * za + pb * pb);
+  if (r <= 0)
+    return ignition::math::Vector3d(0, 0, -this->ellA);
+  const double sinTheta = za / r;
+  const double cosTheta = pb / r;
+
+  // Bowring's latitude as a ratio, then sin and cos of the latitude
+  const double num = z +
+    this->ellP * this->ellP * this->ellB * sinTheta * sinTheta * sinTheta;
+  const double den = p - e2 * this->ellA * cosTheta * cosTheta * cosTheta;
+  const double n = sqrt(num * num + den * den);
+  const double sinLat = num / n;
+  const double cosLat = den / n;
+
+  // Height along the normal, well conditioned at any latitude:
+  // h = p cos(lat) + z sin(lat) - a sqrt(1 - e^2 sin^2(lat))
+  const double alt = p * cosLat + z * sinLat -
+    this->ellA * sqrt(1.0 - e2 * sinLat * sinLat);
+
+  return ignition::math::Vector3d(atan2(num, den), atan2(y, x), alt);
+}
+
+//////////////////////////////////////////////////
+// Vermeille, H. "Computing geodetic coordinates from geocentric
+// coordinates", Journal of Geodesy 78, 94-95 (2004)
+ignition::math::Vector3d SphericalCoordinatesPrivate::GeodeticVermeille(
+    const ignition::math::Vector3d &_ecef) const
+{
+  const double x = _ecef.X();
+  const double y = _ecef.Y();
+  const double z = _ecef.Z();
+  const double a2 = this->ellA * this->ellA;
+  const double e2 = this->ellE * this->ellE;
+  const double e4 = e2 * e2;
+
+  const double rho2 = x * x + y * y;
+  const double p = rho2 / a2;
+  const double q = (1.0 - e2) / a2 * z * z;
+  const double r = (p + q - e4) / 6.0;
+
+  // The closed form is undefined close to the center of the Earth
+  if (r <= 0)
+    return this->GeodeticBowringAlgebraic(_ecef);
+
+  const double s = e4 * p * q / (4.0 * r * r * r);
+  const double t = std::cbrt(1.0 + s + sqrt(s * (2.0 + s)));
+  const double u = r * (1.0 + t + 1.0 / t);
+  const double v = sqrt(u * u + e4 * q);
+  const double w = e2 * (u + v - q) / (2.0 * v);
+  const double k = sqrt(u + v + w * w) - w;
+  const double d = k * sqrt(rho2) / (k + e2);
+  const double dz = sqrt(d * d + z * z);
+
+  return ignition::math::Vector3d(
+      2.0 * atan2(z, d + dz),
+      atan2(y, x),
+      (k + e2 - 1.0) / k * dz);
+}
+
+//////////////////////////////////////////////////
+void SphericalCoordinatesPrivate::ToECEF(
+    const ignition::math::Vector3d *_pos, ignition::math::Vector3d *_ecef,
+    const size_t _size, const SphericalCoordinates::CoordinateType _in) const
+{
+  const Matrix3d &rot = this->rotGlobalToECEF;
+  switch (_in)
+  {
+    case SphericalCoordinates::SPHERICAL:
+      {
+        const double e2 = this->ellE * this->ellE;
+        const double b2a2 =
+          (this->ellB * this->ellB) / (this->ellA * this->ellA);
+        for (size_t i = 0; i < _size; ++i)
+        {
+          const double cosLat = cos(_pos[i].X());
+          const double sinLat = sin(_pos[i].X());
+          const double cosLon = cos(_pos[i].Y());
+          const double sinLon = sin(_pos[i].Y());
+          const double alt = _pos[i].Z();
+
+          // Radius of planet curvature (meters)
+          const double curvature =
+            this->ellA / sqrt(1.0 - e2 * sinLat * sinLat);
+
+          _ecef[i].Set((alt + curvature) * cosLat * cosLon,
+                       (alt + curvature) * cosLat * sinLon,
+                       (b2a2 * curvature + alt) * sinLat);
+        }
+        break;
+      }
+    case SphericalCoordinates::LOCAL:
+      {
+        for (size_t i = 0; i < _size; ++i)
+        {
+          const double x = _pos[i].X();
+          const double y = _pos[i].Y();
+          _ecef[i] = this->origin + rot * ignition::math::Vector3d(
+              -x * this->cosHea + y * this->sinHea,
+              -x * this->sinHea - y * this->cosHea,
+              _pos[i].Z());
+        }
+        break;
+      }
+    case SphericalCoordinates::GLOBAL:
+      {
+        for (size_t i = 0; i < _size; ++i)
+          _ecef[i] = this->origin + rot * _pos[i];
+        break;
+      }
+    case SphericalCoordinates::ECEF:
+    default:
+      {
+        if (_ecef != _pos)
+          std::copy(_pos, _pos + _size, _ecef);
+        break;
+      }
+  }
+}
+
+//////////////////////////////////////////////////
+void SphericalCoordinatesPrivate::FromECEF(
+    const ignition::math::Vector3d *_ecef, ignition::math::Vector3d *_pos,
+    const size_t _size, const SphericalCoordinates::CoordinateType _out) const
+{
+  const Matrix3d &rot = this->rotECEFToGlobal;
+  switch (_out)
+  {
+    case SphericalCoordinates::SPHERICAL:
+      {
+        // Same formulas as the single point Geodetic* functions, with the
+        // ellipsoid terms hoisted out of the loops
+        const double e2 = this->ellE * this->ellE;
+        const double e2a = e2 * this->ellA;
+        const double p2b = this->ellP * this->ellP * this->ellB;
+        switch (this->geodeticMethod)
+        {
+          case SphericalCoordinates::BOWRING_ALGEBRAIC:
+            for (size_t i = 0; i < _size; ++i)
+            {
+              const double x = _ecef[i].X();
+              const double y = _ecef[i].Y();
+              const double z = _ecef[i].Z();
+              const double p = sqrt(x * x + y * y);
+              const double za = z * this->ellA;
+              const double pb = p * this->ellB;
+              const double r = sqrt(za * za + pb * pb);
+              if (r <= 0)
+              {
+                _pos[i].Set(0, 0, -this->ellA);
+                continue;
+              }
+              const double sinTheta = za / r;
+              const double cosTheta = pb / r;
+
+              const double num = z + p2b * sinTheta * sinTheta * sinTheta;
+              const double den = p - e2a * cosTheta * cosTheta * cosTheta;
+              const double n = sqrt(num * num + den * den);
+              const double sinLat = num / n;
+              const double cosLat = den / n;
+
+              _pos[i].Set(atan2(num, den), atan2(y, x),
+                  p * cosLat + z * sinLat -
+                  this->ellA * sqrt(1.0 - e2 * sinLat * sinLat));
+            }
+            break;
+          case SphericalCoordinates::VERMEILLE:
+            {
+              const double invA2 = 1.0 / (this->ellA * this->ellA);
+              const double e4 = e2 * e2;
+              for (size_t i = 0; i < _size; ++i)
+              {
+                const double x = _ecef[i].X();
+                const double y = _ecef[i].Y();
+                const double z = _ecef[i].Z();
+                const double rho2 = x * x + y * y;
+                const double p = rho2 * invA2;
+                const double q = (1.0 - e2) * invA2 * z * z;
+                const double r = (p + q - e4) / 6.0;
+                if (r <= 0)
+                {
+                  _pos[i] = this->GeodeticBowringAlgebraic(_ecef[i]);
+                  continue;
+                }
+
+                const double s = e4 * p * q / (4.0 * r * r * r);
+                const double t = std::cbrt(1.0 + s + sqrt(s * (2.0 + s)));
+                const double u = r * (1.0 + t + 1.0 / t);
+                const double v = sqrt(u * u + e4 * q);
+                const double w = e2 * (u + v - q) / (2.0 * v);
+                const double k = sqrt(u + v + w * w) - w;
+                const double d = k * sqrt(rho2) / (k + e2);
+                const double dz = sqrt(d * d + z * z);
+                _pos[i].Set(2.0 * atan2(z, d + dz), atan2(y, x),
+                    (k + e2 - 1.0) / k * dz);
+              }
+              break;
+            }
+          case SphericalCoordinates::BOWRING:
+          default:
+            {
+              const double ab = this->ellA / this->ellB;
+              for (size_t i = 0; i < _size; ++i)
+              {
+                const double x = _ecef[i].X();
+                const double y = _ecef[i].Y();
+                const double z = _ecef[i].Z();
+                const double p = sqrt(x * x + y * y);
+                const double theta = atan((z * ab) / p);
+                const double sinTheta = sin(theta);
+                const double cosTheta = cos(theta);
+
+                // Calculate latitude and longitude
+                const double lat = atan(
+                    (z + p2b * sinTheta * sinTheta * sinTheta) /
+                    (p - e2a * cosTheta * cosTheta * cosTheta));
+                const double lon = atan2(y, x);
+
+                // Radius of planet curvature at the current latitude.
+                const double sinLat = sin(lat);
+                const double curvature =
+                  this->ellA / sqrt(1.0 - e2 * sinLat * sinLat);
+
+                _pos[i].Set(lat, lon, p / cos(lat) - curvature);
+              }
+              break;
+            }
+        }
+        break;
+      }
+    case SphericalCoordinates::GLOBAL:
+      {
+        for (size_t i = 0; i < _size; ++i)
+          _pos[i] = rot * (_ecef[i] - this->origin);
+        break;
+      }
+    case SphericalCoordinates::LOCAL:
+      {
+        for (size_t i = 0; i < _size; ++i)
+        {
+          const ignition::math::Vector3d global =
+            rot * (_ecef[i] - this->origin);
+          _pos[i].Set(
+              global.X() * this->cosHea - global.Y() * this->sinHea,
+              global.X() * this->sinHea + global.Y() * this->cosHea,
+              global.Z());
+        }
+        break;
+      }
+    case SphericalCoordinates::ECEF:
+    default:
+      {
+        if (_pos != _ecef)
+          std::copy(_ecef, _ecef + _size, _pos);
+        break;
+      }
+  }
+}
+
 //////////////////////////////////////////////////
 SphericalCoordinates::SurfaceType SphericalCoordinates::Convert(
   const std::string &_str)
@@ -302,6 +661,19 @@ double SphericalCoordinates::Distance(const ignition::math::Angle &_latA,
   return d;
 }
 
+//////////////////////////////////////////////////
+void SphericalCoordinates::SetGeodeticConversion(const GeodeticMethod &_method)
+{
+  this->dataPtr->geodeticMethod = _method;
+}
+
+//////////////////////////////////////////////////
+SphericalCoordinates::GeodeticMethod
+SphericalCoordinates::GeodeticConversion() const
+{
+  return this->dataPtr->geodeticMethod;
+}
+
 //////////////////////////////////////////////////
 void SphericalCoordinates::UpdateTransformationMatrix()
 {
@@ -407,29 +779,7 @@ ignition::math::Vector3d SphericalCoordinates::PositionTransform(
     case SPHERICAL:
       {
         // Convert from ECEF to SPHERICAL
-        double p = sqrt(tmp.X() * tmp.X() + tmp.Y() * tmp.Y());
-        double theta = atan((tmp.Z() * this->dataPtr->ellA) /
-            (p * this->dataPtr->ellB));
-
-        // Calculate latitude and longitude
-        double lat = atan(
-            (tmp.Z() + std::pow(this->dataPtr->ellP, 2) * this->dataPtr->ellB *
-             std::pow(sin(theta), 3)) /
-            (p - std::pow(this->dataPtr->ellE, 2) *
-             this->dataPtr->ellA * std::pow(cos(theta), 3)));
-
-        double lon = atan2(tmp.Y(), tmp.X());
-
-        // Recalculate radius of planet curvature at the current latitude.
-        double nCurvature = 1.0 - std::pow(this->dataPtr->ellE, 2) *
-          std::pow(sin(lat), 2);
-        nCurvature = this->dataPtr->ellA / sqrt(nCurvature);
-
-        tmp.X(lat);
-        tmp.Y(lon);
-
-        // Now calculate Z
-        tmp.Z(p/cos(lat) - nCurvature);
+        tmp = this->dataPtr->Geodetic(tmp);
         break;
       }
 
@@ -460,6 +810,36 @@ ignition::math::Vector3d SphericalCoordinates::PositionTransform(
   return tmp;
 }
 
+//////////////////////////////////////////////////
+bool SphericalCoordinates::PositionTransform(
+    const ignition::math::Vector3d *_pos, ignition::math::Vector3d *_result,
+    const size_t _size,
+    const CoordinateType &_in, const CoordinateType &_out) const
+{
+  if (_in < SPHERICAL || _in > LOCAL)
+  {
+    std::cerr << "Invalid coordinate type[" << _in << "]\n";
+    return false;
+  }
+  if (_out < SPHERICAL || _out > LOCAL)
+  {
+    std::cerr << "Unknown coordinate type[" << _out << "]\n";
+    return false;
+  }
+
+  // Work through blocks small enough for the intermediate ECEF positions
+  // to stay in cache between the two stages.
+  const size_t blockSize = 256;
+  ignition::math::Vector3d ecef[blockSize];
+  for (size_t start = 0; start < _size; start += blockSize)
+  {
+    const size_t n = std::min(blockSize, _size - start);
+    this->dataPtr->ToECEF(_pos + start, ecef, n, _in);
+    this->dataPtr->FromECEF(ecef, _result + start, n, _out);
+  }
+  return true;
+}
+
 //////////////////////////////////////////////////
 ignition::math::Vector3d SphericalCoordinates::VelocityTransform(
     const ignition::math::Vector3d &_vel,
@@ -551,6 +931,7 @@ SphericalCoordinates &SphericalCoordinates::operator=(
   this->SetLongitudeReference(_sc.LongitudeReference());
   this->SetElevationReference(_sc.ElevationReference());
   this->SetHeadingOffset(_sc.HeadingOffset());
+  this->SetGeodeticConversion(_sc.GeodeticConversion());
 
   // Generate transformation matrix
   this->UpdateTransformationMatrix();
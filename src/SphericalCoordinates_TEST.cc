@@ -16,6 +16,8 @@
 */
 #include <gtest/gtest.h>
 
+#include <vector>
+
 #include "ignition/math/SphericalCoordinates.hh"
 
 using namespace ignition;
@@ -383,3 +385,172 @@ TEST(SphericalCoordinatesTest, AssignmentOp)
   math::SphericalCoordinates sc2 = sc1;
   EXPECT_EQ(sc1, sc2);
 }
+
+//////////////////////////////////////////////////
+// Test batch transforms against single point transforms
+TEST(SphericalCoordinatesTest, BatchPositionTransform)
+{
+  math::SphericalCoordinates sc(math::SphericalCoordinates::EARTH_WGS84,
+      IGN_DTOR(37.3877349), IGN_DTOR(-122.0651166), 32.0, IGN_DTOR(30.0));
+
+  // Enough points to span several internal blocks
+  std::vector<math::Vector3d> spherical;
+  for (int i = 0; i < 700; ++i)
+  {
+    spherical.push_back(math::Vector3d(
+        IGN_DTOR(-89.0 + 178.0 * i / 699.0),
+        IGN_DTOR(-180.0 + 0.5 * i),
+        -100.0 + 20.0 * i));
+  }
+
+  const math::SphericalCoordinates::CoordinateType types[] = {
+    math::SphericalCoordinates::SPHERICAL,
+    math::SphericalCoordinates::ECEF,
+    math::SphericalCoordinates::GLOBAL,
+    math::SphericalCoordinates::LOCAL};
+
+  for (auto in : types)
+  {
+    // Input positions expressed in the "in" frame
+    std::vector<math::Vector3d> input(spherical.size());
+    EXPECT_TRUE(sc.PositionTransform(spherical.data(), input.data(),
+        input.size(), math::SphericalCoordinates::SPHERICAL, in));
+
+    for (auto out : types)
+    {
+      std::vector<math::Vector3d> result(input.size());
+      EXPECT_TRUE(sc.PositionTransform(input.data(), result.data(),
+          input.size(), in, out));
+
+      // In-place conversion
+      std::vector<math::Vector3d> inPlace = input;
+      EXPECT_TRUE(sc.PositionTransform(inPlace.data(), inPlace.data(),
+          inPlace.size(), in, out));
+
+      const double tol =
+        out == math::SphericalCoordinates::SPHERICAL ? 1e-9 : 1e-6;
+      for (size_t i = 0; i < input.size(); ++i)
+      {
+        math::Vector3d expected = sc.PositionTransform(input[i], in, out);
+        EXPECT_NEAR(expected.X(), result[i].X(), tol);
+        EXPECT_NEAR(expected.Y(), result[i].Y(), tol);
+        EXPECT_NEAR(expected.Z(), result[i].Z(), 1e-6);
+        EXPECT_EQ(result[i], inPlace[i]);
+      }
+    }
+  }
+
+  // Invalid coordinate types leave the output unchanged
+  math::Vector3d pos(1, 2, -4);
+  math::Vector3d result(5, 6, 7);
+  EXPECT_FALSE(sc.PositionTransform(&pos, &result, 1,
+      static_cast<math::SphericalCoordinates::CoordinateType>(5),
+      math::SphericalCoordinates::ECEF));
+  EXPECT_FALSE(sc.PositionTransform(&pos, &result, 1,
+      math::SphericalCoordinates::ECEF,
+      static_cast<math::SphericalCoordinates::CoordinateType>(0)));
+  EXPECT_EQ(math::Vector3d(5, 6, 7), result);
+
+  // Empty input
+  EXPECT_TRUE(sc.PositionTransform(nullptr, nullptr, 0,
+      math::SphericalCoordinates::ECEF, math::SphericalCoordinates::LOCAL));
+}
+
+//////////////////////////////////////////////////
+// Test the accuracy of each ECEF to SPHERICAL conversion over the full
+// latitude range, using the SPHERICAL to ECEF conversion as reference.
+TEST(SphericalCoordinatesTest, GeodeticConversion)
+{
+  math::SphericalCoordinates sc;
+  EXPECT_EQ(math::SphericalCoordinates::BOWRING, sc.GeodeticConversion());
+
+  // Assignment copies the method
+  {
+    math::SphericalCoordinates other;
+    other.SetGeodeticConversion(math::SphericalCoordinates::VERMEILLE);
+    sc = other;
+    EXPECT_EQ(math::SphericalCoordinates::VERMEILLE, sc.GeodeticConversion());
+  }
+
+  struct Bounds
+  {
+    math::SphericalCoordinates::GeodeticMethod method;
+    double maxAltitude;
+    double latTol;
+    double altTol;
+  };
+
+  // Documented error bounds
+  const Bounds bounds[] = {
+    {math::SphericalCoordinates::BOWRING, 12e3, 5e-13, 2e-6},
+    {math::SphericalCoordinates::BOWRING, 1e6, 1e-9, 1e-2},
+    {math::SphericalCoordinates::BOWRING_ALGEBRAIC, 12e3, 5e-13, 1e-8},
+    {math::SphericalCoordinates::BOWRING_ALGEBRAIC, 1e6, 1e-9, 1e-8},
+    {math::SphericalCoordinates::VERMEILLE, 4e7, 1e-15, 1e-7}};
+
+  for (auto const &bound : bounds)
+  {
+    sc.SetGeodeticConversion(bound.method);
+    for (double alt : {-12e3, 0.0, bound.maxAltitude})
+    {
+      for (int i = 0; i <= 1800; ++i)
+      {
+        const double latDeg = -90.0 + 0.1 * i;
+
+        // The altitude of BOWRING is ill-conditioned at the poles
+        if (bound.method == math::SphericalCoordinates::BOWRING &&
+            std::abs(latDeg) > 89.95)
+        {
+          continue;
+        }
+
+        const math::Vector3d geodetic(IGN_DTOR(latDeg), IGN_DTOR(10.0 + i),
+            alt);
+        const math::Vector3d ecef = sc.PositionTransform(geodetic,
+            math::SphericalCoordinates::SPHERICAL,
+            math::SphericalCoordinates::ECEF);
+        const math::Vector3d result = sc.PositionTransform(ecef,
+            math::SphericalCoordinates::ECEF,
+            math::SphericalCoordinates::SPHERICAL);
+
+        EXPECT_NEAR(geodetic.X(), result.X(), bound.latTol)
+          << bound.method << " " << latDeg << " " << alt;
+        EXPECT_NEAR(std::cos(geodetic.Y()), std::cos(result.Y()), 1e-15);
+        EXPECT_NEAR(std::sin(geodetic.Y()), std::sin(result.Y()), 1e-15);
+        EXPECT_NEAR(geodetic.Z(), result.Z(), bound.altTol)
+          << bound.method << " " << latDeg << " " << alt;
+      }
+    }
+  }
+
+  // Close to the center of the Earth VERMEILLE falls back to
+  // BOWRING_ALGEBRAIC
+  math::Vector3d center(1000, -2000, 500);
+  sc.SetGeodeticConversion(math::SphericalCoordinates::VERMEILLE);
+  math::Vector3d vermeille = sc.PositionTransform(center,
+      math::SphericalCoordinates::ECEF, math::SphericalCoordinates::SPHERICAL);
+  sc.SetGeodeticConversion(math::SphericalCoordinates::BOWRING_ALGEBRAIC);
+  math::Vector3d algebraic = sc.PositionTransform(center,
+      math::SphericalCoordinates::ECEF, math::SphericalCoordinates::SPHERICAL);
+  EXPECT_EQ(vermeille, algebraic);
+
+  // The batch transform uses the selected method
+  for (auto method : {math::SphericalCoordinates::BOWRING,
+                      math::SphericalCoordinates::BOWRING_ALGEBRAIC,
+                      math::SphericalCoordinates::VERMEILLE})
+  {
+    sc.SetGeodeticConversion(method);
+    const math::Vector3d ecef[3] = {math::Vector3d(4e6, 3e6, -3.5e6),
+      math::Vector3d(-1e5, 2e4, 6.3e6), math::Vector3d(7e6, -1e6, 1e6)};
+    math::Vector3d batch[3];
+    EXPECT_TRUE(sc.PositionTransform(ecef, batch, 3,
+        math::SphericalCoordinates::ECEF,
+        math::SphericalCoordinates::SPHERICAL));
+    for (int i = 0; i < 3; ++i)
+    {
+      EXPECT_EQ(sc.PositionTransform(ecef[i],
+          math::SphericalCoordinates::ECEF,
+          math::SphericalCoordinates::SPHERICAL), batch[i]) << i;
+    }
+  }
+}
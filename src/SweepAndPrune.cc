@@ -0,0 +1,559 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <ignition/math/SweepAndPrune.hh>
+
+using namespace ignition::math;
+
+namespace
+{
+  /// \brief Number of boxes added in one update above which the endpoint
+  /// arrays are sorted from scratch instead of by insertion.
+  const size_t kRebuildCount = 32;
+
+  /// \brief Largest number of boxes, so that an identifier and the
+  /// endpoint type fit in 32 bits.
+  const size_t kMaxBoxes = size_t(1) << 31;
+
+  /// \brief Minimum or maximum of a box along one axis.
+  struct Endpoint
+  {
+    /// \brief Coordinate along the axis.
+    double value;
+
+    /// \brief Box identifier shifted left by one, with the lowest bit set
+    /// for a maximum.
+    uint32_t data;
+  };
+
+  /// \brief Order endpoints by value, with minimums before maximums of
+  /// equal value so that touching boxes overlap.
+  inline bool Less(const Endpoint &_a, const Endpoint &_b)
+  {
+    return _a.value < _b.value ||
+      (!(_b.value < _a.value) && (_a.data & 1) < (_b.data & 1));
+  }
+
+  /// \brief Get the key of a pair of boxes.
+  inline uint64_t Key(uint32_t _a, uint32_t _b)
+  {
+    if (_a > _b)
+      std::swap(_a, _b);
+    return (static_cast<uint64_t>(_a) << 32) | _b;
+  }
+}
+
+//////////////////////////////////////////////////
+class ignition::math::SweepAndPrunePrivate
+{
+  /// \brief State of a box slot.
+  public: enum class State : uint8_t
+  {
+    /// \brief The slot holds no box.
+    FREE,
+
+    /// \brief The slot holds a box.
+    ALIVE,
+
+    /// \brief The box was removed, pending the next update.
+    REMOVED
+  };
+
+  /// \brief Bounds of a box.
+  public: struct BoxData
+  {
+    /// \brief Minimum corner.
+    double lower[3];
+
+    /// \brief Maximum corner.
+    double upper[3];
+
+    /// \brief Minimum corner at the last update.
+    double lastLower[3];
+
+    /// \brief Maximum corner at the last update.
+    double lastUpper[3];
+
+    /// \brief State of the slot.
+    State state;
+  };
+
+  /// \brief Check whether two boxes overlap, like
+  /// AxisAlignedBox::Intersects.
+  /// \param[in] _a Identifier of the first box.
+  /// \param[in] _b Identifier of the second box.
+  /// \return True if the boxes overlap.
+  public: bool Overlap(const uint32_t _a, const uint32_t _b) const;
+
+  /// \brief Check whether two boxes overlapped at the last update, which
+  /// is when their pair is in the set of pairs.
+  /// \param[in] _a Identifier of the first box.
+  /// \param[in] _b Identifier of the second box.
+  /// \return True if the boxes overlapped.
+  public: bool Overlapped(const uint32_t _a, const uint32_t _b) const;
+
+  /// \brief Record that a pair overlaps.
+  /// \param[in] _key Key of the pair.
+  public: void AddPair(const uint64_t _key);
+
+  /// \brief Record that a pair no longer overlaps.
+  /// \param[in] _key Key of the pair.
+  public: void RemovePair(const uint64_t _key);
+
+  /// \brief Drop the endpoints and pairs of removed boxes.
+  public: void ApplyRemovals();
+
+  /// \brief Restore the order of an axis with an insertion sort, adding
+  /// and removing pairs as minimums and maximums swap.
+  /// \param[in] _axis The axis.
+  public: void InsertionSort(const int _axis);
+
+  /// \brief Sort all axes from scratch and find every pair with a single
+  /// sweep along the x-axis.
+  public: void Rebuild();
+
+  /// \brief Box bounds, indexed by identifier.
+  public: std::vector<BoxData> boxes;
+
+  /// \brief Sorted endpoints along each axis.
+  public: std::vector<Endpoint> axes[3];
+
+  /// \brief Keys of the overlapping pairs.
+  public: std::unordered_set<uint64_t> pairs;
+
+  /// \brief Pairs that changed since the last update, mapped to whether
+  /// they overlapped at the last update.
+  public: std::unordered_map<uint64_t, bool> changed;
+
+  /// \brief Identifiers that can be reused.
+  public: std::vector<uint32_t> freeIds;
+
+  /// \brief Identifiers removed since the last update.
+  public: std::vector<uint32_t> removedIds;
+
+  /// \brief Number of boxes added since the last update.
+  public: size_t addedCount = 0;
+
+  /// \brief Whether boxes moved since the last update.
+  public: bool moved = false;
+
+  /// \brief Number of boxes.
+  public: size_t count = 0;
+
+  /// \brief Pairs added during the last update.
+  public: std::vector<SweepAndPrune::Pair> addedPairs;
+
+  /// \brief Pairs removed during the last update.
+  public: std::vector<SweepAndPrune::Pair> removedPairs;
+};
+
+//////////////////////////////////////////////////
+bool SweepAndPrunePrivate::Overlap(const uint32_t _a, const uint32_t _b) const
+{
+  const BoxData &a = this->boxes[_a];
+  const BoxData &b = this->boxes[_b];
+  return a.upper[0] >= b.lower[0] && a.upper[1] >= b.lower[1] &&
+    a.upper[2] >= b.lower[2] && a.lower[0] <= b.upper[0] &&
+    a.lower[1] <= b.upper[1] && a.lower[2] <= b.upper[2];
+}
+
+//////////////////////////////////////////////////
+bool SweepAndPrunePrivate::Overlapped(const uint32_t _a,
+    const uint32_t _b) const
+{
+  const BoxData &a = this->boxes[_a];
+  const BoxData &b = this->boxes[_b];
+  return a.lastUpper[0] >= b.lastLower[0] &&
+    a.lastUpper[1] >= b.lastLower[1] && a.lastUpper[2] >= b.lastLower[2] &&
+    a.lastLower[0] <= b.lastUpper[0] && a.lastLower[1] <= b.lastUpper[1] &&
+    a.lastLower[2] <= b.lastUpper[2];
+}
+
+//////////////////////////////////////////////////
+void SweepAndPrunePrivate::AddPair(const uint64_t _key)
+{
+  // emplace keeps the state of the last update if the pair already changed
+  if (this->pairs.insert(_key).second)
+    this->changed.emplace(_key, false);
+}
+
+//////////////////////////////////////////////////
+void SweepAndPrunePrivate::RemovePair(const uint64_t _key)
+{
+  if (this->pairs.erase(_key) > 0)
+    this->changed.emplace(_key, true);
+}
+
+//////////////////////////////////////////////////
+void SweepAndPrunePrivate::ApplyRemovals()
+{
+  if (this->removedIds.empty())
+    return;
+
+  auto removed = [this](const uint32_t _id)
+  {
+    return this->boxes[_id].state == State::REMOVED;
+  };
+
+  for (std::vector<Endpoint> &axis : this->axes)
+  {
+    axis.erase(std::remove_if(axis.begin(), axis.end(),
+          [&](const Endpoint &_e) {return removed(_e.data >> 1);}),
+        axis.end());
+  }
+
+  for (auto iter = this->pairs.begin(); iter != this->pairs.end();)
+  {
+    const uint64_t key = *iter;
+    if (removed(static_cast<uint32_t>(key >> 32)) ||
+        removed(static_cast<uint32_t>(key)))
+    {
+      this->changed.emplace(key, true);
+      iter = this->pairs.erase(iter);
+    }
+    else
+    {
+      ++iter;
+    }
+  }
+
+  for (const uint32_t id : this->removedIds)
+    this->boxes[id].state = State::FREE;
+}
+
+//////////////////////////////////////////////////
+void SweepAndPrunePrivate::InsertionSort(const int _axis)
+{
+  std::vector<Endpoint> &axis = this->axes[_axis];
+  const size_t size = axis.size();
+  Endpoint *endpoints = axis.data();
+  for (size_t i = 1; i < size; ++i)
+  {
+    const Endpoint e = endpoints[i];
+    size_t j = i;
+    while (j > 0 && Less(e, endpoints[j - 1]))
+    {
+      // The endpoint moves left past another one. A minimum passing a
+      // maximum means the boxes now overlap along this axis, and a
+      // maximum passing a minimum means they are now apart. Checking the
+      // bounds first avoids looking up pairs that can't change, which is
+      // most of them.
+      const Endpoint &other = endpoints[j - 1];
+      const uint32_t id = e.data >> 1;
+      const uint32_t otherId = other.data >> 1;
+      if (id != otherId && (e.data & 1) != (other.data & 1))
+      {
+        if ((e.data & 1) == 0)
+        {
+          if (this->Overlap(id, otherId) && !this->Overlapped(id, otherId))
+            this->AddPair(Key(id, otherId));
+        }
+        else if (this->Overlapped(id, otherId))
+        {
+          this->RemovePair(Key(id, otherId));
+        }
+      }
+      endpoints[j] = other;
+      --j;
+    }
+    endpoints[j] = e;
+  }
+}
+
+//////////////////////////////////////////////////
+void SweepAndPrunePrivate::Rebuild()
+{
+  for (std::vector<Endpoint> &axis : this->axes)
+    std::sort(axis.begin(), axis.end(), Less);
+
+  std::unordered_set<uint64_t> found;
+  found.reserve(this->pairs.size());
+  std::vector<uint32_t> active;
+  for (const Endpoint &e : this->axes[0])
+  {
+    const uint32_t id = e.data >> 1;
+    if (e.data & 1)
+    {
+      auto iter = std::find(active.begin(), active.end(), id);
+      if (iter != active.end())
+      {
+        *iter = active.back();
+        active.pop_back();
+      }
+      continue;
+    }
+
+    for (const uint32_t other : active)
+    {
+      if (this->Overlap(id, other))
+        found.insert(Key(id, other));
+    }
+    active.push_back(id);
+  }
+
+  for (const uint64_t key : this->pairs)
+  {
+    if (found.count(key) == 0)
+      this->changed.emplace(key, true);
+  }
+  for (const uint64_t key : found)
+  {
+    if (this->pairs.count(key) == 0)
+      this->changed.emplace(key, false);
+  }
+  this->pairs.swap(found);
+}
+
+//////////////////////////////////////////////////
+SweepAndPrune::SweepAndPrune()
+  : dataPtr(new SweepAndPrunePrivate)
+{
+}
+
+//////////////////////////////////////////////////
+SweepAndPrune::SweepAndPrune(const SweepAndPrune &_sap)
+  : dataPtr(new SweepAndPrunePrivate(*_sap.dataPtr))
+{
+}
+
+//////////////////////////////////////////////////
+SweepAndPrune::~SweepAndPrune()
+{
+}
+
+//////////////////////////////////////////////////
+SweepAndPrune &SweepAndPrune::operator=(const SweepAndPrune &_sap)
+{
+  *this->dataPtr = *_sap.dataPtr;
+  return *this;
+}
+
+//////////////////////////////////////////////////
+size_t SweepAndPrune::Add(const AxisAlignedBox &_box)
+{
+  SweepAndPrunePrivate &d = *this->dataPtr;
+
+  uint32_t id;
+  if (!d.freeIds.empty())
+  {
+    id = d.freeIds.back();
+    d.freeIds.pop_back();
+  }
+  else if (d.boxes.size() < kMaxBoxes)
+  {
+    id = static_cast<uint32_t>(d.boxes.size());
+    d.boxes.emplace_back();
+  }
+  else
+  {
+    std::cerr << "SweepAndPrune holds the maximum of " << kMaxBoxes
+              << " boxes.\n";
+    return kInvalidId;
+  }
+
+  SweepAndPrunePrivate::BoxData &box = d.boxes[id];
+  box.state = SweepAndPrunePrivate::State::ALIVE;
+  for (int a = 0; a < 3; ++a)
+  {
+    box.lower[a] = _box.Min()[a];
+    box.upper[a] = _box.Max()[a];
+
+    // A new box had no pairs
+    box.lastLower[a] = std::numeric_limits<double>::infinity();
+    box.lastUpper[a] = -std::numeric_limits<double>::infinity();
+
+    // New endpoints start at the end of the arrays, where they are
+    // apart from every box, and are sorted into place by Update
+    d.axes[a].push_back({box.lower[a], id << 1});
+    d.axes[a].push_back({box.upper[a], (id << 1) | 1});
+  }
+
+  ++d.addedCount;
+  ++d.count;
+  return id;
+}
+
+//////////////////////////////////////////////////
+bool SweepAndPrune::Set(const size_t _id, const AxisAlignedBox &_box)
+{
+  if (!this->Has(_id))
+    return false;
+
+  SweepAndPrunePrivate::BoxData &box = this->dataPtr->boxes[_id];
+  for (int a = 0; a < 3; ++a)
+  {
+    box.lower[a] = _box.Min()[a];
+    box.upper[a] = _box.Max()[a];
+  }
+  this->dataPtr->moved = true;
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool SweepAndPrune::Remove(const size_t _id)
+{
+  if (!this->Has(_id))
+    return false;
+
+  this->dataPtr->boxes[_id].state = SweepAndPrunePrivate::State::REMOVED;
+  this->dataPtr->removedIds.push_back(static_cast<uint32_t>(_id));
+  --this->dataPtr->count;
+  return true;
+}
+
+//////////////////////////////////////////////////
+void SweepAndPrune::Clear()
+{
+  for (size_t i = 0; i < this->dataPtr->boxes.size(); ++i)
+    this->Remove(i);
+}
+
+//////////////////////////////////////////////////
+bool SweepAndPrune::Has(const size_t _id) const
+{
+  return _id < this->dataPtr->boxes.size() &&
+    this->dataPtr->boxes[_id].state == SweepAndPrunePrivate::State::ALIVE;
+}
+
+//////////////////////////////////////////////////
+AxisAlignedBox SweepAndPrune::Box(const size_t _id) const
+{
+  AxisAlignedBox result;
+  if (!this->Has(_id))
+    return result;
+
+  // Set the corners directly, since the constructors would swap the
+  // corners of an empty box
+  const SweepAndPrunePrivate::BoxData &box = this->dataPtr->boxes[_id];
+  result.Min().Set(box.lower[0], box.lower[1], box.lower[2]);
+  result.Max().Set(box.upper[0], box.upper[1], box.upper[2]);
+  return result;
+}
+
+//////////////////////////////////////////////////
+size_t SweepAndPrune::Size() const
+{
+  return this->dataPtr->count;
+}
+
+//////////////////////////////////////////////////
+void SweepAndPrune::Update()
+{
+  SweepAndPrunePrivate &d = *this->dataPtr;
+
+  d.ApplyRemovals();
+
+  if (d.moved)
+  {
+    for (int a = 0; a < 3; ++a)
+    {
+      for (Endpoint &e : d.axes[a])
+      {
+        const SweepAndPrunePrivate::BoxData &box = d.boxes[e.data >> 1];
+        e.value = (e.data & 1) ? box.upper[a] : box.lower[a];
+      }
+    }
+  }
+
+  // Inserting a new box passes over the whole array, so many new boxes
+  // are cheaper to handle with a full sort
+  if (d.addedCount > kRebuildCount)
+  {
+    d.Rebuild();
+  }
+  else
+  {
+    for (int a = 0; a < 3; ++a)
+      d.InsertionSort(a);
+  }
+
+  d.addedPairs.clear();
+  d.removedPairs.clear();
+  for (const auto &change : d.changed)
+  {
+    const bool overlapping = d.pairs.count(change.first) > 0;
+    if (overlapping == change.second)
+      continue;
+
+    const Pair pair(static_cast<size_t>(change.first >> 32),
+        static_cast<size_t>(change.first & 0xffffffff));
+    if (overlapping)
+      d.addedPairs.push_back(pair);
+    else
+      d.removedPairs.push_back(pair);
+  }
+  std::sort(d.addedPairs.begin(), d.addedPairs.end());
+  std::sort(d.removedPairs.begin(), d.removedPairs.end());
+  d.changed.clear();
+
+  for (SweepAndPrunePrivate::BoxData &box : d.boxes)
+  {
+    std::copy(box.lower, box.lower + 3, box.lastLower);
+    std::copy(box.upper, box.upper + 3, box.lastUpper);
+  }
+
+  // Removed identifiers become available once their pairs are reported
+  d.freeIds.insert(d.freeIds.end(), d.removedIds.begin(),
+      d.removedIds.end());
+  d.removedIds.clear();
+  d.addedCount = 0;
+  d.moved = false;
+}
+
+//////////////////////////////////////////////////
+std::vector<SweepAndPrune::Pair> SweepAndPrune::Pairs() const
+{
+  std::vector<Pair> result;
+  result.reserve(this->dataPtr->pairs.size());
+  for (const uint64_t key : this->dataPtr->pairs)
+  {
+    result.emplace_back(static_cast<size_t>(key >> 32),
+        static_cast<size_t>(key & 0xffffffff));
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+//////////////////////////////////////////////////
+bool SweepAndPrune::Overlapping(const size_t _id1, const size_t _id2) const
+{
+  if (_id1 == _id2 || _id1 >= this->dataPtr->boxes.size() ||
+      _id2 >= this->dataPtr->boxes.size())
+  {
+    return false;
+  }
+  return this->dataPtr->pairs.count(Key(static_cast<uint32_t>(_id1),
+        static_cast<uint32_t>(_id2))) > 0;
+}
+
+//////////////////////////////////////////////////
+const std::vector<SweepAndPrune::Pair> &SweepAndPrune::AddedPairs() const
+{
+  return this->dataPtr->addedPairs;
+}
+
+//////////////////////////////////////////////////
+const std::vector<SweepAndPrune::Pair> &SweepAndPrune::RemovedPairs() const
+{
+  return this->dataPtr->removedPairs;
+}
@@ -0,0 +1,224 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <vector>
+
+#include "ignition/math/Rand.hh"
+#include "ignition/math/SweepAndPrune.hh"
+
+using namespace ignition;
+using Pair = math::SweepAndPrune::Pair;
+
+/////////////////////////////////////////////////
+/// \brief Find the overlapping pairs by checking every pair of boxes.
+std::vector<Pair> BruteForce(const std::map<size_t, math::AxisAlignedBox> &_b)
+{
+  std::vector<Pair> pairs;
+  for (auto a = _b.begin(); a != _b.end(); ++a)
+  {
+    for (auto b = std::next(a); b != _b.end(); ++b)
+    {
+      if (a->second.Intersects(b->second))
+        pairs.push_back(Pair(a->first, b->first));
+    }
+  }
+  return pairs;
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the pairs in _a that are not in _b.
+std::vector<Pair> Difference(const std::vector<Pair> &_a,
+    const std::vector<Pair> &_b)
+{
+  std::vector<Pair> result;
+  std::set_difference(_a.begin(), _a.end(), _b.begin(), _b.end(),
+      std::back_inserter(result));
+  return result;
+}
+
+/////////////////////////////////////////////////
+math::AxisAlignedBox RandomBox(const double _range, const double _size)
+{
+  const math::Vector3d center(math::Rand::DblUniform(-_range, _range),
+      math::Rand::DblUniform(-_range, _range),
+      math::Rand::DblUniform(-_range, _range));
+  const math::Vector3d half(math::Rand::DblUniform(0, _size),
+      math::Rand::DblUniform(0, _size), math::Rand::DblUniform(0, _size));
+  return math::AxisAlignedBox(center - half, center + half);
+}
+
+/////////////////////////////////////////////////
+TEST(SweepAndPruneTest, Empty)
+{
+  math::SweepAndPrune sap;
+  EXPECT_EQ(0u, sap.Size());
+  EXPECT_FALSE(sap.Has(0));
+  EXPECT_FALSE(sap.Set(0, math::AxisAlignedBox()));
+  EXPECT_FALSE(sap.Remove(0));
+  EXPECT_FALSE(sap.Overlapping(0, 1));
+  EXPECT_EQ(math::AxisAlignedBox(), sap.Box(0));
+
+  sap.Update();
+  EXPECT_TRUE(sap.Pairs().empty());
+  EXPECT_TRUE(sap.AddedPairs().empty());
+  EXPECT_TRUE(sap.RemovedPairs().empty());
+}
+
+/////////////////////////////////////////////////
+TEST(SweepAndPruneTest, Events)
+{
+  math::SweepAndPrune sap;
+  const size_t a = sap.Add(math::AxisAlignedBox(0, 0, 0, 1, 1, 1));
+  const size_t b = sap.Add(math::AxisAlignedBox(2, 0, 0, 3, 1, 1));
+  const size_t c = sap.Add(math::AxisAlignedBox(0.5, 0.5, 0.5, 2.5, 2, 2));
+  EXPECT_EQ(3u, sap.Size());
+  EXPECT_TRUE(sap.Has(c));
+  EXPECT_EQ(math::AxisAlignedBox(2, 0, 0, 3, 1, 1), sap.Box(b));
+
+  // Pairs are only found by Update
+  EXPECT_FALSE(sap.Overlapping(a, c));
+  sap.Update();
+  EXPECT_TRUE(sap.Overlapping(a, c));
+  EXPECT_TRUE(sap.Overlapping(c, b));
+  EXPECT_FALSE(sap.Overlapping(a, b));
+  EXPECT_EQ(std::vector<Pair>({{a, c}, {b, c}}), sap.AddedPairs());
+  EXPECT_TRUE(sap.RemovedPairs().empty());
+
+  // Nothing changed
+  sap.Update();
+  EXPECT_TRUE(sap.AddedPairs().empty());
+  EXPECT_TRUE(sap.RemovedPairs().empty());
+  EXPECT_EQ(std::vector<Pair>({{a, c}, {b, c}}), sap.Pairs());
+
+  // Move b so it touches a and leaves c
+  EXPECT_TRUE(sap.Set(b, math::AxisAlignedBox(1, -2, 0, 2, -0.5, 1)));
+  sap.Update();
+  EXPECT_EQ(std::vector<Pair>(), sap.AddedPairs());
+  EXPECT_EQ(std::vector<Pair>({{b, c}}), sap.RemovedPairs());
+  EXPECT_TRUE(sap.Set(b, math::AxisAlignedBox(1, -2, 0, 2, 0, 1)));
+  sap.Update();
+  EXPECT_EQ(std::vector<Pair>({{a, b}}), sap.AddedPairs());
+  EXPECT_TRUE(sap.RemovedPairs().empty());
+
+  // A move that leaves and comes back within one update is not reported
+  EXPECT_TRUE(sap.Set(b, math::AxisAlignedBox(10, 10, 10, 11, 11, 11)));
+  EXPECT_TRUE(sap.Set(b, math::AxisAlignedBox(1, -2, 0, 2, 0, 1)));
+  sap.Update();
+  EXPECT_TRUE(sap.AddedPairs().empty());
+  EXPECT_TRUE(sap.RemovedPairs().empty());
+
+  // Empty boxes never overlap
+  EXPECT_TRUE(sap.Set(c, math::AxisAlignedBox()));
+  sap.Update();
+  EXPECT_EQ(std::vector<Pair>({{a, c}}), sap.RemovedPairs());
+  EXPECT_EQ(math::AxisAlignedBox(), sap.Box(c));
+
+  // Removal reports the pairs and frees the identifier after the update
+  EXPECT_TRUE(sap.Remove(a));
+  EXPECT_FALSE(sap.Has(a));
+  EXPECT_FALSE(sap.Remove(a));
+  EXPECT_FALSE(sap.Set(a, math::AxisAlignedBox()));
+  EXPECT_NE(a, sap.Add(math::AxisAlignedBox(5, 5, 5, 6, 6, 6)));
+  sap.Update();
+  EXPECT_EQ(std::vector<Pair>({{a, b}}), sap.RemovedPairs());
+  EXPECT_EQ(a, sap.Add(math::AxisAlignedBox(0, 0, 0, 1, 1, 1)));
+  sap.Update();
+  EXPECT_EQ(std::vector<Pair>({{a, b}}), sap.AddedPairs());
+
+  // Copies are independent
+  math::SweepAndPrune copy(sap);
+  sap.Clear();
+  EXPECT_EQ(0u, sap.Size());
+  sap.Update();
+  EXPECT_EQ(std::vector<Pair>({{a, b}}), sap.RemovedPairs());
+  EXPECT_TRUE(sap.Pairs().empty());
+  EXPECT_EQ(std::vector<Pair>({{a, b}}), copy.Pairs());
+  EXPECT_EQ(4u, copy.Size());
+
+  sap = copy;
+  EXPECT_TRUE(sap.Overlapping(a, b));
+}
+
+/////////////////////////////////////////////////
+TEST(SweepAndPruneTest, RandomMotion)
+{
+  math::Rand::Seed(5);
+  math::SweepAndPrune sap;
+  std::map<size_t, math::AxisAlignedBox> boxes;
+
+  // Enough boxes at once to sort from scratch
+  for (int i = 0; i < 300; ++i)
+  {
+    const math::AxisAlignedBox box = RandomBox(10, 1);
+    boxes[sap.Add(box)] = box;
+  }
+  sap.Update();
+  std::vector<Pair> expected = BruteForce(boxes);
+  ASSERT_EQ(expected, sap.Pairs());
+  EXPECT_EQ(expected, sap.AddedPairs());
+  EXPECT_FALSE(expected.empty());
+
+  for (int frame = 0; frame < 100; ++frame)
+  {
+    // Small motions, and now and then a large jump, a new box, a removed
+    // box or an empty box
+    for (auto &entry : boxes)
+    {
+      math::AxisAlignedBox box = entry.second;
+      if (math::Rand::IntUniform(0, 50) == 0)
+        box = RandomBox(10, 1);
+      else if (math::Rand::IntUniform(0, 200) == 0)
+        box = math::AxisAlignedBox();
+      else if (box != math::AxisAlignedBox())
+      {
+        box = box + math::Vector3d(math::Rand::DblUniform(-0.1, 0.1),
+            math::Rand::DblUniform(-0.1, 0.1),
+            math::Rand::DblUniform(-0.1, 0.1));
+      }
+      entry.second = box;
+      ASSERT_TRUE(sap.Set(entry.first, box));
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+      if (math::Rand::IntUniform(0, 1) == 0)
+      {
+        auto iter = std::next(boxes.begin(),
+            math::Rand::IntUniform(0, static_cast<int>(boxes.size()) - 1));
+        ASSERT_TRUE(sap.Remove(iter->first));
+        boxes.erase(iter);
+      }
+      else
+      {
+        const math::AxisAlignedBox box = RandomBox(10, 1);
+        boxes[sap.Add(box)] = box;
+      }
+    }
+    sap.Update();
+
+    const std::vector<Pair> previous = expected;
+    expected = BruteForce(boxes);
+    ASSERT_EQ(expected, sap.Pairs()) << "frame " << frame;
+    EXPECT_EQ(Difference(expected, previous), sap.AddedPairs());
+    EXPECT_EQ(Difference(previous, expected), sap.RemovedPairs());
+    EXPECT_EQ(boxes.size(), sap.Size());
+  }
+}
@@ -0,0 +1,832 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <ignition/math/Binary.hh>
+#include <ignition/math/Helpers.hh>
+#include <ignition/math/TrajectoryLog.hh>
+
+using namespace ignition::math;
+
+namespace
+{
+  /// \brief File format version.
+  const uint16_t kVersion = 1;
+
+  /// \brief Size of the file header in bytes.
+  const size_t kHeaderSize = 32;
+
+  /// \brief Size of an index entry in bytes.
+  const size_t kIndexEntrySize = 32;
+
+  /// \brief Size of the footer in bytes.
+  const size_t kFooterSize = 24;
+
+  /// \brief Magic bytes at the start of the file.
+  const char kMagic[8] = {'I', 'G', 'N', 'T', 'R', 'A', 'J', '\0'};
+
+  /// \brief Magic bytes at the end of a closed file.
+  const char kIndexMagic[8] = {'I', 'G', 'N', 'T', 'I', 'D', 'X', '\0'};
+
+  /// \brief Location and time range of a chunk.
+  struct ChunkInfo
+  {
+    /// \brief Time of the first sample in nanoseconds.
+    int64_t firstTime;
+
+    /// \brief Time of the last sample in nanoseconds.
+    int64_t lastTime;
+
+    /// \brief Offset of the chunk in the file.
+    uint64_t offset;
+
+    /// \brief Number of samples.
+    uint64_t count;
+
+    /// \brief Index of the first sample in the log.
+    size_t first;
+  };
+
+  /// \brief Get the size of a chunk in the file.
+  /// \param[in] _count Number of samples.
+  /// \param[in] _columns Number of value columns.
+  /// \return Size in bytes.
+  uint64_t ChunkBytes(const uint64_t _count, const size_t _columns)
+  {
+    return 8 + _count * 8 * (1 + _columns);
+  }
+
+  /// \brief Convert a time point to nanoseconds since the clock epoch.
+  /// \param[in] _time The time point.
+  /// \return Nanoseconds.
+  int64_t ToNanoseconds(const std::chrono::steady_clock::time_point &_time)
+  {
+    const std::pair<int64_t, int64_t> secNsec = timePointToSecNsec(_time);
+    return secNsec.first * 1000000000 + secNsec.second;
+  }
+
+  /// \brief Convert nanoseconds since the clock epoch to a time point.
+  /// \param[in] _ns Nanoseconds, not negative.
+  /// \return The time point.
+  std::chrono::steady_clock::time_point FromNanoseconds(const int64_t _ns)
+  {
+    return secNsecToTimePoint(static_cast<uint64_t>(_ns / 1000000000),
+        static_cast<uint64_t>(_ns % 1000000000));
+  }
+}
+
+// Private data class
+class ignition::math::TrajectoryLogWriterPrivate
+{
+  /// \brief Encode the buffered samples and write them to the file. If
+  /// writing fails the buffered samples are dropped and the writer stops
+  /// accepting samples.
+  /// \return False if writing failed.
+  public: bool Flush()
+  {
+    if (this->failed)
+      return false;
+    if (this->count == 0)
+      return true;
+
+    const uint64_t bytes = ChunkBytes(this->count, this->columns);
+    unsigned char *dst = this->encoded.data();
+    detail::StoreLittleEndian(static_cast<uint64_t>(this->count), dst);
+    dst += 8;
+    for (size_t i = 0; i < this->count; ++i, dst += 8)
+      detail::StoreLittleEndian(this->times[i], dst);
+    for (size_t c = 0; c < this->columns; ++c)
+    {
+      const double *column = this->values.data() + c * this->chunkSize;
+      for (size_t i = 0; i < this->count; ++i, dst += 8)
+        detail::StoreLittleEndian(column[i], dst);
+    }
+
+    this->out.write(reinterpret_cast<const char *>(this->encoded.data()),
+        static_cast<std::streamsize>(bytes));
+    if (!this->out.good())
+    {
+      std::cerr << "Unable to write trajectory log chunk\n";
+      this->size -= this->count;
+      this->count = 0;
+      this->failed = true;
+      return false;
+    }
+
+    ChunkInfo info;
+    info.firstTime = this->times[0];
+    info.lastTime = this->times[this->count - 1];
+    info.offset = this->offset;
+    info.count = this->count;
+    info.first = this->size - this->count;
+    this->index.push_back(info);
+    this->offset += bytes;
+    this->count = 0;
+    return true;
+  }
+
+  /// \brief Buffer a sample, writing the chunk when it is full.
+  /// \param[in] _time Time of the sample.
+  /// \param[in] _values Values of the sample, one per column.
+  /// \return False if the sample was rejected or writing failed.
+  public: bool Append(const std::chrono::steady_clock::time_point &_time,
+              const double *_values)
+  {
+    if (this->failed)
+    {
+      std::cerr << "Trajectory log is not writable after a failed write\n";
+      return false;
+    }
+
+    const int64_t ns = ToNanoseconds(_time);
+    if (ns < 0)
+    {
+      std::cerr << "Trajectory log samples must not be before the clock "
+                << "epoch\n";
+      return false;
+    }
+    if (ns < this->lastTime)
+    {
+      std::cerr << "Trajectory log samples must be appended in time order\n";
+      return false;
+    }
+
+    this->times[this->count] = ns;
+    for (size_t c = 0; c < this->columns; ++c)
+      this->values[c * this->chunkSize + this->count] = _values[c];
+    this->lastTime = ns;
+    ++this->count;
+    ++this->size;
+
+    if (this->count == this->chunkSize)
+      return this->Flush();
+    return true;
+  }
+
+  /// \brief The file.
+  public: std::ofstream out;
+
+  /// \brief Kind of samples.
+  public: TrajectoryLogType type = TRAJECTORY_LOG_POSE3;
+
+  /// \brief Number of value columns.
+  public: size_t columns = 0;
+
+  /// \brief Number of samples per chunk.
+  public: size_t chunkSize = 0;
+
+  /// \brief Timestamps of the buffered samples.
+  public: std::vector<int64_t> times;
+
+  /// \brief Values of the buffered samples, one column after the other.
+  public: std::vector<double> values;
+
+  /// \brief Buffer holding an encoded chunk.
+  public: std::vector<unsigned char> encoded;
+
+  /// \brief Number of buffered samples.
+  public: size_t count = 0;
+
+  /// \brief Total number of samples.
+  public: size_t size = 0;
+
+  /// \brief Time of the last sample in nanoseconds.
+  public: int64_t lastTime = 0;
+
+  /// \brief Offset in the file of the next chunk.
+  public: uint64_t offset = 0;
+
+  /// \brief Written chunks.
+  public: std::vector<ChunkInfo> index;
+
+  /// \brief True once a write has failed.
+  public: bool failed = false;
+};
+
+// Private data class
+class ignition::math::TrajectoryLogReaderPrivate
+{
+  /// \brief Load the index from the end of the file, or rebuild it by
+  /// walking the chunks if the file was not closed.
+  /// \return False if the file is corrupt.
+  public: bool LoadIndex()
+  {
+    const unsigned char *end = this->data + this->size;
+    if (this->size >= kHeaderSize + kFooterSize &&
+        std::memcmp(end - 8, kIndexMagic, 8) == 0)
+    {
+      const uint64_t indexOffset =
+        detail::LoadLittleEndian<uint64_t>(end - kFooterSize);
+      const uint64_t chunkCount =
+        detail::LoadLittleEndian<uint64_t>(end - 16);
+      if (indexOffset < kHeaderSize ||
+          indexOffset > this->size - kFooterSize ||
+          chunkCount != (this->size - kFooterSize - indexOffset) /
+            kIndexEntrySize ||
+          (this->size - kFooterSize - indexOffset) % kIndexEntrySize != 0)
+      {
+        std::cerr << "Trajectory log index is corrupt\n";
+        return false;
+      }
+
+      uint64_t expected = kHeaderSize;
+      int64_t lastTime = 0;
+      const unsigned char *entry = this->data + indexOffset;
+      for (uint64_t i = 0; i < chunkCount; ++i, entry += kIndexEntrySize)
+      {
+        ChunkInfo info;
+        info.firstTime = detail::LoadLittleEndian<int64_t>(entry);
+        info.lastTime = detail::LoadLittleEndian<int64_t>(entry + 8);
+        info.offset = detail::LoadLittleEndian<uint64_t>(entry + 16);
+        info.count = detail::LoadLittleEndian<uint64_t>(entry + 24);
+        if (info.offset != expected || info.count == 0 ||
+            info.count > this->chunkSize ||
+            info.offset + ChunkBytes(info.count, this->columns) >
+              indexOffset ||
+            detail::LoadLittleEndian<uint64_t>(this->data + info.offset) !=
+              info.count ||
+            info.firstTime < lastTime || info.lastTime < info.firstTime ||
+            this->TimeAt(info, 0) != info.firstTime ||
+            this->TimeAt(info, info.count - 1) != info.lastTime)
+        {
+          std::cerr << "Trajectory log index entry " << i << " is corrupt\n";
+          return false;
+        }
+        info.first = this->count;
+        this->count += info.count;
+        expected = info.offset + ChunkBytes(info.count, this->columns);
+        lastTime = info.lastTime;
+        this->chunks.push_back(info);
+      }
+      return true;
+    }
+
+    // Keep every complete chunk of a log that was not closed
+    uint64_t offset = kHeaderSize;
+    int64_t lastTime = 0;
+    while (this->size - offset >= 8)
+    {
+      const uint64_t chunkCount =
+        detail::LoadLittleEndian<uint64_t>(this->data + offset);
+      if (chunkCount == 0 || chunkCount > this->chunkSize ||
+          ChunkBytes(chunkCount, this->columns) > this->size - offset)
+      {
+        break;
+      }
+
+      ChunkInfo info;
+      info.firstTime =
+        detail::LoadLittleEndian<int64_t>(this->data + offset + 8);
+      info.lastTime = detail::LoadLittleEndian<int64_t>(
+          this->data + offset + chunkCount * 8);
+      if (info.firstTime < lastTime || info.lastTime < info.firstTime)
+        break;
+      info.offset = offset;
+      info.count = chunkCount;
+      info.first = this->count;
+      this->count += chunkCount;
+      this->chunks.push_back(info);
+      lastTime = info.lastTime;
+      offset += ChunkBytes(chunkCount, this->columns);
+    }
+    return true;
+  }
+
+  /// \brief Find the chunk holding a sample.
+  /// \param[in] _index Index of the sample, which must be in range.
+  /// \return The chunk.
+  public: const ChunkInfo &ChunkOf(const size_t _index) const
+  {
+    auto it = std::upper_bound(this->chunks.begin(), this->chunks.end(),
+        _index, [](const size_t _i, const ChunkInfo &_chunk)
+        {
+          return _i < _chunk.first;
+        });
+    return *(it - 1);
+  }
+
+  /// \brief Get the timestamp of a sample.
+  /// \param[in] _chunk The chunk holding the sample.
+  /// \param[in] _i Index of the sample in the chunk.
+  /// \return Nanoseconds since the clock epoch.
+  public: int64_t TimeAt(const ChunkInfo &_chunk, const size_t _i) const
+  {
+    return detail::LoadLittleEndian<int64_t>(
+        this->data + _chunk.offset + 8 + _i * 8);
+  }
+
+  /// \brief Get a value of a sample.
+  /// \param[in] _chunk The chunk holding the sample.
+  /// \param[in] _column Index of the value column.
+  /// \param[in] _i Index of the sample in the chunk.
+  /// \return The value.
+  public: double ValueAt(const ChunkInfo &_chunk, const size_t _column,
+              const size_t _i) const
+  {
+    return detail::LoadLittleEndian<double>(this->data + _chunk.offset + 8 +
+        (_column + 1) * _chunk.count * 8 + _i * 8);
+  }
+
+  /// \brief Decode a sample as a pose.
+  /// \param[in] _index Index of the sample, which must be in range.
+  /// \return The pose.
+  public: Pose3d PoseAt(const size_t _index) const
+  {
+    const ChunkInfo &chunk = this->ChunkOf(_index);
+    const size_t i = _index - chunk.first;
+    Pose3d pose(this->ValueAt(chunk, 0, i), this->ValueAt(chunk, 1, i),
+        this->ValueAt(chunk, 2, i), 0, 0, 0);
+    if (this->type == TRAJECTORY_LOG_POSE3)
+    {
+      pose.Rot().Set(this->ValueAt(chunk, 3, i), this->ValueAt(chunk, 4, i),
+          this->ValueAt(chunk, 5, i), this->ValueAt(chunk, 6, i));
+    }
+    return pose;
+  }
+
+  /// \brief Find the last sample at or before a time.
+  /// \param[in] _ns Time in nanoseconds.
+  /// \param[out] _index Index of the sample.
+  /// \return False if the time is before the first sample.
+  public: bool Find(const int64_t _ns, size_t &_index) const
+  {
+    auto chunk = std::upper_bound(this->chunks.begin(), this->chunks.end(),
+        _ns, [](const int64_t _t, const ChunkInfo &_c)
+        {
+          return _t < _c.firstTime;
+        });
+    if (chunk == this->chunks.begin())
+      return false;
+    --chunk;
+
+    size_t lo = 0;
+    size_t hi = chunk->count;
+    // Binary search for the first timestamp after the time
+    while (lo < hi)
+    {
+      const size_t mid = lo + (hi - lo) / 2;
+      if (this->TimeAt(*chunk, mid) <= _ns)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    if (lo == 0)
+      return false;
+    _index = chunk->first + lo - 1;
+    return true;
+  }
+
+  /// \brief Start of the file contents.
+  public: const unsigned char *data = nullptr;
+
+  /// \brief Size of the file.
+  public: size_t size = 0;
+
+#ifdef _WIN32
+  /// \brief File contents.
+  public: std::vector<unsigned char> contents;
+#endif
+
+  /// \brief Kind of samples.
+  public: TrajectoryLogType type = TRAJECTORY_LOG_POSE3;
+
+  /// \brief Number of value columns.
+  public: size_t columns = 0;
+
+  /// \brief Maximum number of samples per chunk.
+  public: uint64_t chunkSize = 0;
+
+  /// \brief Number of samples.
+  public: size_t count = 0;
+
+  /// \brief The chunks, in time order.
+  public: std::vector<ChunkInfo> chunks;
+};
+
+//////////////////////////////////////////////////
+TrajectoryLogWriter::TrajectoryLogWriter()
+  : dataPtr(new TrajectoryLogWriterPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+TrajectoryLogWriter::~TrajectoryLogWriter()
+{
+  this->Close();
+}
+
+//////////////////////////////////////////////////
+bool TrajectoryLogWriter::Open(const std::string &_filename,
+    const TrajectoryLogType _type, const size_t _chunkSize)
+{
+  this->Close();
+
+  if (_type != TRAJECTORY_LOG_VECTOR3 && _type != TRAJECTORY_LOG_POSE3)
+  {
+    std::cerr << "Invalid trajectory log type " << _type << "\n";
+    return false;
+  }
+  if (_chunkSize == 0 || _chunkSize > std::numeric_limits<uint32_t>::max())
+  {
+    std::cerr << "Trajectory log chunk size must be between 1 and "
+              << std::numeric_limits<uint32_t>::max() << "\n";
+    return false;
+  }
+
+  TrajectoryLogWriterPrivate &d = *this->dataPtr;
+  d.out.open(_filename, std::ios::binary | std::ios::trunc);
+  if (!d.out)
+  {
+    std::cerr << "Unable to create trajectory log [" << _filename << "]\n";
+    return false;
+  }
+
+  unsigned char header[kHeaderSize] = {};
+  std::memcpy(header, kMagic, sizeof(kMagic));
+  detail::StoreLittleEndian(kVersion, header + 8);
+  header[10] = static_cast<unsigned char>(_type);
+  detail::StoreLittleEndian(static_cast<uint32_t>(_chunkSize), header + 12);
+  d.out.write(reinterpret_cast<const char *>(header), sizeof(header));
+
+  d.type = _type;
+  d.columns = static_cast<size_t>(_type);
+  d.chunkSize = _chunkSize;
+  d.times.resize(_chunkSize);
+  d.values.resize(_chunkSize * d.columns);
+  d.encoded.resize(ChunkBytes(_chunkSize, d.columns));
+  d.count = 0;
+  d.size = 0;
+  d.lastTime = 0;
+  d.offset = kHeaderSize;
+  d.index.clear();
+  d.failed = !d.out.good();
+  if (d.failed)
+    std::cerr << "Unable to write trajectory log header\n";
+  return !d.failed;
+}
+
+//////////////////////////////////////////////////
+bool TrajectoryLogWriter::IsOpen() const
+{
+  return this->dataPtr->out.is_open();
+}
+
+//////////////////////////////////////////////////
+bool TrajectoryLogWriter::Append(
+    const std::chrono::steady_clock::time_point &_time, const Pose3d &_pose)
+{
+  if (!this->IsOpen() || this->dataPtr->type != TRAJECTORY_LOG_POSE3)
+  {
+    std::cerr << "Poses can only be appended to an open pose log\n";
+    return false;
+  }
+
+  const double values[7] = {_pose.Pos().X(), _pose.Pos().Y(),
+    _pose.Pos().Z(), _pose.Rot().W(), _pose.Rot().X(), _pose.Rot().Y(),
+    _pose.Rot().Z()};
+  return this->dataPtr->Append(_time, values);
+}
+
+//////////////////////////////////////////////////
+bool TrajectoryLogWriter::Append(
+    const std::chrono::steady_clock::time_point &_time,
+    const Vector3d &_position)
+{
+  if (!this->IsOpen() || this->dataPtr->type != TRAJECTORY_LOG_VECTOR3)
+  {
+    std::cerr << "Positions can only be appended to an open position log\n";
+    return false;
+  }
+
+  const double values[3] = {_position.X(), _position.Y(), _position.Z()};
+  return this->dataPtr->Append(_time, values);
+}
+
+//////////////////////////////////////////////////
+size_t TrajectoryLogWriter::Size() const
+{
+  return this->dataPtr->size;
+}
+
+//////////////////////////////////////////////////
+bool TrajectoryLogWriter::Close()
+{
+  TrajectoryLogWriterPrivate &d = *this->dataPtr;
+  if (!d.out.is_open())
+    return false;
+
+  bool result = d.Flush();
+  if (result)
+  {
+    unsigned char entry[kIndexEntrySize];
+    for (const ChunkInfo &info : d.index)
+    {
+      detail::StoreLittleEndian(info.firstTime, entry);
+      detail::StoreLittleEndian(info.lastTime, entry + 8);
+      detail::StoreLittleEndian(info.offset, entry + 16);
+      detail::StoreLittleEndian(info.count, entry + 24);
+      d.out.write(reinterpret_cast<const char *>(entry), sizeof(entry));
+    }
+
+    unsigned char footer[kFooterSize];
+    detail::StoreLittleEndian(d.offset, footer);
+    detail::StoreLittleEndian(static_cast<uint64_t>(d.index.size()),
+        footer + 8);
+    std::memcpy(footer + 16, kIndexMagic, sizeof(kIndexMagic));
+    d.out.write(reinterpret_cast<const char *>(footer), sizeof(footer));
+    d.out.flush();
+    if (!d.out.good())
+    {
+      std::cerr << "Unable to write trajectory log index\n";
+      result = false;
+    }
+  }
+
+  d.out.close();
+  d.index.clear();
+  d.index.shrink_to_fit();
+  return result;
+}
+
+//////////////////////////////////////////////////
+TrajectoryLogReader::TrajectoryLogReader()
+  : dataPtr(new TrajectoryLogReaderPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+TrajectoryLogReader::~TrajectoryLogReader()
+{
+  this->Close();
+}
+
+//////////////////////////////////////////////////
+bool TrajectoryLogReader::Open(const std::string &_filename)
+{
+  this->Close();
+  TrajectoryLogReaderPrivate &d = *this->dataPtr;
+
+#ifdef _WIN32
+  std::ifstream in(_filename, std::ios::binary);
+  if (!in)
+  {
+    std::cerr << "Unable to open trajectory log [" << _filename << "]\n";
+    return false;
+  }
+  d.contents.assign(std::istreambuf_iterator<char>(in),
+      std::istreambuf_iterator<char>());
+  d.data = d.contents.data();
+  d.size = d.contents.size();
+#else
+  const int fd = open(_filename.c_str(), O_RDONLY);
+  if (fd < 0)
+  {
+    std::cerr << "Unable to open trajectory log [" << _filename << "]\n";
+    return false;
+  }
+  struct stat info;
+  if (fstat(fd, &info) != 0 || info.st_size < 0 ||
+      static_cast<size_t>(info.st_size) < kHeaderSize)
+  {
+    close(fd);
+    std::cerr << "[" << _filename << "] is not a trajectory log\n";
+    return false;
+  }
+  void *mapped = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ,
+      MAP_SHARED, fd, 0);
+  close(fd);
+  if (mapped == MAP_FAILED)
+  {
+    std::cerr << "Unable to map trajectory log [" << _filename << "]\n";
+    return false;
+  }
+  d.data = static_cast<const unsigned char *>(mapped);
+  d.size = static_cast<size_t>(info.st_size);
+#endif
+
+  if (d.size < kHeaderSize || std::memcmp(d.data, kMagic, 8) != 0)
+  {
+    std::cerr << "[" << _filename << "] is not a trajectory log\n";
+    this->Close();
+    return false;
+  }
+
+  const uint16_t version = detail::LoadLittleEndian<uint16_t>(d.data + 8);
+  if (version != kVersion)
+  {
+    std::cerr << "Unsupported trajectory log version " << version << "\n";
+    this->Close();
+    return false;
+  }
+
+  const unsigned char type = d.data[10];
+  d.chunkSize = detail::LoadLittleEndian<uint32_t>(d.data + 12);
+  if ((type != TRAJECTORY_LOG_VECTOR3 && type != TRAJECTORY_LOG_POSE3) ||
+      d.chunkSize == 0)
+  {
+    std::cerr << "Trajectory log [" << _filename << "] has a corrupt "
+              << "header\n";
+    this->Close();
+    return false;
+  }
+  d.type = static_cast<TrajectoryLogType>(type);
+  d.columns = type;
+
+  if (!d.LoadIndex())
+  {
+    this->Close();
+    return false;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////
+void TrajectoryLogReader::Close()
+{
+  TrajectoryLogReaderPrivate &d = *this->dataPtr;
+#ifdef _WIN32
+  d.contents.clear();
+  d.contents.shrink_to_fit();
+#else
+  if (d.data)
+    munmap(const_cast<unsigned char *>(d.data), d.size);
+#endif
+  d.data = nullptr;
+  d.size = 0;
+  d.count = 0;
+  d.chunks.clear();
+}
+
+//////////////////////////////////////////////////
+bool TrajectoryLogReader::IsOpen() const
+{
+  return this->dataPtr->data != nullptr;
+}
+
+//////////////////////////////////////////////////
+TrajectoryLogType TrajectoryLogReader::Type() const
+{
+  return this->dataPtr->type;
+}
+
+//////////////////////////////////////////////////
+size_t TrajectoryLogReader::Size() const
+{
+  return this->dataPtr->count;
+}
+
+//////////////////////////////////////////////////
+std::chrono::steady_clock::time_point TrajectoryLogReader::StartTime() const
+{
+  if (this->dataPtr->chunks.empty())
+    return secNsecToTimePoint(0, 0);
+  return FromNanoseconds(this->dataPtr->chunks.front().firstTime);
+}
+
+//////////////////////////////////////////////////
+std::chrono::steady_clock::time_point TrajectoryLogReader::EndTime() const
+{
+  if (this->dataPtr->chunks.empty())
+    return secNsecToTimePoint(0, 0);
+  return FromNanoseconds(this->dataPtr->chunks.back().lastTime);
+}
+
+//////////////////////////////////////////////////
+bool TrajectoryLogReader::Time(const size_t _index,
+    std::chrono::steady_clock::time_point &_time) const
+{
+  if (_index >= this->dataPtr->count)
+    return false;
+
+  const ChunkInfo &chunk = this->dataPtr->ChunkOf(_index);
+  _time = FromNanoseconds(this->dataPtr->TimeAt(chunk,
+        _index - chunk.first));
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool TrajectoryLogReader::Pose(const size_t _index, Pose3d &_pose) const
+{
+  if (_index >= this->dataPtr->count)
+    return false;
+
+  _pose = this->dataPtr->PoseAt(_index);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool TrajectoryLogReader::Position(const size_t _index,
+    Vector3d &_position) const
+{
+  if (_index >= this->dataPtr->count)
+    return false;
+
+  const ChunkInfo &chunk = this->dataPtr->ChunkOf(_index);
+  const size_t i = _index - chunk.first;
+  _position.Set(this->dataPtr->ValueAt(chunk, 0, i),
+      this->dataPtr->ValueAt(chunk, 1, i),
+      this->dataPtr->ValueAt(chunk, 2, i));
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool TrajectoryLogReader::Find(
+    const std::chrono::steady_clock::time_point &_time, size_t &_index) const
+{
+  return this->dataPtr->Find(ToNanoseconds(_time), _index);
+}
+
+//////////////////////////////////////////////////
+bool TrajectoryLogReader::Interpolate(
+    const std::chrono::steady_clock::time_point &_time, Pose3d &_pose) const
+{
+  const TrajectoryLogReaderPrivate &d = *this->dataPtr;
+  const int64_t ns = ToNanoseconds(_time);
+  size_t index;
+  if (!d.Find(ns, index))
+    return false;
+
+  const ChunkInfo &chunk = d.ChunkOf(index);
+  const int64_t t0 = d.TimeAt(chunk, index - chunk.first);
+  if (ns == t0)
+  {
+    _pose = d.PoseAt(index);
+    return true;
+  }
+  if (index + 1 >= d.count)
+    return false;
+
+  const ChunkInfo &next = d.ChunkOf(index + 1);
+  const int64_t t1 = d.TimeAt(next, index + 1 - next.first);
+  const double t = static_cast<double>(ns - t0) /
+    static_cast<double>(t1 - t0);
+  const Pose3d p0 = d.PoseAt(index);
+  const Pose3d p1 = d.PoseAt(index + 1);
+  _pose.Set(p0.Pos() + (p1.Pos() - p0.Pos()) * t,
+      Quaterniond::Slerp(t, p0.Rot(), p1.Rot(), true));
+  return true;
+}
+
+//////////////////////////////////////////////////
+size_t TrajectoryLogReader::ChunkCount() const
+{
+  return this->dataPtr->chunks.size();
+}
+
+//////////////////////////////////////////////////
+bool TrajectoryLogReader::ChunkColumns(const size_t _chunk, Chunk &_columns,
+    size_t &_first) const
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  const TrajectoryLogReaderPrivate &d = *this->dataPtr;
+  if (_chunk >= d.chunks.size())
+    return false;
+
+  // Chunks start at multiples of 8 bytes from the page aligned mapping
+  const ChunkInfo &chunk = d.chunks[_chunk];
+  const unsigned char *start = d.data + chunk.offset + 8;
+  _columns.count = chunk.count;
+  _columns.time = reinterpret_cast<const int64_t *>(start);
+  for (size_t c = 0; c < 7; ++c)
+  {
+    _columns.columns[c] = c < d.columns ?
+      reinterpret_cast<const double *>(start + (c + 1) * chunk.count * 8) :
+      nullptr;
+  }
+  _first = chunk.first;
+  return true;
+#else
+  (void)_chunk;
+  (void)_columns;
+  (void)_first;
+  return false;
+#endif
+}
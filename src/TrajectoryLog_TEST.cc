@@ -0,0 +1,349 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "ignition/math/Helpers.hh"
+#include "ignition/math/Rand.hh"
+#include "ignition/math/TrajectoryLog.hh"
+
+using namespace ignition;
+
+/////////////////////////////////////////////////
+/// \brief Get the time of a test sample.
+/// \param[in] _i Index of the sample.
+/// \return 10 seconds plus 20 milliseconds per sample.
+std::chrono::steady_clock::time_point SampleTime(const int _i)
+{
+  return math::secNsecToTimePoint(10, 0) + std::chrono::milliseconds(20 * _i);
+}
+
+/////////////////////////////////////////////////
+/// \brief Get the size of a file.
+/// \param[in] _filename Path of the file.
+/// \return Size in bytes.
+size_t FileSize(const std::string &_filename)
+{
+  std::ifstream in(_filename, std::ios::binary | std::ios::ate);
+  return static_cast<size_t>(in.tellg());
+}
+
+/////////////////////////////////////////////////
+TEST(TrajectoryLogTest, Poses)
+{
+  const std::string filename = "TrajectoryLogTest_Poses.traj";
+  math::Rand::Seed(17);
+  std::vector<math::Pose3d> poses;
+  for (int i = 0; i < 1000; ++i)
+  {
+    poses.push_back(math::Pose3d(math::Rand::DblUniform(-9, 9),
+          math::Rand::DblUniform(-9, 9), math::Rand::DblUniform(-9, 9),
+          math::Rand::DblUniform(-3, 3), math::Rand::DblUniform(-3, 3),
+          math::Rand::DblUniform(-3, 3)));
+  }
+
+  math::TrajectoryLogWriter writer;
+  EXPECT_FALSE(writer.IsOpen());
+  ASSERT_TRUE(writer.Open(filename, math::TRAJECTORY_LOG_POSE3, 64));
+  EXPECT_TRUE(writer.IsOpen());
+  for (int i = 0; i < 1000; ++i)
+    EXPECT_TRUE(writer.Append(SampleTime(i), poses[i]));
+  EXPECT_EQ(1000u, writer.Size());
+
+  // Wrong kind of sample, or out of order
+  EXPECT_FALSE(writer.Append(SampleTime(1000), math::Vector3d::Zero));
+  EXPECT_FALSE(writer.Append(SampleTime(998), poses[0]));
+  EXPECT_EQ(1000u, writer.Size());
+  EXPECT_TRUE(writer.Close());
+  EXPECT_FALSE(writer.IsOpen());
+  EXPECT_FALSE(writer.Close());
+
+  // 32 byte header, 15 chunks of 8 + 64 * 64 bytes and a short last chunk
+  // of 8 + 40 * 64 bytes, then 16 index entries and the footer.
+  EXPECT_EQ(32u + 15 * 4104 + 2568 + 16 * 32 + 24, FileSize(filename));
+
+  math::TrajectoryLogReader reader;
+  EXPECT_FALSE(reader.IsOpen());
+  ASSERT_TRUE(reader.Open(filename));
+  EXPECT_TRUE(reader.IsOpen());
+  EXPECT_EQ(math::TRAJECTORY_LOG_POSE3, reader.Type());
+  EXPECT_EQ(1000u, reader.Size());
+  EXPECT_EQ(16u, reader.ChunkCount());
+  EXPECT_EQ(SampleTime(0), reader.StartTime());
+  EXPECT_EQ(SampleTime(999), reader.EndTime());
+
+  // Random access
+  for (size_t i = 0; i < poses.size(); i += 7)
+  {
+    math::Pose3d pose;
+    EXPECT_TRUE(reader.Pose(i, pose));
+    EXPECT_EQ(poses[i], pose);
+    math::Vector3d position;
+    EXPECT_TRUE(reader.Position(i, position));
+    EXPECT_EQ(poses[i].Pos(), position);
+    std::chrono::steady_clock::time_point time;
+    EXPECT_TRUE(reader.Time(i, time));
+    EXPECT_EQ(SampleTime(static_cast<int>(i)), time);
+  }
+  math::Pose3d pose;
+  EXPECT_FALSE(reader.Pose(1000, pose));
+
+  // Find the sample at or before a time
+  size_t index = 0;
+  EXPECT_TRUE(reader.Find(SampleTime(640), index));
+  EXPECT_EQ(640u, index);
+  EXPECT_TRUE(reader.Find(SampleTime(639) + std::chrono::milliseconds(19),
+        index));
+  EXPECT_EQ(639u, index);
+  EXPECT_TRUE(reader.Find(SampleTime(5000), index));
+  EXPECT_EQ(999u, index);
+  EXPECT_FALSE(reader.Find(SampleTime(0) - std::chrono::nanoseconds(1),
+        index));
+
+  // Interpolate across a chunk boundary
+  EXPECT_TRUE(reader.Interpolate(SampleTime(63), pose));
+  EXPECT_EQ(poses[63], pose);
+  EXPECT_TRUE(reader.Interpolate(SampleTime(63) + std::chrono::milliseconds(5),
+        pose));
+  EXPECT_EQ(poses[63].Pos() + (poses[64].Pos() - poses[63].Pos()) * 0.25,
+      pose.Pos());
+  EXPECT_EQ(math::Quaterniond::Slerp(0.25, poses[63].Rot(), poses[64].Rot(),
+        true), pose.Rot());
+  EXPECT_TRUE(reader.Interpolate(SampleTime(999), pose));
+  EXPECT_FALSE(reader.Interpolate(SampleTime(999) +
+        std::chrono::nanoseconds(1), pose));
+
+  // Columns in place
+  math::TrajectoryLogReader::Chunk chunk;
+  size_t first = 0;
+  if (reader.ChunkColumns(15, chunk, first))
+  {
+    EXPECT_EQ(40u, chunk.count);
+    EXPECT_EQ(960u, first);
+    EXPECT_EQ(10000000000 + 20000000 * int64_t(961), chunk.time[1]);
+    EXPECT_DOUBLE_EQ(poses[961].Pos().Y(), chunk.columns[1][1]);
+    EXPECT_DOUBLE_EQ(poses[961].Rot().W(), chunk.columns[3][1]);
+    EXPECT_DOUBLE_EQ(poses[999].Rot().Z(), chunk.columns[6][39]);
+  }
+  EXPECT_FALSE(reader.ChunkColumns(16, chunk, first));
+
+  reader.Close();
+  EXPECT_FALSE(reader.IsOpen());
+  EXPECT_EQ(0u, reader.Size());
+  EXPECT_EQ(0, std::remove(filename.c_str()));
+}
+
+/////////////////////////////////////////////////
+TEST(TrajectoryLogTest, Positions)
+{
+  const std::string filename = "TrajectoryLogTest_Positions.traj";
+  {
+    // The destructor closes the log
+    math::TrajectoryLogWriter writer;
+    ASSERT_TRUE(writer.Open(filename, math::TRAJECTORY_LOG_VECTOR3, 4));
+    EXPECT_FALSE(writer.Append(SampleTime(0), math::Pose3d::Zero));
+    for (int i = 0; i < 10; ++i)
+      EXPECT_TRUE(writer.Append(SampleTime(i), math::Vector3d(i, 2 * i, 0)));
+
+    // Samples may share a time
+    EXPECT_TRUE(writer.Append(SampleTime(9), math::Vector3d(9, 20, 0)));
+  }
+
+  math::TrajectoryLogReader reader;
+  ASSERT_TRUE(reader.Open(filename));
+  EXPECT_EQ(math::TRAJECTORY_LOG_VECTOR3, reader.Type());
+  EXPECT_EQ(11u, reader.Size());
+  EXPECT_EQ(3u, reader.ChunkCount());
+
+  math::Pose3d pose;
+  EXPECT_TRUE(reader.Pose(3, pose));
+  EXPECT_EQ(math::Pose3d(3, 6, 0, 0, 0, 0), pose);
+  EXPECT_TRUE(reader.Interpolate(SampleTime(2) + std::chrono::milliseconds(10),
+        pose));
+  EXPECT_EQ(math::Vector3d(2.5, 5, 0), pose.Pos());
+  EXPECT_EQ(math::Quaterniond::Identity, pose.Rot());
+
+  size_t index = 0;
+  EXPECT_TRUE(reader.Find(SampleTime(9), index));
+  EXPECT_EQ(10u, index);
+
+  math::TrajectoryLogReader::Chunk chunk;
+  size_t first = 0;
+  if (reader.ChunkColumns(1, chunk, first))
+  {
+    EXPECT_EQ(4u, first);
+    EXPECT_DOUBLE_EQ(10.0, chunk.columns[1][1]);
+    EXPECT_EQ(nullptr, chunk.columns[3]);
+  }
+
+  // An empty log
+  math::TrajectoryLogWriter writer;
+  ASSERT_TRUE(writer.Open(filename, math::TRAJECTORY_LOG_VECTOR3));
+  EXPECT_TRUE(writer.Close());
+  ASSERT_TRUE(reader.Open(filename));
+  EXPECT_EQ(0u, reader.Size());
+  EXPECT_EQ(0u, reader.ChunkCount());
+  EXPECT_EQ(math::secNsecToTimePoint(0, 0), reader.StartTime());
+  EXPECT_FALSE(reader.Find(SampleTime(0), index));
+  EXPECT_FALSE(reader.Interpolate(SampleTime(0), pose));
+  EXPECT_EQ(0, std::remove(filename.c_str()));
+}
+
+/////////////////////////////////////////////////
+TEST(TrajectoryLogTest, Unclosed)
+{
+  const std::string filename = "TrajectoryLogTest_Unclosed.traj";
+  math::TrajectoryLogWriter writer;
+  ASSERT_TRUE(writer.Open(filename, math::TRAJECTORY_LOG_POSE3, 16));
+  for (int i = 0; i < 40; ++i)
+    EXPECT_TRUE(writer.Append(SampleTime(i), math::Pose3d(i, 0, 0, 0, 0, 0)));
+  EXPECT_TRUE(writer.Close());
+
+  // Drop the index and part of the last chunk, as if the writer had stopped
+  // while writing it
+  std::string contents;
+  {
+    std::ifstream in(filename, std::ios::binary);
+    contents.assign(std::istreambuf_iterator<char>(in),
+        std::istreambuf_iterator<char>());
+  }
+  const size_t chunkBytes = 8 + 16 * 64;
+  const size_t end = 32 + 2 * chunkBytes + 100;
+  ASSERT_GT(contents.size(), end);
+  {
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    out.write(contents.data(), end);
+  }
+
+  math::TrajectoryLogReader reader;
+  ASSERT_TRUE(reader.Open(filename));
+  EXPECT_EQ(32u, reader.Size());
+  EXPECT_EQ(2u, reader.ChunkCount());
+  EXPECT_EQ(SampleTime(31), reader.EndTime());
+  math::Pose3d pose;
+  EXPECT_TRUE(reader.Pose(31, pose));
+  EXPECT_EQ(math::Pose3d(31, 0, 0, 0, 0, 0), pose);
+  reader.Close();
+  EXPECT_EQ(0, std::remove(filename.c_str()));
+}
+
+/////////////////////////////////////////////////
+TEST(TrajectoryLogTest, Errors)
+{
+  const std::string filename = "TrajectoryLogTest_Errors.traj";
+  math::TrajectoryLogWriter writer;
+  EXPECT_FALSE(writer.Append(SampleTime(0), math::Pose3d::Zero));
+  EXPECT_FALSE(writer.Open(filename, math::TRAJECTORY_LOG_POSE3, 0));
+  EXPECT_FALSE(writer.Open(filename, static_cast<math::TrajectoryLogType>(4)));
+  EXPECT_FALSE(writer.Open("/no/such/dir/log.traj"));
+
+  ASSERT_TRUE(writer.Open(filename));
+  EXPECT_FALSE(writer.Append(math::secNsecToTimePoint(0, 0) -
+        std::chrono::seconds(1), math::Pose3d::Zero));
+  EXPECT_TRUE(writer.Append(SampleTime(0), math::Pose3d::Zero));
+  EXPECT_TRUE(writer.Close());
+
+  math::TrajectoryLogReader reader;
+  EXPECT_FALSE(reader.Open("/no/such/dir/log.traj"));
+
+  std::string contents;
+  {
+    std::ifstream in(filename, std::ios::binary);
+    contents.assign(std::istreambuf_iterator<char>(in),
+        std::istreambuf_iterator<char>());
+  }
+  auto check = [&](const std::string &_contents)
+  {
+    {
+      std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+      out.write(_contents.data(), _contents.size());
+    }
+    return reader.Open(filename);
+  };
+  EXPECT_TRUE(check(contents));
+  EXPECT_EQ(1u, reader.Size());
+
+  // Not a log, or a newer version
+  EXPECT_FALSE(check(""));
+  EXPECT_FALSE(reader.IsOpen());
+  EXPECT_FALSE(check(contents.substr(0, 20)));
+  std::string bad = contents;
+  bad[0] = 'X';
+  EXPECT_FALSE(check(bad));
+  bad = contents;
+  bad[8] = 2;
+  EXPECT_FALSE(check(bad));
+  bad = contents;
+  bad[10] = 5;
+  EXPECT_FALSE(check(bad));
+
+  // A corrupt index
+  bad = contents;
+  bad[bad.size() - 16] = 3;
+  EXPECT_FALSE(check(bad));
+  bad = contents;
+  bad[bad.size() - 24 - 8] = 2;
+  EXPECT_FALSE(check(bad));
+
+  // Index times that do not match the chunk
+  bad = contents;
+  bad[bad.size() - 24 - 32] ^= 1;
+  EXPECT_FALSE(check(bad));
+  bad = contents;
+  bad[bad.size() - 24 - 24] ^= 1;
+  EXPECT_FALSE(check(bad));
+  EXPECT_EQ(0, std::remove(filename.c_str()));
+}
+
+/////////////////////////////////////////////////
+TEST(TrajectoryLogTest, FailedWrite)
+{
+#ifndef _WIN32
+  // Every write to /dev/full fails once the stream buffer is flushed
+  if (!std::ifstream("/dev/full"))
+    return;
+
+  math::TrajectoryLogWriter writer;
+  ASSERT_TRUE(writer.Open("/dev/full", math::TRAJECTORY_LOG_POSE3, 1024));
+  for (int i = 0; i < 1023; ++i)
+    EXPECT_TRUE(writer.Append(SampleTime(i), math::Pose3d::Zero));
+  EXPECT_EQ(1023u, writer.Size());
+
+  // The chunk write fails, and the writer stops accepting samples
+  EXPECT_FALSE(writer.Append(SampleTime(1023), math::Pose3d::Zero));
+  EXPECT_EQ(0u, writer.Size());
+  for (int i = 1024; i < 1034; ++i)
+    EXPECT_FALSE(writer.Append(SampleTime(i), math::Pose3d::Zero));
+  EXPECT_EQ(0u, writer.Size());
+  EXPECT_FALSE(writer.Close());
+  EXPECT_FALSE(writer.IsOpen());
+
+  // The writer can be reused
+  const std::string filename = "TrajectoryLogTest_FailedWrite.traj";
+  ASSERT_TRUE(writer.Open(filename, math::TRAJECTORY_LOG_POSE3, 4));
+  EXPECT_TRUE(writer.Append(SampleTime(0), math::Pose3d::Zero));
+  EXPECT_TRUE(writer.Close());
+  EXPECT_EQ(0, std::remove(filename.c_str()));
+#endif
+}
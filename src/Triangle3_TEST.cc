@@ -17,12 +17,27 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <cstring>
+#include <vector>
+
 #include "ignition/math/Triangle3.hh"
 #include "ignition/math/Helpers.hh"
+#include "ignition/math/Rand.hh"
 
 using namespace ignition;
 using namespace math;
 
+/////////////////////////////////////////////////
+/// \brief Check that two doubles have the same bits.
+/// \param[in] _a First value.
+/// \param[in] _b Second value.
+/// \return True if the values are bit for bit identical.
+bool SameBits(const double _a, const double _b)
+{
+  return std::memcmp(&_a, &_b, sizeof(double)) == 0;
+}
+
 /////////////////////////////////////////////////
 TEST(Triangle3Test, Constructor)
 {
@@ -259,3 +274,207 @@ TEST(Triangle3Test, Area)
     EXPECT_NEAR(tri.Area(), (sqrt(2) * sqrt(1.5))*0.5, 1e-6);
   }
 }
+
+/////////////////////////////////////////////////
+TEST(Triangle3Test, IntersectRay)
+{
+  const Triangle3d tri(Vector3d(0, 0, 0), Vector3d(1, 0, 0),
+      Vector3d(0, 1, 0));
+  const Vector3d down(0, 0, -1);
+  double t, u, v;
+
+  // Front and back faces
+  ASSERT_TRUE(tri.IntersectWatertight(Vector3d(0.2, 0.3, 1), down,
+        t, u, v));
+  EXPECT_DOUBLE_EQ(1.0, t);
+  EXPECT_DOUBLE_EQ(0.2, u);
+  EXPECT_DOUBLE_EQ(0.3, v);
+  ASSERT_TRUE(tri.IntersectWatertight(Vector3d(0.2, 0.3, -2),
+        Vector3d(0, 0, 4), t, u, v));
+  EXPECT_DOUBLE_EQ(0.5, t);
+  EXPECT_DOUBLE_EQ(0.2, u);
+  EXPECT_DOUBLE_EQ(0.3, v);
+
+  // Oblique ray
+  ASSERT_TRUE(tri.IntersectWatertight(Vector3d(-1, 0.5, 1),
+        Vector3d(1.25, -0.25, -1), t, u, v));
+  EXPECT_DOUBLE_EQ(1.0, t);
+  EXPECT_DOUBLE_EQ(0.25, u);
+  EXPECT_DOUBLE_EQ(0.25, v);
+
+  // Vertices and edges are inside
+  EXPECT_TRUE(tri.IntersectWatertight(Vector3d(0, 0, 1), down, t, u, v));
+  EXPECT_TRUE(tri.IntersectWatertight(Vector3d(1, 0, 1), down, t, u, v));
+  EXPECT_TRUE(tri.IntersectWatertight(Vector3d(0.5, 0.5, 1), down,
+        t, u, v));
+
+  // Misses give an infinite t and zero weights
+  EXPECT_FALSE(tri.IntersectWatertight(Vector3d(0.6, 0.6, 1), down,
+        t, u, v));
+  EXPECT_TRUE(std::isinf(t) && t > 0);
+  EXPECT_DOUBLE_EQ(0.0, u);
+  EXPECT_DOUBLE_EQ(0.0, v);
+  EXPECT_FALSE(tri.IntersectWatertight(Vector3d(-0.1, 0.2, 1), down,
+        t, u, v));
+  EXPECT_FALSE(tri.IntersectWatertight(Vector3d(0.2, 0.3, 1),
+        Vector3d(0, 0, 1), t, u, v));
+
+  // Range limits
+  EXPECT_FALSE(tri.IntersectWatertight(Vector3d(0.2, 0.3, 1), down,
+        t, u, v, 0, 0.9));
+  EXPECT_TRUE(std::isinf(t) && t > 0);
+  EXPECT_DOUBLE_EQ(0.0, u);
+  EXPECT_DOUBLE_EQ(0.0, v);
+  EXPECT_FALSE(tri.IntersectWatertight(Vector3d(0.2, 0.3, 1), down,
+        t, u, v, 1.1));
+  EXPECT_TRUE(tri.IntersectWatertight(Vector3d(0.2, 0.3, 1), down,
+        t, u, v, 1.0, 1.0));
+
+  // Rays in the plane of the triangle, zero directions and degenerate
+  // triangles never hit
+  EXPECT_FALSE(tri.IntersectWatertight(Vector3d(-1, 0.2, 0),
+        Vector3d(1, 0, 0), t, u, v));
+  EXPECT_FALSE(tri.IntersectWatertight(Vector3d(0.2, 0.3, 0),
+        Vector3d::Zero, t, u, v));
+  EXPECT_TRUE(std::isinf(t) && t > 0);
+  EXPECT_DOUBLE_EQ(0.0, u);
+  EXPECT_DOUBLE_EQ(0.0, v);
+  const Triangle3d line(Vector3d(0, 0, 0), Vector3d(1, 0, 0),
+      Vector3d(2, 0, 0));
+  EXPECT_FALSE(line.IntersectWatertight(Vector3d(0.5, 0, 1), down,
+        t, u, v));
+
+  // Float triangles
+  const Triangle3f trif(Vector3f(0, 0, 0), Vector3f(1, 0, 0),
+      Vector3f(0, 1, 0));
+  float tf, uf, vf;
+  ASSERT_TRUE(trif.IntersectWatertight(Vector3f(0.25f, 0.5f, 2),
+        Vector3f(0, 0, -1), tf, uf, vf));
+  EXPECT_FLOAT_EQ(2.0f, tf);
+  EXPECT_FLOAT_EQ(0.25f, uf);
+  EXPECT_FLOAT_EQ(0.5f, vf);
+}
+
+/////////////////////////////////////////////////
+TEST(Triangle3Test, IntersectRayMatchesIntersects)
+{
+  Rand::Seed(42);
+  for (int i = 0; i < 1000; ++i)
+  {
+    const Triangle3d tri(
+        Vector3d(Rand::DblUniform(-5, 5), Rand::DblUniform(-5, 5),
+          Rand::DblUniform(-5, 5)),
+        Vector3d(Rand::DblUniform(-5, 5), Rand::DblUniform(-5, 5),
+          Rand::DblUniform(-5, 5)),
+        Vector3d(Rand::DblUniform(-5, 5), Rand::DblUniform(-5, 5),
+          Rand::DblUniform(-5, 5)));
+
+    // Segment through a point inside the triangle, starting at least one
+    // unit from it
+    const double a = Rand::DblUniform(0.01, 0.98);
+    const double b = Rand::DblUniform(0.01, 0.99 - a);
+    const Vector3d target = tri[0] * (1 - a - b) + tri[1] * a + tri[2] * b;
+    const Vector3d dir = Vector3d(Rand::DblUniform(-1, 1),
+        Rand::DblUniform(-1, 1), Rand::DblUniform(-1, 1)).Normalize();
+    if (std::abs(dir.Dot(tri.Normal())) < 0.1)
+      continue;
+    const Line3d segment(target - dir * Rand::DblUniform(1.5, 3),
+        target + dir * Rand::DblUniform(0.5, 3));
+
+    Vector3d expected;
+    ASSERT_TRUE(tri.Intersects(segment, expected));
+
+    double t, u, v;
+    ASSERT_TRUE(tri.IntersectWatertight(segment[0],
+          segment[1] - segment[0], t, u, v, 0, 1));
+    const Vector3d point = segment[0] + (segment[1] - segment[0]) * t;
+    EXPECT_NEAR(0.0, point.Distance(expected), 1e-12);
+    EXPECT_NEAR(a, u, 1e-9);
+    EXPECT_NEAR(b, v, 1e-9);
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(Triangle3Test, IntersectRayWatertight)
+{
+  // A fan of triangles around a shared center, forming a height field.
+  // Rays from above aimed at points on the shared edges and at the center
+  // must hit at least one triangle. The rays are steeper than the fan so
+  // no edge is on the silhouette.
+  Rand::Seed(7);
+  const int count = 7;
+  const Vector3d center(0.1234567, -0.7654321, 0.31415);
+  std::vector<Vector3d> rim;
+  for (int i = 0; i < count; ++i)
+  {
+    const double angle = 2 * IGN_PI * (i + Rand::DblUniform(0, 0.5)) / count;
+    rim.push_back(center + Vector3d(std::cos(angle), std::sin(angle),
+          Rand::DblUniform(-0.1, 0.1)) * Rand::DblUniform(0.5, 2.0));
+  }
+  std::vector<Triangle3d> fan;
+  for (int i = 0; i < count; ++i)
+    fan.push_back(Triangle3d(center, rim[i], rim[(i + 1) % count]));
+
+  double t, u, v;
+  for (int i = 0; i < 20000; ++i)
+  {
+    const int edge = i % count;
+    const double s = (i % 50 == 0) ? 0.0 : Rand::DblUniform(0, 1);
+    const Vector3d target = center + (rim[edge] - center) * s;
+    const Vector3d origin = target + Vector3d(Rand::DblUniform(-0.5, 0.5),
+        Rand::DblUniform(-0.5, 0.5), Rand::DblUniform(2, 3));
+    const Vector3d dir = target - origin;
+
+    int hits = 0;
+    for (const Triangle3d &tri : fan)
+      hits += tri.IntersectWatertight(origin, dir, t, u, v) ? 1 : 0;
+    EXPECT_GE(hits, 1) << "target " << target << " origin " << origin;
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(Triangle3Test, IntersectRayBatch)
+{
+  Rand::Seed(11);
+  const size_t count = 257;
+  std::vector<Triangle3d> tris;
+  std::vector<double> p[3][3];
+  for (size_t i = 0; i < count; ++i)
+  {
+    Vector3d pts[3];
+    for (int k = 0; k < 3; ++k)
+    {
+      pts[k].Set(Rand::DblUniform(-1, 1), Rand::DblUniform(-1, 1),
+          Rand::DblUniform(-1, 1));
+      for (int a = 0; a < 3; ++a)
+        p[k][a].push_back(pts[k][a]);
+    }
+    tris.push_back(Triangle3d(pts[0], pts[1], pts[2]));
+  }
+  const double *p0[3] = {p[0][0].data(), p[0][1].data(), p[0][2].data()};
+  const double *p1[3] = {p[1][0].data(), p[1][1].data(), p[1][2].data()};
+  const double *p2[3] = {p[2][0].data(), p[2][1].data(), p[2][2].data()};
+
+  // One ray against many triangles
+  const Vector3d origin(0.1, -0.2, 3);
+  const Vector3d dir(-0.05, 0.1, -1);
+  std::vector<double> t(count), u(count), v(count);
+  const size_t hits = Triangle3d::IntersectWatertight(origin, dir, p0, p1,
+      p2, count, t.data(), u.data(), v.data());
+  size_t expectedHits = 0;
+  for (size_t i = 0; i < count; ++i)
+  {
+    double ti, ui, vi;
+    const bool hit = tris[i].IntersectWatertight(origin, dir, ti, ui, vi);
+    expectedHits += hit ? 1 : 0;
+    if (!hit)
+    {
+      EXPECT_TRUE(std::isinf(t[i]) && t[i] > 0);
+    }
+    EXPECT_TRUE(SameBits(ti, t[i])) << i;
+    EXPECT_TRUE(SameBits(ui, u[i])) << i;
+    EXPECT_TRUE(SameBits(vi, v[i])) << i;
+  }
+  EXPECT_EQ(expectedHits, hits);
+  EXPECT_GT(hits, 0u);
+}
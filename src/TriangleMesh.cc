@@ -0,0 +1,1001 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <numeric>
+
+#include <ignition/math/TriangleMesh.hh>
+
+using namespace ignition::math;
+
+namespace
+{
+  /// \brief Nodes with more triangles than this are always split.
+  const uint32_t kForceSplitSize = 16;
+
+  /// \brief Number of bins used to evaluate split candidates.
+  const int kBinCount = 16;
+
+  /// \brief Depth after which nodes are split at the median, which bounds
+  /// the depth of the tree for any input.
+  const uint32_t kMaxSahDepth = 48;
+
+  /// \brief Size of the traversal stack. The tree is at most
+  /// kMaxSahDepth + 32 levels deep.
+  const int kStackSize = 128;
+
+  /// \brief Number of rays traversed together in packet queries.
+  const size_t kPacketSize = 8;
+
+  /// \brief Factor applied to the far distance of ray-box tests so that
+  /// rounding never culls a triangle that lies on a box face.
+  const double kRobustFar = 1.0 + 4.0 * std::numeric_limits<double>::epsilon();
+
+  /// \brief A ray with a precomputed reciprocal direction.
+  struct Ray
+  {
+    /// \brief Origin.
+    double o[3];
+
+    /// \brief Direction.
+    double d[3];
+
+    /// \brief Reciprocal of the direction. Zero components are replaced
+    /// by a tiny value so the slab test never computes 0 * inf.
+    double inv[3];
+
+    /// \brief Index in Node::bounds of the near plane along each axis.
+    int nearIndex[3];
+
+    /// \brief Index in Node::bounds of the far plane along each axis.
+    int farIndex[3];
+
+    /// \brief Set the ray.
+    /// \param[in] _origin Origin.
+    /// \param[in] _dir Direction.
+    void Set(const Vector3d &_origin, const Vector3d &_dir)
+    {
+      for (int a = 0; a < 3; ++a)
+      {
+        this->o[a] = _origin[a];
+        this->d[a] = _dir[a];
+        const double dir = std::abs(_dir[a]) < 1e-300 ?
+          std::copysign(1e-300, _dir[a]) : _dir[a];
+        this->inv[a] = 1.0 / dir;
+        this->nearIndex[a] = dir < 0 ? a + 3 : a;
+        this->farIndex[a] = dir < 0 ? a : a + 3;
+      }
+    }
+  };
+
+  /// \brief Best hit found so far by a ray query.
+  struct Hit
+  {
+    /// \brief Ray parameter, which is also the far limit of the query.
+    double t;
+
+    /// \brief Index of the triangle in hierarchy order.
+    uint32_t slot;
+
+    /// \brief Original index of the triangle, used to break ties.
+    size_t triangle;
+
+    /// \brief Barycentric weight of the second vertex.
+    double u;
+
+    /// \brief Barycentric weight of the third vertex.
+    double v;
+  };
+
+  /// \brief Get the dot product of two 3-vectors.
+  inline double Dot(const double *_a, const double *_b)
+  {
+    return _a[0] * _b[0] + _a[1] * _b[1] + _a[2] * _b[2];
+  }
+
+  /// \brief Get the cross product of two 3-vectors.
+  inline void Cross(const double *_a, const double *_b, double *_out)
+  {
+    _out[0] = _a[1] * _b[2] - _a[2] * _b[1];
+    _out[1] = _a[2] * _b[0] - _a[0] * _b[2];
+    _out[2] = _a[0] * _b[1] - _a[1] * _b[0];
+  }
+
+  /// \brief Get half the surface area of a box.
+  inline double HalfArea(const Vector3d &_lower, const Vector3d &_upper)
+  {
+    const Vector3d size = _upper - _lower;
+    return size.X() * size.Y() + size.Y() * size.Z() + size.Z() * size.X();
+  }
+
+  /// \brief Get the point on a segment that is nearest to a point.
+  /// \return Parameter of the nearest point, in [0, 1].
+  inline double ClosestOnSegment(const Vector3d &_a, const Vector3d &_b,
+      const Vector3d &_p)
+  {
+    const Vector3d ab = _b - _a;
+    const double len2 = ab.SquaredLength();
+    if (len2 <= 0)
+      return 0;
+    return std::min(1.0, std::max(0.0, (_p - _a).Dot(ab) / len2));
+  }
+}
+
+//////////////////////////////////////////////////
+class ignition::math::TriangleMeshPrivate
+{
+  /// \brief A node of the hierarchy.
+  public: struct Node
+  {
+    /// \brief Bounding box of the node, as the lower corner followed by
+    /// the upper corner.
+    public: double bounds[6];
+
+    /// \brief Index of the first triangle for a leaf, or of the first of
+    /// the two adjacent children for an inner node.
+    public: uint32_t offset;
+
+    /// \brief Number of triangles in a leaf, zero for an inner node.
+    public: uint32_t count;
+
+    /// \brief Axis that an inner node was split along.
+    public: uint32_t axis;
+  };
+
+  /// \brief A triangle stored for ray tests, as its first vertex and the
+  /// two edges that leave it.
+  public: struct TriangleData
+  {
+    /// \brief First vertex.
+    public: double v0[3];
+
+    /// \brief Second vertex minus the first.
+    public: double e1[3];
+
+    /// \brief Third vertex minus the first.
+    public: double e2[3];
+  };
+
+  /// \brief Build the hierarchy from the vertices and indices.
+  public: void Build();
+
+  /// \brief Intersect a ray with the box of a node.
+  /// \param[in] _node Node to test.
+  /// \param[in] _ray Ray to test.
+  /// \param[in] _tMin Near limit of the ray.
+  /// \param[in] _tMax Far limit of the ray.
+  /// \param[out] _tEnter Ray parameter where the ray enters the box.
+  /// \return True if the ray overlaps the box within the limits.
+  public: static bool IntersectBox(const Node &_node, const Ray &_ray,
+              const double _tMin, const double _tMax, double &_tEnter);
+
+  /// \brief Intersect a ray with a triangle of the hierarchy, and update
+  /// _hit if the triangle is nearer.
+  /// \param[in] _slot Index of the triangle in hierarchy order.
+  /// \param[in] _ray Ray to test.
+  /// \param[in] _tMin Near limit of the ray.
+  /// \param[in,out] _hit Best hit so far.
+  /// \return True if _hit was updated.
+  public: bool IntersectTriangle(const uint32_t _slot, const Ray &_ray,
+              const double _tMin, Hit &_hit) const;
+
+  /// \brief Find the nearest triangle hit by a ray.
+  /// \param[in] _ray Ray to cast.
+  /// \param[in] _tMin Near limit of the ray.
+  /// \param[in,out] _hit Far limit of the ray on input, nearest hit on
+  /// output.
+  /// \param[in] _any Stop at the first hit.
+  /// \return True if a triangle was hit.
+  public: bool Traverse(const Ray &_ray, const double _tMin, Hit &_hit,
+              const bool _any) const;
+
+  /// \brief Traverse a packet of rays together.
+  /// \param[in] _rays Rays of the packet.
+  /// \param[in] _count Number of rays, at most kPacketSize.
+  /// \param[in] _tMin Near limit of the rays.
+  /// \param[in,out] _hits Far limits of the rays on input, nearest hits
+  /// on output.
+  /// \param[in] _any Stop each ray at its first hit.
+  public: void TraversePacket(const Ray *_rays, const size_t _count,
+              const double _tMin, Hit *_hits, const bool _any) const;
+
+  /// \brief Convert an internal hit to a public result.
+  /// \param[in] _ray Ray that produced the hit.
+  /// \param[in] _hit Internal hit.
+  /// \param[out] _result Public result.
+  public: void FillHit(const Ray &_ray, const Hit &_hit,
+              TriangleMesh::RayHit &_result) const;
+
+  /// \brief Vertex positions.
+  public: std::vector<Vector3d> vertices;
+
+  /// \brief Vertex indices, three per triangle.
+  public: std::vector<unsigned int> indices;
+
+  /// \brief Nodes of the hierarchy. The root is the first node.
+  public: std::vector<Node> nodes;
+
+  /// \brief Triangles in hierarchy order.
+  public: std::vector<TriangleData> triangles;
+
+  /// \brief Original index of each triangle in hierarchy order.
+  public: std::vector<uint32_t> order;
+};
+
+//////////////////////////////////////////////////
+void TriangleMeshPrivate::Build()
+{
+  this->nodes.clear();
+  this->triangles.clear();
+  this->order.clear();
+
+  const uint32_t count = static_cast<uint32_t>(this->indices.size() / 3);
+  if (count == 0)
+    return;
+
+  const double inf = std::numeric_limits<double>::infinity();
+  std::vector<Vector3d> lower(count);
+  std::vector<Vector3d> upper(count);
+  std::vector<Vector3d> center(count);
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    const Vector3d &p0 = this->vertices[this->indices[3 * i]];
+    const Vector3d &p1 = this->vertices[this->indices[3 * i + 1]];
+    const Vector3d &p2 = this->vertices[this->indices[3 * i + 2]];
+    lower[i] = p0;
+    lower[i].Min(p1);
+    lower[i].Min(p2);
+    upper[i] = p0;
+    upper[i].Max(p1);
+    upper[i].Max(p2);
+    center[i] = (lower[i] + upper[i]) * 0.5;
+  }
+
+  this->order.resize(count);
+  std::iota(this->order.begin(), this->order.end(), 0u);
+
+  struct Task
+  {
+    uint32_t node;
+    uint32_t begin;
+    uint32_t end;
+    uint32_t depth;
+  };
+
+  // A tree with non-empty leaves has at most 2n - 1 nodes
+  this->nodes.reserve(2 * static_cast<size_t>(count));
+  this->nodes.emplace_back();
+  std::vector<Task> tasks = {{0, 0, count, 0}};
+  while (!tasks.empty())
+  {
+    const Task task = tasks.back();
+    tasks.pop_back();
+
+    Vector3d nodeLower(inf, inf, inf), nodeUpper(-inf, -inf, -inf);
+    Vector3d centerLower(inf, inf, inf), centerUpper(-inf, -inf, -inf);
+    for (uint32_t i = task.begin; i < task.end; ++i)
+    {
+      const uint32_t t = this->order[i];
+      nodeLower.Min(lower[t]);
+      nodeUpper.Max(upper[t]);
+      centerLower.Min(center[t]);
+      centerUpper.Max(center[t]);
+    }
+
+    Node &node = this->nodes[task.node];
+    for (int a = 0; a < 3; ++a)
+    {
+      node.bounds[a] = nodeLower[a];
+      node.bounds[a + 3] = nodeUpper[a];
+    }
+    node.offset = task.begin;
+    node.count = task.end - task.begin;
+    node.axis = 0;
+
+    const uint32_t size = task.end - task.begin;
+    const Vector3d extent = centerUpper - centerLower;
+    int axis = 0;
+    if (extent.Y() > extent[axis])
+      axis = 1;
+    if (extent.Z() > extent[axis])
+      axis = 2;
+
+    // Triangles whose centers coincide can't be separated
+    if (size <= 1 || extent[axis] <= 0)
+      continue;
+
+    uint32_t mid = task.begin;
+    if (task.depth < kMaxSahDepth)
+    {
+      const double scale = kBinCount * (1 - 1e-6) / extent[axis];
+      const double origin = centerLower[axis];
+      auto binOf = [&](const uint32_t _t)
+      {
+        return std::min(kBinCount - 1,
+            static_cast<int>((center[_t][axis] - origin) * scale));
+      };
+
+      uint32_t binCount[kBinCount] = {0};
+      Vector3d binLower[kBinCount], binUpper[kBinCount];
+      for (int b = 0; b < kBinCount; ++b)
+      {
+        binLower[b].Set(inf, inf, inf);
+        binUpper[b].Set(-inf, -inf, -inf);
+      }
+      for (uint32_t i = task.begin; i < task.end; ++i)
+      {
+        const uint32_t t = this->order[i];
+        const int b = binOf(t);
+        ++binCount[b];
+        binLower[b].Min(lower[t]);
+        binUpper[b].Max(upper[t]);
+      }
+
+      // Cost of the right side of every split, sweeping from the right
+      double rightCost[kBinCount] = {0};
+      Vector3d sweepLower(inf, inf, inf), sweepUpper(-inf, -inf, -inf);
+      uint32_t sweepCount = 0;
+      for (int b = kBinCount - 1; b > 0; --b)
+      {
+        sweepLower.Min(binLower[b]);
+        sweepUpper.Max(binUpper[b]);
+        sweepCount += binCount[b];
+        rightCost[b] = sweepCount == 0 ? 0 :
+          sweepCount * HalfArea(sweepLower, sweepUpper);
+      }
+
+      int bestSplit = 0;
+      double bestCost = inf;
+      sweepLower.Set(inf, inf, inf);
+      sweepUpper.Set(-inf, -inf, -inf);
+      sweepCount = 0;
+      for (int b = 1; b < kBinCount; ++b)
+      {
+        sweepLower.Min(binLower[b - 1]);
+        sweepUpper.Max(binUpper[b - 1]);
+        sweepCount += binCount[b - 1];
+        if (sweepCount == 0 || sweepCount == size)
+          continue;
+        const double cost =
+          sweepCount * HalfArea(sweepLower, sweepUpper) + rightCost[b];
+        if (cost < bestCost)
+        {
+          bestCost = cost;
+          bestSplit = b;
+        }
+      }
+
+      // Traversing a node costs about as much as one triangle test
+      const double area = HalfArea(nodeLower, nodeUpper);
+      const double splitCost = 1.0 + (area > 0 ? bestCost / area : size);
+      if (size <= kForceSplitSize && !(splitCost < size))
+        continue;
+
+      if (bestSplit > 0)
+      {
+        mid = static_cast<uint32_t>(std::partition(
+            this->order.begin() + task.begin, this->order.begin() + task.end,
+            [&](const uint32_t _t) {return binOf(_t) < bestSplit;}) -
+          this->order.begin());
+      }
+    }
+
+    // Median split when the heuristic could not separate the triangles
+    if (mid == task.begin || mid == task.end)
+    {
+      mid = task.begin + size / 2;
+      std::nth_element(this->order.begin() + task.begin,
+          this->order.begin() + mid, this->order.begin() + task.end,
+          [&](const uint32_t _a, const uint32_t _b)
+          {
+            return center[_a][axis] < center[_b][axis];
+          });
+    }
+
+    const uint32_t left = static_cast<uint32_t>(this->nodes.size());
+    node.offset = left;
+    node.count = 0;
+    node.axis = static_cast<uint32_t>(axis);
+    this->nodes.emplace_back();
+    this->nodes.emplace_back();
+    tasks.push_back({left + 1, mid, task.end, task.depth + 1});
+    tasks.push_back({left, task.begin, mid, task.depth + 1});
+  }
+
+  this->triangles.resize(count);
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    const uint32_t t = this->order[i];
+    const Vector3d &p0 = this->vertices[this->indices[3 * t]];
+    const Vector3d &p1 = this->vertices[this->indices[3 * t + 1]];
+    const Vector3d &p2 = this->vertices[this->indices[3 * t + 2]];
+    TriangleData &data = this->triangles[i];
+    for (int a = 0; a < 3; ++a)
+    {
+      data.v0[a] = p0[a];
+      data.e1[a] = p1[a] - p0[a];
+      data.e2[a] = p2[a] - p0[a];
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+bool TriangleMeshPrivate::IntersectBox(const Node &_node, const Ray &_ray,
+    const double _tMin, const double _tMax, double &_tEnter)
+{
+  const double *b = _node.bounds;
+  const double x0 = (b[_ray.nearIndex[0]] - _ray.o[0]) * _ray.inv[0];
+  const double y0 = (b[_ray.nearIndex[1]] - _ray.o[1]) * _ray.inv[1];
+  const double z0 = (b[_ray.nearIndex[2]] - _ray.o[2]) * _ray.inv[2];
+  const double x1 = (b[_ray.farIndex[0]] - _ray.o[0]) * _ray.inv[0];
+  const double y1 = (b[_ray.farIndex[1]] - _ray.o[1]) * _ray.inv[1];
+  const double z1 = (b[_ray.farIndex[2]] - _ray.o[2]) * _ray.inv[2];
+  _tEnter = std::max(std::max(x0, _tMin), std::max(y0, z0));
+  const double tExit =
+    std::min(std::min(x1, y1), z1) * kRobustFar;
+  return _tEnter <= std::min(tExit, _tMax);
+}
+
+//////////////////////////////////////////////////
+bool TriangleMeshPrivate::IntersectTriangle(const uint32_t _slot,
+    const Ray &_ray, const double _tMin, Hit &_hit) const
+{
+  // Moller-Trumbore
+  const TriangleData &tri = this->triangles[_slot];
+  double p[3];
+  Cross(_ray.d, tri.e2, p);
+  const double det = Dot(tri.e1, p);
+
+  // Parallel rays and degenerate triangles. Subnormal determinants are
+  // rejected too, since their inverse overflows.
+  if (!(std::abs(det) >= std::numeric_limits<double>::min()))
+    return false;
+
+  const double invDet = 1.0 / det;
+  const double s[3] = {
+    _ray.o[0] - tri.v0[0], _ray.o[1] - tri.v0[1], _ray.o[2] - tri.v0[2]};
+  const double u = Dot(s, p) * invDet;
+  if (u < 0 || u > 1)
+    return false;
+
+  double q[3];
+  Cross(s, tri.e1, q);
+  const double v = Dot(_ray.d, q) * invDet;
+  if (v < 0 || u + v > 1)
+    return false;
+
+  const double t = Dot(tri.e2, q) * invDet;
+  if (t < _tMin || t > _hit.t)
+    return false;
+
+  // Break ties by the original index, so the result does not depend on
+  // the traversal order
+  const size_t triangle = this->order[_slot];
+  if (!(t < _hit.t) && !(_hit.t < t) && triangle >= _hit.triangle)
+    return false;
+
+  _hit.t = t;
+  _hit.slot = _slot;
+  _hit.triangle = triangle;
+  _hit.u = u;
+  _hit.v = v;
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool TriangleMeshPrivate::Traverse(const Ray &_ray, const double _tMin,
+    Hit &_hit, const bool _any) const
+{
+  if (this->nodes.empty())
+    return false;
+
+  double tEnter;
+  if (!IntersectBox(this->nodes[0], _ray, _tMin, _hit.t, tEnter))
+    return false;
+
+  // Both children are tested before descending, the nearer one is visited
+  // first and the other is kept on the stack with its entry distance
+  uint32_t stack[kStackSize];
+  double stackEnter[kStackSize];
+  int top = 0;
+  uint32_t current = 0;
+  bool found = false;
+  while (true)
+  {
+    const Node &node = this->nodes[current];
+    if (node.count > 0)
+    {
+      for (uint32_t k = node.offset; k < node.offset + node.count; ++k)
+      {
+        if (this->IntersectTriangle(k, _ray, _tMin, _hit))
+        {
+          found = true;
+          if (_any)
+            return true;
+        }
+      }
+    }
+    else
+    {
+      double tLeft, tRight;
+      const bool left = IntersectBox(this->nodes[node.offset], _ray, _tMin,
+          _hit.t, tLeft);
+      const bool right = IntersectBox(this->nodes[node.offset + 1], _ray,
+          _tMin, _hit.t, tRight);
+      if (left && right)
+      {
+        const bool leftFirst = tLeft <= tRight;
+        current = node.offset + (leftFirst ? 0 : 1);
+        stack[top] = node.offset + (leftFirst ? 1 : 0);
+        stackEnter[top++] = leftFirst ? tRight : tLeft;
+        continue;
+      }
+      if (left || right)
+      {
+        current = node.offset + (left ? 0 : 1);
+        continue;
+      }
+    }
+
+    // Pop the next node that may still hold a nearer hit
+    while (top > 0 && stackEnter[top - 1] > _hit.t)
+      --top;
+    if (top == 0)
+      break;
+    current = stack[--top];
+  }
+  return found;
+}
+
+//////////////////////////////////////////////////
+void TriangleMeshPrivate::TraversePacket(const Ray *_rays,
+    const size_t _count, const double _tMin, Hit *_hits,
+    const bool _any) const
+{
+  if (this->nodes.empty())
+    return;
+
+  // Each stack entry keeps the first ray of the packet that hit the parent
+  // node. Rays before it missed an ancestor and are skipped, and a node is
+  // entered as soon as one ray hits it, so a coherent packet usually needs
+  // a single box test per node. The remaining rays are only box tested at
+  // the leaves.
+  uint32_t stack[kStackSize];
+  size_t stackFirst[kStackSize];
+  int top = 0;
+  stack[top] = 0;
+  stackFirst[top++] = 0;
+  size_t active = _count;
+  double tEnter;
+  while (top > 0 && active > 0)
+  {
+    --top;
+    const Node &node = this->nodes[stack[top]];
+    size_t first = stackFirst[top];
+    while (first < _count &&
+           !IntersectBox(node, _rays[first], _tMin, _hits[first].t, tEnter))
+    {
+      ++first;
+    }
+    if (first == _count)
+      continue;
+
+    if (node.count == 0)
+    {
+      const bool negative = _rays[first].d[node.axis] < 0;
+      stack[top] = node.offset + (negative ? 0 : 1);
+      stackFirst[top++] = first;
+      stack[top] = node.offset + (negative ? 1 : 0);
+      stackFirst[top++] = first;
+      continue;
+    }
+
+    for (size_t l = first; l < _count; ++l)
+    {
+      if (l != first &&
+          !IntersectBox(node, _rays[l], _tMin, _hits[l].t, tEnter))
+      {
+        continue;
+      }
+
+      for (uint32_t k = node.offset; k < node.offset + node.count; ++k)
+      {
+        if (this->IntersectTriangle(k, _rays[l], _tMin, _hits[l]) && _any)
+        {
+          // Retire the ray, its range is now empty
+          _hits[l].t = -std::numeric_limits<double>::max();
+          --active;
+          break;
+        }
+      }
+    }
+  }
+}
+
+//////////////////////////////////////////////////
+void TriangleMeshPrivate::FillHit(const Ray &_ray, const Hit &_hit,
+    TriangleMesh::RayHit &_result) const
+{
+  const TriangleData &tri = this->triangles[_hit.slot];
+  double n[3];
+  Cross(tri.e1, tri.e2, n);
+  _result.t = _hit.t;
+  _result.point.Set(_ray.o[0] + _ray.d[0] * _hit.t,
+      _ray.o[1] + _ray.d[1] * _hit.t, _ray.o[2] + _ray.d[2] * _hit.t);
+  _result.normal.Set(n[0], n[1], n[2]);
+  _result.normal.Normalize();
+  _result.triangle = _hit.triangle;
+  _result.u = _hit.u;
+  _result.v = _hit.v;
+}
+
+//////////////////////////////////////////////////
+TriangleMesh::TriangleMesh()
+  : dataPtr(new TriangleMeshPrivate)
+{
+}
+
+//////////////////////////////////////////////////
+TriangleMesh::TriangleMesh(const std::vector<Vector3d> &_vertices,
+    const std::vector<unsigned int> &_indices)
+  : dataPtr(new TriangleMeshPrivate)
+{
+  this->Set(_vertices, _indices);
+}
+
+//////////////////////////////////////////////////
+TriangleMesh::TriangleMesh(const TriangleMesh &_mesh)
+  : dataPtr(new TriangleMeshPrivate(*_mesh.dataPtr))
+{
+}
+
+//////////////////////////////////////////////////
+TriangleMesh::~TriangleMesh()
+{
+}
+
+//////////////////////////////////////////////////
+TriangleMesh &TriangleMesh::operator=(const TriangleMesh &_mesh)
+{
+  *this->dataPtr = *_mesh.dataPtr;
+  return *this;
+}
+
+//////////////////////////////////////////////////
+bool TriangleMesh::Set(const std::vector<Vector3d> &_vertices,
+    const std::vector<unsigned int> &_indices)
+{
+  this->dataPtr->vertices.clear();
+  this->dataPtr->indices.clear();
+  this->dataPtr->Build();
+
+  if (_indices.size() % 3 != 0)
+  {
+    std::cerr << "TriangleMesh index count [" << _indices.size()
+      << "] is not a multiple of three.\n";
+    return false;
+  }
+
+  for (const unsigned int index : _indices)
+  {
+    if (index >= _vertices.size())
+    {
+      std::cerr << "TriangleMesh index [" << index << "] is out of range "
+        << "for [" << _vertices.size() << "] vertices.\n";
+      return false;
+    }
+  }
+
+  this->dataPtr->vertices = _vertices;
+  this->dataPtr->indices = _indices;
+  this->dataPtr->Build();
+  return true;
+}
+
+//////////////////////////////////////////////////
+const std::vector<Vector3d> &TriangleMesh::Vertices() const
+{
+  return this->dataPtr->vertices;
+}
+
+//////////////////////////////////////////////////
+const std::vector<unsigned int> &TriangleMesh::Indices() const
+{
+  return this->dataPtr->indices;
+}
+
+//////////////////////////////////////////////////
+size_t TriangleMesh::TriangleCount() const
+{
+  return this->dataPtr->indices.size() / 3;
+}
+
+//////////////////////////////////////////////////
+Triangle3d TriangleMesh::Triangle(const size_t _index) const
+{
+  if (_index >= this->TriangleCount())
+    return Triangle3d();
+
+  const std::vector<Vector3d> &v = this->dataPtr->vertices;
+  const std::vector<unsigned int> &i = this->dataPtr->indices;
+  return Triangle3d(v[i[3 * _index]], v[i[3 * _index + 1]],
+      v[i[3 * _index + 2]]);
+}
+
+//////////////////////////////////////////////////
+AxisAlignedBox TriangleMesh::BoundingBox() const
+{
+  if (this->dataPtr->nodes.empty())
+    return AxisAlignedBox();
+
+  const TriangleMeshPrivate::Node &root = this->dataPtr->nodes[0];
+  return AxisAlignedBox(
+      Vector3d(root.bounds[0], root.bounds[1], root.bounds[2]),
+      Vector3d(root.bounds[3], root.bounds[4], root.bounds[5]));
+}
+
+//////////////////////////////////////////////////
+bool TriangleMesh::RayCast(const Vector3d &_origin, const Vector3d &_dir,
+    RayHit &_hit, const double _minT, const double _maxT) const
+{
+  Ray ray;
+  ray.Set(_origin, _dir);
+  Hit hit = {_maxT, 0, kNoTriangle, 0, 0};
+  if (!this->dataPtr->Traverse(ray, _minT, hit, false))
+    return false;
+
+  this->dataPtr->FillHit(ray, hit, _hit);
+  return true;
+}
+
+//////////////////////////////////////////////////
+bool TriangleMesh::RayCast(const Line3d &_segment, RayHit &_hit) const
+{
+  return this->RayCast(_segment[0], _segment[1] - _segment[0], _hit, 0, 1);
+}
+
+//////////////////////////////////////////////////
+size_t TriangleMesh::RayCast(const Vector3d *_origins, const Vector3d *_dirs,
+    const size_t _count, RayHit *_hits, const double _minT,
+    const double _maxT) const
+{
+  size_t hitCount = 0;
+  for (size_t start = 0; start < _count; start += kPacketSize)
+  {
+    const size_t size = std::min(kPacketSize, _count - start);
+    Ray rays[kPacketSize];
+    Hit hits[kPacketSize];
+    for (size_t l = 0; l < size; ++l)
+    {
+      rays[l].Set(_origins[start + l], _dirs[start + l]);
+      hits[l] = {_maxT, 0, kNoTriangle, 0, 0};
+    }
+
+    this->dataPtr->TraversePacket(rays, size, _minT, hits, false);
+
+    for (size_t l = 0; l < size; ++l)
+    {
+      if (hits[l].triangle != kNoTriangle)
+      {
+        this->dataPtr->FillHit(rays[l], hits[l], _hits[start + l]);
+        ++hitCount;
+      }
+      else
+      {
+        _hits[start + l] = RayHit();
+      }
+    }
+  }
+  return hitCount;
+}
+
+//////////////////////////////////////////////////
+bool TriangleMesh::Occluded(const Vector3d &_origin, const Vector3d &_dir,
+    const double _minT, const double _maxT) const
+{
+  Ray ray;
+  ray.Set(_origin, _dir);
+  Hit hit = {_maxT, 0, kNoTriangle, 0, 0};
+  return this->dataPtr->Traverse(ray, _minT, hit, true);
+}
+
+//////////////////////////////////////////////////
+bool TriangleMesh::Occluded(const Line3d &_segment) const
+{
+  return this->Occluded(_segment[0], _segment[1] - _segment[0], 0, 1);
+}
+
+//////////////////////////////////////////////////
+size_t TriangleMesh::Occluded(const Vector3d *_origins,
+    const Vector3d *_dirs, const size_t _count, bool *_occluded,
+    const double _minT, const double _maxT) const
+{
+  size_t occludedCount = 0;
+  for (size_t start = 0; start < _count; start += kPacketSize)
+  {
+    const size_t size = std::min(kPacketSize, _count - start);
+    Ray rays[kPacketSize];
+    Hit hits[kPacketSize];
+    for (size_t l = 0; l < size; ++l)
+    {
+      rays[l].Set(_origins[start + l], _dirs[start + l]);
+      hits[l] = {_maxT, 0, kNoTriangle, 0, 0};
+    }
+
+    this->dataPtr->TraversePacket(rays, size, _minT, hits, true);
+
+    for (size_t l = 0; l < size; ++l)
+    {
+      _occluded[start + l] = hits[l].triangle != kNoTriangle;
+      occludedCount += _occluded[start + l] ? 1 : 0;
+    }
+  }
+  return occludedCount;
+}
+
+//////////////////////////////////////////////////
+bool TriangleMesh::ClosestPoint(const Vector3d &_point, PointHit &_hit,
+    const double _maxDistance) const
+{
+  const TriangleMeshPrivate &d = *this->dataPtr;
+  if (d.nodes.empty())
+    return false;
+
+  double best = _maxDistance * _maxDistance;
+  size_t bestTriangle = kNoTriangle;
+  Vector3d bestPoint;
+  double bestU = 0, bestV = 0;
+
+  // Squared distance from the query point to the box of a node
+  auto boxDistance = [&](const uint32_t _index)
+  {
+    const TriangleMeshPrivate::Node &node = d.nodes[_index];
+    double dist = 0;
+    for (int a = 0; a < 3; ++a)
+    {
+      const double delta = std::max(0.0, std::max(
+          node.bounds[a] - _point[a], _point[a] - node.bounds[a + 3]));
+      dist += delta * delta;
+    }
+    return dist;
+  };
+
+  uint32_t stack[kStackSize];
+  double stackDist[kStackSize];
+  int top = 0;
+  stack[top] = 0;
+  stackDist[top++] = boxDistance(0);
+  while (top > 0)
+  {
+    --top;
+    if (stackDist[top] > best)
+      continue;
+    const TriangleMeshPrivate::Node &node = d.nodes[stack[top]];
+
+    if (node.count == 0)
+    {
+      // Push the farther child first so the nearer one is searched first
+      const double left = boxDistance(node.offset);
+      const double right = boxDistance(node.offset + 1);
+      const bool leftFirst = left <= right;
+      stack[top] = node.offset + (leftFirst ? 1 : 0);
+      stackDist[top++] = leftFirst ? right : left;
+      stack[top] = node.offset + (leftFirst ? 0 : 1);
+      stackDist[top++] = leftFirst ? left : right;
+      continue;
+    }
+
+    for (uint32_t k = node.offset; k < node.offset + node.count; ++k)
+    {
+      const TriangleMeshPrivate::TriangleData &tri = d.triangles[k];
+      const Vector3d a(tri.v0[0], tri.v0[1], tri.v0[2]);
+      const Vector3d ab(tri.e1[0], tri.e1[1], tri.e1[2]);
+      const Vector3d ac(tri.e2[0], tri.e2[1], tri.e2[2]);
+
+      // Closest point on a triangle from Ericson, "Real-Time Collision
+      // Detection", section 5.1.5, with the weights kept as u and v
+      double u = 0, v = 0;
+      const Vector3d ap = _point - a;
+      const double d1 = ab.Dot(ap);
+      const double d2 = ac.Dot(ap);
+      const Vector3d bp = ap - ab;
+      const double d3 = ab.Dot(bp);
+      const double d4 = ac.Dot(bp);
+      const Vector3d cp = ap - ac;
+      const double d5 = ab.Dot(cp);
+      const double d6 = ac.Dot(cp);
+      const double vc = d1 * d4 - d3 * d2;
+      const double vb = d5 * d2 - d1 * d6;
+      const double va = d3 * d6 - d5 * d4;
+      if (ab.Cross(ac).SquaredLength() <= 0)
+      {
+        // Degenerate triangle, use the nearest of its edges
+        const Vector3d b = a + ab, c = a + ac;
+        const double sab = ClosestOnSegment(a, b, _point);
+        const double sac = ClosestOnSegment(a, c, _point);
+        const double sbc = ClosestOnSegment(b, c, _point);
+        const double dab = (a + ab * sab - _point).SquaredLength();
+        const double dac = (a + ac * sac - _point).SquaredLength();
+        const double dbc = (b + (c - b) * sbc - _point).SquaredLength();
+        if (dab <= dac && dab <= dbc)
+          u = sab;
+        else if (dac <= dbc)
+          v = sac;
+        else
+        {
+          u = 1 - sbc;
+          v = sbc;
+        }
+      }
+      else if (d1 <= 0 && d2 <= 0)
+      {
+      }
+      else if (d3 >= 0 && d4 <= d3)
+      {
+        u = 1;
+      }
+      else if (vc <= 0 && d1 >= 0 && d3 <= 0)
+      {
+        u = d1 / (d1 - d3);
+      }
+      else if (d6 >= 0 && d5 <= d6)
+      {
+        v = 1;
+      }
+      else if (vb <= 0 && d2 >= 0 && d6 <= 0)
+      {
+        v = d2 / (d2 - d6);
+      }
+      else if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0)
+      {
+        v = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+        u = 1 - v;
+      }
+      else
+      {
+        const double denom = 1.0 / (va + vb + vc);
+        u = vb * denom;
+        v = vc * denom;
+      }
+
+      const Vector3d q = a + ab * u + ac * v;
+      const double dist = (q - _point).SquaredLength();
+      const size_t triangle = d.order[k];
+      if (dist < best || (!(best < dist) && triangle < bestTriangle))
+      {
+        best = dist;
+        bestTriangle = triangle;
+        bestPoint = q;
+        bestU = u;
+        bestV = v;
+      }
+    }
+  }
+
+  if (bestTriangle == kNoTriangle)
+    return false;
+
+  _hit.distance = std::sqrt(best);
+  _hit.point = bestPoint;
+  _hit.triangle = bestTriangle;
+  _hit.u = bestU;
+  _hit.v = bestV;
+  return true;
+}
@@ -0,0 +1,394 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "ignition/math/Rand.hh"
+#include "ignition/math/TriangleMesh.hh"
+
+using namespace ignition;
+
+/////////////////////////////////////////////////
+/// \brief Check that two doubles have the same bits.
+/// \param[in] _a First value.
+/// \param[in] _b Second value.
+/// \return True if the values are bit for bit identical.
+bool SameBits(const double _a, const double _b)
+{
+  return std::memcmp(&_a, &_b, sizeof(double)) == 0;
+}
+
+/////////////////////////////////////////////////
+/// \brief Create a cube mesh centered at the origin with outward facing
+/// triangles.
+math::TriangleMesh CubeMesh(const double _half)
+{
+  std::vector<math::Vector3d> vertices;
+  for (int i = 0; i < 8; ++i)
+  {
+    vertices.push_back(math::Vector3d(
+        (i & 1) ? _half : -_half,
+        (i & 2) ? _half : -_half,
+        (i & 4) ? _half : -_half));
+  }
+  const std::vector<unsigned int> indices = {
+    0, 2, 1, 1, 2, 3,
+    4, 5, 6, 5, 7, 6,
+    0, 1, 4, 1, 5, 4,
+    2, 6, 3, 3, 6, 7,
+    0, 4, 2, 2, 4, 6,
+    1, 3, 5, 3, 7, 5};
+  return math::TriangleMesh(vertices, indices);
+}
+
+/////////////////////////////////////////////////
+/// \brief Create a mesh of random triangles inside a box.
+math::TriangleMesh RandomMesh(const size_t _count)
+{
+  std::vector<math::Vector3d> vertices;
+  std::vector<unsigned int> indices;
+  for (size_t i = 0; i < _count; ++i)
+  {
+    const math::Vector3d center(math::Rand::DblUniform(-10, 10),
+        math::Rand::DblUniform(-10, 10), math::Rand::DblUniform(-10, 10));
+    for (int k = 0; k < 3; ++k)
+    {
+      indices.push_back(static_cast<unsigned int>(vertices.size()));
+      vertices.push_back(center + math::Vector3d(
+          math::Rand::DblUniform(-1, 1), math::Rand::DblUniform(-1, 1),
+          math::Rand::DblUniform(-1, 1)));
+    }
+  }
+  return math::TriangleMesh(vertices, indices);
+}
+
+/////////////////////////////////////////////////
+/// \brief Brute force ray cast, returning the nearest t or infinity.
+double BruteForceRayCast(const math::TriangleMesh &_mesh,
+    const math::Vector3d &_origin, const math::Vector3d &_dir)
+{
+  double best = std::numeric_limits<double>::infinity();
+  for (size_t i = 0; i < _mesh.TriangleCount(); ++i)
+  {
+    const math::Triangle3d tri = _mesh.Triangle(i);
+    const math::Vector3d e1 = tri[1] - tri[0];
+    const math::Vector3d e2 = tri[2] - tri[0];
+    const math::Vector3d n = e1.Cross(e2);
+    const double denom = n.Dot(_dir);
+    if (std::abs(denom) < 1e-12)
+      continue;
+    const double t = n.Dot(tri[0] - _origin) / denom;
+    if (t < 0 || t >= best)
+      continue;
+    const math::Vector3d p = _origin + _dir * t - tri[0];
+    const double u = p.Cross(e2).Dot(n) / n.SquaredLength();
+    const double v = e1.Cross(p).Dot(n) / n.SquaredLength();
+    if (u >= 0 && v >= 0 && u + v <= 1)
+      best = t;
+  }
+  return best;
+}
+
+/////////////////////////////////////////////////
+/// \brief Distance from a point to a segment.
+double SegmentDistance(const math::Vector3d &_a, const math::Vector3d &_b,
+    const math::Vector3d &_p)
+{
+  const math::Vector3d ab = _b - _a;
+  const double s = std::min(1.0,
+      std::max(0.0, (_p - _a).Dot(ab) / ab.SquaredLength()));
+  return _p.Distance(_a + ab * s);
+}
+
+/////////////////////////////////////////////////
+/// \brief Brute force distance from a point to a mesh.
+double BruteForceDistance(const math::TriangleMesh &_mesh,
+    const math::Vector3d &_point)
+{
+  double best = std::numeric_limits<double>::infinity();
+  for (size_t i = 0; i < _mesh.TriangleCount(); ++i)
+  {
+    const math::Triangle3d tri = _mesh.Triangle(i);
+    const math::Vector3d e1 = tri[1] - tri[0];
+    const math::Vector3d e2 = tri[2] - tri[0];
+    const math::Vector3d n = e1.Cross(e2);
+    const double height = n.Dot(_point - tri[0]) / n.Length();
+    const math::Vector3d p = _point - tri[0];
+    const double u = p.Cross(e2).Dot(n) / n.SquaredLength();
+    const double v = e1.Cross(p).Dot(n) / n.SquaredLength();
+    if (u >= 0 && v >= 0 && u + v <= 1)
+    {
+      best = std::min(best, std::abs(height));
+      continue;
+    }
+    for (int k = 0; k < 3; ++k)
+    {
+      best = std::min(best,
+          SegmentDistance(tri[k], tri[(k + 1) % 3], _point));
+    }
+  }
+  return best;
+}
+
+/////////////////////////////////////////////////
+TEST(TriangleMeshTest, Empty)
+{
+  math::TriangleMesh mesh;
+  EXPECT_EQ(0u, mesh.TriangleCount());
+  EXPECT_TRUE(mesh.Vertices().empty());
+  EXPECT_TRUE(mesh.Indices().empty());
+  EXPECT_EQ(math::AxisAlignedBox(), mesh.BoundingBox());
+  EXPECT_EQ(math::Vector3d::Zero, mesh.Triangle(0)[0]);
+
+  math::TriangleMesh::RayHit hit;
+  EXPECT_FALSE(mesh.RayCast(math::Vector3d::Zero, math::Vector3d::UnitX,
+        hit));
+  EXPECT_FALSE(mesh.Occluded(math::Vector3d::Zero, math::Vector3d::UnitX));
+  math::TriangleMesh::PointHit pointHit;
+  EXPECT_FALSE(mesh.ClosestPoint(math::Vector3d::Zero, pointHit));
+  EXPECT_EQ(math::TriangleMesh::kNoTriangle, hit.triangle);
+  EXPECT_EQ(math::TriangleMesh::kNoTriangle, pointHit.triangle);
+}
+
+/////////////////////////////////////////////////
+TEST(TriangleMeshTest, Set)
+{
+  const std::vector<math::Vector3d> vertices = {
+    {0, 0, 0}, {1, 0, 0}, {0, 1, 0}};
+
+  math::TriangleMesh mesh(vertices, {0, 1, 2});
+  EXPECT_EQ(1u, mesh.TriangleCount());
+  EXPECT_EQ(vertices, mesh.Vertices());
+  for (unsigned int i = 0; i < 3; ++i)
+    EXPECT_EQ(vertices[i], mesh.Triangle(0)[i]);
+  EXPECT_EQ(math::AxisAlignedBox(math::Vector3d::Zero,
+        math::Vector3d(1, 1, 0)), mesh.BoundingBox());
+
+  // Copies keep the hierarchy
+  math::TriangleMesh copy(mesh);
+  math::TriangleMesh assigned;
+  assigned = mesh;
+  math::TriangleMesh::RayHit hit;
+  EXPECT_TRUE(copy.RayCast({0.2, 0.2, 1}, {0, 0, -1}, hit));
+  EXPECT_TRUE(assigned.RayCast({0.2, 0.2, 1}, {0, 0, -1}, hit));
+
+  // Invalid input leaves the mesh empty
+  EXPECT_FALSE(mesh.Set(vertices, {0, 1}));
+  EXPECT_EQ(0u, mesh.TriangleCount());
+  EXPECT_FALSE(mesh.RayCast({0.2, 0.2, 1}, {0, 0, -1}, hit));
+  EXPECT_FALSE(mesh.Set(vertices, {0, 1, 3}));
+  EXPECT_EQ(0u, mesh.TriangleCount());
+  EXPECT_TRUE(mesh.Set(vertices, {0, 1, 2}));
+  EXPECT_EQ(1u, mesh.TriangleCount());
+}
+
+/////////////////////////////////////////////////
+TEST(TriangleMeshTest, CubeRayCast)
+{
+  const math::TriangleMesh mesh = CubeMesh(1.0);
+  EXPECT_EQ(12u, mesh.TriangleCount());
+
+  math::TriangleMesh::RayHit hit;
+  ASSERT_TRUE(mesh.RayCast({-5, 0.3, 0.2}, {1, 0, 0}, hit));
+  EXPECT_DOUBLE_EQ(4.0, hit.t);
+  EXPECT_EQ(math::Vector3d(-1, 0.3, 0.2), hit.point);
+  EXPECT_EQ(math::Vector3d(-1, 0, 0), hit.normal);
+  EXPECT_LT(hit.triangle, mesh.TriangleCount());
+
+  // The barycentric weights reproduce the hit point
+  const math::Triangle3d tri = mesh.Triangle(hit.triangle);
+  EXPECT_EQ(hit.point, tri[0] * (1 - hit.u - hit.v) + tri[1] * hit.u +
+      tri[2] * hit.v);
+
+  // The direction does not need to be normalized
+  ASSERT_TRUE(mesh.RayCast({-5, 0.3, 0.2}, {2, 0, 0}, hit));
+  EXPECT_DOUBLE_EQ(2.0, hit.t);
+
+  // From the inside the far side is hit
+  ASSERT_TRUE(mesh.RayCast({0, 0.1, 0.2}, {0, 0, 1}, hit));
+  EXPECT_DOUBLE_EQ(0.8, hit.t);
+  EXPECT_EQ(math::Vector3d::UnitZ, hit.normal);
+
+  // Range limits
+  EXPECT_FALSE(mesh.RayCast({-5, 0.3, 0.2}, {1, 0, 0}, hit, 0, 3.9));
+  ASSERT_TRUE(mesh.RayCast({-5, 0.3, 0.2}, {1, 0, 0}, hit, 4.5));
+  EXPECT_DOUBLE_EQ(6.0, hit.t);
+  EXPECT_FALSE(mesh.RayCast({-5, 0.3, 0.2}, {-1, 0, 0}, hit));
+  EXPECT_FALSE(mesh.RayCast({-5, 3, 0.2}, {1, 0, 0}, hit));
+
+  // Segments
+  ASSERT_TRUE(mesh.RayCast(math::Line3d(-5, 0.3, 0.2, 5, 0.3, 0.2), hit));
+  EXPECT_DOUBLE_EQ(0.4, hit.t);
+  EXPECT_EQ(math::Vector3d(-1, 0.3, 0.2), hit.point);
+  EXPECT_FALSE(mesh.RayCast(math::Line3d(-5, 0.3, 0.2, -2, 0.3, 0.2), hit));
+  EXPECT_FALSE(mesh.RayCast(math::Line3d(-0.5, 0, 0, 0.5, 0, 0), hit));
+
+  // Occlusion
+  EXPECT_TRUE(mesh.Occluded({-5, 0.3, 0.2}, {1, 0, 0}));
+  EXPECT_FALSE(mesh.Occluded({-5, 0.3, 0.2}, {1, 0, 0}, 0, 3.9));
+  EXPECT_TRUE(mesh.Occluded(math::Line3d(-5, 0, 0, 0, 0, 0)));
+  EXPECT_FALSE(mesh.Occluded(math::Line3d(-5, 0, 0, -1.5, 0, 0)));
+  EXPECT_FALSE(mesh.Occluded(math::Line3d(-0.5, 0, 0, 0.5, 0, 0)));
+}
+
+/////////////////////////////////////////////////
+TEST(TriangleMeshTest, CubeClosestPoint)
+{
+  const math::TriangleMesh mesh = CubeMesh(1.0);
+
+  math::TriangleMesh::PointHit hit;
+  ASSERT_TRUE(mesh.ClosestPoint({3, 0.5, -0.25}, hit));
+  EXPECT_DOUBLE_EQ(2.0, hit.distance);
+  EXPECT_EQ(math::Vector3d(1, 0.5, -0.25), hit.point);
+
+  // Nearest to a corner
+  ASSERT_TRUE(mesh.ClosestPoint({2, 2, 2}, hit));
+  EXPECT_DOUBLE_EQ(std::sqrt(3.0), hit.distance);
+  EXPECT_EQ(math::Vector3d(1, 1, 1), hit.point);
+
+  // Inside points find the nearest face
+  ASSERT_TRUE(mesh.ClosestPoint({0.1, 0.2, 0.7}, hit));
+  EXPECT_NEAR(0.3, hit.distance, 1e-15);
+  EXPECT_EQ(math::Vector3d(0.1, 0.2, 1.0), hit.point);
+  const math::Triangle3d tri = mesh.Triangle(hit.triangle);
+  EXPECT_EQ(hit.point, tri[0] * (1 - hit.u - hit.v) + tri[1] * hit.u +
+      tri[2] * hit.v);
+
+  // Maximum distance
+  EXPECT_FALSE(mesh.ClosestPoint({3, 0.5, -0.25}, hit, 1.9));
+  EXPECT_TRUE(mesh.ClosestPoint({3, 0.5, -0.25}, hit, 2.0));
+
+  // Degenerate triangles use their edges
+  math::TriangleMesh line({{0, 0, 0}, {1, 0, 0}, {2, 0, 0}}, {0, 1, 2});
+  ASSERT_TRUE(line.ClosestPoint({1.5, 1, 0}, hit));
+  EXPECT_DOUBLE_EQ(1.0, hit.distance);
+  EXPECT_EQ(math::Vector3d(1.5, 0, 0), hit.point);
+  math::TriangleMesh::RayHit rayHit;
+  EXPECT_FALSE(line.RayCast({1.5, 0, 1}, {0, 0, -1}, rayHit));
+}
+
+/////////////////////////////////////////////////
+TEST(TriangleMeshTest, SharedEdges)
+{
+  // A flat grid of unit squares, each split into two triangles
+  const int size = 16;
+  std::vector<math::Vector3d> vertices;
+  std::vector<unsigned int> indices;
+  for (int j = 0; j <= size; ++j)
+  {
+    for (int i = 0; i <= size; ++i)
+      vertices.push_back(math::Vector3d(i, j, 0));
+  }
+  for (int j = 0; j < size; ++j)
+  {
+    for (int i = 0; i < size; ++i)
+    {
+      const unsigned int v = j * (size + 1) + i;
+      indices.insert(indices.end(), {v, v + 1, v + size + 2});
+      indices.insert(indices.end(), {v, v + size + 2, v + size + 1});
+    }
+  }
+  const math::TriangleMesh mesh(vertices, indices);
+
+  // Rays through vertices, edges and diagonals all hit
+  math::TriangleMesh::RayHit hit;
+  for (int j = 0; j <= 2 * size; ++j)
+  {
+    for (int i = 0; i <= 2 * size; ++i)
+    {
+      const math::Vector3d target(i * 0.5, j * 0.5, 0);
+      ASSERT_TRUE(mesh.RayCast(target + math::Vector3d(0.25, -0.5, 2),
+            math::Vector3d(-0.25, 0.5, -2), hit)) << target;
+      EXPECT_DOUBLE_EQ(1.0, hit.t);
+      EXPECT_EQ(target, hit.point);
+    }
+  }
+}
+
+/////////////////////////////////////////////////
+TEST(TriangleMeshTest, RandomQueries)
+{
+  math::Rand::Seed(42);
+  const math::TriangleMesh mesh = RandomMesh(1000);
+
+  const size_t count = 500;
+  std::vector<math::Vector3d> origins, dirs;
+  for (size_t i = 0; i < count; ++i)
+  {
+    origins.push_back(math::Vector3d(math::Rand::DblUniform(-15, 15),
+        math::Rand::DblUniform(-15, 15), math::Rand::DblUniform(-15, 15)));
+    // Aim at the cloud of triangles
+    dirs.push_back(math::Vector3d(math::Rand::DblUniform(-5, 5),
+        math::Rand::DblUniform(-5, 5), math::Rand::DblUniform(-5, 5)) -
+        origins.back());
+  }
+
+  std::vector<math::TriangleMesh::RayHit> packet(count);
+  bool occluded[count];
+  const size_t hitCount =
+    mesh.RayCast(origins.data(), dirs.data(), count, packet.data());
+  const size_t occludedCount =
+    mesh.Occluded(origins.data(), dirs.data(), count, occluded);
+  EXPECT_EQ(hitCount, occludedCount);
+
+  size_t hits = 0;
+  for (size_t i = 0; i < count; ++i)
+  {
+    const double expected = BruteForceRayCast(mesh, origins[i], dirs[i]);
+
+    math::TriangleMesh::RayHit hit;
+    const bool found = mesh.RayCast(origins[i], dirs[i], hit);
+    ASSERT_EQ(std::isfinite(expected), found) << i;
+    EXPECT_EQ(found, mesh.Occluded(origins[i], dirs[i]));
+    EXPECT_EQ(found, occluded[i]);
+    if (!found)
+    {
+      EXPECT_EQ(math::TriangleMesh::kNoTriangle, packet[i].triangle);
+      continue;
+    }
+    ++hits;
+    EXPECT_NEAR(expected, hit.t, 1e-9);
+
+    // The packet matches the single ray exactly
+    EXPECT_TRUE(SameBits(hit.t, packet[i].t)) << i;
+    EXPECT_TRUE(SameBits(hit.u, packet[i].u)) << i;
+    EXPECT_TRUE(SameBits(hit.v, packet[i].v)) << i;
+    EXPECT_EQ(hit.triangle, packet[i].triangle);
+    EXPECT_EQ(hit.point, packet[i].point);
+
+    // A range that ends before the hit is clear
+    EXPECT_FALSE(mesh.Occluded(origins[i], dirs[i], 0, hit.t * 0.999));
+  }
+  EXPECT_EQ(hits, hitCount);
+  EXPECT_GT(hits, count / 2);
+
+  for (size_t i = 0; i < 200; ++i)
+  {
+    const math::Vector3d point(math::Rand::DblUniform(-15, 15),
+        math::Rand::DblUniform(-15, 15), math::Rand::DblUniform(-15, 15));
+    math::TriangleMesh::PointHit hit;
+    ASSERT_TRUE(mesh.ClosestPoint(point, hit));
+    EXPECT_NEAR(BruteForceDistance(mesh, point), hit.distance, 1e-9);
+    EXPECT_NEAR(point.Distance(hit.point), hit.distance, 1e-9);
+  }
+}
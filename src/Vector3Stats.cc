@@ -14,6 +14,9 @@
  * limitations under the License.
  *
 */
+#include <algorithm>
+#include <cmath>
+
 #include <ignition/math/Vector3Stats.hh>
 #include "Vector3StatsPrivate.hh"
 
@@ -42,6 +45,41 @@ void Vector3Stats::InsertData(const Vector3d &_data)
   this->dataPtr->mag.InsertData(_data.Length());
 }
 
+//////////////////////////////////////////////////
+void Vector3Stats::InsertData(const Vector3d *_data, const size_t _size)
+{
+  // Split the samples into contiguous component arrays one block at a
+  // time, so each component can use the fused batch reduction.
+  const size_t blockSize = 256;
+  double x[blockSize];
+  double y[blockSize];
+  double z[blockSize];
+  double mag[blockSize];
+
+  SignalAccumulator accX, accY, accZ, accMag;
+  for (size_t start = 0; start < _size; start += blockSize)
+  {
+    const size_t n = std::min(blockSize, _size - start);
+    for (size_t i = 0; i < n; ++i)
+    {
+      const Vector3d &v = _data[start + i];
+      x[i] = v.X();
+      y[i] = v.Y();
+      z[i] = v.Z();
+      mag[i] = std::sqrt(x[i]*x[i] + y[i]*y[i] + z[i]*z[i]);
+    }
+    accX.InsertData(x, n);
+    accY.InsertData(y, n);
+    accZ.InsertData(z, n);
+    accMag.InsertData(mag, n);
+  }
+
+  this->dataPtr->x.Merge(accX);
+  this->dataPtr->y.Merge(accY);
+  this->dataPtr->z.Merge(accZ);
+  this->dataPtr->mag.Merge(accMag);
+}
+
 //////////////////////////////////////////////////
 bool Vector3Stats::InsertStatistic(const std::string &_name)
 {
@@ -17,6 +17,9 @@
 
 #include <gtest/gtest.h>
 
+#include <vector>
+
+#include <ignition/math/Rand.hh>
 #include <ignition/math/Vector3Stats.hh>
 
 using namespace ignition;
@@ -187,3 +190,37 @@ TEST_F(Vector3StatsTest, Vector3Stats)
     EXPECT_NEAR(this->Mag(name), 1.0, 1e-10);
   }
 }
+
+//////////////////////////////////////////////////
+TEST_F(Vector3StatsTest, InsertDataBatch)
+{
+  std::vector<math::Vector3d> data;
+  for (int i = 0; i < 600; ++i)
+  {
+    data.push_back(math::Vector3d(
+        math::Rand::DblUniform(-1, 1),
+        math::Rand::DblUniform(-2, 2),
+        math::Rand::DblUniform(-3, 3)));
+  }
+
+  math::Vector3Stats serial;
+  EXPECT_TRUE(serial.InsertStatistics("max,maxAbs,mean,min,rms,var"));
+  EXPECT_TRUE(this->stats.InsertStatistics("max,maxAbs,mean,min,rms,var"));
+
+  for (auto const &v : data)
+    serial.InsertData(v);
+  this->stats.InsertData(data.data(), data.size());
+
+  EXPECT_EQ(this->stats.X().Count(), 600u);
+  EXPECT_EQ(this->stats.Y().Count(), 600u);
+  EXPECT_EQ(this->stats.Z().Count(), 600u);
+  EXPECT_EQ(this->stats.Mag().Count(), 600u);
+
+  for (auto const &stat : serial.X().Map())
+  {
+    EXPECT_NEAR(this->X(stat.first), stat.second, 1e-10) << stat.first;
+    EXPECT_NEAR(this->Y(stat.first), serial.Y().Map()[stat.first], 1e-10);
+    EXPECT_NEAR(this->Z(stat.first), serial.Z().Map()[stat.first], 1e-10);
+    EXPECT_NEAR(this->Mag(stat.first), serial.Mag().Map()[stat.first], 1e-10);
+  }
+}
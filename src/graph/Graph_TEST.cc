@@ -16,7 +16,9 @@
 */
 
 #include <gtest/gtest.h>
+#include <sstream>
 #include <string>
+#include <vector>
 
 #include "ignition/math/graph/Graph.hh"
 
@@ -457,3 +459,128 @@ TYPED_TEST(GraphTestFixture, EdgelessOutDegree)
     EXPECT_EQ(0u, graph.OutDegree(idVertex.first));
   }
 }
+
+/////////////////////////////////////////////////
+/// \brief Get the DOT text of a graph, which lists every vertex and edge.
+/// \param[in] _graph The graph.
+/// \return The text.
+template<typename G>
+std::string ToDot(const G &_graph)
+{
+  std::ostringstream out;
+  out << _graph;
+  return out.str();
+}
+
+/////////////////////////////////////////////////
+TYPED_TEST(GraphTestFixture, FromSorted)
+{
+  const std::vector<Vertex<int>> vertices =
+    {{"a", 1, 2}, {"b", 2, 5}, {"b", 3, 6}, {"c", 4, 9}};
+  const std::vector<EdgeInitializer<double>> edges =
+    {{{2, 5}, 0.5, 2.0}, {{6, 2}}, {{9, 9}, 1.5}, {{5, 6}}};
+
+  // The same graph as when adding the elements one by one
+  TypeParam graph = TypeParam::FromSorted(vertices, edges);
+  TypeParam expected(vertices, edges);
+  EXPECT_EQ(ToDot(expected), ToDot(graph));
+  EXPECT_EQ(4u, graph.Vertices().size());
+  EXPECT_EQ(2u, graph.Vertices("b").size());
+  EXPECT_EQ(4u, graph.Edges().size());
+  EXPECT_DOUBLE_EQ(2.0, graph.EdgeFromId(0).Weight());
+  EXPECT_DOUBLE_EQ(1.5, graph.EdgeFromId(2).Data());
+  EXPECT_EQ(3u, graph.EdgeFromVertices(5, 6).Id());
+  EXPECT_EQ(graph.OutDegree(2), expected.OutDegree(2));
+  EXPECT_EQ(graph.InDegree(6), expected.InDegree(6));
+  EXPECT_EQ(graph.AdjacentsFrom(9).size(), expected.AdjacentsFrom(9).size());
+
+  // New elements get the next Ids
+  EXPECT_EQ(10u, graph.AddVertex("d", 5).Id());
+  EXPECT_EQ(4u, graph.AddEdge({10, 2}, 1.0).Id());
+  EXPECT_TRUE(graph.RemoveVertex(2));
+  EXPECT_EQ(2u, graph.Edges().size());
+
+  // Default Ids follow the previous vertex. Out of order vertices and
+  // edges with unknown vertices are ignored, without using an edge Id.
+  graph = TypeParam::FromSorted(
+      {{"x"}, {"y"}, {"z", 0, 7}, {"w"}, {"v", 0, 3}},
+      {{{0, 1}}, {{1, 3}}, {{7, 8}}, {{8, 0}}});
+  EXPECT_EQ(4u, graph.Vertices().size());
+  EXPECT_EQ("y", graph.VertexFromId(1).Name());
+  EXPECT_EQ("w", graph.VertexFromId(8).Name());
+  EXPECT_FALSE(graph.VertexFromId(3).Valid());
+  EXPECT_EQ(3u, graph.Edges().size());
+  EXPECT_EQ(1u, graph.EdgeFromVertices(7, 8).Id());
+  EXPECT_EQ(2u, graph.EdgeFromVertices(8, 0).Id());
+
+  // A large graph
+  std::vector<Vertex<int>> manyVertices;
+  std::vector<EdgeInitializer<double>> manyEdges;
+  for (VertexId i = 0; i < 10000; ++i)
+  {
+    manyVertices.push_back({std::to_string(i), static_cast<int>(i)});
+    manyEdges.push_back({{i, (i * 7 + 1) % 10000}, i * 0.5});
+  }
+  graph = TypeParam::FromSorted(manyVertices, manyEdges);
+  EXPECT_EQ(ToDot(TypeParam(manyVertices, manyEdges)), ToDot(graph));
+}
+
+/////////////////////////////////////////////////
+TYPED_TEST(GraphTestFixture, SaveLoad)
+{
+  TypeParam graph(
+    {{"a", 1, 2}, {"", 2, 5}, {std::string(70000, 'n'), 3, 6}, {"c", 4, 9}},
+    {{{2, 5}, 0.5, 2.0}, {{6, 2}}, {{9, 9}, 1.5}, {{5, 6}}});
+
+  // Gaps in the Ids are kept
+  EXPECT_TRUE(graph.RemoveEdge(1));
+
+  std::stringstream stream;
+  EXPECT_TRUE(graph.Save(stream));
+  const std::string saved = stream.str();
+  EXPECT_EQ("IGNGRAPH", saved.substr(0, 8));
+  EXPECT_EQ(0u, saved.size() % 8);
+
+  TypeParam loaded;
+  loaded.AddVertex("old", 0);
+  EXPECT_TRUE(loaded.Load(stream));
+  EXPECT_EQ(ToDot(graph), ToDot(loaded));
+  EXPECT_EQ(70000u, loaded.VertexFromId(6).Name().size());
+  EXPECT_EQ(3, loaded.VertexFromId(6).Data());
+  EXPECT_DOUBLE_EQ(2.0, loaded.EdgeFromId(0).Weight());
+  EXPECT_DOUBLE_EQ(0.5, loaded.EdgeFromId(0).Data());
+  EXPECT_FALSE(loaded.EdgeFromId(1).Valid());
+  EXPECT_EQ(graph.InDegree(2), loaded.InDegree(2));
+  EXPECT_EQ(4u, loaded.AddEdge({2, 9}, 1.0).Id());
+
+  // An empty graph
+  std::stringstream empty;
+  EXPECT_TRUE(TypeParam().Save(empty));
+  EXPECT_EQ(48u, empty.str().size());
+  EXPECT_TRUE(loaded.Load(empty));
+  EXPECT_TRUE(loaded.Empty());
+
+  // Invalid files leave the graph unchanged
+  auto load = [&](const std::string &_bytes)
+  {
+    std::stringstream in(_bytes);
+    return loaded.Load(in);
+  };
+  ASSERT_TRUE(load(saved));
+  EXPECT_FALSE(load(""));
+  EXPECT_FALSE(load(saved.substr(0, saved.size() - 1)));
+  EXPECT_FALSE(load(saved.substr(0, 100)));
+  std::string bad = saved;
+  bad[0] = 'X';
+  EXPECT_FALSE(load(bad));
+  bad = saved;
+  bad[8] = 2;
+  EXPECT_FALSE(load(bad));
+  bad = saved;
+  bad[10] = bad[10] == 1 ? 0 : 1;
+  EXPECT_FALSE(load(bad));
+  bad = saved;
+  bad[12] = 8;
+  EXPECT_FALSE(load(bad));
+  EXPECT_EQ(ToDot(graph), ToDot(loaded));
+}
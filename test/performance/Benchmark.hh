@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#ifndef IGNITION_MATH_TEST_PERFORMANCE_BENCHMARK_HH_
+#define IGNITION_MATH_TEST_PERFORMANCE_BENCHMARK_HH_
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "test_config.h"  // NOLINT(build/include)
+
+namespace ignition
+{
+  namespace math
+  {
+    namespace test
+    {
+      /// \brief Prevent the compiler from optimizing away a value that a
+      /// benchmark computes but does not otherwise use.
+      /// \param[in] _value Value to keep.
+      template<typename T>
+      inline void DoNotOptimize(const T &_value)
+      {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(_value) : "memory");
+#else
+        static volatile const void *sink;
+        sink = &_value;
+#endif
+      }
+
+      /// \brief Timing of one benchmark.
+      struct BenchmarkResult
+      {
+        /// \brief Name of the gtest test case that ran the benchmark.
+        std::string suite;
+
+        /// \brief Name of the benchmark.
+        std::string name;
+
+        /// \brief Number of operations timed in each sample.
+        uint64_t iterations = 0;
+
+        /// \brief Time per operation of each sample, in nanoseconds.
+        std::vector<double> samples;
+
+        /// \brief Median time per operation in nanoseconds.
+        double median = 0;
+
+        /// \brief Mean time per operation in nanoseconds.
+        double mean = 0;
+
+        /// \brief Fastest time per operation in nanoseconds.
+        double min = 0;
+
+        /// \brief Standard deviation of the time per operation in
+        /// nanoseconds.
+        double stddev = 0;
+      };
+
+      /// \brief Read a positive number from an environment variable.
+      /// \param[in] _name Name of the variable.
+      /// \param[in] _default Value used when the variable is not set or
+      /// not a positive number.
+      /// \return The value.
+      inline double EnvNumber(const char *_name, const double _default)
+      {
+        const char *env = std::getenv(_name);
+        if (!env)
+          return _default;
+        char *end = nullptr;
+        const double value = std::strtod(env, &end);
+        return (end != env && value > 0) ? value : _default;
+      }
+
+      /// \brief Collects benchmark results and writes them, grouped by
+      /// test case, to <TestCase>.json and <TestCase>.csv when the test
+      /// program exits.
+      ///
+      /// The following environment variables control the runs:
+      ///   - IGN_MATH_BENCHMARK_OUTPUT: output directory, defaults to
+      ///     test_results in the build directory.
+      ///   - IGN_MATH_BENCHMARK_SAMPLES: number of timed samples per
+      ///     benchmark, defaults to 5.
+      ///   - IGN_MATH_BENCHMARK_MIN_TIME: minimum duration of a sample in
+      ///     seconds, defaults to 0.05.
+      class BenchmarkReporter : public ::testing::Environment
+      {
+        /// \brief Get the reporter of this test program.
+        /// \return The reporter.
+        public: static BenchmarkReporter &Instance()
+        {
+          static BenchmarkReporter *reporter = static_cast<BenchmarkReporter*>(
+              ::testing::AddGlobalTestEnvironment(new BenchmarkReporter));
+          return *reporter;
+        }
+
+        /// \brief Record a result.
+        /// \param[in] _result Result to record.
+        public: void Add(const BenchmarkResult &_result)
+        {
+          this->results.push_back(_result);
+        }
+
+        /// \brief Output directory.
+        /// \return Directory the result files are written to.
+        public: static std::string OutputDirectory()
+        {
+          const char *env = std::getenv("IGN_MATH_BENCHMARK_OUTPUT");
+          if (env && *env)
+            return env;
+          return std::string(PROJECT_BINARY_PATH) + "/test_results";
+        }
+
+        /// \brief Write the results.
+        public: void TearDown() override
+        {
+          std::map<std::string, std::vector<const BenchmarkResult*>> suites;
+          for (const auto &result : this->results)
+            suites[result.suite].push_back(&result);
+
+          const std::string dir = OutputDirectory();
+          for (const auto &suite : suites)
+          {
+            const std::string base = dir + "/" + suite.first;
+            std::ofstream json(base + ".json");
+            std::ofstream csv(base + ".csv");
+            if (!json || !csv)
+            {
+              std::cerr << "Unable to write benchmark results to ["
+                        << base << ".{json,csv}]" << std::endl;
+              continue;
+            }
+            WriteJson(json, suite.first, suite.second);
+            WriteCsv(csv, suite.second);
+            std::cout << "Benchmark results written to [" << base
+                      << ".{json,csv}]" << std::endl;
+          }
+        }
+
+        /// \brief Write results as JSON.
+        /// \param[in] _out Output stream.
+        /// \param[in] _suite Name of the test case.
+        /// \param[in] _results Results of the test case.
+        private: static void WriteJson(std::ostream &_out,
+            const std::string &_suite,
+            const std::vector<const BenchmarkResult*> &_results)
+        {
+          _out << std::setprecision(9);
+          _out << "{\n  \"suite\": \"" << _suite << "\",\n"
+               << "  \"unit\": \"ns\",\n  \"benchmarks\": [";
+          for (size_t i = 0; i < _results.size(); ++i)
+          {
+            const BenchmarkResult &r = *_results[i];
+            _out << (i == 0 ? "\n" : ",\n")
+                 << "    {\"name\": \"" << r.name << "\""
+                 << ", \"iterations\": " << r.iterations
+                 << ", \"median\": " << r.median
+                 << ", \"mean\": " << r.mean
+                 << ", \"min\": " << r.min
+                 << ", \"stddev\": " << r.stddev
+                 << ", \"samples\": [";
+            for (size_t s = 0; s < r.samples.size(); ++s)
+              _out << (s == 0 ? "" : ", ") << r.samples[s];
+            _out << "]}";
+          }
+          _out << "\n  ]\n}\n";
+        }
+
+        /// \brief Write results as CSV, one row per benchmark.
+        /// \param[in] _out Output stream.
+        /// \param[in] _results Results of the test case.
+        private: static void WriteCsv(std::ostream &_out,
+            const std::vector<const BenchmarkResult*> &_results)
+        {
+          _out << std::setprecision(9);
+          _out << "suite,name,iterations,median_ns,mean_ns,min_ns,stddev_ns\n";
+          for (const auto *r : _results)
+          {
+            _out << r->suite << "," << r->name << "," << r->iterations << ","
+                 << r->median << "," << r->mean << "," << r->min << ","
+                 << r->stddev << "\n";
+          }
+        }
+
+        /// \brief Recorded results.
+        private: std::vector<BenchmarkResult> results;
+      };
+
+      /// \brief Time a function and record the result under the current
+      /// gtest test case.
+      ///
+      /// The iteration count is doubled until one sample takes at least
+      /// the minimum sample time, then that many iterations are timed for
+      /// each sample.
+      /// \param[in] _name Name of the benchmark.
+      /// \param[in] _fn Function to time. It is called with the index of
+      /// the iteration and should perform _opsPerCall operations.
+      /// \param[in] _opsPerCall Number of operations performed by each call
+      /// of _fn, used to report the time per operation.
+      /// \return The result.
+      template<typename F>
+      BenchmarkResult Benchmark(const std::string &_name, F _fn,
+          const uint64_t _opsPerCall = 1)
+      {
+        using Clock = std::chrono::steady_clock;
+        const double minTime = EnvNumber("IGN_MATH_BENCHMARK_MIN_TIME", 0.05);
+        const int sampleCount = static_cast<int>(
+            EnvNumber("IGN_MATH_BENCHMARK_SAMPLES", 5));
+
+        auto timeCalls = [&](const uint64_t _calls)
+        {
+          const auto start = Clock::now();
+          for (uint64_t i = 0; i < _calls; ++i)
+            _fn(i);
+          return std::chrono::duration<double>(Clock::now() - start).count();
+        };
+
+        // Calibrate, which also warms up caches and branch predictors
+        uint64_t calls = 1;
+        while (timeCalls(calls) < minTime && calls < (1ull << 40))
+          calls *= 2;
+
+        BenchmarkResult result;
+        const ::testing::TestInfo *info =
+          ::testing::UnitTest::GetInstance()->current_test_info();
+        result.suite = info ? info->test_case_name() : "benchmark";
+        result.name = _name;
+        result.iterations = calls * _opsPerCall;
+
+        for (int s = 0; s < sampleCount; ++s)
+        {
+          result.samples.push_back(
+              timeCalls(calls) * 1e9 / static_cast<double>(result.iterations));
+        }
+
+        std::vector<double> sorted = result.samples;
+        std::sort(sorted.begin(), sorted.end());
+        const size_t n = sorted.size();
+        result.median = n % 2 ? sorted[n / 2] :
+          0.5 * (sorted[n / 2 - 1] + sorted[n / 2]);
+        result.min = sorted.front();
+        for (double s : sorted)
+          result.mean += s / n;
+        for (double s : sorted)
+          result.stddev += (s - result.mean) * (s - result.mean) / n;
+        result.stddev = std::sqrt(result.stddev);
+
+        std::cout << std::left << std::setw(48) << (result.suite + "." + _name)
+                  << std::right << std::setw(14) << result.median
+                  << " ns/op (min " << result.min << ", stddev "
+                  << result.stddev << ")" << std::endl;
+
+        BenchmarkReporter::Instance().Add(result);
+        return result;
+      }
+    }
+  }
+}
+#endif
@@ -0,0 +1,471 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+// Runs the performance tests several times and compares the median time of
+// each benchmark against a baseline file.
+//
+// Usage:
+//   benchmark_compare --baseline <file> [--runs <n>] [--threshold <ratio>]
+//     [--sigma <k>] [--output <dir>] [--filter <gtest filter>]
+//     [--allow-missing] [--update-baseline] <benchmark executable>...
+//
+// Each run writes its results to <output>/run<i>, after removing the CSV
+// files left there by an earlier invocation. A benchmark is a significant
+// slowdown when its median over the runs is both more than <threshold>
+// slower than the baseline, and slower by more than <sigma> times the
+// combined noise of the baseline and the current runs. The noise of a
+// benchmark is the larger of the scaled median absolute deviation of its
+// per-run medians and the median of its per-run standard deviations.
+//
+// A benchmark in the baseline that did not run is reported as missing,
+// and counts as a failure unless --allow-missing is given, for example
+// together with --filter.
+//
+// Exit status is 0 when there are no significant slowdowns or missing
+// benchmarks, 1 when there is at least one, and 2 on usage or run errors,
+// or when the baseline file cannot be read. With --update-baseline the
+// current results are written to the baseline file instead.
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/////////////////////////////////////////////////
+/// \brief Summary of one benchmark over several runs.
+struct Summary
+{
+  /// \brief Median time per operation in nanoseconds.
+  double median = 0;
+
+  /// \brief Noise of the time per operation in nanoseconds.
+  double noise = 0;
+
+  /// \brief Number of runs.
+  int runs = 0;
+};
+
+/////////////////////////////////////////////////
+/// \brief Median of a set of values.
+/// \param[in] _values Values, reordered by the call.
+/// \return The median, or zero if _values is empty.
+static double Median(std::vector<double> &_values)
+{
+  if (_values.empty())
+    return 0;
+  std::sort(_values.begin(), _values.end());
+  const size_t n = _values.size();
+  return n % 2 ? _values[n / 2] : 0.5 * (_values[n / 2 - 1] + _values[n / 2]);
+}
+
+/////////////////////////////////////////////////
+/// \brief Split a CSV line.
+/// \param[in] _line Line to split.
+/// \return Fields of the line.
+static std::vector<std::string> SplitCsv(const std::string &_line)
+{
+  std::vector<std::string> fields;
+  std::stringstream ss(_line);
+  std::string field;
+  while (std::getline(ss, field, ','))
+    fields.push_back(field);
+  return fields;
+}
+
+/////////////////////////////////////////////////
+/// \brief Quote a string for the shell.
+/// \param[in] _arg String to quote.
+/// \return The quoted string.
+static std::string ShellQuote(const std::string &_arg)
+{
+  std::string quoted = "'";
+  for (char c : _arg)
+  {
+    if (c == '\'')
+      quoted += "'\\''";
+    else
+      quoted += c;
+  }
+  return quoted + "'";
+}
+
+/////////////////////////////////////////////////
+/// \brief Create a directory and its parents.
+/// \param[in] _path Directory to create.
+/// \return True if the directory exists after the call.
+static bool MakeDirectories(const std::string &_path)
+{
+  for (size_t pos = _path.find('/', 1); pos != std::string::npos;
+       pos = _path.find('/', pos + 1))
+  {
+    mkdir(_path.substr(0, pos).c_str(), 0755);
+  }
+  mkdir(_path.c_str(), 0755);
+  struct stat info;
+  return stat(_path.c_str(), &info) == 0 && S_ISDIR(info.st_mode);
+}
+
+/////////////////////////////////////////////////
+/// \brief Check if a file name ends in .csv.
+/// \param[in] _file File name.
+/// \return True if _file is a CSV file.
+static bool IsCsv(const std::string &_file)
+{
+  return _file.size() >= 4 && _file.compare(_file.size() - 4, 4, ".csv") == 0;
+}
+
+/////////////////////////////////////////////////
+/// \brief Remove the benchmark CSV files left in a directory by an earlier
+/// run, so that they are not read again.
+/// \param[in] _dir Directory to clear.
+/// \return False if a file could not be removed.
+static bool ClearRun(const std::string &_dir)
+{
+  DIR *dir = opendir(_dir.c_str());
+  if (!dir)
+    return false;
+
+  bool result = true;
+  while (struct dirent *entry = readdir(dir))
+  {
+    const std::string file = entry->d_name;
+    if (IsCsv(file) && std::remove((_dir + "/" + file).c_str()) != 0)
+      result = false;
+  }
+  closedir(dir);
+  return result;
+}
+
+/////////////////////////////////////////////////
+/// \brief Read the benchmark CSV files written to a directory.
+/// \param[in] _dir Directory to read.
+/// \param[out] _medians Median of each benchmark, keyed by suite.name.
+/// \param[out] _stddevs Standard deviation of each benchmark.
+static void ReadRun(const std::string &_dir,
+    std::map<std::string, std::vector<double>> &_medians,
+    std::map<std::string, std::vector<double>> &_stddevs)
+{
+  DIR *dir = opendir(_dir.c_str());
+  if (!dir)
+    return;
+
+  while (struct dirent *entry = readdir(dir))
+  {
+    const std::string file = entry->d_name;
+    if (!IsCsv(file))
+      continue;
+
+    std::ifstream in(_dir + "/" + file);
+    std::string line;
+
+    // Skip the header
+    std::getline(in, line);
+    while (std::getline(in, line))
+    {
+      // suite,name,iterations,median_ns,mean_ns,min_ns,stddev_ns
+      const std::vector<std::string> fields = SplitCsv(line);
+      if (fields.size() < 7)
+        continue;
+      const std::string key = fields[0] + "." + fields[1];
+      _medians[key].push_back(std::atof(fields[3].c_str()));
+      _stddevs[key].push_back(std::atof(fields[6].c_str()));
+    }
+  }
+  closedir(dir);
+}
+
+/////////////////////////////////////////////////
+/// \brief Read a baseline file.
+/// \param[in] _path Path of the file.
+/// \param[out] _baseline Summary of each benchmark, keyed by suite.name.
+/// \return False if the file could not be opened.
+static bool ReadBaseline(const std::string &_path,
+    std::map<std::string, Summary> &_baseline)
+{
+  std::ifstream in(_path);
+  if (!in)
+    return false;
+
+  std::string line;
+  while (std::getline(in, line))
+  {
+    if (line.empty() || line[0] == '#')
+      continue;
+
+    // suite,name,median_ns,noise_ns,runs
+    const std::vector<std::string> fields = SplitCsv(line);
+    if (fields.size() < 5 || fields[0] == "suite")
+      continue;
+    Summary &summary = _baseline[fields[0] + "." + fields[1]];
+    summary.median = std::atof(fields[2].c_str());
+    summary.noise = std::atof(fields[3].c_str());
+    summary.runs = std::atoi(fields[4].c_str());
+  }
+  return true;
+}
+
+/////////////////////////////////////////////////
+/// \brief Write a baseline file.
+/// \param[in] _path Path of the file.
+/// \param[in] _current Summary of each benchmark, keyed by suite.name.
+/// \return False if the file could not be written.
+static bool WriteBaseline(const std::string &_path,
+    const std::map<std::string, Summary> &_current)
+{
+  std::ofstream out(_path);
+  if (!out)
+    return false;
+
+  out << std::setprecision(9);
+  out << "suite,name,median_ns,noise_ns,runs\n";
+  for (const auto &entry : _current)
+  {
+    const size_t dot = entry.first.find('.');
+    out << entry.first.substr(0, dot) << "," << entry.first.substr(dot + 1)
+        << "," << entry.second.median << "," << entry.second.noise << ","
+        << entry.second.runs << "\n";
+  }
+  return static_cast<bool>(out);
+}
+
+/////////////////////////////////////////////////
+/// \brief Print the usage message.
+static void Usage()
+{
+  std::cerr << "Usage: benchmark_compare --baseline <file> [--runs <n>]\n"
+            << "  [--threshold <ratio>] [--sigma <k>] [--output <dir>]\n"
+            << "  [--filter <gtest filter>] [--allow-missing]\n"
+            << "  [--update-baseline] <benchmark executable>...\n";
+}
+
+/////////////////////////////////////////////////
+int main(int _argc, char **_argv)
+{
+  std::string baselinePath;
+  std::string outputDir = "performance_regression";
+  std::string filter;
+  int runs = 5;
+  double threshold = 0.1;
+  double sigma = 3.0;
+  bool update = false;
+  bool allowMissing = false;
+  std::vector<std::string> executables;
+
+  for (int i = 1; i < _argc; ++i)
+  {
+    const std::string arg = _argv[i];
+    const bool hasValue = i + 1 < _argc;
+    if (arg == "--baseline" && hasValue)
+      baselinePath = _argv[++i];
+    else if (arg == "--runs" && hasValue)
+      runs = std::atoi(_argv[++i]);
+    else if (arg == "--threshold" && hasValue)
+      threshold = std::atof(_argv[++i]);
+    else if (arg == "--sigma" && hasValue)
+      sigma = std::atof(_argv[++i]);
+    else if (arg == "--output" && hasValue)
+      outputDir = _argv[++i];
+    else if (arg == "--filter" && hasValue)
+      filter = _argv[++i];
+    else if (arg == "--allow-missing")
+      allowMissing = true;
+    else if (arg == "--update-baseline")
+      update = true;
+    else if (!arg.empty() && arg[0] != '-')
+      executables.push_back(arg);
+    else
+    {
+      Usage();
+      return 2;
+    }
+  }
+
+  if (baselinePath.empty() || executables.empty() || runs < 1 ||
+      threshold < 0 || sigma < 0)
+  {
+    Usage();
+    return 2;
+  }
+
+  // Fail before running anything when there is nothing to compare against
+  std::map<std::string, Summary> baseline;
+  if (!update && !ReadBaseline(baselinePath, baseline))
+  {
+    std::cerr << "Unable to read baseline [" << baselinePath << "]. Record "
+              << "one with --update-baseline first.\n";
+    return 2;
+  }
+
+  // Run every benchmark the requested number of times
+  std::map<std::string, std::vector<double>> medians;
+  std::map<std::string, std::vector<double>> stddevs;
+  for (int run = 0; run < runs; ++run)
+  {
+    const std::string runDir = outputDir + "/run" + std::to_string(run);
+    if (!MakeDirectories(runDir))
+    {
+      std::cerr << "Unable to create directory [" << runDir << "]\n";
+      return 2;
+    }
+    if (!ClearRun(runDir))
+    {
+      std::cerr << "Unable to remove old results from [" << runDir << "]\n";
+      return 2;
+    }
+    setenv("IGN_MATH_BENCHMARK_OUTPUT", runDir.c_str(), 1);
+
+    for (const auto &exe : executables)
+    {
+      std::cout << "Run " << run + 1 << "/" << runs << ": " << exe
+                << std::endl;
+      std::string cmd = ShellQuote(exe);
+      if (!filter.empty())
+        cmd += " " + ShellQuote("--gtest_filter=" + filter);
+      cmd += " > " + ShellQuote(runDir + "/" +
+          exe.substr(exe.find_last_of('/') + 1) + ".log") + " 2>&1";
+      if (std::system(cmd.c_str()) != 0)
+      {
+        std::cerr << "[" << exe << "] failed, see the log in [" << runDir
+                  << "]\n";
+        return 2;
+      }
+    }
+    ReadRun(runDir, medians, stddevs);
+  }
+
+  std::map<std::string, Summary> current;
+  for (auto &entry : medians)
+  {
+    Summary &summary = current[entry.first];
+    summary.runs = static_cast<int>(entry.second.size());
+    summary.median = Median(entry.second);
+
+    std::vector<double> deviations;
+    for (double m : entry.second)
+      deviations.push_back(std::abs(m - summary.median));
+    summary.noise = std::max(1.4826 * Median(deviations),
+        Median(stddevs[entry.first]));
+  }
+
+  if (current.empty())
+  {
+    std::cerr << "No benchmark results were found in [" << outputDir
+              << "]\n";
+    return 2;
+  }
+
+  if (update)
+  {
+    if (!WriteBaseline(baselinePath, current))
+    {
+      std::cerr << "Unable to write baseline [" << baselinePath << "]\n";
+      return 2;
+    }
+    std::cout << "Baseline written to [" << baselinePath << "] with "
+              << current.size() << " benchmarks." << std::endl;
+    return 0;
+  }
+
+  // Compare against the baseline
+  size_t width = 9;
+  for (const auto &entry : current)
+    width = std::max(width, entry.first.size());
+  for (const auto &entry : baseline)
+    width = std::max(width, entry.first.size());
+
+  std::cout << "\n" << std::left << std::setw(width) << "Benchmark"
+            << std::right << std::setw(16) << "Baseline [ns]"
+            << std::setw(16) << "Current [ns]" << std::setw(10) << "Delta"
+            << "  Status\n" << std::string(width + 50, '-') << "\n";
+  std::cout << std::fixed;
+
+  int slower = 0;
+  int faster = 0;
+  int missing = 0;
+  for (const auto &entry : current)
+  {
+    const Summary &cur = entry.second;
+    std::cout << std::left << std::setw(width) << entry.first << std::right;
+
+    auto base = baseline.find(entry.first);
+    if (base == baseline.end())
+    {
+      std::cout << std::setw(16) << "-" << std::setw(16)
+                << std::setprecision(2) << cur.median << std::setw(10) << "-"
+                << "  new\n";
+      continue;
+    }
+
+    const double diff = cur.median - base->second.median;
+    const double ratio = base->second.median > 0 ?
+      diff / base->second.median : 0;
+    const double noise = std::sqrt(cur.noise * cur.noise +
+        base->second.noise * base->second.noise);
+    const bool significant = std::abs(ratio) > threshold &&
+      std::abs(diff) > sigma * noise;
+
+    std::string status = "ok";
+    if (significant && diff > 0)
+    {
+      status = "SLOWER";
+      ++slower;
+    }
+    else if (significant)
+    {
+      status = "faster";
+      ++faster;
+    }
+
+    std::cout << std::setw(16) << std::setprecision(2)
+              << base->second.median << std::setw(16) << cur.median
+              << std::setw(9) << std::setprecision(1) << std::showpos
+              << 100.0 * ratio << "%" << std::noshowpos << "  " << status
+              << "\n";
+  }
+
+  for (const auto &entry : baseline)
+  {
+    if (current.find(entry.first) == current.end())
+    {
+      std::cout << std::left << std::setw(width) << entry.first << std::right
+                << std::setw(16) << std::setprecision(2)
+                << entry.second.median << std::setw(16) << "-"
+                << std::setw(10) << "-" << "  "
+                << (allowMissing ? "missing" : "MISSING") << "\n";
+      ++missing;
+    }
+  }
+
+  std::cout << "\n" << current.size() << " benchmarks, " << slower
+            << " significantly slower, " << faster
+            << " significantly faster, " << missing
+            << " missing (threshold " << std::setprecision(0)
+            << 100.0 * threshold << "%, " << std::setprecision(1) << sigma
+            << " sigma)." << std::endl;
+
+  return slower > 0 || (missing > 0 && !allowMissing) ? 1 : 0;
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ignition/math/Helpers.hh"
+#include "ignition/math/SphericalCoordinates.hh"
+#include "ignition/math/Vector3.hh"
+
+#include "Benchmark.hh"
+
+using namespace ignition;
+using math::test::Benchmark;
+using math::test::DoNotOptimize;
+
+/////////////////////////////////////////////////
+// Compare the speed and accuracy of the ECEF to SPHERICAL conversion
+// methods on points spread over the full latitude range, from below the
+// surface up to low Earth orbit.
+TEST(GeodeticConversion, Methods)
+{
+  const size_t count = 100000;
+
+  math::SphericalCoordinates sc;
+  std::vector<math::Vector3d> geodetic(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    const double lat = -IGN_PI_2 + IGN_PI * i / (count - 1);
+    const double lon = -IGN_PI + 2.0 * IGN_PI * ((i * 7919) % count) / count;
+    const double alt = -12e3 + 1012e3 * ((i * 104729) % count) / count;
+    geodetic[i].Set(lat, lon, alt);
+  }
+
+  std::vector<math::Vector3d> ecef(count);
+  ASSERT_TRUE(sc.PositionTransform(geodetic.data(), ecef.data(), count,
+      math::SphericalCoordinates::SPHERICAL,
+      math::SphericalCoordinates::ECEF));
+
+  std::vector<math::Vector3d> result(count);
+  const std::pair<math::SphericalCoordinates::GeodeticMethod, std::string>
+    methods[] = {{math::SphericalCoordinates::BOWRING, "Bowring"},
+                 {math::SphericalCoordinates::BOWRING_ALGEBRAIC,
+                   "BowringAlgebraic"},
+                 {math::SphericalCoordinates::VERMEILLE, "Vermeille"}};
+  for (auto const &method : methods)
+  {
+    sc.SetGeodeticConversion(method.first);
+    const std::string &name = method.second;
+
+    // Single point API
+    Benchmark(name + "_Single", [&](uint64_t _i)
+    {
+      DoNotOptimize(sc.PositionTransform(ecef[_i % count],
+          math::SphericalCoordinates::ECEF,
+          math::SphericalCoordinates::SPHERICAL));
+    });
+
+    // Batch API
+    Benchmark(name + "_Batch", [&](uint64_t)
+    {
+      sc.PositionTransform(ecef.data(), result.data(), count,
+          math::SphericalCoordinates::ECEF,
+          math::SphericalCoordinates::SPHERICAL);
+      DoNotOptimize(result.back());
+    }, count);
+
+    double maxLatError = 0;
+    double maxAltError = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+      // Skip the poles, where the BOWRING altitude is ill-conditioned
+      if (std::abs(geodetic[i].X()) > IGN_DTOR(89.95))
+        continue;
+      maxLatError = std::max(maxLatError,
+          std::abs(geodetic[i].X() - result[i].X()));
+      maxAltError = std::max(maxAltError,
+          std::abs(geodetic[i].Z() - result[i].Z()));
+    }
+
+    std::cout << name << " max lat error[" << maxLatError << " rad]"
+              << " max alt error[" << maxAltError << " m]" << std::endl;
+
+    EXPECT_LT(maxLatError, 1e-9);
+    EXPECT_LT(maxAltError, 1e-2);
+  }
+}
@@ -0,0 +1,295 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "ignition/math/Angle.hh"
+#include "ignition/math/AxisAlignedBox.hh"
+#include "ignition/math/Frustum.hh"
+#include "ignition/math/Line3.hh"
+#include "ignition/math/OrientedBox.hh"
+#include "ignition/math/Rand.hh"
+#include "ignition/math/Spline.hh"
+#include "ignition/math/SweepAndPrune.hh"
+#include "ignition/math/Triangle3.hh"
+
+#include "Benchmark.hh"
+
+using namespace ignition;
+using math::test::Benchmark;
+using math::test::DoNotOptimize;
+
+/// \brief Number of precomputed inputs, a power of two.
+static const size_t kInputs = 1024;
+
+/////////////////////////////////////////////////
+/// \brief Random points in a 20 m cube centered on the origin.
+static std::vector<math::Vector3d> RandomPoints()
+{
+  math::Rand::Seed(1234);
+  std::vector<math::Vector3d> points;
+  for (size_t i = 0; i < kInputs; ++i)
+  {
+    points.push_back(math::Vector3d(math::Rand::DblUniform(-10, 10),
+          math::Rand::DblUniform(-10, 10), math::Rand::DblUniform(-10, 10)));
+  }
+  return points;
+}
+
+/////////////////////////////////////////////////
+/// \brief Random boxes with corners in a 20 m cube centered on the origin.
+static std::vector<math::AxisAlignedBox> RandomBoxes()
+{
+  std::vector<math::Vector3d> points = RandomPoints();
+  std::vector<math::AxisAlignedBox> boxes;
+  for (size_t i = 0; i < kInputs; ++i)
+  {
+    const math::Vector3d &p = points[i];
+    const math::Vector3d &q = points[(i + 1) % kInputs];
+    boxes.push_back(math::AxisAlignedBox(p, p + (q - p) * 0.25));
+  }
+  return boxes;
+}
+
+/////////////////////////////////////////////////
+TEST(Geometry, Frustum)
+{
+  math::Frustum frustum(0.1, 10.0, math::Angle(IGN_DTOR(60)), 1.33,
+      math::Pose3d(0, 0, 0, 0, 0, 0.3));
+  std::vector<math::Vector3d> points = RandomPoints();
+  std::vector<math::AxisAlignedBox> boxes = RandomBoxes();
+  const size_t mask = kInputs - 1;
+
+  Benchmark("Frustum_ContainsPoint", [&](uint64_t _i)
+  {
+    DoNotOptimize(frustum.Contains(points[_i & mask]));
+  });
+  Benchmark("Frustum_ContainsBox", [&](uint64_t _i)
+  {
+    DoNotOptimize(frustum.Contains(boxes[_i & mask]));
+  });
+}
+
+/////////////////////////////////////////////////
+TEST(Geometry, AxisAlignedBox)
+{
+  std::vector<math::Vector3d> points = RandomPoints();
+  std::vector<math::AxisAlignedBox> boxes = RandomBoxes();
+  const size_t mask = kInputs - 1;
+
+  Benchmark("AxisAlignedBox_Intersects", [&](uint64_t _i)
+  {
+    DoNotOptimize(boxes[_i & mask].Intersects(boxes[(_i + 1) & mask]));
+  });
+  Benchmark("AxisAlignedBox_IntersectRay", [&](uint64_t _i)
+  {
+    const math::Vector3d &origin = points[_i & mask];
+    math::Vector3d dir = points[(_i + 1) & mask] - origin;
+    dir.Normalize();
+    DoNotOptimize(boxes[_i & mask].Intersect(origin, dir, 0, 100));
+  });
+  Benchmark("AxisAlignedBox_IntersectLine", [&](uint64_t _i)
+  {
+    const math::Line3d line(points[_i & mask], points[(_i + 1) & mask]);
+    DoNotOptimize(boxes[_i & mask].Intersect(line));
+  });
+}
+
+/////////////////////////////////////////////////
+TEST(Geometry, Spline)
+{
+  std::vector<math::Vector3d> points = RandomPoints();
+  math::Spline spline;
+  for (size_t i = 0; i < 32; ++i)
+    spline.AddPoint(points[i]);
+
+  // Trigger the coefficient computation outside of the timed loop
+  spline.Interpolate(0.5);
+
+  Benchmark("Spline_Interpolate", [&](uint64_t _i)
+  {
+    DoNotOptimize(spline.Interpolate((_i & 1023) / 1023.0));
+  });
+  Benchmark("Spline_InterpolateSegment", [&](uint64_t _i)
+  {
+    DoNotOptimize(spline.Interpolate(_i % 31, (_i & 1023) / 1023.0));
+  });
+  Benchmark("Spline_InterpolateTangent", [&](uint64_t _i)
+  {
+    DoNotOptimize(spline.InterpolateTangent((_i & 1023) / 1023.0));
+  });
+}
+
+/////////////////////////////////////////////////
+TEST(Geometry, Triangle3)
+{
+  std::vector<math::Vector3d> points = RandomPoints();
+  const size_t mask = kInputs - 1;
+
+  // Small triangles around the points, and segments from each point to
+  // the next one, so that a fraction of the tests hit
+  std::vector<math::Triangle3d> triangles;
+  std::vector<double> p[3][3];
+  for (size_t i = 0; i < kInputs; ++i)
+  {
+    const math::Vector3d &a = points[i];
+    const math::Vector3d b = a + (points[(i + 7) & mask] - a) * 0.3;
+    const math::Vector3d c = a + (points[(i + 13) & mask] - a) * 0.3;
+    triangles.push_back(math::Triangle3d(a, b, c));
+    for (int k = 0; k < 3; ++k)
+    {
+      p[0][k].push_back(a[k]);
+      p[1][k].push_back(b[k]);
+      p[2][k].push_back(c[k]);
+    }
+  }
+
+  Benchmark("Triangle3_Intersects", [&](uint64_t _i)
+  {
+    const math::Line3d line(points[(_i + 1) & mask] * 2,
+        triangles[_i & mask][1] * 0.5 + triangles[_i & mask][2] * 0.5);
+    math::Vector3d point;
+    DoNotOptimize(triangles[_i & mask].Intersects(line, point));
+  });
+  Benchmark("Triangle3_IntersectWatertight", [&](uint64_t _i)
+  {
+    const math::Vector3d origin = points[(_i + 1) & mask] * 2;
+    const math::Vector3d dir = triangles[_i & mask][1] * 0.5 +
+      triangles[_i & mask][2] * 0.5 - origin;
+    double t, u, v;
+    DoNotOptimize(triangles[_i & mask].IntersectWatertight(origin, dir,
+          t, u, v));
+  });
+
+  // One ray against all triangles
+  const double *p0[3] = {p[0][0].data(), p[0][1].data(), p[0][2].data()};
+  const double *p1[3] = {p[1][0].data(), p[1][1].data(), p[1][2].data()};
+  const double *p2[3] = {p[2][0].data(), p[2][1].data(), p[2][2].data()};
+  std::vector<double> t(kInputs), u(kInputs), v(kInputs);
+  Benchmark("Triangle3_IntersectBatchTriangles", [&](uint64_t _i)
+  {
+    const math::Vector3d &origin = points[_i & mask];
+    const math::Vector3d dir = points[(_i + 1) & mask] - origin;
+    DoNotOptimize(math::Triangle3d::IntersectWatertight(origin, dir, p0, p1,
+          p2, kInputs, t.data(), u.data(), v.data()));
+  }, kInputs);
+}
+
+/////////////////////////////////////////////////
+TEST(Geometry, SweepAndPrune)
+{
+  // Boxes of up to 1 m in a 100 m cube that jitter by up to 2 cm per
+  // frame, like bodies of a simulation
+  math::Rand::Seed(1234);
+  const size_t count = 10000;
+  std::vector<math::AxisAlignedBox> boxes[2];
+  for (size_t i = 0; i < count; ++i)
+  {
+    const math::Vector3d center(math::Rand::DblUniform(-50, 50),
+        math::Rand::DblUniform(-50, 50), math::Rand::DblUniform(-50, 50));
+    const math::Vector3d half(math::Rand::DblUniform(0.1, 0.5),
+        math::Rand::DblUniform(0.1, 0.5), math::Rand::DblUniform(0.1, 0.5));
+    const math::Vector3d offset(math::Rand::DblUniform(-0.02, 0.02),
+        math::Rand::DblUniform(-0.02, 0.02),
+        math::Rand::DblUniform(-0.02, 0.02));
+    boxes[0].push_back(math::AxisAlignedBox(center - half, center + half));
+    boxes[1].push_back(math::AxisAlignedBox(center - half + offset,
+          center + half + offset));
+  }
+
+  math::SweepAndPrune sap;
+  for (const math::AxisAlignedBox &box : boxes[0])
+    sap.Add(box);
+  sap.Update();
+
+  // Boxes move back and forth between two frames
+  Benchmark("SweepAndPrune_Update", [&](uint64_t _i)
+  {
+    const std::vector<math::AxisAlignedBox> &frame = boxes[(_i + 1) & 1];
+    for (size_t i = 0; i < count; ++i)
+      sap.Set(i, frame[i]);
+    sap.Update();
+    DoNotOptimize(sap.AddedPairs().size());
+  }, count);
+
+  // All pairs of a tenth of the boxes
+  const size_t bruteCount = count / 10;
+  Benchmark("SweepAndPrune_BruteForce", [&](uint64_t)
+  {
+    size_t pairs = 0;
+    for (size_t i = 0; i < bruteCount; ++i)
+    {
+      for (size_t j = i + 1; j < bruteCount; ++j)
+        pairs += boxes[0][i].Intersects(boxes[0][j]) ? 1 : 0;
+    }
+    DoNotOptimize(pairs);
+  }, bruteCount);
+}
+
+/////////////////////////////////////////////////
+TEST(Geometry, OrientedBox)
+{
+  std::vector<math::Vector3d> points = RandomPoints();
+  std::vector<math::AxisAlignedBox> aabbs = RandomBoxes();
+  const size_t mask = kInputs - 1;
+
+  // Boxes of up to 4 m with random orientations
+  std::vector<math::OrientedBoxd> boxes;
+  std::vector<double> centers[3], halfSizes[3], rotations[9];
+  for (size_t i = 0; i < kInputs; ++i)
+  {
+    const math::Vector3d &p = points[i];
+    const math::Vector3d &q = points[(i + 1) & mask];
+    const math::OrientedBoxd box((q - p).Abs() * 0.2, math::Pose3d(p,
+          math::Quaterniond(q.X(), q.Y(), q.Z())));
+    boxes.push_back(box);
+
+    const math::Matrix3d rot(box.Pose().Rot());
+    for (int a = 0; a < 3; ++a)
+    {
+      centers[a].push_back(box.Pose().Pos()[a]);
+      halfSizes[a].push_back(box.Size()[a] * 0.5);
+      for (int b = 0; b < 3; ++b)
+        rotations[3 * a + b].push_back(rot(a, b));
+    }
+  }
+
+  Benchmark("OrientedBox_Intersects", [&](uint64_t _i)
+  {
+    DoNotOptimize(boxes[_i & mask].Intersects(boxes[(_i + 1) & mask]));
+  });
+  Benchmark("OrientedBox_IntersectsAxisAlignedBox", [&](uint64_t _i)
+  {
+    DoNotOptimize(boxes[_i & mask].Intersects(aabbs[(_i + 1) & mask]));
+  });
+
+  const double *c[3] = {centers[0].data(), centers[1].data(),
+    centers[2].data()};
+  const double *h[3] = {halfSizes[0].data(), halfSizes[1].data(),
+    halfSizes[2].data()};
+  const double *r[9];
+  for (int i = 0; i < 9; ++i)
+    r[i] = rotations[i].data();
+  std::unique_ptr<bool[]> results(new bool[kInputs]);
+  Benchmark("OrientedBox_IntersectsBatch", [&](uint64_t _i)
+  {
+    DoNotOptimize(boxes[_i & mask].Intersects(c, h, r, kInputs,
+          results.get()));
+  }, kInputs);
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "ignition/math/Rand.hh"
+#include "ignition/math/graph/Graph.hh"
+#include "ignition/math/graph/GraphAlgorithms.hh"
+
+#include "Benchmark.hh"
+
+using namespace ignition;
+using namespace math;
+using math::test::Benchmark;
+using math::test::DoNotOptimize;
+
+/////////////////////////////////////////////////
+/// \brief Build a square grid graph with random edge weights.
+/// \param[in] _side Number of vertices along each side.
+/// \return The graph.
+static graph::UndirectedGraph<int, double> GridGraph(const int _side)
+{
+  Rand::Seed(1234);
+  graph::UndirectedGraph<int, double> g;
+  for (int i = 0; i < _side * _side; ++i)
+    g.AddVertex(std::to_string(i), i, i);
+
+  for (int r = 0; r < _side; ++r)
+  {
+    for (int c = 0; c < _side; ++c)
+    {
+      const graph::VertexId v = r * _side + c;
+      if (c + 1 < _side)
+        g.AddEdge({v, v + 1}, 0, Rand::DblUniform(1, 10));
+      if (r + 1 < _side)
+        g.AddEdge({v, v + _side}, 0, Rand::DblUniform(1, 10));
+    }
+  }
+  return g;
+}
+
+/////////////////////////////////////////////////
+/// \brief Build a directed graph where every vertex has a fixed number of
+/// outgoing edges to random vertices.
+/// \param[in] _vertices Number of vertices.
+/// \param[in] _degree Number of outgoing edges per vertex.
+/// \return The graph.
+static graph::DirectedGraph<int, double> RandomGraph(const int _vertices,
+    const int _degree)
+{
+  Rand::Seed(1234);
+  graph::DirectedGraph<int, double> g;
+  for (int i = 0; i < _vertices; ++i)
+    g.AddVertex(std::to_string(i), i, i);
+
+  for (int v = 0; v < _vertices; ++v)
+  {
+    for (int d = 0; d < _degree; ++d)
+    {
+      const graph::VertexId to = Rand::IntUniform(0, _vertices - 1);
+      if (to != static_cast<graph::VertexId>(v))
+        g.AddEdge({v, to}, 0, Rand::DblUniform(1, 10));
+    }
+  }
+  return g;
+}
+
+/////////////////////////////////////////////////
+TEST(GraphDijkstra, Grid)
+{
+  auto small = GridGraph(10);
+  auto large = GridGraph(50);
+
+  Benchmark("Dijkstra_Grid100_AllPaths", [&](uint64_t _i)
+  {
+    DoNotOptimize(graph::Dijkstra(small, _i % 100));
+  });
+  Benchmark("Dijkstra_Grid2500_AllPaths", [&](uint64_t _i)
+  {
+    DoNotOptimize(graph::Dijkstra(large, _i % 2500));
+  });
+  Benchmark("Dijkstra_Grid2500_CornerToCorner", [&](uint64_t)
+  {
+    DoNotOptimize(graph::Dijkstra(large, 0, 2499));
+  });
+}
+
+/////////////////////////////////////////////////
+TEST(GraphDijkstra, Random)
+{
+  auto g = RandomGraph(2000, 8);
+
+  Benchmark("Dijkstra_Random2000x8_AllPaths", [&](uint64_t _i)
+  {
+    DoNotOptimize(graph::Dijkstra(g, _i % 2000));
+  });
+}
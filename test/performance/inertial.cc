@@ -0,0 +1,156 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "ignition/math/Helpers.hh"
+#include "ignition/math/Inertial.hh"
+#include "ignition/math/Material.hh"
+#include "ignition/math/Rand.hh"
+
+#include "Benchmark.hh"
+
+using namespace ignition;
+using math::test::Benchmark;
+using math::test::DoNotOptimize;
+
+/////////////////////////////////////////////////
+TEST(Inertial, Aggregate)
+{
+  const size_t count = 5000;
+  math::Rand::Seed(1234);
+  std::vector<math::Inertiald> bodies;
+  for (size_t i = 0; i < count; ++i)
+  {
+    math::MassMatrix3d mm;
+    mm.SetFromBox(math::Rand::DblUniform(0.1, 10),
+        math::Vector3d(math::Rand::DblUniform(0.1, 2),
+          math::Rand::DblUniform(0.1, 2), math::Rand::DblUniform(0.1, 2)));
+    bodies.push_back(math::Inertiald(mm, math::Pose3d(
+        math::Rand::DblUniform(-5, 5), math::Rand::DblUniform(-5, 5),
+        math::Rand::DblUniform(-5, 5), math::Rand::DblUniform(-3, 3),
+        math::Rand::DblUniform(-3, 3), math::Rand::DblUniform(-3, 3))));
+  }
+
+  Benchmark("Inertiald_AddAssign", [&](uint64_t)
+  {
+    math::Inertiald sum = bodies[0];
+    for (size_t i = 1; i < count; ++i)
+      sum += bodies[i];
+    DoNotOptimize(sum);
+  }, count);
+
+  Benchmark("Inertiald_Aggregate", [&](uint64_t)
+  {
+    math::Inertiald sum;
+    DoNotOptimize(math::Inertiald::Aggregate(bodies, sum));
+    DoNotOptimize(sum);
+  }, count);
+}
+
+/////////////////////////////////////////////////
+TEST(Inertial, SetFromMesh)
+{
+  // UV sphere with 2 * rings * segments triangles
+  const unsigned int rings = 200;
+  const unsigned int segments = 250;
+  std::vector<math::Vector3d> vertices;
+  std::vector<unsigned int> indices;
+  for (unsigned int r = 0; r <= rings; ++r)
+  {
+    const double polar = IGN_PI * r / rings;
+    for (unsigned int s = 0; s < segments; ++s)
+    {
+      const double azimuth = 2 * IGN_PI * s / segments;
+      vertices.push_back(math::Vector3d(std::sin(polar) * std::cos(azimuth),
+            std::sin(polar) * std::sin(azimuth), std::cos(polar)));
+    }
+  }
+  for (unsigned int r = 0; r < rings; ++r)
+  {
+    for (unsigned int s = 0; s < segments; ++s)
+    {
+      const unsigned int a = r * segments + s;
+      const unsigned int b = r * segments + (s + 1) % segments;
+      const unsigned int c = a + segments;
+      const unsigned int d = b + segments;
+      indices.insert(indices.end(), {a, c, b, b, c, d});
+    }
+  }
+
+  const math::Material material(1000.0);
+  const size_t triangles = indices.size() / 3;
+  Benchmark("Inertiald_SetFromMesh", [&](uint64_t)
+  {
+    math::Inertiald inertial;
+    DoNotOptimize(inertial.SetFromMesh(material, vertices, indices));
+    DoNotOptimize(inertial);
+  }, triangles);
+}
+
+/////////////////////////////////////////////////
+TEST(Inertial, PrincipalMoments)
+{
+  const size_t count = 4096;
+  math::Rand::Seed(1234);
+  std::vector<math::MassMatrix3d> massMatrices;
+  for (size_t i = 0; i < count; ++i)
+  {
+    math::MassMatrix3d mm;
+    mm.SetFromBox(math::Rand::DblUniform(0.1, 10),
+        math::Vector3d(math::Rand::DblUniform(0.1, 2),
+          math::Rand::DblUniform(0.1, 2), math::Rand::DblUniform(0.1, 2)),
+        math::Quaterniond(math::Rand::DblUniform(-3, 3),
+          math::Rand::DblUniform(-3, 3), math::Rand::DblUniform(-3, 3)));
+    massMatrices.push_back(mm);
+  }
+  std::vector<math::Vector3d> moments(count);
+  std::vector<math::Quaterniond> offsets(count);
+
+  Benchmark("MassMatrix3d_PrincipalMoments_Single", [&](uint64_t)
+  {
+    for (size_t i = 0; i < count; ++i)
+      moments[i] = massMatrices[i].PrincipalMoments();
+    DoNotOptimize(moments.back());
+  }, count);
+
+  Benchmark("MassMatrix3d_PrincipalMoments_Batch", [&](uint64_t)
+  {
+    math::MassMatrix3d::PrincipalMoments(massMatrices.data(), count,
+        moments.data());
+    DoNotOptimize(moments.back());
+  }, count);
+
+  Benchmark("MassMatrix3d_PrincipalAxesOffset_Single", [&](uint64_t)
+  {
+    for (size_t i = 0; i < count; ++i)
+    {
+      moments[i] = massMatrices[i].PrincipalMoments();
+      offsets[i] = massMatrices[i].PrincipalAxesOffset();
+    }
+    DoNotOptimize(offsets.back());
+  }, count);
+
+  Benchmark("MassMatrix3d_PrincipalAxesOffset_Batch", [&](uint64_t)
+  {
+    math::MassMatrix3d::PrincipalMoments(massMatrices.data(), count,
+        moments.data(), offsets.data());
+    DoNotOptimize(offsets.back());
+  }, count);
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "ignition/math/Kmeans.hh"
+#include "ignition/math/Rand.hh"
+
+#include "Benchmark.hh"
+
+using namespace ignition;
+using math::test::Benchmark;
+using math::test::DoNotOptimize;
+
+/////////////////////////////////////////////////
+/// \brief Random observations around a set of cluster centers.
+/// \param[in] _count Number of observations.
+/// \param[in] _clusters Number of clusters.
+/// \return The observations.
+static std::vector<math::Vector3d> Observations(const size_t _count,
+    const size_t _clusters)
+{
+  math::Rand::Seed(1234);
+  std::vector<math::Vector3d> centers;
+  for (size_t i = 0; i < _clusters; ++i)
+  {
+    centers.push_back(math::Vector3d(math::Rand::DblUniform(-100, 100),
+          math::Rand::DblUniform(-100, 100),
+          math::Rand::DblUniform(-100, 100)));
+  }
+
+  std::vector<math::Vector3d> obs;
+  for (size_t i = 0; i < _count; ++i)
+  {
+    obs.push_back(centers[i % _clusters] +
+        math::Vector3d(math::Rand::DblNormal(0, 5),
+          math::Rand::DblNormal(0, 5), math::Rand::DblNormal(0, 5)));
+  }
+  return obs;
+}
+
+/////////////////////////////////////////////////
+TEST(Kmeans, Cluster)
+{
+  std::vector<math::Vector3d> centroids;
+  std::vector<unsigned int> labels;
+
+  auto small = Observations(1000, 8);
+  Benchmark("Kmeans_Cluster_1000x8", [&](uint64_t)
+  {
+    math::Kmeans kmeans(small);
+    DoNotOptimize(kmeans.Cluster(8, centroids, labels));
+  });
+
+  auto large = Observations(20000, 16);
+  Benchmark("Kmeans_Cluster_20000x16", [&](uint64_t)
+  {
+    math::Kmeans kmeans(large);
+    DoNotOptimize(kmeans.Cluster(16, centroids, labels));
+  });
+}
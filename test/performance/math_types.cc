@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "ignition/math/Matrix4.hh"
+#include "ignition/math/Pose3.hh"
+#include "ignition/math/Quaternion.hh"
+#include "ignition/math/Rand.hh"
+#include "ignition/math/Vector3.hh"
+
+#include "Benchmark.hh"
+
+using namespace ignition;
+using math::test::Benchmark;
+using math::test::DoNotOptimize;
+
+/// \brief Number of precomputed inputs. A power of two so the input index
+/// is a cheap mask.
+static const size_t kInputs = 1024;
+
+/////////////////////////////////////////////////
+/// \brief Random inputs shared by the benchmarks.
+struct Inputs
+{
+  Inputs()
+  {
+    math::Rand::Seed(1234);
+    for (size_t i = 0; i < kInputs; ++i)
+    {
+      vec.push_back(math::Vector3d(math::Rand::DblUniform(-10, 10),
+            math::Rand::DblUniform(-10, 10), math::Rand::DblUniform(-10, 10)));
+      quat.push_back(math::Quaterniond(math::Rand::DblUniform(-3, 3),
+            math::Rand::DblUniform(-3, 3), math::Rand::DblUniform(-3, 3)));
+      pose.push_back(math::Pose3d(vec.back(), quat.back()));
+      mat.push_back(math::Matrix4d(pose.back()));
+    }
+  }
+
+  std::vector<math::Vector3d> vec;
+  std::vector<math::Quaterniond> quat;
+  std::vector<math::Pose3d> pose;
+  std::vector<math::Matrix4d> mat;
+};
+
+/////////////////////////////////////////////////
+TEST(MathTypes, Vector3)
+{
+  Inputs in;
+  const size_t mask = kInputs - 1;
+
+  Benchmark("Vector3d_Add", [&](uint64_t _i)
+  {
+    DoNotOptimize(in.vec[_i & mask] + in.vec[(_i + 1) & mask]);
+  });
+  Benchmark("Vector3d_Cross", [&](uint64_t _i)
+  {
+    DoNotOptimize(in.vec[_i & mask].Cross(in.vec[(_i + 1) & mask]));
+  });
+  Benchmark("Vector3d_Dot", [&](uint64_t _i)
+  {
+    DoNotOptimize(in.vec[_i & mask].Dot(in.vec[(_i + 1) & mask]));
+  });
+  Benchmark("Vector3d_Normalized", [&](uint64_t _i)
+  {
+    DoNotOptimize(in.vec[_i & mask].Normalized());
+  });
+}
+
+/////////////////////////////////////////////////
+TEST(MathTypes, Quaternion)
+{
+  Inputs in;
+  const size_t mask = kInputs - 1;
+
+  Benchmark("Quaterniond_Multiply", [&](uint64_t _i)
+  {
+    DoNotOptimize(in.quat[_i & mask] * in.quat[(_i + 1) & mask]);
+  });
+  Benchmark("Quaterniond_RotateVector", [&](uint64_t _i)
+  {
+    DoNotOptimize(in.quat[_i & mask].RotateVector(in.vec[_i & mask]));
+  });
+  Benchmark("Quaterniond_Inverse", [&](uint64_t _i)
+  {
+    DoNotOptimize(in.quat[_i & mask].Inverse());
+  });
+  Benchmark("Quaterniond_Euler", [&](uint64_t _i)
+  {
+    DoNotOptimize(in.quat[_i & mask].Euler());
+  });
+  Benchmark("Quaterniond_Slerp", [&](uint64_t _i)
+  {
+    DoNotOptimize(math::Quaterniond::Slerp(0.3, in.quat[_i & mask],
+          in.quat[(_i + 1) & mask]));
+  });
+}
+
+/////////////////////////////////////////////////
+TEST(MathTypes, Matrix4)
+{
+  Inputs in;
+  const size_t mask = kInputs - 1;
+
+  Benchmark("Matrix4d_Multiply", [&](uint64_t _i)
+  {
+    DoNotOptimize(in.mat[_i & mask] * in.mat[(_i + 1) & mask]);
+  });
+  Benchmark("Matrix4d_MultiplyVector", [&](uint64_t _i)
+  {
+    DoNotOptimize(in.mat[_i & mask] * in.vec[_i & mask]);
+  });
+  Benchmark("Matrix4d_Inverse", [&](uint64_t _i)
+  {
+    DoNotOptimize(in.mat[_i & mask].Inverse());
+  });
+  Benchmark("Matrix4d_Pose", [&](uint64_t _i)
+  {
+    DoNotOptimize(in.mat[_i & mask].Pose());
+  });
+}
+
+/////////////////////////////////////////////////
+TEST(MathTypes, Pose3)
+{
+  Inputs in;
+  const size_t mask = kInputs - 1;
+
+  Benchmark("Pose3d_Compose", [&](uint64_t _i)
+  {
+    DoNotOptimize(in.pose[_i & mask] + in.pose[(_i + 1) & mask]);
+  });
+  Benchmark("Pose3d_InverseCompose", [&](uint64_t _i)
+  {
+    DoNotOptimize(in.pose[_i & mask] - in.pose[(_i + 1) & mask]);
+  });
+  Benchmark("Pose3d_Inverse", [&](uint64_t _i)
+  {
+    DoNotOptimize(in.pose[_i & mask].Inverse());
+  });
+  Benchmark("Pose3d_CoordPositionAdd", [&](uint64_t _i)
+  {
+    DoNotOptimize(in.pose[_i & mask].CoordPositionAdd(in.vec[_i & mask]));
+  });
+}
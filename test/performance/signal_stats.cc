@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "ignition/math/Rand.hh"
+#include "ignition/math/SignalStats.hh"
+#include "ignition/math/Vector3.hh"
+#include "ignition/math/Vector3Stats.hh"
+
+#include "Benchmark.hh"
+
+using namespace ignition;
+using math::test::Benchmark;
+using math::test::DoNotOptimize;
+
+/// \brief Number of samples inserted per benchmark call.
+static const size_t kSamples = 4096;
+
+/////////////////////////////////////////////////
+TEST(SignalStats, InsertData)
+{
+  std::vector<double> data(kSamples);
+  math::Rand::Seed(1234);
+  math::Rand::FillNormal(data.data(), data.size(), 0.0, 1.0);
+
+  math::SignalStats stats;
+  stats.InsertStatistics("max,maxAbs,mean,min,rms,var");
+
+  Benchmark("SignalStats_InsertData_Single", [&](uint64_t)
+  {
+    for (double d : data)
+      stats.InsertData(d);
+    DoNotOptimize(stats.Count());
+  }, kSamples);
+
+  Benchmark("SignalStats_InsertData_Batch", [&](uint64_t)
+  {
+    stats.InsertData(data.data(), data.size());
+    DoNotOptimize(stats.Count());
+  }, kSamples);
+
+  math::SignalAccumulator acc;
+  Benchmark("SignalAccumulator_InsertData_Batch", [&](uint64_t)
+  {
+    acc.InsertData(data.data(), data.size());
+    DoNotOptimize(acc.Count());
+  }, kSamples);
+}
+
+/////////////////////////////////////////////////
+TEST(SignalStats, Vector3StatsInsertData)
+{
+  std::vector<math::Vector3d> data(kSamples);
+  math::Rand::Seed(1234);
+  math::Rand::FillNormal(data.data(), data.size(), math::Vector3d::Zero,
+      math::Vector3d::One);
+
+  math::Vector3Stats stats;
+  stats.InsertStatistics("mean,rms,var");
+
+  Benchmark("Vector3Stats_InsertData_Single", [&](uint64_t)
+  {
+    for (const auto &d : data)
+      stats.InsertData(d);
+    DoNotOptimize(stats.Mag().Count());
+  }, kSamples);
+
+  Benchmark("Vector3Stats_InsertData_Batch", [&](uint64_t)
+  {
+    stats.InsertData(data.data(), data.size());
+    DoNotOptimize(stats.Mag().Count());
+  }, kSamples);
+}
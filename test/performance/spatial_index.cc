@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "ignition/math/KdTree.hh"
+#include "ignition/math/OccupancyMap.hh"
+#include "ignition/math/Rand.hh"
+#include "ignition/math/SpaceFillingCurve.hh"
+#include "ignition/math/SpatialHashGrid.hh"
+
+#include "Benchmark.hh"
+
+using namespace ignition;
+using math::test::Benchmark;
+using math::test::DoNotOptimize;
+
+/// \brief Number of points of the point sets.
+static const size_t kPoints = 100000;
+
+/// \brief Number of precomputed query points, a power of two.
+static const size_t kQueries = 1024;
+
+/////////////////////////////////////////////////
+/// \brief Uniform random points in a 10 m cube centered on the origin, at
+/// a density of 100 points per m^3.
+static std::vector<math::Vector3d> RandomPoints(const size_t _count)
+{
+  std::vector<math::Vector3d> points;
+  for (size_t i = 0; i < _count; ++i)
+  {
+    points.push_back(math::Vector3d(math::Rand::DblUniform(-5, 5),
+          math::Rand::DblUniform(-5, 5), math::Rand::DblUniform(-5, 5)));
+  }
+  return points;
+}
+
+/////////////////////////////////////////////////
+TEST(SpatialIndex, SpatialHashGrid)
+{
+  math::Rand::Seed(1234);
+  const std::vector<math::Vector3d> points = RandomPoints(kPoints);
+  const std::vector<math::Vector3d> queries = RandomPoints(kQueries);
+  const size_t mask = kQueries - 1;
+
+  // Cells of about the query radius, as for particle interactions
+  const double radius = 0.2;
+  math::SpatialHashGridd grid(radius);
+
+  Benchmark("SpatialHashGrid_Build", [&](uint64_t)
+  {
+    grid.Build(points);
+    DoNotOptimize(grid.CellCount());
+  }, kPoints);
+
+  grid.Build(points);
+  std::vector<size_t> result;
+  Benchmark("SpatialHashGrid_Radius", [&](uint64_t _i)
+  {
+    grid.Radius(queries[_i & mask], radius, result);
+    DoNotOptimize(result.size());
+  });
+  Benchmark("SpatialHashGrid_Nearest8", [&](uint64_t _i)
+  {
+    grid.Nearest(queries[_i & mask], 8, result);
+    DoNotOptimize(result.size());
+  });
+
+  std::vector<math::SpatialHashGridd::Pair> pairs;
+  Benchmark("SpatialHashGrid_Pairs", [&](uint64_t)
+  {
+    grid.Pairs(radius, pairs);
+    DoNotOptimize(pairs.size());
+  }, kPoints);
+}
+
+/////////////////////////////////////////////////
+TEST(SpatialIndex, KdTree)
+{
+  math::Rand::Seed(1234);
+  const std::vector<math::Vector3d> points = RandomPoints(kPoints);
+  const std::vector<math::Vector3d> queries = RandomPoints(kQueries);
+  const size_t mask = kQueries - 1;
+
+  math::KdTreed tree;
+  Benchmark("KdTree_Build", [&](uint64_t)
+  {
+    tree.Build(points);
+    DoNotOptimize(tree.Size());
+  }, kPoints);
+
+  tree.Build(points);
+  size_t index;
+  double distance;
+  Benchmark("KdTree_Nearest", [&](uint64_t _i)
+  {
+    DoNotOptimize(tree.Nearest(queries[_i & mask], index, distance));
+  });
+  std::vector<size_t> result;
+  Benchmark("KdTree_Nearest8", [&](uint64_t _i)
+  {
+    tree.Nearest(queries[_i & mask], 8, result);
+    DoNotOptimize(result.size());
+  });
+  Benchmark("KdTree_Nearest8_Epsilon0.5", [&](uint64_t _i)
+  {
+    tree.Nearest(queries[_i & mask], 8, result,
+        std::numeric_limits<double>::infinity(), 0.5);
+    DoNotOptimize(result.size());
+  });
+  Benchmark("KdTree_Radius", [&](uint64_t _i)
+  {
+    tree.Radius(queries[_i & mask], 0.2, result);
+    DoNotOptimize(result.size());
+  });
+
+  std::vector<size_t> indices(kQueries * 8);
+  Benchmark("KdTree_Nearest8_Batch", [&](uint64_t)
+  {
+    DoNotOptimize(tree.Nearest(queries.data(), kQueries, 8, indices.data(),
+          nullptr));
+  }, kQueries);
+
+  math::KdTreef treef(points);
+  Benchmark("KdTreef_Nearest8", [&](uint64_t _i)
+  {
+    treef.Nearest(queries[_i & mask], 8, result);
+    DoNotOptimize(result.size());
+  });
+}
+
+/////////////////////////////////////////////////
+TEST(SpatialIndex, OccupancyMap)
+{
+  math::Rand::Seed(1234);
+
+  // A lidar scan of 10k rays of up to 20 m, around a sensor that moves by
+  // 10 cm between scans
+  std::vector<math::Vector3d> scan;
+  for (int i = 0; i < 10000; ++i)
+  {
+    math::Vector3d dir(math::Rand::DblNormal(0, 1),
+        math::Rand::DblNormal(0, 1), math::Rand::DblNormal(0, 0.2));
+    dir.Normalize();
+    scan.push_back(dir * math::Rand::DblUniform(2, 20));
+  }
+
+  math::OccupancyMap map(0.1);
+  Benchmark("OccupancyMap_InsertScan", [&](uint64_t _i)
+  {
+    const math::Vector3d origin((_i % 100) * 0.1, 0, 0);
+    DoNotOptimize(map.InsertScan(origin, scan));
+  }, scan.size());
+
+  const std::vector<math::Vector3d> queries = RandomPoints(kQueries);
+  const size_t mask = kQueries - 1;
+  Benchmark("OccupancyMap_Occupied", [&](uint64_t _i)
+  {
+    DoNotOptimize(map.Occupied(queries[_i & mask]));
+  });
+
+  std::vector<math::OccupancyMap::Leaf> leaves;
+  const math::AxisAlignedBox box(-2, -2, -2, 2, 2, 2);
+  Benchmark("OccupancyMap_Leaves", [&](uint64_t)
+  {
+    map.Leaves(box, leaves);
+    DoNotOptimize(leaves.size());
+  });
+}
+
+/////////////////////////////////////////////////
+TEST(SpatialIndex, SpaceFillingCurve)
+{
+  math::Rand::Seed(1234);
+  const std::vector<math::Vector3d> points = RandomPoints(kPoints);
+  const math::AxisAlignedBox box(-5, -5, -5, 5, 5, 5);
+  using Curve = math::SpaceFillingCurve;
+
+  std::vector<uint64_t> keys(kPoints);
+  Benchmark("SpaceFillingCurve_MortonKey", [&](uint64_t)
+  {
+    for (size_t i = 0; i < kPoints; ++i)
+      keys[i] = Curve::Key(points[i], box);
+    DoNotOptimize(keys.data());
+  }, kPoints);
+  Benchmark("SpaceFillingCurve_HilbertKey", [&](uint64_t)
+  {
+    for (size_t i = 0; i < kPoints; ++i)
+      keys[i] = Curve::Key(points[i], box, Curve::CURVE_HILBERT);
+    DoNotOptimize(keys.data());
+  }, kPoints);
+
+  for (size_t i = 0; i < kPoints; ++i)
+    keys[i] = Curve::Key(points[i], box);
+  std::vector<uint64_t> sorted;
+  std::vector<size_t> order;
+  Benchmark("SpaceFillingCurve_RadixSort", [&](uint64_t)
+  {
+    sorted = keys;
+    Curve::RadixSort(sorted, &order);
+    DoNotOptimize(order.data());
+  }, kPoints);
+  Benchmark("SpaceFillingCurve_StdSort", [&](uint64_t)
+  {
+    sorted = keys;
+    std::sort(sorted.begin(), sorted.end());
+    DoNotOptimize(sorted.data());
+  }, kPoints);
+
+  std::vector<math::Vector3d> work;
+  Benchmark("SpaceFillingCurve_Sort", [&](uint64_t)
+  {
+    work = points;
+    Curve::Sort(work, order);
+    DoNotOptimize(work.data());
+  }, kPoints);
+}
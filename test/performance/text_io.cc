@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "ignition/math/Binary.hh"
+#include "ignition/math/Format.hh"
+#include "ignition/math/Matrix4.hh"
+#include "ignition/math/Parse.hh"
+#include "ignition/math/Pose3.hh"
+#include "ignition/math/Rand.hh"
+#include "ignition/math/Vector3.hh"
+
+#include "Benchmark.hh"
+
+using namespace ignition;
+using math::test::Benchmark;
+using math::test::DoNotOptimize;
+
+/// \brief Number of precomputed inputs. A power of two so the input index
+/// is a cheap mask.
+static const size_t kInputs = 1024;
+
+/////////////////////////////////////////////////
+/// \brief Random values and the text written by their output operators.
+struct Inputs
+{
+  Inputs()
+  {
+    math::Rand::Seed(1234);
+    for (size_t i = 0; i < kInputs; ++i)
+    {
+      const math::Vector3d v(math::Rand::DblUniform(-100, 100),
+          math::Rand::DblUniform(-100, 100), math::Rand::DblUniform(-100, 100));
+      const math::Pose3d p(v, math::Quaterniond(math::Rand::DblUniform(-3, 3),
+            math::Rand::DblUniform(-3, 3), math::Rand::DblUniform(-3, 3)));
+      vecValue.push_back(v);
+      poseValue.push_back(p);
+      matValue.push_back(math::Matrix4d(p));
+      std::ostringstream out;
+      out << v;
+      vec.push_back(out.str());
+      out.str("");
+      out << p;
+      pose.push_back(out.str());
+      out.str("");
+      out << math::Matrix4d(p);
+      mat.push_back(out.str());
+    }
+  }
+
+  std::vector<std::string> vec;
+  std::vector<std::string> pose;
+  std::vector<std::string> mat;
+  std::vector<math::Vector3d> vecValue;
+  std::vector<math::Pose3d> poseValue;
+  std::vector<math::Matrix4d> matValue;
+};
+
+/////////////////////////////////////////////////
+/// \brief Read a value with the input operator.
+template<typename T>
+T StreamRead(const std::string &_text)
+{
+  std::istringstream in(_text);
+  T value;
+  in >> value;
+  return value;
+}
+
+/////////////////////////////////////////////////
+/// \brief Write a value with the output operator.
+template<typename T>
+std::string StreamWrite(const T &_value)
+{
+  std::ostringstream out;
+  out << _value;
+  return out.str();
+}
+
+/////////////////////////////////////////////////
+TEST(TextIO, Parse)
+{
+  Inputs in;
+  const size_t mask = kInputs - 1;
+
+  Benchmark("Vector3d_StreamRead", [&](uint64_t _i)
+  {
+    DoNotOptimize(StreamRead<math::Vector3d>(in.vec[_i & mask]));
+  });
+  Benchmark("Vector3d_Parse", [&](uint64_t _i)
+  {
+    math::Vector3d v;
+    math::Parse(in.vec[_i & mask], v);
+    DoNotOptimize(v);
+  });
+  Benchmark("Pose3d_StreamRead", [&](uint64_t _i)
+  {
+    DoNotOptimize(StreamRead<math::Pose3d>(in.pose[_i & mask]));
+  });
+  Benchmark("Pose3d_Parse", [&](uint64_t _i)
+  {
+    math::Pose3d p;
+    math::Parse(in.pose[_i & mask], p);
+    DoNotOptimize(p);
+  });
+  Benchmark("Matrix4d_StreamRead", [&](uint64_t _i)
+  {
+    DoNotOptimize(StreamRead<math::Matrix4d>(in.mat[_i & mask]));
+  });
+  Benchmark("Matrix4d_Parse", [&](uint64_t _i)
+  {
+    math::Matrix4d m;
+    math::Parse(in.mat[_i & mask], m);
+    DoNotOptimize(m);
+  });
+}
+
+/////////////////////////////////////////////////
+TEST(TextIO, Format)
+{
+  Inputs in;
+  const size_t mask = kInputs - 1;
+  char buffer[512];
+
+  Benchmark("Vector3d_StreamWrite", [&](uint64_t _i)
+  {
+    DoNotOptimize(StreamWrite(in.vecValue[_i & mask]));
+  });
+  Benchmark("Vector3d_Format", [&](uint64_t _i)
+  {
+    DoNotOptimize(math::Format(buffer, sizeof(buffer),
+          in.vecValue[_i & mask]));
+  });
+  Benchmark("Pose3d_StreamWrite", [&](uint64_t _i)
+  {
+    DoNotOptimize(StreamWrite(in.poseValue[_i & mask]));
+  });
+  Benchmark("Pose3d_Format", [&](uint64_t _i)
+  {
+    DoNotOptimize(math::Format(buffer, sizeof(buffer),
+          in.poseValue[_i & mask]));
+  });
+  Benchmark("Matrix4d_StreamWrite", [&](uint64_t _i)
+  {
+    DoNotOptimize(StreamWrite(in.matValue[_i & mask]));
+  });
+  Benchmark("Matrix4d_Format", [&](uint64_t _i)
+  {
+    DoNotOptimize(math::Format(buffer, sizeof(buffer),
+          in.matValue[_i & mask]));
+  });
+
+  // Whole CSV files of poses, per pose
+  std::vector<char> file(kInputs * 160);
+  const math::FormatOptions csv(math::FORMAT_SHORTEST, 6, ',');
+  Benchmark("Pose3d_FormatLines", [&](uint64_t)
+  {
+    size_t size = 0;
+    DoNotOptimize(math::FormatLines(file.data(), file.size(),
+          in.poseValue.data(), kInputs, size, csv));
+  }, kInputs);
+}
+
+/////////////////////////////////////////////////
+TEST(TextIO, Binary)
+{
+  // Binary logs, for comparison with the text formats
+  Inputs in;
+  const size_t mask = kInputs - 1;
+  std::vector<unsigned char> file(
+      math::Binary::ArraySize<math::Pose3d>(kInputs));
+
+  Benchmark("Pose3d_BinaryWriteArray", [&](uint64_t)
+  {
+    DoNotOptimize(math::Binary::WriteArray(in.poseValue.data(), kInputs,
+          file.data(), file.size()));
+  }, kInputs);
+
+  const math::BinaryArrayView<math::Pose3d> view(file.data(), file.size());
+  Benchmark("Pose3d_BinaryViewRead", [&](uint64_t _i)
+  {
+    DoNotOptimize(view[_i & mask]);
+  });
+}
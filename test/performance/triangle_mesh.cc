@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2020 Open Source Robotics Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "ignition/math/Rand.hh"
+#include "ignition/math/TriangleMesh.hh"
+
+#include "Benchmark.hh"
+
+using namespace ignition;
+using math::test::Benchmark;
+using math::test::DoNotOptimize;
+
+/////////////////////////////////////////////////
+/// \brief Build a bumpy terrain of 2 * _size * _size triangles over
+/// [-50, 50] x [-50, 50].
+math::TriangleMesh Terrain(const unsigned int _size)
+{
+  std::vector<math::Vector3d> vertices;
+  std::vector<unsigned int> indices;
+  for (unsigned int j = 0; j <= _size; ++j)
+  {
+    for (unsigned int i = 0; i <= _size; ++i)
+    {
+      const double x = 100.0 * i / _size - 50;
+      const double y = 100.0 * j / _size - 50;
+      vertices.push_back(math::Vector3d(x, y,
+            2 * std::sin(0.3 * x) * std::cos(0.2 * y)));
+    }
+  }
+  for (unsigned int j = 0; j < _size; ++j)
+  {
+    for (unsigned int i = 0; i < _size; ++i)
+    {
+      const unsigned int v = j * (_size + 1) + i;
+      indices.insert(indices.end(), {v, v + 1, v + _size + 2});
+      indices.insert(indices.end(), {v, v + _size + 2, v + _size + 1});
+    }
+  }
+  return math::TriangleMesh(vertices, indices);
+}
+
+/////////////////////////////////////////////////
+TEST(TriangleMesh, Build)
+{
+  const math::TriangleMesh terrain = Terrain(256);
+  const std::vector<math::Vector3d> &vertices = terrain.Vertices();
+  const std::vector<unsigned int> &indices = terrain.Indices();
+
+  Benchmark("TriangleMesh_Build", [&](uint64_t)
+  {
+    math::TriangleMesh mesh;
+    DoNotOptimize(mesh.Set(vertices, indices));
+  }, terrain.TriangleCount());
+}
+
+/////////////////////////////////////////////////
+TEST(TriangleMesh, Queries)
+{
+  const math::TriangleMesh terrain = Terrain(256);
+
+  // Depth camera looking down at the terrain from above
+  const unsigned int width = 160;
+  const unsigned int height = 120;
+  const size_t count = width * height;
+  const math::Vector3d eye(-20, -10, 30);
+  std::vector<math::Vector3d> origins(count, eye);
+  std::vector<math::Vector3d> dirs;
+  for (unsigned int v = 0; v < height; ++v)
+  {
+    for (unsigned int u = 0; u < width; ++u)
+    {
+      dirs.push_back(math::Vector3d(
+          (u - 0.5 * width) / width, (v - 0.5 * height) / width, -0.8));
+    }
+  }
+  std::vector<math::TriangleMesh::RayHit> hits(count);
+  bool occluded[count];
+
+  Benchmark("TriangleMesh_RayCast_Single", [&](uint64_t)
+  {
+    for (size_t i = 0; i < count; ++i)
+      terrain.RayCast(origins[i], dirs[i], hits[i]);
+    DoNotOptimize(hits.back());
+  }, count);
+
+  Benchmark("TriangleMesh_RayCast_Packet", [&](uint64_t)
+  {
+    DoNotOptimize(terrain.RayCast(origins.data(), dirs.data(), count,
+          hits.data()));
+  }, count);
+
+  Benchmark("TriangleMesh_Occluded_Single", [&](uint64_t)
+  {
+    for (size_t i = 0; i < count; ++i)
+      occluded[i] = terrain.Occluded(origins[i], dirs[i]);
+    DoNotOptimize(occluded[count - 1]);
+  }, count);
+
+  Benchmark("TriangleMesh_Occluded_Packet", [&](uint64_t)
+  {
+    DoNotOptimize(terrain.Occluded(origins.data(), dirs.data(), count,
+          occluded));
+  }, count);
+
+  // Random points within a meter of the surface
+  math::Rand::Seed(1234);
+  std::vector<math::Vector3d> points;
+  for (size_t i = 0; i < 4096; ++i)
+  {
+    const double x = math::Rand::DblUniform(-50, 50);
+    const double y = math::Rand::DblUniform(-50, 50);
+    points.push_back(math::Vector3d(x, y, 2 * std::sin(0.3 * x) *
+          std::cos(0.2 * y) + math::Rand::DblUniform(-1, 1)));
+  }
+  Benchmark("TriangleMesh_ClosestPoint", [&](uint64_t)
+  {
+    math::TriangleMesh::PointHit hit;
+    for (const math::Vector3d &point : points)
+      terrain.ClosestPoint(point, hit);
+    DoNotOptimize(hit);
+  }, points.size());
+}